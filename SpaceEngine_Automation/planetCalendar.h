@@ -0,0 +1,373 @@
+//Planet Calendar
+//Shared Header
+//Chris D. | Version 1 | Version Date: 10/18/2026
+
+// ============================================================ //
+// |                    VERSION HISTORY                       | //
+// ============================================================ //
+//Version 0 (10/18/2026): CalendarSpec and PlanetClock moved out
+//  of seScreenshotEngine.cpp so the generator, its benchmark,
+//  and the star tools share one calendar.
+//Version 1 (10/18/2026): Leap-cycle calendars (CalendarSpec::
+//  leapRule) with whole-day years and months and O(1) table
+//  lookups.
+
+// ============================================================ //
+// |                  PROGRAM DESCRIPTION                     | //
+// ============================================================ //
+//Planet-relative calendar arithmetic: converts between seconds
+//since year0 and SpaceEngine date/time stamps for a planet with
+//arbitrary day, month, and year lengths.
+//
+//leapRule picks how fractional yearDays/monthDays become dates:
+//  none      - the original continuous calendar: a year is exactly
+//              yearDays long, so with 365.25 each year starts 6 h
+//              later in the day than the one before.
+//  even      - whole-day years: floor(yearDays) days plus leap days
+//              spread evenly over the shortest cycle whose average
+//              is yearDays (365.25 -> one leap day every 4 years).
+//  gregorian - Earth's calendar (4/100/400 rule, Jan..Dec month
+//              lengths), the dates SpaceEngine itself uses;
+//              yearDays and monthDays are ignored.
+//  P:+d,...  - custom divisibility rules on the year number, e.g.
+//              "4:+1,100:-1,400:+1" on top of floor(yearDays).
+//With a leap rule, months are whole days too: month m starts on day
+//floor(m * monthDays) and the last month absorbs the leap days. Even
+//cycles place each leap day where the continuous calendar would
+//have gained a whole day (365.25: year0+3, year0+7, ...).
+//Conversions look up one precomputed cycle of year starts, so they
+//cost the same for any date. Interval steps (addYears, addMonths)
+//use the cycle's mean year and month.
+
+#ifndef LIVE_SKYBOXES_PLANET_CALENDAR_H
+#define LIVE_SKYBOXES_PLANET_CALENDAR_H
+
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <algorithm>
+
+// ============================================================ //
+// |             FUNCTION AND STRUCT DEFINITIONS              | //
+// ============================================================ //
+// --------------------- TIME ADVANCEMENT --------------------- //
+struct CalendarSpec {
+    double dayHours {24.0}; //Length of 1 day in Earth hours
+    double monthDays {30.0}; //Length of 1 month in planet-days
+    double yearDays {365.0}; //Length of 1 year in planet-days
+    int year0 {2000}; //Base year (YYYY label origin)
+    std::string leapRule {"none"}; //none | even | gregorian | P:+d,...
+};
+
+struct DateParts {
+    int year{2000}, month{1}, day{1}, hour{0}, minute{0};
+    double second{0.0};
+};
+
+// ---------------------- LEAP CYCLES ------------------------ //
+//One full cycle of whole-day years starting at year0, and the
+//month starts for a year of each length in the cycle.
+struct LeapCycle {
+    int years = 0;                      //0: continuous calendar
+    long long days = 0;                 //Days per cycle
+    std::vector<long long> yearStart;   //years + 1 entries, day of each year's start
+    int baseDays = 0;                   //Shortest year
+    std::vector<int> monthStart[3];     //By year length - baseDays; last entry is the year's end
+    double meanMonthDays = 0.0;
+
+    static long long floorDiv(long long a,long long b) {
+        long long q = a / b;
+        return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+    }
+
+    static LeapCycle build(const CalendarSpec& spec) {
+        LeapCycle cycle;
+        if (spec.leapRule.empty() || spec.leapRule == "none") return cycle;
+        std::vector<int> leapDays;      //Per cycle year
+        bool gregorian = false;
+        cycle.baseDays = (int)std::floor(spec.yearDays + 1e-9);
+
+        if (spec.leapRule == "even") {
+            //Shortest cycle N with N * fraction whole (to 1e-9), else
+            //the closest within kMaxCycle years.
+            const int kMaxCycle = 10000;
+            const double fraction = spec.yearDays - cycle.baseDays;
+            int years = kMaxCycle;
+            for (int n = 1; n <= kMaxCycle; n++) {
+                if (std::fabs(n * fraction - std::round(n * fraction)) < 1e-9 * n) { years = n; break; }
+            }
+            const long long leaps = std::llround(years * fraction);
+            for (int k = 0; k < years; k++) leapDays.push_back((int)(((k + 1) * leaps) / years - (k * leaps) / years));
+        } else {
+            //Divisibility rules on the absolute year; the cycle is their lcm.
+            std::vector<std::pair<int,int>> rules;
+            std::string ruleText = spec.leapRule;
+            if (ruleText == "gregorian") { ruleText = "4:+1,100:-1,400:+1"; gregorian = true; cycle.baseDays = 365; }
+            long long years = 1;
+            for (size_t begin = 0, end; begin < ruleText.size(); begin = end + 1) {
+                end = ruleText.find(',',begin);
+                if (end == std::string::npos) end = ruleText.size();
+                int period = 0, delta = 0;
+                if (std::sscanf(ruleText.substr(begin,end - begin).c_str(),"%d:%d",&period,&delta) != 2 || period <= 0) {
+                    throw std::runtime_error("Bad leapRule term (expected P:+d): " + ruleText.substr(begin,end - begin));
+                }
+                rules.push_back({period,delta});
+                long long a = years, b = period;
+                while (b) { long long t = a % b; a = b; b = t; }
+                years = years / a * period;
+                if (years > 100000) throw std::runtime_error("leapRule cycle longer than 100000 years: " + spec.leapRule);
+            }
+            for (long long k = 0; k < years; k++) {
+                const long long year = spec.year0 + k;
+                int extra = 0;
+                for (const auto& rule : rules) if (year % rule.first == 0) extra += rule.second;
+                leapDays.push_back(extra);
+            }
+        }
+
+        cycle.years = (int)leapDays.size();
+        cycle.yearStart.assign(cycle.years + 1,0);
+        int minExtra = 0, maxExtra = 0;
+        for (int k = 0; k < cycle.years; k++) {
+            cycle.yearStart[k + 1] = cycle.yearStart[k] + cycle.baseDays + leapDays[k];
+            minExtra = std::min(minExtra,leapDays[k]);
+            maxExtra = std::max(maxExtra,leapDays[k]);
+        }
+        cycle.baseDays += minExtra;
+        if (cycle.baseDays < 1 || maxExtra - minExtra > 2) throw std::runtime_error("leapRule gives unusable year lengths: " + spec.leapRule);
+        cycle.days = cycle.yearStart[cycle.years];
+
+        // ----- Month starts per year length ----- //
+        for (int extra = 0; extra <= maxExtra - minExtra; extra++) {
+            const int yearDays = cycle.baseDays + extra;
+            std::vector<int>& starts = cycle.monthStart[extra];
+            if (gregorian) {
+                static const int kMonthDays[12] = { 31,28,31,30,31,30,31,31,30,31,30,31 };
+                starts.push_back(0);
+                for (int m = 0; m < 12; m++) starts.push_back(starts.back() + kMonthDays[m] + (m == 1 ? yearDays - 365 : 0));
+            } else {
+                //Every year has the shortest year's month count.
+                if (spec.monthDays <= 0.0) throw std::runtime_error("monthDays must be > 0");
+                for (int m = 0; m == 0 || std::floor(m * spec.monthDays + 1e-9) < cycle.baseDays; m++) {
+                    starts.push_back((int)std::floor(m * spec.monthDays + 1e-9));
+                }
+                starts.push_back(yearDays);
+            }
+        }
+        cycle.meanMonthDays = gregorian ? (double)cycle.days / cycle.years / 12.0 : spec.monthDays;
+        return cycle;
+    }
+
+    //Year offset from year0 and day of that year for a day index.
+    void locateDay(long long day,long long& yearOffset,int& dayOfYear) const {
+        const long long cycles = floorDiv(day,days);
+        const long long inCycle = day - cycles * days;
+        //Year starts are within a day or two of linear, so the estimate
+        //is at most one off.
+        int k = (int)(inCycle * years / days);
+        while (k + 1 < years && yearStart[k + 1] <= inCycle) k++;
+        while (k > 0 && yearStart[k] > inCycle) k--;
+        yearOffset = cycles * years + k;
+        dayOfYear = (int)(inCycle - yearStart[k]);
+    }
+
+    long long yearStartDay(long long yearOffset) const {
+        const long long cycles = floorDiv(yearOffset,years);
+        return cycles * days + yearStart[yearOffset - cycles * years];
+    }
+
+    const std::vector<int>& monthsOf(long long yearOffset) const {
+        const long long k = yearOffset - floorDiv(yearOffset,years) * years;
+        return monthStart[yearStart[k + 1] - yearStart[k] - baseDays];
+    }
+};
+
+struct PlanetClock {
+    CalendarSpec spec;
+    LeapCycle cycle;
+
+    PlanetClock() : PlanetClock(CalendarSpec{}) {}
+    PlanetClock(const CalendarSpec& calendar) : spec(calendar), cycle(LeapCycle::build(calendar)) {}
+
+    double daySec() const {
+        return spec.dayHours * 3600.0;
+    }
+    double monthSec() const {
+        if (cycle.years > 0) return cycle.meanMonthDays * daySec();
+        return spec.monthDays * daySec();
+    }
+    double yearSec() const {
+        if (cycle.years > 0) return (double)cycle.days / cycle.years * daySec();
+        return spec.yearDays * daySec();
+    }
+
+    double toSeconds(const DateParts& part) const {
+        if (cycle.years > 0) {
+            const long long yearOffset = part.year - spec.year0;
+            const std::vector<int>& months = cycle.monthsOf(yearOffset);
+            //Months past the year's last roll into the next year, as the
+            //continuous calendar does.
+            const long long monthIndex = part.month - 1;
+            const long long monthsInYear = (long long)months.size() - 1;
+            long long day = 0;
+            if (monthIndex >= 0 && monthIndex < monthsInYear) {
+                day = cycle.yearStartDay(yearOffset) + months[monthIndex];
+            } else {
+                const long long extraYears = LeapCycle::floorDiv(monthIndex,monthsInYear);
+                const std::vector<int>& other = cycle.monthsOf(yearOffset + extraYears);
+                day = cycle.yearStartDay(yearOffset + extraYears) + other[std::min<long long>(monthIndex - extraYears * monthsInYear,(long long)other.size() - 2)];
+            }
+            day += part.day - 1;
+            return (double)day * daySec() + part.hour * 3600.0 + part.minute * 60.0 + part.second;
+        }
+        int yearOffset = part.year - spec.year0;
+        //Month index is (month - 1) | Day index is (day - 1)
+        double time = 0.0;
+        time += yearOffset * yearSec();
+        time += (part.month - 1) * monthSec();
+        time += (part.day - 1) * daySec();
+        time += part.hour * 3600.0;
+        time += part.minute * 60.0;
+        time += part.second;
+        return time;
+    }
+
+    DateParts fromSeconds(double seconds) const {
+        DateParts part;
+        if (cycle.years > 0) return fromSecondsLeap(seconds);
+        // ----- Years ----- //
+        double years = std::floor(seconds / yearSec());
+        seconds -= years * yearSec();
+        part.year = spec.year0 + static_cast<int>(years);
+
+        // ----- Months ----- //
+        double months = std::floor(seconds / monthSec());
+        seconds -= months * monthSec();
+        part.month = static_cast<int>(months) + 1;
+
+        // ------ Days ----- //
+        double days = std::floor(seconds / daySec());
+        seconds -= days * daySec();
+        part.day = static_cast<int>(days) + 1;
+
+        // ----- Time of Day ----- //
+        part.hour = static_cast<int>(std::floor(seconds / 3600.0));
+        seconds -= part.hour * 3600.0;
+        part.minute = static_cast<int>(std::floor(seconds / 60.0));
+        seconds -= part.minute * 60.0;
+        part.second = seconds;
+
+        return part;
+    }
+
+    DateParts fromSecondsLeap(double seconds) const {
+        DateParts part;
+        // ----- Whole Days ----- //
+        const double day = std::floor(seconds / daySec());
+        seconds -= day * daySec();
+        if (seconds < 0.0) seconds = 0.0;
+
+        // ----- Year, Month and Day ----- //
+        long long yearOffset = 0;
+        int dayOfYear = 0;
+        cycle.locateDay((long long)day,yearOffset,dayOfYear);
+        part.year = spec.year0 + (int)yearOffset;
+        const std::vector<int>& months = cycle.monthsOf(yearOffset);
+        int month = (int)(dayOfYear / cycle.meanMonthDays);
+        if (month > (int)months.size() - 2) month = (int)months.size() - 2;
+        while (months[month + 1] <= dayOfYear) month++;
+        while (months[month] > dayOfYear) month--;
+        part.month = month + 1;
+        part.day = dayOfYear - months[month] + 1;
+
+        // ----- Time of Day ----- //
+        part.hour = static_cast<int>(std::floor(seconds / 3600.0));
+        seconds -= part.hour * 3600.0;
+        part.minute = static_cast<int>(std::floor(seconds / 60.0));
+        seconds -= part.minute * 60.0;
+        part.second = seconds;
+        return part;
+    }
+    // ============= FORMATTING FOR SPACEENGINE ============== //
+    static std::string formatDate(const DateParts& part) {
+        char buffer[32];
+        std::snprintf(buffer,sizeof(buffer),"%04d.%02d.%02d",part.year,part.month,part.day);
+        return std::string(buffer);
+    }
+
+    static std::string formatTime(const DateParts& part) {
+        char buffer[32];
+        std::snprintf(buffer,sizeof(buffer),"%02d:%02d:%05.2f",part.hour,part.minute,part.second);
+        return std::string(buffer);
+    }
+
+    // -- Parsing "YYYY.MM.DD" and "HH:MM:SS.ss" into parts -- //
+    static DateParts parseParts(const std::string& ymd,const std::string& hms,int year0default) {
+        DateParts part;
+        int year = year0default, month = 1, day = 1, hour = 0, minute = 0;
+        double second = 0.0;
+        std::sscanf(ymd.c_str(),"%d.%d.%d",&year,&month,&day);
+        std::sscanf(hms.c_str(),"%d:%d:%lf",&hour,&minute,&second);
+        part.year = year;
+        part.month = month;
+        part.day = day;
+        part.hour = hour;
+        part.minute = minute;
+        part.second = second;
+        return part;
+    }
+    // --------------- Time Stepping Utilities --------------- //
+    double addSeconds(double time,double seconds) const {
+        return time + seconds;
+    }
+
+    double addHours(double time,double hours) const {
+        return time + hours * 3600.0;
+    }
+
+    double addDays(double time,double days) const {
+        return time + days * daySec();
+    }
+
+    double addMonths(double time,double months) const {
+        return time + months * monthSec();
+    }
+
+    double addYears(double time,double years) const {
+        return time + years * yearSec();
+    }
+    // ------------------ Time Comparisons ------------------- //
+    static bool greaterThanOrEqualTo(double time1,double time2) {
+        return (time1 + 1e-9) >= time2;
+    }
+};
+
+// ---------------------- INTERVAL UNITS ---------------------- //
+enum class IntervalUnit { Seconds, Hours, Days, Months, Years };
+
+static inline IntervalUnit parseIntervalUnit(const std::string& unit) {
+    if      (unit == "seconds") return IntervalUnit::Seconds;
+    else if (unit == "hours")   return IntervalUnit::Hours;
+    else if (unit == "days")    return IntervalUnit::Days;
+    else if (unit == "months")  return IntervalUnit::Months;
+    else if (unit == "years")   return IntervalUnit::Years;
+    throw std::runtime_error("Unknown intervalUnit: " + unit);
+}
+
+//Seconds added by one step. Matches PlanetClock::add*() bit for bit,
+//since each of those is time + (step * unitSeconds).
+static inline double intervalStepSeconds(const PlanetClock& clock,IntervalUnit unit,double step) {
+    switch (unit) {
+        case IntervalUnit::Seconds: return step;
+        case IntervalUnit::Hours:   return step * 3600.0;
+        case IntervalUnit::Days:    return step * clock.daySec();
+        case IntervalUnit::Months:  return step * clock.monthSec();
+        case IntervalUnit::Years:   return step * clock.yearSec();
+    }
+    return step;
+}
+
+#endif // LIVE_SKYBOXES_PLANET_CALENDAR_H
@@ -0,0 +1,279 @@
+//SpaceEngine Object File Parsing
+//Shared Header
+//Chris D. | Version 0 | Version Date: 10/18/2026
+
+// ============================================================ //
+// |                    VERSION HISTORY                       | //
+// ============================================================ //
+//Version 0 (10/18/2026): Native port of seObjectParser.py for
+//  catalog-wide batch generation.
+
+// ============================================================ //
+// |                  PROGRAM DESCRIPTION                     | //
+// ============================================================ //
+//Reads SpaceEngine catalog/object files (.se/.sc) into a block
+//tree and derives a CalendarSpec per Planet, following the same
+//key and unit rules as seObjectParser.py. Unlike the Python
+//version, closing braces end their block, and a block header on
+//its own line ("Planet "Name"" followed by "{") is recognized.
+
+#ifndef LIVE_SKYBOXES_SE_CATALOG_PARSER_H
+#define LIVE_SKYBOXES_SE_CATALOG_PARSER_H
+
+#include <cctype>
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <utility>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "planetCalendar.h"
+
+// ============================================================ //
+// |             FUNCTION AND STRUCT DEFINITIONS              | //
+// ============================================================ //
+struct CatalogBlock {
+    std::string type;
+    std::string name;
+    int parent = -1;
+    std::vector<std::pair<std::string,std::string>> keyValue; // 'KV' for 'Key-Value'
+    std::vector<int> children;
+
+    const std::string* getValue(const std::string& key) const {
+        for (const auto& kv : keyValue) {
+            if (kv.first == key) return &kv.second;
+        }
+        return nullptr;
+    }
+};
+
+//All blocks live in one array; parent/children are indices into it.
+struct Catalog {
+    std::vector<CatalogBlock> blocks;
+    std::vector<int> roots;
+
+    int findChild(int block,const std::string& type) const {
+        for (int child : blocks[block].children) {
+            if (blocks[child].type == type) return child;
+        }
+        return -1;
+    }
+
+    //Breadth-first, like seObjectParser.findBlock().
+    int findBlock(const std::string& type,const std::string& name) const {
+        std::vector<int> queue(roots.begin(),roots.end());
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const CatalogBlock& block = blocks[queue[head]];
+            if (block.type == type && (name.empty() || block.name == name)) return queue[head];
+            queue.insert(queue.end(),block.children.begin(),block.children.end());
+        }
+        return -1;
+    }
+
+    std::vector<int> blocksOfType(const std::string& type) const {
+        std::vector<int> found;
+        for (int i = 0; i < (int)blocks.size(); ++i) {
+            if (blocks[i].type == type) found.push_back(i);
+        }
+        return found;
+    }
+};
+
+// ------------------------- PARSING ------------------------- //
+static inline std::string trimCopy(const std::string& text) {
+    size_t first = 0, last = text.size();
+    while (first < last && std::isspace((unsigned char)text[first])) ++first;
+    while (last > first && std::isspace((unsigned char)text[last - 1])) --last;
+    return text.substr(first,last - first);
+}
+
+static inline std::string unquote(const std::string& value) {
+    if (value.size() >= 2 && ((value.front() == '"' && value.back() == '"')
+                           || (value.front() == '\'' && value.back() == '\''))) {
+        return value.substr(1,value.size() - 2);
+    }
+    return value;
+}
+
+static inline bool isWordChar(char c) {
+    return std::isalnum((unsigned char)c) || c == '_';
+}
+
+static inline Catalog parseCatalog(const std::string& text) {
+    Catalog catalog;
+    std::vector<int> stack;
+
+    auto openBlock = [&](const std::string& type,const std::string& name) {
+        CatalogBlock block;
+        block.type = type;
+        block.name = name;
+        block.parent = stack.empty() ? -1 : stack.back();
+        int index = (int)catalog.blocks.size();
+        catalog.blocks.push_back(std::move(block));
+        if (stack.empty()) catalog.roots.push_back(index);
+        else catalog.blocks[stack.back()].children.push_back(index);
+        stack.push_back(index);
+    };
+
+    //Header line waiting for a "{" on the next line.
+    bool pendingHeader = false;
+    std::string pendingType, pendingName;
+
+    std::istringstream lines(text);
+    std::string raw;
+    while (std::getline(lines,raw)) {
+        std::string line = raw.substr(0,raw.find("//")); // Strip any // comments
+        line = trimCopy(line);
+        if (line.empty()) continue;
+
+        if (line == "{") {
+            if (pendingHeader) {
+                //The header was stored as a key-value pair; it is a block.
+                if (!stack.empty()) {
+                    auto& kv = catalog.blocks[stack.back()].keyValue;
+                    if (!kv.empty() && kv.back().first == pendingType) kv.pop_back();
+                }
+                openBlock(pendingType,pendingName);
+            }
+            pendingHeader = false;
+            continue;
+        }
+        pendingHeader = false;
+
+        if (line == "}") {
+            if (!stack.empty()) stack.pop_back();
+            continue;
+        }
+
+        // ----- Leading word ----- //
+        size_t pos = 0;
+        while (pos < line.size() && isWordChar(line[pos])) ++pos;
+        if (pos == 0 || std::isdigit((unsigned char)line[0])) continue;
+        std::string word = line.substr(0,pos);
+        std::string rest = trimCopy(line.substr(pos));
+
+        // ----- Block opening on the same line ----- //
+        if (!rest.empty() && rest.back() == '{') {
+            std::string header = trimCopy(rest.substr(0,rest.size() - 1));
+            if (header.empty() || (header.size() >= 2 && header.front() == '"' && header.back() == '"')) {
+                openBlock(word,unquote(header));
+                continue;
+            }
+        }
+
+        // ----- Key-value (also a possible block header) ----- //
+        if (rest.empty()) {
+            pendingHeader = true;
+            pendingType = word;
+            pendingName.clear();
+            if (!stack.empty()) catalog.blocks[stack.back()].keyValue.emplace_back(word,"");
+            continue;
+        }
+        std::string value = unquote(rest);
+        if (rest.front() == '"' && rest.back() == '"') {
+            pendingHeader = true;
+            pendingType = word;
+            pendingName = value;
+        }
+        if (!stack.empty()) catalog.blocks[stack.back()].keyValue.emplace_back(word,value);
+    }
+    return catalog;
+}
+
+static inline Catalog loadCatalog(const std::string& path) {
+    std::ifstream file(path,std::ios::binary);
+    if (!file) throw std::runtime_error("Failed to open catalog: " + path);
+    std::ostringstream ss;
+    ss << file.rdbuf();
+    return parseCatalog(ss.str());
+}
+
+// ---------------------- UNIT CONVERSION --------------------- //
+//Same units as seObjectParser.numToHours(); unitless values are hours.
+static inline bool numToHours(const std::string& text,double& hours) {
+    std::string value = trimCopy(text);
+    const char* begin = value.c_str();
+    char* end = nullptr;
+    double number = std::strtod(begin,&end);
+    if (end == begin) return false;
+    std::string unit = trimCopy(std::string(end));
+    for (char& c : unit) c = (char)std::tolower((unsigned char)c);
+    if (unit.empty() || unit == "h" || unit == "hr" || unit == "hrs" || unit == "hour" || unit == "hours") {
+        hours = number;
+    } else if (unit == "d" || unit == "day" || unit == "days") {
+        hours = number * 24.0;
+    } else if (unit == "yr" || unit == "year" || unit == "years") {
+        hours = number * 24.0 * 365.0;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static inline double hoursToDays(double hours,double dayHours) {
+    return hours / std::max(dayHours,1e-9);
+}
+
+// ---------------------- CALENDAR SPECS ---------------------- //
+//The month-determining moon of a planet: a Moon nested inside it,
+//or the first top-level Moon whose ParentBody names it.
+static inline int findPlanetMoon(const Catalog& catalog,int planet) {
+    int nested = catalog.findChild(planet,"Moon");
+    if (nested >= 0) return nested;
+    const std::string& planetName = catalog.blocks[planet].name;
+    for (int moon : catalog.blocksOfType("Moon")) {
+        const std::string* parent = catalog.blocks[moon].getValue("ParentBody");
+        if (parent && *parent == planetName) return moon;
+    }
+    return -1;
+}
+
+//Port of seObjectParser.buildCalendarSpec() for one Planet block.
+static inline CalendarSpec buildCalendarSpec(const Catalog& catalog,int planet,int moon,
+                                             double fallbackDayHours = 24.0,double fallbackYearDays = 365.0) {
+    CalendarSpec spec;
+    spec.dayHours = fallbackDayHours;
+    spec.yearDays = fallbackYearDays;
+    spec.monthDays = 30.0;
+    spec.year0 = 2000;
+    if (planet < 0) return spec;
+    const CatalogBlock& planetBlock = catalog.blocks[planet];
+
+    // ----- Day Length ----- //
+    for (const char* key : {"RotationPeriod","SiderealDay","DayLength","RotationalPeriodHours"}) {
+        const std::string* value = planetBlock.getValue(key);
+        double hours = 0.0;
+        if (value && !value->empty() && numToHours(*value,hours)) {
+            spec.dayHours = hours;
+            break;
+        }
+    }
+
+    // ----- Year Length ----- //
+    int orbit = catalog.findChild(planet,"Orbit");
+    if (orbit >= 0) {
+        const std::string* value = catalog.blocks[orbit].getValue("Period");
+        double hours = 0.0;
+        if (value && !value->empty() && numToHours(*value,hours)) {
+            spec.yearDays = hoursToDays(hours,spec.dayHours);
+        }
+    }
+
+    // ----- Month Length ----- //
+    if (moon >= 0) {
+        int moonOrbit = catalog.findChild(moon,"Orbit");
+        if (moonOrbit >= 0) {
+            const std::string* value = catalog.blocks[moonOrbit].getValue("Period");
+            double hours = 0.0;
+            if (value && !value->empty() && numToHours(*value,hours)) {
+                spec.monthDays = hoursToDays(hours,spec.dayHours);
+            }
+        }
+    }
+    return spec;
+}
+
+#endif // LIVE_SKYBOXES_SE_CATALOG_PARSER_H
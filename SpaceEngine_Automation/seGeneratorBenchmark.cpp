@@ -0,0 +1,354 @@
+//SpaceEngine Script Generator Benchmark
+//Benchmark
+//Chris D. | Version 1 | Version Date: 10/18/2026
+
+// ============================================================ //
+// |                    VERSION HISTORY                       | //
+// ============================================================ //
+//Version 0 (10/18/2026): Functional launch
+//Version 1 (10/18/2026): --leapRule benchmarks the leap-cycle
+//  calendar's date conversion.
+
+// ============================================================ //
+// |                  PROGRAM DESCRIPTION                     | //
+// ============================================================ //
+//Drives seScriptGenerator.h from 1k up to 100M frames for every
+//intervalUnit and reports frames/s, bytes/s, peak heap, and heap
+//allocation counts for the reference, streaming, and parallel
+//generators. Output is hashed as it is produced (nothing touches
+//the disk) and each mode's hash is checked against the reference
+//generator, or against streaming once the reference is skipped
+//for frame counts it cannot hold in memory.
+
+// ============================================================ //
+// |                  COMPILE BASH SCRIPT                     | //
+// ============================================================ //
+// g++ -std=c++17 -O2 seGeneratorBenchmark.cpp -o seGeneratorBenchmark
+// (parallel mode on worker threads) add: -fopenmp -DUSE_OMP
+
+// ============================================================ //
+// |                    INCLUDE / DEFINE                      | //
+// ============================================================ //
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include "seScriptGenerator.h"
+
+// ============================================================ //
+// |                   ALLOCATION TRACKING                    | //
+// ============================================================ //
+//Every global new/delete in this program goes through a 16-byte
+//size header so live and peak heap bytes can be tracked exactly.
+namespace allocStats {
+    std::atomic<uint64_t> count{0};
+    std::atomic<int64_t> liveBytes{0};
+    std::atomic<int64_t> peakBytes{0};
+
+    static void reset() {
+        count.store(0);
+        peakBytes.store(liveBytes.load());
+    }
+}
+
+static void* trackedAlloc(size_t size) {
+    void* raw = std::malloc(size + 16);
+    if (!raw) throw std::bad_alloc();
+    *static_cast<size_t*>(raw) = size;
+    allocStats::count.fetch_add(1,std::memory_order_relaxed);
+    int64_t live = allocStats::liveBytes.fetch_add((int64_t)size,std::memory_order_relaxed) + (int64_t)size;
+    int64_t peak = allocStats::peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !allocStats::peakBytes.compare_exchange_weak(peak,live,std::memory_order_relaxed)) {}
+    return static_cast<char*>(raw) + 16;
+}
+
+static void trackedFree(void* ptr) {
+    if (!ptr) return;
+    void* raw = static_cast<char*>(ptr) - 16;
+    allocStats::liveBytes.fetch_sub((int64_t)*static_cast<size_t*>(raw),std::memory_order_relaxed);
+    std::free(raw);
+}
+
+void* operator new(size_t size) { return trackedAlloc(size); }
+void* operator new[](size_t size) { return trackedAlloc(size); }
+void operator delete(void* ptr) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr,size_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr,size_t) noexcept { trackedFree(ptr); }
+
+static long peakRssKiB() {
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF,&usage) == 0) {
+    #ifdef __APPLE__
+        return usage.ru_maxrss / 1024;
+    #else
+        return usage.ru_maxrss;
+    #endif
+    }
+#endif
+    return -1;
+}
+
+// ============================================================ //
+// |                       HASHING SINK                       | //
+// ============================================================ //
+//64-bit word hash over the byte stream. Partial words are carried
+//between calls, so the digest does not depend on chunk boundaries.
+struct HashSink {
+    uint64_t hash = 0x9E3779B97F4A7C15ull;
+    uint64_t bytes = 0;
+    unsigned char carry[8];
+    int carried = 0;
+
+    void mix(uint64_t word) {
+        hash ^= word;
+        hash *= 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 32;
+    }
+
+    void write(const char* data,size_t size) {
+        bytes += size;
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+        while (carried > 0 && carried < 8 && size > 0) {
+            carry[carried++] = *p++;
+            --size;
+        }
+        if (carried == 8) {
+            uint64_t word;
+            std::memcpy(&word,carry,8);
+            mix(word);
+            carried = 0;
+        }
+        while (size >= 8) {
+            uint64_t word;
+            std::memcpy(&word,p,8);
+            mix(word);
+            p += 8;
+            size -= 8;
+        }
+        while (size > 0) {
+            carry[carried++] = *p++;
+            --size;
+        }
+    }
+
+    uint64_t digest() const {
+        uint64_t h = hash;
+        for (int i = 0; i < carried; i++) {
+            h ^= carry[i];
+            h *= 0x100000001B3ull;
+        }
+        return h ^ bytes;
+    }
+};
+
+// ============================================================ //
+// |                        BENCHMARK                         | //
+// ============================================================ //
+struct RunResult {
+    bool ran = false;
+    double seconds = 0.0;
+    uint64_t bytes = 0;
+    uint64_t digest = 0;
+    uint64_t allocations = 0;
+    int64_t peakHeap = 0;
+};
+
+static RunResult runOnce(const std::string& mode,const ScriptSpec& spec) {
+    RunResult result;
+    HashSink hashSink;
+    ScriptSink sink = [&](const char* data,size_t size) { hashSink.write(data,size); };
+
+    int64_t baseline = allocStats::liveBytes.load();
+    allocStats::reset();
+    auto t0 = std::chrono::steady_clock::now();
+    generateScript(mode,spec,sink);
+    auto t1 = std::chrono::steady_clock::now();
+
+    result.ran = true;
+    result.seconds = std::chrono::duration<double>(t1 - t0).count();
+    result.bytes = hashSink.bytes;
+    result.digest = hashSink.digest();
+    result.allocations = allocStats::count.load();
+    result.peakHeap = allocStats::peakBytes.load() - baseline;
+    return result;
+}
+
+static std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss,item,',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+// ------------------------ HANDLING ------------------------- //
+static void usage(const char* argv0) {
+    std::fprintf(stderr,
+    "Usage:\n"
+        "  %s [--minFrames N] (default 1000)\n"
+        "     [--maxFrames N] (default 100000000)\n"
+        "     [--units seconds,hours,days,months,years]\n"
+        "     [--modes reference,streaming,parallel]\n"
+        "     [--referenceMaxFrames N] (default 1000000; the reference holds the whole script in memory)\n"
+        "     [--repeat N] (best of N runs, default 1)\n"
+        "     [--leapRule <none|even|gregorian|P:+d,...>] (default none)\n"
+        "     [--csv <path>]\n",
+        argv0);
+}
+
+static std::string getArg(int& i,int argc,char** argv) {
+    if (i + 1 >= argc) {
+        throw std::runtime_error(std::string("Missing value after ") + argv[i]);
+    }
+    return std::string(argv[++i]);
+}
+
+// ============================================================ //
+// |                      MAIN PROGRAM                        | //
+// ============================================================ //
+int main(int argc,char** argv) {
+    try {
+        // ===================== INPUTS ===================== //
+        long long minFrames = 1000;
+        long long maxFrames = 100000000;
+        long long referenceMaxFrames = 1000000;
+        int repeat = 1;
+        std::vector<std::string> units = {"seconds","hours","days","months","years"};
+        std::vector<std::string> modes = {"reference","streaming","parallel"};
+        std::string csvPath;
+        std::string leapRule = "none";
+
+        for (int i = 1; i < argc; ++i) {
+            std::string key = argv[i];
+            if (key == "--minFrames") {
+                minFrames = std::stoll(getArg(i,argc,argv));
+            } else if (key == "--maxFrames") {
+                maxFrames = std::stoll(getArg(i,argc,argv));
+            } else if (key == "--units") {
+                units = splitList(getArg(i,argc,argv));
+            } else if (key == "--modes") {
+                modes = splitList(getArg(i,argc,argv));
+            } else if (key == "--referenceMaxFrames") {
+                referenceMaxFrames = std::stoll(getArg(i,argc,argv));
+            } else if (key == "--repeat") {
+                repeat = std::max(1,std::stoi(getArg(i,argc,argv)));
+            } else if (key == "--csv") {
+                csvPath = getArg(i,argc,argv);
+            } else if (key == "--leapRule") {
+                leapRule = getArg(i,argc,argv);
+            } else {
+                usage(argv[0]);
+                throw std::runtime_error("Unknown argument: " + key);
+            }
+        }
+        if (minFrames < 1 || maxFrames < minFrames || maxFrames > 2147483647LL) {
+            throw std::runtime_error("Frame range must satisfy 1 <= minFrames <= maxFrames <= 2147483647.");
+        }
+
+        FILE* csv = nullptr;
+        if (!csvPath.empty()) {
+            csv = std::fopen(csvPath.c_str(),"w");
+            if (!csv) throw std::runtime_error("Failed to open output: " + csvPath);
+            std::fprintf(csv,"unit,frames,mode,seconds,frames_per_s,bytes,bytes_per_s,allocations,peak_heap_bytes,digest,match\n");
+        }
+
+        int threads = 1;
+        #ifdef USE_OMP
+        threads = omp_get_max_threads();
+        #endif
+        std::printf("[LIVE SKYBOXES] Generator benchmark | threads: %d | repeat: %d\n",threads,repeat);
+        std::printf("%-8s %11s %-10s %9s %12s %10s %12s %10s %s\n",
+                    "unit","frames","mode","seconds","frames/s","MB/s","allocations","peak MB","hash");
+
+        // ---- Calendar: deliberately fractional so every field rolls over ---- //
+        ScriptSpec spec;
+        spec.scriptName = "LIVE SKYBOXES";
+        spec.capturePosition = "Sol/Earth";
+        spec.initialDate = "2000.01.01";
+        spec.startTime = "00:00:00.00";
+        spec.captureObject = "ISS";
+        spec.captureType = "CubeMap";
+        spec.exportFiletype = "png";
+        spec.calendar.dayHours = 25.3;
+        spec.calendar.monthDays = 29.53;
+        spec.calendar.yearDays = 365.2422;
+        spec.calendar.leapRule = leapRule;
+
+        bool allMatch = true;
+        for (const std::string& unit : units) {
+            parseIntervalUnit(unit);
+            spec.intervalUnit = unit;
+            spec.intervalStep = (unit == "seconds") ? 7.5 : 1.0;
+
+            for (long long frames = minFrames; frames <= maxFrames; frames *= 10) {
+                spec.frames = (int)frames;
+                bool haveExpected = false;
+                uint64_t expected = 0;
+
+                for (const std::string& mode : modes) {
+                    if (mode == "reference" && frames > referenceMaxFrames) {
+                        std::printf("%-8s %11lld %-10s %9s (skipped above --referenceMaxFrames)\n",
+                                    unit.c_str(),frames,mode.c_str(),"-");
+                        continue;
+                    }
+                    RunResult best;
+                    for (int r = 0; r < repeat; ++r) {
+                        RunResult run = runOnce(mode,spec);
+                        if (!best.ran || run.seconds < best.seconds) best = run;
+                    }
+                    //Reference first when it ran, otherwise the first mode that did.
+                    if (!haveExpected) {
+                        expected = best.digest;
+                        haveExpected = true;
+                    }
+                    bool match = best.digest == expected;
+                    allMatch = allMatch && match;
+
+                    double fps = frames / std::max(best.seconds,1e-12);
+                    double bps = best.bytes / std::max(best.seconds,1e-12);
+                    std::printf("%-8s %11lld %-10s %9.4f %12.0f %10.1f %12llu %10.2f %016llx %s\n",
+                                unit.c_str(),frames,mode.c_str(),best.seconds,fps,bps / 1e6,
+                                (unsigned long long)best.allocations,best.peakHeap / 1e6,
+                                (unsigned long long)best.digest,match ? "OK" : "MISMATCH");
+                    std::fflush(stdout);
+                    if (csv) {
+                        std::fprintf(csv,"%s,%lld,%s,%.6f,%.1f,%llu,%.1f,%llu,%lld,%016llx,%d\n",
+                                     unit.c_str(),frames,mode.c_str(),best.seconds,fps,
+                                     (unsigned long long)best.bytes,bps,(unsigned long long)best.allocations,
+                                     (long long)best.peakHeap,(unsigned long long)best.digest,match ? 1 : 0);
+                    }
+                }
+                if (frames > maxFrames / 10) break;
+            }
+        }
+        if (csv) std::fclose(csv);
+
+        std::printf("[LIVE SKYBOXES] Peak process RSS: %ld KiB\n",peakRssKiB());
+        if (!allMatch) {
+            std::fprintf(stderr,"ERROR: generator output hashes do not match the reference.\n");
+            return 1;
+        }
+        std::printf("[LIVE SKYBOXES] All generator outputs match.\n");
+        return 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr,"ERROR: %s\n",e.what());
+        return 1;
+    }
+} // END OF MAIN PROGRAM
@@ -1,6 +1,6 @@
 //SpaceEngine Screenshot Engine
 //Engine
-//Chris D. | Version 1 | Version Date: 11/9/2025
+//Chris D. | Version 5 | Version Date: 10/18/2026
 
 // ============================================================ //
 // |                    VERSION HISTORY                       | //
@@ -8,6 +8,17 @@
 //Version 0 (10/29/2025): Functional launch
 //Version 1 (11/9/2025): Reprogramming from Python to C++ for
 //  performance.
+//Version 2 (10/18/2026): Calendar and script templates moved to
+//  planetCalendar.h and seScriptGenerator.h. Scripts now stream
+//  to disk (--mode streaming|parallel|reference).
+//Version 3 (10/18/2026): Catalog batch mode (--catalog/--batchDir)
+//  writes a script and schedule for every Planet block of an
+//  object file.
+//Version 4 (10/18/2026): --progressFd writes JSON progress records;
+//  --cancelFile or SIGINT stops at the next chunk and removes the
+//  partial script, and any batch folder left empty (exit code 130).
+//Version 5 (10/18/2026): --leapRule gives fractional calendars
+//  whole-day years and months (planetCalendar.h).
 
 // ============================================================ //
 // |                  PROGRAM DESCRIPTION                     | //
@@ -19,6 +30,7 @@
 // |                  COMPILE BASH SCRIPT                     | //
 // ============================================================ //
 // g++ -std=c++17 -O2 seScreenshotEngine.cpp -o seScreenshotEngine
+// (optional parallel mode) add: -fopenmp -DUSE_OMP
 
 // ============================================================ //
 // |                    INCLUDE / DEFINE                      | //
@@ -27,6 +39,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <cctype>
 #include <string>
 #include <vector>
 #include <stdexcept>
@@ -35,130 +48,18 @@
 #include <iomanip>
 #include <cmath>
 #include <filesystem>
+#include <functional>
+#include <algorithm>
 
-namespace fs = std::filesystem;
-
-// ============================================================ //
-// |             FUNCTION AND STRUCT DEFINITIONS              | //
-// ============================================================ //
-// --------------------- TIME ADVANCEMENT --------------------- //
-struct CalendarSpec {
-    double dayHours {24.0}; //Length of 1 day in Earth hours
-    double monthDays {30.0}; //Length of 1 month in planet-days
-    double yearDays {365.0}; //Length of 1 year in planet-days
-    int year0 {2000}; //Base year (YYYY label origin)
-};
-
-struct DateParts {
-    int year{2000}, month{1}, day{1}, hour{0}, minute{0};
-    double second{0.0};
-};
-
-struct PlanetClock {
-    CalendarSpec spec;
-    
-    double daySec() const {
-        return spec.dayHours * 3600.0;
-    }
-    double monthSec() const {
-        return spec.monthDays * daySec();
-    }
-    double yearSec() const {
-        return spec.yearDays * daySec();
-    }
-
-    double toSeconds(const DateParts& part) const {
-        int yearOffset = part.year - spec.year0;
-        //Month index is (month - 1) | Day index is (day - 1)
-        double time = 0.0;
-        time += yearOffset * yearSec();
-        time += (part.month - 1) * monthSec();
-        time += (part.day - 1) * daySec();
-        time += part.hour * 3600.0;
-        time += part.minute * 60.0;
-        time += part.second;
-        return time;
-    }
-
-    DateParts fromSeconds(double seconds) const {
-        DateParts part;
-        // ----- Years ----- //
-        double years = std::floor(seconds / yearSec());
-        seconds -= years * yearSec();
-        part.year = spec.year0 + static_cast<int>(years);
-
-        // ----- Months ----- //
-        double months = std::floor(seconds / monthSec());
-        seconds -= months * monthSec();
-        part.month = static_cast<int>(months) + 1;
-
-        // ------ Days ----- //
-        double days = std::floor(seconds / daySec());
-        seconds -= days * daySec();
-        part.day = static_cast<int>(days) + 1;
-
-        // ----- Time of Day ----- //
-        part.hour = static_cast<int>(std::floor(seconds / 3600.0));
-        seconds -= part.hour * 3600.0;
-        part.minute = static_cast<int>(std::floor(seconds / 60.0));
-        seconds -= part.minute * 60.0;
-        part.second = seconds;
-
-        return part;
-    }
-    // ============= FORMATTING FOR SPACEENGINE ============== //
-    static std::string formatDate(const DateParts& part) {
-        char buffer[32];
-        std::snprintf(buffer,sizeof(buffer),"%04d.%02d.%02d",part.year,part.month,part.day);
-        return std::string(buffer);
-    }
-
-    static std::string formatTime(const DateParts& part) {
-        char buffer[32];
-        std::snprintf(buffer,sizeof(buffer),"%02d:%02d:%05.2f",part.hour,part.minute,part.second);
-        return std::string(buffer);
-    }
-
-    // -- Parsing "YYYY.MM.DD" and "HH:MM:SS.ss" into parts -- //
-    static DateParts parseParts(const std::string& ymd,const std::string& hms,int year0default) {
-        DateParts part;
-        int year = year0default, month = 1, day = 1, hour = 0, minute = 0;
-        double second = 0.0;
-        std::sscanf(ymd.c_str(),"%d.%d.%d",&year,&month,&day);
-        std::sscanf(hms.c_str(),"%d:%d:%lf",&hour,&minute,&second);
-        part.year = year;
-        part.month = month;
-        part.day = day;
-        part.hour = hour;
-        part.minute = minute;
-        part.second = second;
-        return part;
-    }
-    // --------------- Time Stepping Utilities --------------- //
-    double addSeconds(double time,double seconds) const {
-        return time + seconds;
-    }
-    
-    double addHours(double time,double hours) const {
-        return time + hours * 3600.0;
-    }
-
-    double addDays(double time,double days) const {
-        return time + days * daySec();
-    }
+#include "seScriptGenerator.h"
+#include "seCatalogParser.h"
+#include "../engineProgress.h"
 
-    double addMonths(double time,double months) const {
-        return time + months * monthSec();
-    }
+#ifdef USE_OMP
+#include <omp.h>
+#endif
 
-    double addYears(double time,double years) const {
-        return time + years * yearSec();
-    }
-    // ------------------ Time Comparisons ------------------- //
-    static bool greaterThanOrEqualTo(double time1,double time2) {
-        return (time1 + 1e-9) >= time2;
-    }
-};
+namespace fs = std::filesystem;
 
 // ------------------------ HANDLING ------------------------- //
 static void usage(const char* argv0) {
@@ -178,12 +79,25 @@ static void usage(const char* argv0) {
         "     --monthDays <double>\n"
         "     --yearDays <double>\n"
         "     [--year0 <int>]\n"
+        "     [--leapRule <none|even|gregorian|P:+d,...>] (default none: continuous fractional years)\n"
         "     --intervalUnit <seconds|hours|days|months|years>\n"
         "     --intervalStep <double>\n"
         "     [--endDate YYYY.MM.DD] [--endTime HH:MM:SS.ss]\n"
         "     [--orbitPeriodHours <double>]\n"
-        "     [--debugDir <folder>] (writes a .txt copy for debugging)\n",
-        argv0);
+        "     [--debugDir <folder>] (writes a .txt copy for debugging)\n"
+        "     [--mode <streaming|parallel|reference>] (default streaming)\n"
+        "     [--progressFd N] (JSON progress lines) [--cancelFile <path>] (stop once it exists)\n"
+        "\n"
+        "  Catalog batch mode (one script and schedule per Planet block):\n"
+        "  %s --catalog <object file .se/.sc> --batchDir <folder>\n"
+        "     [--out <script filename>] (default adaptiveSkybox.se)\n"
+        "     [--capturePosition <prefix>] (default: ParentBody/Name per planet)\n"
+        "     --initialDate, --captureObject, --captureType, --exportFiletype,\n"
+        "     --intervalUnit, --intervalStep, --year0 and --leapRule as above.\n"
+        "     Frames come from --frames, --endDate or --orbitPeriodHours when given,\n"
+        "     otherwise one orbit of each planet.\n"
+        "     --progressFd and --cancelFile as above (progress counts bodies).\n",
+        argv0,argv0);
 }
 
 static std::string getArg(int& i,int argc,char** argv) {
@@ -193,6 +107,162 @@ static std::string getArg(int& i,int argc,char** argv) {
     return std::string(argv[++i]);
 }
 
+// ============================================================ //
+// |                 CATALOG BATCH GENERATION                 | //
+// ============================================================ //
+struct BatchOptions {
+    std::string catalogPath;
+    std::string batchDir;
+    std::string scriptFile = "adaptiveSkybox.se";
+    std::string endDate;
+    std::string endTime = "00:00:00.00";
+    double orbitPeriodHours = 0.0;
+    std::string mode = "streaming";
+};
+
+struct BatchBody {
+    int planet = -1, moon = -1;
+    std::string name, parent, moonName, folder;
+    ScriptSpec spec;
+    size_t scriptBytes = 0;
+    std::string status = "ok";
+};
+
+static std::string folderName(const std::string& name) {
+    std::string folder;
+    for (char c : name) {
+        bool keep = std::isalnum((unsigned char)c) || c == '-' || c == '_' || c == '.';
+        folder += keep ? c : '_';
+    }
+    return folder.empty() ? std::string("unnamed") : folder;
+}
+
+static void writeFile(const fs::path& path,const std::function<void(const ScriptSink&)>& generate,size_t* bytes) {
+    std::ofstream file(path,std::ios::binary);
+    if (!file) throw std::runtime_error("Failed to open output: " + path.string());
+    size_t written = 0;
+    generate([&](const char* data,size_t size) {
+        file.write(data,(std::streamsize)size);
+        written += size;
+    });
+    file.close();
+    if (!file) throw std::runtime_error("Failed to write output: " + path.string());
+    if (bytes) *bytes = written;
+}
+
+//Generates one script and schedule per Planet block in parallel and
+//writes <batchDir>/index.tsv summarizing every body.
+static int runCatalogBatch(const ScriptSpec& base,const BatchOptions& options) {
+    Catalog catalog = loadCatalog(options.catalogPath);
+    std::vector<int> planets = catalog.blocksOfType("Planet");
+    if (planets.empty()) {
+        throw std::runtime_error("No Planet blocks found in " + options.catalogPath);
+    }
+
+    // ----- Per-Body Specs (serial: cheap, and folder names must be unique) ----- //
+    std::vector<BatchBody> bodies(planets.size());
+    std::vector<std::string> usedFolders;
+    for (size_t i = 0; i < planets.size(); ++i) {
+        BatchBody& body = bodies[i];
+        const CatalogBlock& block = catalog.blocks[planets[i]];
+        body.planet = planets[i];
+        body.name = block.name.empty() ? ("Planet" + std::to_string(i + 1)) : block.name;
+        const std::string* parent = block.getValue("ParentBody");
+        body.parent = parent ? *parent : "";
+        body.moon = findPlanetMoon(catalog,body.planet);
+        body.moonName = body.moon >= 0 ? catalog.blocks[body.moon].name : "";
+
+        std::string folder = folderName(body.name);
+        std::string unique = folder;
+        for (int n = 2; std::find(usedFolders.begin(),usedFolders.end(),unique) != usedFolders.end(); ++n) {
+            unique = folder + "_" + std::to_string(n);
+        }
+        usedFolders.push_back(unique);
+        body.folder = unique;
+
+        body.spec = base;
+        body.spec.calendar = buildCalendarSpec(catalog,body.planet,body.moon);
+        body.spec.calendar.year0 = base.calendar.year0;
+        body.spec.calendar.leapRule = base.calendar.leapRule;
+        if (base.capturePosition.empty()) {
+            body.spec.capturePosition = body.parent.empty() ? body.name : body.parent + "/" + body.name;
+        } else {
+            body.spec.capturePosition = base.capturePosition + "/" + body.name;
+        }
+    }
+
+    const bool createdBatchDir = fs::create_directories(options.batchDir);
+
+    // ----- Generation ----- //
+    //A cancelled body removes its own files, and its folder when this
+    //run created it; bodies already finished stay, and no index is
+    //written.
+    progress::Reporter& reporter = progress::engine();
+    reporter.stage("bodies",(int64_t)bodies.size());
+    #ifdef USE_OMP
+    #pragma omp parallel for schedule(dynamic,1)
+    #endif
+    for (int i = 0; i < (int)bodies.size(); ++i) {
+        BatchBody& body = bodies[i];
+        fs::path folder = fs::path(options.batchDir) / body.folder;
+        bool createdFolder = false;
+        try {
+            reporter.checkpoint();
+            if (body.spec.frames <= 0) {
+                double orbitHours = options.orbitPeriodHours;
+                if (orbitHours <= 0.0 && options.endDate.empty()) {
+                    orbitHours = body.spec.calendar.yearDays * body.spec.calendar.dayHours;
+                }
+                body.spec.frames = deriveFrameCount(body.spec,options.endDate,options.endTime,orbitHours);
+            }
+            createdFolder = fs::create_directories(folder);
+            writeFile(folder / options.scriptFile,[&](const ScriptSink& sink) {
+                generateScript(options.mode,body.spec,sink,[&](int) { reporter.checkpoint(); });
+            },&body.scriptBytes);
+            reporter.checkpoint();
+            writeFile(folder / "schedule.tsv",[&](const ScriptSink& sink) {
+                generateSchedule(body.spec,sink);
+            },nullptr);
+            reporter.advance();
+        } catch (const progress::Cancelled&) {
+            std::error_code ec;
+            fs::remove(folder / options.scriptFile,ec);
+            fs::remove(folder / "schedule.tsv",ec);
+            if (createdFolder && fs::is_empty(folder,ec)) fs::remove(folder,ec);
+            body.status = "cancelled";
+        } catch (const std::exception& e) {
+            body.status = std::string("error: ") + e.what();
+        }
+    }
+
+    if (reporter.cancelled() && createdBatchDir) {
+        std::error_code ec;
+        if (fs::is_empty(options.batchDir,ec)) fs::remove(options.batchDir,ec);
+    }
+    reporter.checkpoint();
+
+    // ----- Summary Index ----- //
+    fs::path indexPath = fs::path(options.batchDir) / "index.tsv";
+    std::ofstream index(indexPath,std::ios::binary);
+    if (!index) throw std::runtime_error("Failed to open output: " + indexPath.string());
+    index << "body\tparent\tmoon\tdayHours\tmonthDays\tyearDays\tframes\tscript\tschedule\tbytes\tstatus\n";
+    int failures = 0;
+    for (const BatchBody& body : bodies) {
+        if (body.status != "ok") ++failures;
+        index << body.name << "\t" << body.parent << "\t" << body.moonName << "\t"
+              << body.spec.calendar.dayHours << "\t" << body.spec.calendar.monthDays << "\t"
+              << body.spec.calendar.yearDays << "\t" << body.spec.frames << "\t"
+              << body.folder << "/" << options.scriptFile << "\t" << body.folder << "/schedule.tsv\t"
+              << body.scriptBytes << "\t" << body.status << "\n";
+    }
+    index.close();
+
+    std::printf("[LIVE SKYBOXES] Generated %d of %d bodies from %s\n",
+                (int)bodies.size() - failures,(int)bodies.size(),options.catalogPath.c_str());
+    std::printf("[LIVE SKYBOXES] Saved %s\n",indexPath.string().c_str());
+    return failures == 0 ? 0 : 1;
+}
+
 // ============================================================ //
 // |                      MAIN PROGRAM                        | //
 // ============================================================ //
@@ -205,25 +275,14 @@ int main(int argc,char** argv) {
 
         // ===================== INPUTS ===================== //
         std::string outPath;
-        std::string scriptName = "LIVE SKYBOXES";
-        std::string capturePosition;
-        std::string initialDate; //Format YYYY.MM.DD
-        std::string startTime = "00:00:00.00";
-        std::string captureObject;
-        std::string captureType;
-        std::string exportFiletype;
-        int frames = 0;
+        ScriptSpec spec;
         std::string debugDir;
+        std::string mode = "streaming";
+        std::string catalogPath;
+        std::string batchDir;
+        int progressFd = -1;
+        std::string cancelFile;
 
-        //NOTE: Below are all default parameters
-        std::string preDisplay = "Planetarium"; //TODO: Determine if this is a proper display to default to
-        std::string preDate = "2000.01.01";
-        std::string preTime = "00:00:00.00";
-
-        // ----- Calculatable Parameters ----- //
-        CalendarSpec planetCalendar;
-        std::string intervalUnit = "days";
-        double intervalStep = 1.0;
         // --- Optional Hardstops --- //
         std::string endDate;
         std::string endTime = "00:00:00.00";
@@ -234,39 +293,41 @@ int main(int argc,char** argv) {
             if (key == "--out") {
                 outPath = getArg(i,argc,argv);
             } else if (key == "--scriptName") {
-                scriptName = getArg(i,argc,argv);
+                spec.scriptName = getArg(i,argc,argv);
             } else if (key == "--capturePosition") {
-                capturePosition = getArg(i,argc,argv);
+                spec.capturePosition = getArg(i,argc,argv);
             } else if (key == "--initialDate") {
-                initialDate = getArg(i,argc,argv);
+                spec.initialDate = getArg(i,argc,argv);
             } else if (key == "--startTime") {
-                startTime = getArg(i,argc,argv);
+                spec.startTime = getArg(i,argc,argv);
             } else if (key == "--captureObject") {
-                captureObject = getArg(i,argc,argv);
+                spec.captureObject = getArg(i,argc,argv);
             } else if (key == "--captureType") {
-                captureType = getArg(i,argc,argv);
+                spec.captureType = getArg(i,argc,argv);
             } else if (key == "--exportFiletype") {
-                exportFiletype = getArg(i,argc,argv);
+                spec.exportFiletype = getArg(i,argc,argv);
             } else if (key == "--frames") {
-                frames = std::stoi(getArg(i,argc,argv));
+                spec.frames = std::stoi(getArg(i,argc,argv));
             } else if (key == "--preDisplay") {
-                preDisplay = getArg(i,argc,argv);
+                spec.preDisplay = getArg(i,argc,argv);
             } else if (key == "--preDate") {
-                preDate = getArg(i,argc,argv);
+                spec.preDate = getArg(i,argc,argv);
             } else if (key == "--preTime") {
-                preTime = getArg(i,argc,argv);
+                spec.preTime = getArg(i,argc,argv);
             } else if (key == "--dayHours") {
-                planetCalendar.dayHours = std::stod(getArg(i,argc,argv));
+                spec.calendar.dayHours = std::stod(getArg(i,argc,argv));
             } else if (key == "--monthDays") {
-                planetCalendar.monthDays = std::stod(getArg(i,argc,argv));
+                spec.calendar.monthDays = std::stod(getArg(i,argc,argv));
             } else if (key == "--yearDays") {
-                planetCalendar.yearDays = std::stod(getArg(i,argc,argv));
+                spec.calendar.yearDays = std::stod(getArg(i,argc,argv));
             } else if (key == "--year0") {
-                planetCalendar.year0 = std::stoi(getArg(i,argc,argv));
+                spec.calendar.year0 = std::stoi(getArg(i,argc,argv));
+            } else if (key == "--leapRule") {
+                spec.calendar.leapRule = getArg(i,argc,argv);
             } else if (key == "--intervalUnit") {
-                intervalUnit = getArg(i,argc,argv);
+                spec.intervalUnit = getArg(i,argc,argv);
             } else if (key == "--intervalStep") {
-                intervalStep = std::stod(getArg(i,argc,argv));
+                spec.intervalStep = std::stod(getArg(i,argc,argv));
             } else if (key == "--endDate") {
                 endDate = getArg(i,argc,argv);
             } else if (key == "--endTime") {
@@ -275,158 +336,79 @@ int main(int argc,char** argv) {
                 orbitPeriodHours = std::stod(getArg(i,argc,argv));
             } else if (key == "--debugDir") {
                 debugDir = getArg(i,argc,argv);
+            } else if (key == "--mode") {
+                mode = getArg(i,argc,argv);
+            } else if (key == "--catalog") {
+                catalogPath = getArg(i,argc,argv);
+            } else if (key == "--batchDir") {
+                batchDir = getArg(i,argc,argv);
+            } else if (key == "--progressFd") {
+                progressFd = std::stoi(getArg(i,argc,argv));
+            } else if (key == "--cancelFile") {
+                cancelFile = getArg(i,argc,argv);
             } else {
                 usage(argv[0]);
                 throw std::runtime_error("Unknown argument: "  + key);
             }
         }
 
-        PlanetClock planetClock{planetCalendar};
+        progress::Reporter& reporter = progress::engine();
+        reporter.open(progressFd,cancelFile);
 
-        if (frames <= 0) {
-            if (orbitPeriodHours > 0.0) {
-                // Compute frames from orbit period
-                double stepHours = 0.0;
-                if      (intervalUnit == "seconds") stepHours = intervalStep / 3600.0;
-                else if (intervalUnit == "hours")   stepHours = intervalStep;
-                else if (intervalUnit == "days")    stepHours = intervalStep * planetCalendar.dayHours;
-                else if (intervalUnit == "months")  stepHours = intervalStep * planetCalendar.monthDays * planetCalendar.dayHours;
-                else if (intervalUnit == "years")   stepHours = intervalStep * planetCalendar.yearDays  * planetCalendar.dayHours;
-                else throw std::runtime_error("Unknown intervalUnit: " + intervalUnit);
-
-                if (stepHours <= 0.0)
-                    throw std::runtime_error("intervalStep must be > 0");
-
-                frames = (int)std::ceil(orbitPeriodHours / stepHours);
-                if (frames < 1) frames = 1;
+        if (!catalogPath.empty() || !batchDir.empty()) {
+            if (catalogPath.empty() || batchDir.empty() || spec.initialDate.empty() || spec.captureObject.empty()
+                || spec.captureType.empty() || spec.exportFiletype.empty()) {
+                usage(argv[0]);
+                throw std::runtime_error("Catalog mode needs --catalog, --batchDir, --initialDate, --captureObject, --captureType and --exportFiletype.");
             }
-            else if (!endDate.empty()) {
-                // Compute frames by stepping until we reach/past end date/time
-                DateParts startParts = PlanetClock::parseParts(initialDate, startTime, planetCalendar.year0);
-                DateParts endParts   = PlanetClock::parseParts(endDate,   endTime,   planetCalendar.year0);
-
-                double time    = planetClock.toSeconds(startParts);
-                double timeEnd = planetClock.toSeconds(endParts);
-
-                int count = 0;
-
-                if (intervalStep <= 0.0) {
-                    throw std::runtime_error("intervalStep must be > 0 when deriving frames from endDate or endTime");
-                }
-
-                while (true) {
-                ++count;
-                if      (intervalUnit == "seconds") time = planetClock.addSeconds(time, intervalStep);
-                else if (intervalUnit == "hours")   time = planetClock.addHours  (time, intervalStep);
-                else if (intervalUnit == "days")    time = planetClock.addDays   (time, intervalStep);
-                else if (intervalUnit == "months")  time = planetClock.addMonths (time, intervalStep);
-                else if (intervalUnit == "years")   time = planetClock.addYears  (time, intervalStep);
-                else throw std::runtime_error("Unknown intervalUnit: " + intervalUnit);
-
-            if (PlanetClock::greaterThanOrEqualTo(time, timeEnd))
-                break;
+            BatchOptions options;
+            options.catalogPath = catalogPath;
+            options.batchDir = batchDir;
+            if (!outPath.empty()) options.scriptFile = fs::path(outPath).filename().string();
+            if (options.scriptFile.size() < 3 || options.scriptFile.substr(options.scriptFile.size() - 3) != ".se") {
+                options.scriptFile += ".se";
             }
-            frames = count;
+            options.endDate = endDate;
+            options.endTime = endTime;
+            options.orbitPeriodHours = orbitPeriodHours;
+            options.mode = mode;
+            const int status = runCatalogBatch(spec,options);
+            reporter.event("done");
+            return status;
         }
-        else {
-            throw std::runtime_error("Either --frames or --orbitPeriodHours or --endDate/--endTime is required.");
+
+        if (spec.frames <= 0) {
+            spec.frames = deriveFrameCount(spec,endDate,endTime,orbitPeriodHours);
         }
-    }
         if (outPath.size() < 3 || outPath.substr(outPath.size() - 3) != ".se") {
             outPath += ".se";
         }
 
-        if (outPath.empty() || capturePosition.empty() || initialDate.empty()
-            || captureObject.empty() || captureType.empty() || exportFiletype.empty()
-            || frames <= 0) {
+        if (outPath.empty() || spec.capturePosition.empty() || spec.initialDate.empty()
+            || spec.captureObject.empty() || spec.captureType.empty() || spec.exportFiletype.empty()
+            || spec.frames <= 0) {
                 usage(argv[0]);
                 throw std::runtime_error("Missing required arguments.");
             }
-        // ================ SE FILE TEMPLATES ================ //
-        //PREPARATION from screenshotSetup
-        auto screenshotSetup = [&](const std::string& initialDateStr) {
-            std::ostringstream ss;
-            ss
-            << "Print \"[" << scriptName << "] Preparing screenshot configuration.\"\n"
-            << "Select " << capturePosition << "\n"
-            << "Goto {Time 2.0 Dist 0.001}\n"
-            << "Center\n"
-            << "StopTime\n"
-            << "Date \"" << initialDateStr << " 00:00:00.00\"\n"
-            << "Hide " << captureObject << "\n"
-            << "DisplayMode \"" << captureType << "\"\n"
-            << "HidePrint\n"
-            << "WaitMessage \"[" << scriptName << "] Screenshot preparation complete. Press [NEXT] when you are ready to begin the export.\"\n";
-            return ss.str();
-        };
-
-        // ==================== EXECUTION ==================== //
-        auto frameBlock = [&](int frameNum,int frameTotal,
-                        const std::string& curDate,const std::string& curTime,
-                        const std::string& nextDate,const std::string& nextTime) {
-                            std::ostringstream ss;
-                            ss
-                            << "Print \"[" << scriptName << "] Creating frame " << frameNum << " of " << frameTotal << ".\"\n"
-                            << "Date \"" << curDate << " " << curTime << "\"\n"
-                            << "Screenshot {Format \"" << exportFiletype << "\" Name \"frame_\"}\n"
-                            << "Date \"" << nextDate << " " << nextTime << "\"\n"
-                            << "HidePrint\n";
-                            return ss.str();
-                        };
-        auto restore = [&]() {
-            std::ostringstream ss;
-            ss
-            << "Print \"[" << scriptName << "] Restoring pre-export SpaceEngine.\"\n"
-            << "DisplayMode \"" << preDisplay << "\"\n"
-            << "Show " << captureObject << "\n"
-            << "Date \"" << preDate << " " << preTime << "\"\n";
-            return ss.str();
-        };
-        // ---------------- BUILD FULL SCRIPT ---------------- //
-        std::ostringstream out;
-        out << screenshotSetup(initialDate);
-
-        DateParts startParts = PlanetClock::parseParts(initialDate,startTime,planetCalendar.year0);
-        double currentTime = planetClock.toSeconds(startParts);
-
-        for (int frame = 1;frame <= frames; ++frame) {
-            double nextTime = currentTime;
-            if (intervalUnit == "seconds") { //TODO: Refine into a case-switch
-                nextTime = planetClock.addSeconds(nextTime,intervalStep);
-            } else if (intervalUnit == "hours") {
-                nextTime = planetClock.addHours(nextTime,intervalStep);
-            } else if (intervalUnit == "days") {
-                nextTime = planetClock.addDays(nextTime,intervalStep);
-            } else if (intervalUnit == "months") {
-                nextTime = planetClock.addMonths(nextTime,intervalStep);
-            } else if (intervalUnit == "years") {
-                nextTime = planetClock.addYears(nextTime,intervalStep);
-            } else {
-                throw std::runtime_error("Unknown intervalUnit: " + intervalUnit);
-            }
-
-            DateParts currentPart = planetClock.fromSeconds(currentTime);
-            DateParts nextPart = planetClock.fromSeconds(nextTime);
-
-            out << frameBlock(
-                frame,frames,
-                PlanetClock::formatDate(currentPart),
-                PlanetClock::formatTime(currentPart),
-                PlanetClock::formatDate(nextPart),
-                PlanetClock::formatTime(nextPart)
-            );
-
-            currentTime = nextTime;
-        }
-        out << restore();
 
         // ------------------ WRITE TO FILE ------------------ //
+        reporter.stage("script",spec.frames);
         std::ofstream file(outPath,std::ios::binary);
         if (!file) {
             throw std::runtime_error("Failed to open output: " + outPath);
         }
-        file << out.str();
+        reporter.track(outPath);
+        generateScript(mode,spec,[&](const char* data,size_t size) {
+            file.write(data,(std::streamsize)size);
+        },[&](int done) {
+            reporter.set(done);
+            reporter.checkpoint();
+        });
         file.close();
+        if (!file) {
+            throw std::runtime_error("Failed to write output: " + outPath);
+        }
+        reporter.keep();
 
         if (!debugDir.empty()) {
             fs::create_directories(debugDir);
@@ -436,9 +418,17 @@ int main(int argc,char** argv) {
         }
 
         std::printf("[LIVE SKYBOXES] Saved %s\n",outPath.c_str());
+        reporter.event("done");
         return 0;
+    } catch (const progress::Cancelled&) {
+        progress::engine().discard();
+        progress::engine().event("cancelled");
+        std::fprintf(stderr,"[LIVE SKYBOXES] Cancelled\n");
+        return progress::kExitCancelled;
     } catch (const std::exception& e) {
+        progress::engine().discard();
+        progress::engine().event("error",e.what());
         std::fprintf(stderr,"ERROR: %s\n",e.what());
         return 1;
     }
-} // END OF MAIN PROGRAM
\ No newline at end of file
+} // END OF MAIN PROGRAM
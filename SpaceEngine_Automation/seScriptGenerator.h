@@ -0,0 +1,450 @@
+//SpaceEngine Script Generator
+//Shared Header
+//Chris D. | Version 3 | Version Date: 10/18/2026
+
+// ============================================================ //
+// |                    VERSION HISTORY                       | //
+// ============================================================ //
+//Version 0 (10/18/2026): Script templates moved out of
+//  seScreenshotEngine.cpp's main() and split into reference,
+//  streaming, and parallel generators for benchmarking.
+//Version 1 (10/18/2026): generateSchedule() writes the frame
+//  schedule (frame, date, time, seconds) for catalog batches.
+//Version 2 (10/18/2026): Optional ScriptProgress callback (frames
+//  done) after each chunk, block or script.
+//Version 3 (10/18/2026): Month and year steps of leap calendars use
+//  the cycle's mean lengths.
+
+// ============================================================ //
+// |                  PROGRAM DESCRIPTION                     | //
+// ============================================================ //
+//Builds the SpaceEngine .se screenshot script for a planet
+//calendar. All three generators emit byte-identical output:
+//  reference - the original ostringstream build of the whole
+//              script, kept as the correctness baseline.
+//  streaming - formats each frame straight into a fixed chunk
+//              buffer and hands full chunks to the sink.
+//  parallel  - formats blocks of frames on worker threads
+//              (USE_OMP) and hands them to the sink in order.
+
+#ifndef LIVE_SKYBOXES_SE_SCRIPT_GENERATOR_H
+#define LIVE_SKYBOXES_SE_SCRIPT_GENERATOR_H
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <stdexcept>
+#include <functional>
+#include <algorithm>
+
+#include "planetCalendar.h"
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+// ============================================================ //
+// |             FUNCTION AND STRUCT DEFINITIONS              | //
+// ============================================================ //
+struct ScriptSpec {
+    std::string scriptName = "LIVE SKYBOXES";
+    std::string capturePosition;
+    std::string initialDate; //Format YYYY.MM.DD
+    std::string startTime = "00:00:00.00";
+    std::string captureObject;
+    std::string captureType;
+    std::string exportFiletype;
+    int frames = 0;
+
+    std::string preDisplay = "Planetarium";
+    std::string preDate = "2000.01.01";
+    std::string preTime = "00:00:00.00";
+
+    CalendarSpec calendar;
+    std::string intervalUnit = "days";
+    double intervalStep = 1.0;
+};
+
+//Receives the script in order, one contiguous piece at a time.
+using ScriptSink = std::function<void(const char*,size_t)>;
+
+//Frames written so far; called between sink pieces, never from a
+//worker thread, so it may throw to abandon the script.
+using ScriptProgress = std::function<void(int)>;
+
+// ------------------- FRAME COUNT DERIVATION ------------------ //
+//Frame count from an orbit period or an end date/time, exactly as
+//the engine has always derived it when --frames is not given.
+static inline int deriveFrameCount(const ScriptSpec& spec,const std::string& endDate,
+                                   const std::string& endTime,double orbitPeriodHours) {
+    const CalendarSpec& calendar = spec.calendar;
+    PlanetClock planetClock{calendar};
+    int frames = 0;
+    if (orbitPeriodHours > 0.0) {
+        double stepHours = 0.0;
+        if      (spec.intervalUnit == "seconds") stepHours = spec.intervalStep / 3600.0;
+        else if (spec.intervalUnit == "hours")   stepHours = spec.intervalStep;
+        else if (spec.intervalUnit == "days")    stepHours = spec.intervalStep * calendar.dayHours;
+        else if (spec.intervalUnit == "months")  stepHours = spec.intervalStep * calendar.monthDays * calendar.dayHours;
+        else if (spec.intervalUnit == "years")   stepHours = spec.intervalStep * calendar.yearDays  * calendar.dayHours;
+        else throw std::runtime_error("Unknown intervalUnit: " + spec.intervalUnit);
+        //Leap calendars step by their cycle's mean month and year.
+        if (planetClock.cycle.years > 0 && spec.intervalUnit == "months") stepHours = spec.intervalStep * planetClock.monthSec() / 3600.0;
+        if (planetClock.cycle.years > 0 && spec.intervalUnit == "years")  stepHours = spec.intervalStep * planetClock.yearSec() / 3600.0;
+
+        if (stepHours <= 0.0)
+            throw std::runtime_error("intervalStep must be > 0");
+
+        frames = (int)std::ceil(orbitPeriodHours / stepHours);
+        if (frames < 1) frames = 1;
+    } else if (!endDate.empty()) {
+        DateParts startParts = PlanetClock::parseParts(spec.initialDate,spec.startTime,calendar.year0);
+        DateParts endParts   = PlanetClock::parseParts(endDate,endTime,calendar.year0);
+
+        double time    = planetClock.toSeconds(startParts);
+        double timeEnd = planetClock.toSeconds(endParts);
+
+        if (spec.intervalStep <= 0.0) {
+            throw std::runtime_error("intervalStep must be > 0 when deriving frames from endDate or endTime");
+        }
+        double step = intervalStepSeconds(planetClock,parseIntervalUnit(spec.intervalUnit),spec.intervalStep);
+
+        int count = 0;
+        while (true) {
+            ++count;
+            time += step;
+            if (PlanetClock::greaterThanOrEqualTo(time,timeEnd))
+                break;
+        }
+        frames = count;
+    } else {
+        throw std::runtime_error("Either --frames or --orbitPeriodHours or --endDate/--endTime is required.");
+    }
+    return frames;
+}
+
+// ------------------------ TEMPLATES ------------------------ //
+static inline std::string screenshotSetupBlock(const ScriptSpec& spec) {
+    std::ostringstream ss;
+    ss
+    << "Print \"[" << spec.scriptName << "] Preparing screenshot configuration.\"\n"
+    << "Select " << spec.capturePosition << "\n"
+    << "Goto {Time 2.0 Dist 0.001}\n"
+    << "Center\n"
+    << "StopTime\n"
+    << "Date \"" << spec.initialDate << " 00:00:00.00\"\n"
+    << "Hide " << spec.captureObject << "\n"
+    << "DisplayMode \"" << spec.captureType << "\"\n"
+    << "HidePrint\n"
+    << "WaitMessage \"[" << spec.scriptName << "] Screenshot preparation complete. Press [NEXT] when you are ready to begin the export.\"\n";
+    return ss.str();
+}
+
+static inline std::string restoreBlock(const ScriptSpec& spec) {
+    std::ostringstream ss;
+    ss
+    << "Print \"[" << spec.scriptName << "] Restoring pre-export SpaceEngine.\"\n"
+    << "DisplayMode \"" << spec.preDisplay << "\"\n"
+    << "Show " << spec.captureObject << "\n"
+    << "Date \"" << spec.preDate << " " << spec.preTime << "\"\n";
+    return ss.str();
+}
+
+// ============================================================ //
+// |                   REFERENCE GENERATOR                    | //
+// ============================================================ //
+//The engine's original build loop, unchanged: string-compared
+//interval units and one ostringstream per frame, with the whole
+//script held in memory before it reaches the sink.
+static inline void generateReference(const ScriptSpec& spec,const ScriptSink& sink,const ScriptProgress& progress = nullptr) {
+    PlanetClock planetClock{spec.calendar};
+
+    auto frameBlock = [&](int frameNum,int frameTotal,
+                    const std::string& curDate,const std::string& curTime,
+                    const std::string& nextDate,const std::string& nextTime) {
+                        std::ostringstream ss;
+                        ss
+                        << "Print \"[" << spec.scriptName << "] Creating frame " << frameNum << " of " << frameTotal << ".\"\n"
+                        << "Date \"" << curDate << " " << curTime << "\"\n"
+                        << "Screenshot {Format \"" << spec.exportFiletype << "\" Name \"frame_\"}\n"
+                        << "Date \"" << nextDate << " " << nextTime << "\"\n"
+                        << "HidePrint\n";
+                        return ss.str();
+                    };
+
+    std::ostringstream out;
+    out << screenshotSetupBlock(spec);
+
+    DateParts startParts = PlanetClock::parseParts(spec.initialDate,spec.startTime,spec.calendar.year0);
+    double currentTime = planetClock.toSeconds(startParts);
+
+    for (int frame = 1;frame <= spec.frames; ++frame) {
+        double nextTime = currentTime;
+        if (spec.intervalUnit == "seconds") {
+            nextTime = planetClock.addSeconds(nextTime,spec.intervalStep);
+        } else if (spec.intervalUnit == "hours") {
+            nextTime = planetClock.addHours(nextTime,spec.intervalStep);
+        } else if (spec.intervalUnit == "days") {
+            nextTime = planetClock.addDays(nextTime,spec.intervalStep);
+        } else if (spec.intervalUnit == "months") {
+            nextTime = planetClock.addMonths(nextTime,spec.intervalStep);
+        } else if (spec.intervalUnit == "years") {
+            nextTime = planetClock.addYears(nextTime,spec.intervalStep);
+        } else {
+            throw std::runtime_error("Unknown intervalUnit: " + spec.intervalUnit);
+        }
+
+        DateParts currentPart = planetClock.fromSeconds(currentTime);
+        DateParts nextPart = planetClock.fromSeconds(nextTime);
+
+        out << frameBlock(
+            frame,spec.frames,
+            PlanetClock::formatDate(currentPart),
+            PlanetClock::formatTime(currentPart),
+            PlanetClock::formatDate(nextPart),
+            PlanetClock::formatTime(nextPart)
+        );
+
+        currentTime = nextTime;
+    }
+    out << restoreBlock(spec);
+
+    std::string script = out.str();
+    sink(script.data(),script.size());
+    if (progress) progress(spec.frames);
+}
+
+// ============================================================ //
+// |                  FAST FRAME FORMATTING                   | //
+// ============================================================ //
+//Zero-padded decimal for non-negative values; matches "%0*d".
+static inline char* appendPadded(char* dst,long long value,int width) {
+    char digits[24];
+    int n = 0;
+    do {
+        digits[n++] = char('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    for (int i = n; i < width; i++) *dst++ = '0';
+    while (n > 0) *dst++ = digits[--n];
+    return dst;
+}
+
+//Writes "YYYY.MM.DD HH:MM:SS.ss" for a time in seconds, identical
+//to formatDate() + " " + formatTime(). Returns the stamp length.
+static inline int formatStamp(const PlanetClock& clock,double seconds,char* dst) {
+    DateParts part = clock.fromSeconds(seconds);
+    //Hundredths are only hand-rounded when printf's rounding of the
+    //exact binary value cannot differ, i.e. away from a .5 tie.
+    double hundredths = part.second * 100.0;
+    double whole = std::floor(hundredths);
+    double frac = hundredths - whole;
+    bool simple = part.year >= 0 && part.month >= 0 && part.day >= 0
+               && part.hour >= 0 && part.minute >= 0
+               && part.second >= 0.0 && part.second < 99.99
+               && std::fabs(frac - 0.5) > 1e-6;
+    if (!simple) {
+        return std::snprintf(dst,64,"%04d.%02d.%02d %02d:%02d:%05.2f",
+                             part.year,part.month,part.day,part.hour,part.minute,part.second);
+    }
+    long long cents = (long long)whole + (frac > 0.5 ? 1 : 0);
+    char* p = dst;
+    p = appendPadded(p,part.year,4);   *p++ = '.';
+    p = appendPadded(p,part.month,2);  *p++ = '.';
+    p = appendPadded(p,part.day,2);    *p++ = ' ';
+    p = appendPadded(p,part.hour,2);   *p++ = ':';
+    p = appendPadded(p,part.minute,2); *p++ = ':';
+    p = appendPadded(p,cents / 100,2); *p++ = '.';
+    p = appendPadded(p,cents % 100,2);
+    return int(p - dst);
+}
+
+//Constant pieces of a frame block, built once per script.
+struct FrameTemplate {
+    std::string head;   //Print "[name] Creating frame
+    std::string total;  // of N."\nDate "
+    std::string middle; //"\nScreenshot {...}\nDate "
+    std::string tail;   //"\nHidePrint\n
+
+    explicit FrameTemplate(const ScriptSpec& spec) {
+        head = "Print \"[" + spec.scriptName + "] Creating frame ";
+        total = " of " + std::to_string(spec.frames) + ".\"\nDate \"";
+        middle = "\"\nScreenshot {Format \"" + spec.exportFiletype + "\" Name \"frame_\"}\nDate \"";
+        tail = "\"\nHidePrint\n";
+    }
+    size_t maxFrameBytes() const {
+        return head.size() + total.size() + middle.size() + tail.size() + 24 + 2 * 64;
+    }
+};
+
+//Formats frames [first, last] whose first "current" time is
+//startTime, appending to out. Returns the time after the block.
+static inline double formatFrameRange(const PlanetClock& clock,const FrameTemplate& tpl,double stepSeconds,
+                                      int first,int last,double startTime,std::string& out) {
+    size_t used = out.size();
+    out.resize(used + (size_t)(last - first + 1) * tpl.maxFrameBytes());
+    char* p = &out[used];
+    char current[64], next[64];
+    int currentLen = formatStamp(clock,startTime,current);
+    double time = startTime;
+    for (int frame = first; frame <= last; ++frame) {
+        double nextTime = time + stepSeconds;
+        int nextLen = formatStamp(clock,nextTime,next);
+
+        std::memcpy(p,tpl.head.data(),tpl.head.size()); p += tpl.head.size();
+        p = appendPadded(p,frame,1);
+        std::memcpy(p,tpl.total.data(),tpl.total.size()); p += tpl.total.size();
+        std::memcpy(p,current,currentLen); p += currentLen;
+        std::memcpy(p,tpl.middle.data(),tpl.middle.size()); p += tpl.middle.size();
+        std::memcpy(p,next,nextLen); p += nextLen;
+        std::memcpy(p,tpl.tail.data(),tpl.tail.size()); p += tpl.tail.size();
+
+        std::memcpy(current,next,nextLen);
+        currentLen = nextLen;
+        time = nextTime;
+    }
+    out.resize(size_t(p - out.data()));
+    return time;
+}
+
+// ============================================================ //
+// |                   STREAMING GENERATOR                    | //
+// ============================================================ //
+//Single pass, O(chunkBytes) memory. Unit lookup is resolved once
+//and each stamp is formatted once (a frame's "next" stamp is the
+//following frame's "current" stamp).
+static inline void generateStreaming(const ScriptSpec& spec,const ScriptSink& sink,size_t chunkBytes = (1u << 20),
+                                     const ScriptProgress& progress = nullptr) {
+    PlanetClock planetClock{spec.calendar};
+    double stepSeconds = intervalStepSeconds(planetClock,parseIntervalUnit(spec.intervalUnit),spec.intervalStep);
+    FrameTemplate tpl(spec);
+
+    std::string setup = screenshotSetupBlock(spec);
+    sink(setup.data(),setup.size());
+
+    DateParts startParts = PlanetClock::parseParts(spec.initialDate,spec.startTime,spec.calendar.year0);
+    double currentTime = planetClock.toSeconds(startParts);
+
+    //Frames per chunk so a chunk never outgrows its reservation.
+    int framesPerChunk = (int)std::max<size_t>(1,chunkBytes / tpl.maxFrameBytes());
+    std::string chunk;
+    chunk.reserve((size_t)framesPerChunk * tpl.maxFrameBytes());
+    for (int first = 1; first <= spec.frames; first += framesPerChunk) {
+        int last = std::min(spec.frames,first + framesPerChunk - 1);
+        chunk.clear();
+        currentTime = formatFrameRange(planetClock,tpl,stepSeconds,first,last,currentTime,chunk);
+        sink(chunk.data(),chunk.size());
+        if (progress) progress(last);
+    }
+
+    std::string restore = restoreBlock(spec);
+    sink(restore.data(),restore.size());
+}
+
+// ============================================================ //
+// |                    PARALLEL GENERATOR                    | //
+// ============================================================ //
+//Block start times come from a serial pre-pass of the same running
+//sum the other generators use, so every block reproduces their
+//floating-point times exactly. Blocks are then formatted a window
+//at a time on the worker threads and emitted in order, which keeps
+//memory bounded by the window rather than the script length.
+static inline void generateParallel(const ScriptSpec& spec,const ScriptSink& sink,int blockFrames = 16384,
+                                    const ScriptProgress& progress = nullptr) {
+    PlanetClock planetClock{spec.calendar};
+    double stepSeconds = intervalStepSeconds(planetClock,parseIntervalUnit(spec.intervalUnit),spec.intervalStep);
+    FrameTemplate tpl(spec);
+    if (blockFrames < 1) blockFrames = 1;
+
+    std::string setup = screenshotSetupBlock(spec);
+    sink(setup.data(),setup.size());
+
+    DateParts startParts = PlanetClock::parseParts(spec.initialDate,spec.startTime,spec.calendar.year0);
+    double time = planetClock.toSeconds(startParts);
+
+    // ----- Block Start Times (serial running sum) ----- //
+    int blockCount = (spec.frames + blockFrames - 1) / blockFrames;
+    std::vector<double> blockStart((size_t)blockCount);
+    for (int block = 0; block < blockCount; ++block) {
+        blockStart[block] = time;
+        int framesInBlock = std::min(blockFrames,spec.frames - block * blockFrames);
+        for (int i = 0; i < framesInBlock; ++i) time += stepSeconds;
+    }
+
+    // ----- Windowed Formatting ----- //
+    int threads = 1;
+    #ifdef USE_OMP
+    threads = omp_get_max_threads();
+    #endif
+    int window = std::max(1,threads * 2);
+    std::vector<std::string> buffers((size_t)window);
+    for (auto& buffer : buffers) buffer.reserve((size_t)blockFrames * tpl.maxFrameBytes());
+
+    for (int windowStart = 0; windowStart < blockCount; windowStart += window) {
+        int windowEnd = std::min(blockCount,windowStart + window);
+        #ifdef USE_OMP
+        #pragma omp parallel for schedule(dynamic,1)
+        #endif
+        for (int block = windowStart; block < windowEnd; ++block) {
+            std::string& buffer = buffers[block - windowStart];
+            buffer.clear();
+            int first = block * blockFrames + 1;
+            int last = std::min(spec.frames,first + blockFrames - 1);
+            formatFrameRange(planetClock,tpl,stepSeconds,first,last,blockStart[block],buffer);
+        }
+        for (int block = windowStart; block < windowEnd; ++block) {
+            const std::string& buffer = buffers[block - windowStart];
+            sink(buffer.data(),buffer.size());
+            if (progress) progress(std::min(spec.frames,(block + 1) * blockFrames));
+        }
+    }
+
+    std::string restore = restoreBlock(spec);
+    sink(restore.data(),restore.size());
+}
+
+// ============================================================ //
+// |                    SCHEDULE GENERATOR                    | //
+// ============================================================ //
+//Tab-separated frame schedule (frame, date, time, seconds since
+//year0) using the same running time sum as the script generators.
+static inline void generateSchedule(const ScriptSpec& spec,const ScriptSink& sink,size_t chunkBytes = (1u << 20)) {
+    PlanetClock planetClock{spec.calendar};
+    double stepSeconds = intervalStepSeconds(planetClock,parseIntervalUnit(spec.intervalUnit),spec.intervalStep);
+    DateParts startParts = PlanetClock::parseParts(spec.initialDate,spec.startTime,spec.calendar.year0);
+    double time = planetClock.toSeconds(startParts);
+
+    std::string chunk = "frame\tdate\ttime\tseconds\n";
+    chunk.reserve(chunkBytes + 256);
+    char line[160];
+    for (int frame = 1; frame <= spec.frames; ++frame) {
+        char* p = appendPadded(line,frame,1);
+        *p++ = '\t';
+        int stampLen = formatStamp(planetClock,time,p);
+        char* space = static_cast<char*>(std::memchr(p,' ',(size_t)stampLen));
+        if (space) *space = '\t'; //"YYYY.MM.DD HH:MM:SS.ss" -> date<TAB>time
+        p += stampLen;
+        p += std::snprintf(p,48,"\t%.3f\n",time);
+        chunk.append(line,size_t(p - line));
+        if (chunk.size() >= chunkBytes) {
+            sink(chunk.data(),chunk.size());
+            chunk.clear();
+        }
+        time += stepSeconds;
+    }
+    if (!chunk.empty()) sink(chunk.data(),chunk.size());
+}
+
+// ------------------------ DISPATCH ------------------------- //
+static inline void generateScript(const std::string& mode,const ScriptSpec& spec,const ScriptSink& sink,
+                                  const ScriptProgress& progress = nullptr) {
+    if      (mode == "streaming") generateStreaming(spec,sink,(1u << 20),progress);
+    else if (mode == "parallel")  generateParallel(spec,sink,16384,progress);
+    else if (mode == "reference") generateReference(spec,sink,progress);
+    else throw std::runtime_error("Unknown generator mode: " + mode);
+}
+
+#endif // LIVE_SKYBOXES_SE_SCRIPT_GENERATOR_H
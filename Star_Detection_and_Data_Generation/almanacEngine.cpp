@@ -0,0 +1,404 @@
+//Celestial Navigation Almanac
+//Engine
+//Chris D. | Version 2 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Functional launch
+//  Version 1 (10/18/2026): --leapRule for whole-day calendar dates
+//  Version 2 (10/18/2026): GHA of Aries follows absolute planet time,
+//      with --ariesGHA0 taken at year0 rather than at the first row
+//      in the CSV (planetCalendar.h)
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Builds a planet-year nautical almanac from a star catalog
+//  exported by starDetection.py: the Greenwich Hour Angle of every
+//  star for every hour (or --stepHours) of the planet's year, plus
+//  each star's declination.
+//
+//  Angles are stored as 32-bit binary angles (2^32 = 360 degrees,
+//  about 0.0003" per step), so GHA(star) = GHA(Aries) - RA(star)
+//  is a single wrapping unsigned subtraction per entry and each
+//  table row is one vectorizable loop.
+//
+//  Outputs:
+//    <out>.alm  compact binary tables (layout under ALMANAC FILE)
+//    --csv      one row per hour, one column per star, with a DEC
+//               row first; --format dm prints D°MM.M' for printing
+
+// ============================================================== //
+// |                     COMPILE BASH SCRIPT                    | //
+// ============================================================== //
+// g++ almanacEngine.cpp -o almanacEngine -std=c++17 -O3 -Wall
+// (multi-threaded) add: -fopenmp -DUSE_OMP
+
+// ============================================================== //
+// |                      INCLUDE / DEFINE                      | //
+// ============================================================== //
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+
+#include "starTable.h"
+#include "../SpaceEngine_Automation/planetCalendar.h"
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+static const std::string kScriptName = "CHRIS'S KIT";
+
+// ============================================================== //
+// |                       BINARY ANGLES                        | //
+// ============================================================== //
+static inline uint32_t degreesToBam(double degrees) {
+    double turns = degrees / 360.0;
+    turns -= std::floor(turns);
+    return (uint32_t)(uint64_t)std::llround(turns * 4294967296.0);
+}
+
+static inline double bamToDegrees(uint32_t bam) {
+    return bam * (360.0 / 4294967296.0);
+}
+
+// ============================================================== //
+// |                        ALMANAC FILE                        | //
+// ============================================================== //
+//  Little-endian layout, every section aligned to 64 bytes:
+//    AlmanacHeader
+//    float    declination[starCount]       degrees
+//    uint32_t rightAscension[starCount]    binary angle
+//    char     names[nameBytes]             '\0'-separated
+//    uint32_t ariesGHA[rowCount]           binary angle
+//    uint32_t gha[rowCount][starCount]     binary angle, row-major
+struct AlmanacHeader {
+    char magic[8];              // "LSALMNC1"
+    uint32_t version;
+    uint32_t headerBytes;
+    uint32_t starCount;
+    uint32_t rowCount;
+    double startSeconds;        // Planet seconds since year0 for row 0
+    double stepSeconds;         // Time between rows
+    double siderealDaySeconds;  // One 360° turn of Aries
+    double ariesGHA0Degrees;    // GHA of Aries at planet second 0 (start of year0)
+    double dayHours, monthDays, yearDays;
+    int32_t year0;
+    uint32_t nameBytes;
+    uint64_t declinationOffset, rightAscensionOffset, namesOffset, ariesOffset, ghaOffset;
+};
+
+static inline uint64_t alignUp(uint64_t value) { return (value + 63) & ~uint64_t(63); }
+
+// ============================================================== //
+// |                          OPTIONS                           | //
+// ============================================================== //
+struct Options {
+    std::string input;
+    std::string outPath;
+    std::string csvPath;
+    std::string format = "deg";     // deg | dm
+    CalendarSpec calendar;
+    std::string startDate;          // Defaults to year0.01.01
+    std::string startTime = "00:00:00.00";
+    double stepHours = 1.0;
+    long long rows = 0;             // 0 = one planet year
+    double ariesGHA0 = 0.0;
+    double siderealDayHours = 0.0;  // 0 = derived from the solar day
+    size_t maxStars = 0;            // 0 = every star
+};
+
+// ============================================================== //
+// |                     ALMANAC GENERATION                     | //
+// ============================================================== //
+struct Almanac {
+    uint32_t starCount = 0, rowCount = 0;
+    std::vector<uint32_t> rightAscension;
+    std::vector<float> declination;
+    std::vector<uint32_t> aries;     // rowCount
+    std::vector<uint32_t> gha;       // rowCount * starCount
+};
+
+static Almanac buildAlmanac(const StarTable& stars,const Options& opt,double startSeconds,double stepSeconds,
+                            double siderealDaySeconds) {
+    Almanac almanac;
+    almanac.starCount = (uint32_t)stars.size();
+    almanac.rowCount = (uint32_t)opt.rows;
+    almanac.rightAscension.resize(stars.size());
+    almanac.declination.resize(stars.size());
+    for (size_t s = 0; s < stars.size(); s++) {
+        almanac.rightAscension[s] = degreesToBam(stars.rightAscension[s]);
+        almanac.declination[s] = (float)stars.declination[s];
+    }
+
+    // ----- GHA of Aries per row (double precision, then binary angle) ----- //
+    //Absolute planet time, so almanacs with different start dates agree
+    //at the same instant. The start's whole turns are dropped first to
+    //keep the fraction precise far from year0.
+    almanac.aries.resize(almanac.rowCount);
+    double turnsPerSecond = 1.0 / siderealDaySeconds;
+    double startTurns = std::fmod(startSeconds,siderealDaySeconds) * turnsPerSecond;
+    #ifdef USE_OMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (long long row = 0; row < (long long)almanac.rowCount; row++) {
+        double elapsed = row * stepSeconds;
+        double turns = startTurns + elapsed * turnsPerSecond;
+        turns -= std::floor(turns);
+        almanac.aries[row] = degreesToBam(opt.ariesGHA0 + turns * 360.0);
+    }
+
+    // ----- GHA(star) = GHA(Aries) - RA(star), wrapping ----- //
+    const size_t starCount = almanac.starCount;
+    almanac.gha.resize((size_t)almanac.rowCount * starCount);
+    const uint32_t* ra = almanac.rightAscension.data();
+    #ifdef USE_OMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (long long row = 0; row < (long long)almanac.rowCount; row++) {
+        uint32_t* out = almanac.gha.data() + (size_t)row * starCount;
+        const uint32_t aries = almanac.aries[row];
+        #ifdef USE_OMP
+        #pragma omp simd
+        #endif
+        for (size_t s = 0; s < starCount; s++) out[s] = aries - ra[s];
+    }
+    return almanac;
+}
+
+// ============================================================== //
+// |                          WRITERS                           | //
+// ============================================================== //
+static void writeAlmanac(const std::string& path,const Almanac& almanac,const StarTable& stars,
+                         const Options& opt,double startSeconds,double stepSeconds,double siderealDaySeconds) {
+    std::string names;
+    for (const std::string& name : stars.names) { names += name; names.push_back('\0'); }
+
+    AlmanacHeader header;
+    std::memset(&header,0,sizeof(header));
+    std::memcpy(header.magic,"LSALMNC1",8);
+    header.version = 1;
+    header.headerBytes = sizeof(AlmanacHeader);
+    header.starCount = almanac.starCount;
+    header.rowCount = almanac.rowCount;
+    header.startSeconds = startSeconds;
+    header.stepSeconds = stepSeconds;
+    header.siderealDaySeconds = siderealDaySeconds;
+    header.ariesGHA0Degrees = opt.ariesGHA0;
+    header.dayHours = opt.calendar.dayHours;
+    header.monthDays = opt.calendar.monthDays;
+    header.yearDays = opt.calendar.yearDays;
+    header.year0 = opt.calendar.year0;
+    header.nameBytes = (uint32_t)names.size();
+    header.declinationOffset = alignUp(sizeof(AlmanacHeader));
+    header.rightAscensionOffset = alignUp(header.declinationOffset + almanac.starCount * sizeof(float));
+    header.namesOffset = alignUp(header.rightAscensionOffset + almanac.starCount * sizeof(uint32_t));
+    header.ariesOffset = alignUp(header.namesOffset + names.size());
+    header.ghaOffset = alignUp(header.ariesOffset + almanac.rowCount * sizeof(uint32_t));
+
+    FILE* file = std::fopen(path.c_str(),"wb");
+    if (!file) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + path);
+    uint64_t position = 0;
+    auto put = [&](uint64_t offset,const void* data,size_t bytes) {
+        static const char zeros[64] = {0};
+        while (position < offset) {
+            size_t pad = (size_t)std::min<uint64_t>(64,offset - position);
+            std::fwrite(zeros,1,pad,file);
+            position += pad;
+        }
+        if (bytes && std::fwrite(data,1,bytes,file) != bytes) {
+            std::fclose(file);
+            throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + path);
+        }
+        position += bytes;
+    };
+    put(0,&header,sizeof(header));
+    put(header.declinationOffset,almanac.declination.data(),almanac.declination.size() * sizeof(float));
+    put(header.rightAscensionOffset,almanac.rightAscension.data(),almanac.rightAscension.size() * sizeof(uint32_t));
+    put(header.namesOffset,names.data(),names.size());
+    put(header.ariesOffset,almanac.aries.data(),almanac.aries.size() * sizeof(uint32_t));
+    put(header.ghaOffset,almanac.gha.data(),almanac.gha.size() * sizeof(uint32_t));
+    if (std::fclose(file) != 0) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + path);
+}
+
+//Angle text for the CSV: decimal degrees, or degrees and decimal
+//minutes the way printed almanacs show them.
+static int formatAngle(char* dst,double degrees,bool dm,bool signedDec) {
+    if (!dm) return std::snprintf(dst,32,"%.4f",degrees);
+    const char* hemisphere = "";
+    if (signedDec) {
+        hemisphere = degrees < 0 ? "S " : "N ";
+        degrees = std::fabs(degrees);
+    }
+    long tenths = std::lround(degrees * 600.0); // 0.1' units
+    if (!signedDec) tenths %= 360L * 600L;
+    return std::snprintf(dst,32,"%s%ld°%02ld.%ld'",hemisphere,tenths / 600,(tenths % 600) / 10,tenths % 10);
+}
+
+static void writeCsv(const std::string& path,const Almanac& almanac,const StarTable& stars,
+                     const PlanetClock& clock,const Options& opt,double startSeconds,double stepSeconds) {
+    FILE* file = std::fopen(path.c_str(),"wb");
+    if (!file) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + path);
+    const bool dm = (opt.format == "dm");
+
+    std::string head = "row,date,time,gha_aries";
+    for (const std::string& name : stars.names) head += "," + name;
+    head += "\nDEC,,,";
+    char cell[48];
+    for (size_t s = 0; s < almanac.starCount; s++) {
+        formatAngle(cell,almanac.declination[s],dm,true);
+        head += ",";
+        head += cell;
+    }
+    head += "\n";
+    std::fwrite(head.data(),1,head.size(),file);
+
+    // ----- Rows are formatted a block at a time in parallel, written in order ----- //
+    const long long blockRows = 64;
+    long long rows = almanac.rowCount;
+    int threads = 1;
+    #ifdef USE_OMP
+    threads = omp_get_max_threads();
+    #endif
+    long long window = blockRows * std::max(1,threads * 2);
+    std::vector<std::string> blocks((size_t)((window + blockRows - 1) / blockRows));
+    for (long long windowStart = 0; windowStart < rows; windowStart += window) {
+        long long windowEnd = std::min(rows,windowStart + window);
+        int blockCount = (int)((windowEnd - windowStart + blockRows - 1) / blockRows);
+        #ifdef USE_OMP
+        #pragma omp parallel for schedule(dynamic,1)
+        #endif
+        for (int b = 0; b < blockCount; b++) {
+            std::string& text = blocks[b];
+            text.clear();
+            long long first = windowStart + b * blockRows;
+            long long last = std::min(windowEnd,first + blockRows);
+            char buffer[64];
+            for (long long row = first; row < last; row++) {
+                DateParts part = clock.fromSeconds(startSeconds + row * stepSeconds);
+                int n = std::snprintf(buffer,sizeof(buffer),"%lld,%s,%s,",row,
+                                      PlanetClock::formatDate(part).c_str(),PlanetClock::formatTime(part).c_str());
+                text.append(buffer,n);
+                n = formatAngle(buffer,bamToDegrees(almanac.aries[row]),dm,false);
+                text.append(buffer,n);
+                const uint32_t* gha = almanac.gha.data() + (size_t)row * almanac.starCount;
+                for (size_t s = 0; s < almanac.starCount; s++) {
+                    text.push_back(',');
+                    n = formatAngle(buffer,bamToDegrees(gha[s]),dm,false);
+                    text.append(buffer,n);
+                }
+                text.push_back('\n');
+            }
+        }
+        for (int b = 0; b < blockCount; b++) std::fwrite(blocks[b].data(),1,blocks[b].size(),file);
+    }
+    if (std::fclose(file) != 0) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + path);
+}
+
+// ============================================================== //
+// |                        CLI PARSING                         | //
+// ============================================================== //
+static void usage(const char* argv0) {
+    std::fprintf(stderr,
+        "Usage: %s <starTable.txt> --out <almanac.alm>\n"
+        "     --dayHours <double> --monthDays <double> --yearDays <double> [--year0 <int>]\n"
+        "     [--leapRule <none|even|gregorian|P:+d,...>] (default none)\n"
+        "     [--startDate YYYY.MM.DD] [--startTime HH:MM:SS.ss] (default: start of year0)\n"
+        "     [--stepHours <double>] (default 1)\n"
+        "     [--rows N] (default: one planet year of steps)\n"
+        "     [--ariesGHA0 <deg>] (GHA of Aries at the start of year0, default 0)\n"
+        "     [--siderealDayHours <double>] (default: dayHours * yearDays / (yearDays + 1))\n"
+        "     [--maxStars N] (brightest N rows of the table)\n"
+        "     [--csv <path>] [--format deg|dm]\n",
+        argv0);
+}
+
+static Options parseArguments(int argc,char** argv) {
+    Options opt;
+    if (argc < 2) {
+        usage(argv[0]);
+        std::exit(1);
+    }
+    opt.input = argv[1];
+    for (int i=2; i < argc; i++) {
+        std::string key = argv[i];
+        auto need = [&](bool has) { if (!has) throw std::runtime_error("[" + kScriptName + "]: Missing value for " + key); };
+        if (key == "--out") { need(i + 1 < argc); opt.outPath = argv[++i]; }
+        else if (key == "--csv") { need(i + 1 < argc); opt.csvPath = argv[++i]; }
+        else if (key == "--format") { need(i + 1 < argc); opt.format = argv[++i]; }
+        else if (key == "--dayHours") { need(i + 1 < argc); opt.calendar.dayHours = std::stod(argv[++i]); }
+        else if (key == "--monthDays") { need(i + 1 < argc); opt.calendar.monthDays = std::stod(argv[++i]); }
+        else if (key == "--yearDays") { need(i + 1 < argc); opt.calendar.yearDays = std::stod(argv[++i]); }
+        else if (key == "--year0") { need(i + 1 < argc); opt.calendar.year0 = std::stoi(argv[++i]); }
+        else if (key == "--leapRule") { need(i + 1 < argc); opt.calendar.leapRule = argv[++i]; }
+        else if (key == "--startDate") { need(i + 1 < argc); opt.startDate = argv[++i]; }
+        else if (key == "--startTime") { need(i + 1 < argc); opt.startTime = argv[++i]; }
+        else if (key == "--stepHours") { need(i + 1 < argc); opt.stepHours = std::stod(argv[++i]); }
+        else if (key == "--rows") { need(i + 1 < argc); opt.rows = std::stoll(argv[++i]); }
+        else if (key == "--ariesGHA0") { need(i + 1 < argc); opt.ariesGHA0 = std::stod(argv[++i]); }
+        else if (key == "--siderealDayHours") { need(i + 1 < argc); opt.siderealDayHours = std::stod(argv[++i]); }
+        else if (key == "--maxStars") { need(i + 1 < argc); opt.maxStars = (size_t)std::stoll(argv[++i]); }
+        else { usage(argv[0]); throw std::runtime_error("[" + kScriptName + "]: Unknown argument: " + key); }
+    }
+    if (opt.outPath.empty()) throw std::runtime_error("[" + kScriptName + "]: --out is required.");
+    if (opt.format != "deg" && opt.format != "dm") throw std::runtime_error("[" + kScriptName + "]: --format must be deg or dm.");
+    if (opt.stepHours <= 0.0 || opt.calendar.dayHours <= 0.0 || opt.calendar.yearDays <= 0.0) {
+        throw std::runtime_error("[" + kScriptName + "]: stepHours, dayHours and yearDays must be > 0.");
+    }
+    return opt;
+}
+
+// ============================================================== //
+// |                        MAIN PROGRAM                        | //
+// ============================================================== //
+int main(int argc,char** argv) {
+    try {
+        Options opt = parseArguments(argc,argv);
+        StarTable stars = loadStarTable(opt.input);
+        if (opt.maxStars > 0) stars.truncate(opt.maxStars);
+        if (stars.size() == 0) throw std::runtime_error("[" + kScriptName + "]: No stars in " + opt.input);
+
+        PlanetClock clock{opt.calendar};
+        if (opt.startDate.empty()) {
+            char buffer[32];
+            std::snprintf(buffer,sizeof(buffer),"%04d.01.01",opt.calendar.year0);
+            opt.startDate = buffer;
+        }
+        double startSeconds = clock.toSeconds(PlanetClock::parseParts(opt.startDate,opt.startTime,opt.calendar.year0));
+        double stepSeconds = opt.stepHours * 3600.0;
+        if (opt.rows <= 0) opt.rows = (long long)std::ceil(clock.yearSec() / stepSeconds);
+        if (opt.rows > 0xFFFFFFFFLL) throw std::runtime_error("[" + kScriptName + "]: Too many rows.");
+
+        //A prograde planet turns once more per year against the stars than
+        //against its sun, so the sidereal day is slightly shorter.
+        double siderealDayHours = opt.siderealDayHours > 0.0
+            ? opt.siderealDayHours
+            : opt.calendar.dayHours * opt.calendar.yearDays / (opt.calendar.yearDays + 1.0);
+
+        auto t0 = std::chrono::steady_clock::now();
+        Almanac almanac = buildAlmanac(stars,opt,startSeconds,stepSeconds,siderealDayHours * 3600.0);
+        auto t1 = std::chrono::steady_clock::now();
+        writeAlmanac(opt.outPath,almanac,stars,opt,startSeconds,stepSeconds,siderealDayHours * 3600.0);
+        auto t2 = std::chrono::steady_clock::now();
+        if (!opt.csvPath.empty()) writeCsv(opt.csvPath,almanac,stars,clock,opt,startSeconds,stepSeconds);
+        auto t3 = std::chrono::steady_clock::now();
+
+        auto ms = [](auto a,auto b) { return std::chrono::duration<double,std::milli>(b - a).count(); };
+        std::printf("[%s] Almanac: %zu stars x %u rows (%.1f ms compute, %.1f ms write)\n",
+                    kScriptName.c_str(),stars.size(),almanac.rowCount,ms(t0,t1),ms(t1,t2));
+        std::printf("Wrote: %s\n",opt.outPath.c_str());
+        if (!opt.csvPath.empty()) std::printf("Wrote: %s (%.1f ms)\n",opt.csvPath.c_str(),ms(t2,t3));
+        return 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr,"Error: %s\n",e.what());
+        return 1;
+    }
+} // END OF MAIN PROGRAM
@@ -0,0 +1,414 @@
+//Star Detection
+//Bit-Packed Masks (Shared Header)
+//Chris D. | Version 3 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Packed thresholding and rectangular
+//      erode/dilate for the bright-source mask.
+//  Version 1 (10/18/2026): Disc kernels, open/close, AVX2 row
+//      shifts, set/clear bit scanning for run extraction.
+//  Version 2 (10/18/2026): clearRange() for clipping rows to a
+//      footprint.
+//  Version 3 (10/18/2026): packThreshold() sets every bit for a
+//      negative level (the SSE2 path left them clear).
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Binary masks stored one bit per pixel, 64 pixels per word.
+//  Bit i of word w is pixel x = 64 * w + i, so a shift left moves
+//  pixels toward larger x. Bits past the image width are kept 0.
+//
+//  Morphology matches cv2.erode/cv2.dilate with the default border:
+//  pixels outside the image never dilate anything and never erode
+//  anything. Kernels are anchored at their center:
+//    Kernel::rect(kx,ky)  kx x ky rectangle (separable: rows, then columns)
+//    Kernel::disc(r)      rows |dy| <= r, half-width (int)sqrt(r^2 - dy^2),
+//                         the same integer disc as cv2.circle(thickness=-1)
+//
+//  Row shifts use AVX2 when compiled with -mavx2; column passes are
+//  plain word loops the compiler vectorizes on its own.
+
+#ifndef LIVE_SKYBOXES_BIT_MASK_H
+#define LIVE_SKYBOXES_BIT_MASK_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace bitmask {
+
+struct BitMask {
+    int width = 0, height = 0, wordsPerRow = 0;
+    std::vector<uint64_t> words;
+
+    void resize(int w,int h) {
+        width = w; height = h;
+        wordsPerRow = (w + 63) / 64;
+        words.assign((size_t)wordsPerRow * h,0);
+    }
+    uint64_t* row(int y) { return &words[(size_t)y * wordsPerRow]; }
+    const uint64_t* row(int y) const { return &words[(size_t)y * wordsPerRow]; }
+    bool test(int x,int y) const { return (row(y)[x >> 6] >> (x & 63)) & 1; }
+};
+
+struct Kernel {
+    enum Shape { Rect, Disc } shape = Rect;
+    int kx = 1, ky = 1, radius = 0;
+    static Kernel rect(int kx,int ky) { Kernel k; k.kx = kx; k.ky = ky; return k; }
+    static Kernel disc(int radius) { Kernel k; k.shape = Disc; k.radius = radius; k.kx = k.ky = 2 * radius + 1; return k; }
+};
+
+//Valid bits of the last word of a row.
+static inline uint64_t tailMask(int width) {
+    const int bits = width & 63;
+    return bits ? ((1ULL << bits) - 1) : ~0ULL;
+}
+
+static inline int countTrailingZeros(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int n = 0;
+    while (!(word & 1)) { word >>= 1; n++; }
+    return n;
+#endif
+}
+
+// ============================================================== //
+// |                      PACK / UNPACK                         | //
+// ============================================================== //
+//bit = src[x] > level, written straight into packed words. A level of
+//255 or more leaves every bit clear; a negative one sets them all.
+static inline void packThreshold(const uint8_t* src,int width,int level,uint64_t* out) {
+    const int full = width / 64;
+    if (level >= 255) {
+        std::memset(out,0,(size_t)((width + 63) / 64) * sizeof(uint64_t));
+        return;
+    }
+    if (level < 0) {
+        for (int w = 0; w < full; w++) out[w] = ~0ULL;
+        if (width & 63) out[full] = tailMask(width);
+        return;
+    }
+#if defined(__SSE2__)
+    //Unsigned compare as signed after flipping the sign bits.
+    const __m128i flip = _mm_set1_epi8((char)0x80);
+    const __m128i limit = _mm_set1_epi8((char)(level ^ 0x80));
+    for (int w = 0; w < full; w++) {
+        const uint8_t* p = src + (size_t)w * 64;
+        uint64_t bits = 0;
+        for (int part = 0; part < 4; part++) {
+            __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(p + 16 * part)),flip);
+            bits |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpgt_epi8(v,limit)) << (16 * part);
+        }
+        out[w] = bits;
+    }
+#else
+    for (int w = 0; w < full; w++) {
+        const uint8_t* p = src + (size_t)w * 64;
+        uint64_t bits = 0;
+        for (int i = 0; i < 64; i++) bits |= (uint64_t)(p[i] > level) << i;
+        out[w] = bits;
+    }
+#endif
+    if (width & 63) {
+        uint64_t bits = 0;
+        for (int x = full * 64; x < width; x++) bits |= (uint64_t)(src[x] > level) << (x & 63);
+        out[full] = bits;
+    }
+}
+
+//Eight bits to eight 0/255 bytes per table lookup.
+static inline void unpack(const uint64_t* in,int width,uint8_t* out) {
+    static const struct Table {
+        uint64_t bytes[256];
+        Table() {
+            for (int v = 0; v < 256; v++) {
+                bytes[v] = 0;
+                for (int i = 0; i < 8; i++) if (v & (1 << i)) bytes[v] |= 0xFFULL << (8 * i);
+            }
+        }
+    } table;
+    const int fullBytes = width / 8;
+    const uint8_t* packed = reinterpret_cast<const uint8_t*>(in);   // Little-endian: byte k = pixels 8k..8k+7
+    for (int k = 0; k < fullBytes; k++) std::memcpy(out + 8 * k,&table.bytes[packed[k]],8);
+    for (int x = fullBytes * 8; x < width; x++) out[x] = ((in[x >> 6] >> (x & 63)) & 1) ? 255 : 0;
+}
+
+static inline void packThreshold(const uint8_t* src,int width,int height,int level,BitMask& out) {
+    out.resize(width,height);
+    #ifdef USE_OMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (int y = 0; y < height; y++) packThreshold(src + (size_t)y * width,width,level,out.row(y));
+}
+
+static inline void unpack(const BitMask& in,uint8_t* out) {
+    #ifdef USE_OMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (int y = 0; y < in.height; y++) unpack(in.row(y),in.width,out + (size_t)y * in.width);
+}
+
+// ============================================================== //
+// |                        BIT SCANNING                        | //
+// ============================================================== //
+//First set (or clear) pixel at or after x, or width if none.
+static inline int nextSetBit(const uint64_t* row,int width,int x) {
+    const int words = (width + 63) / 64;
+    if (x >= width) return width;
+    int w = x >> 6;
+    uint64_t word = row[w] & (~0ULL << (x & 63));
+    while (!word) {
+        if (++w >= words) return width;
+        word = row[w];
+    }
+    return std::min(width,64 * w + countTrailingZeros(word));
+}
+
+static inline int nextClearBit(const uint64_t* row,int width,int x) {
+    const int words = (width + 63) / 64;
+    if (x >= width) return width;
+    int w = x >> 6;
+    uint64_t word = ~row[w] & (~0ULL << (x & 63));
+    while (!word) {
+        if (++w >= words) return width;
+        word = ~row[w];
+    }
+    return std::min(width,64 * w + countTrailingZeros(word));
+}
+
+//Clears pixels [x0, x1) of a row.
+static inline void clearRange(uint64_t* row,int x0,int x1) {
+    if (x0 >= x1) return;
+    const int w0 = x0 >> 6, w1 = (x1 - 1) >> 6;
+    const uint64_t head = ~0ULL << (x0 & 63), tail = ~0ULL >> (63 - ((x1 - 1) & 63));
+    if (w0 == w1) {
+        row[w0] &= ~(head & tail);
+        return;
+    }
+    row[w0] &= ~head;
+    for (int w = w0 + 1; w < w1; w++) row[w] = 0;
+    row[w1] &= ~tail;
+}
+
+// ============================================================== //
+// |                         ROW SHIFTS                         | //
+// ============================================================== //
+//Word w of a row read at pixel offset `offset`: bit i is pixel
+//64 * w + i + offset, with `fill` for words outside the row.
+static inline uint64_t shiftedWord(const uint64_t* row,int words,int w,int offset,uint64_t fill) {
+    const long long position = 64LL * w + offset;
+    const long long index = (position >= 0) ? position / 64 : -((-position + 63) / 64);
+    const int bit = (int)(position - index * 64);
+    auto at = [&](long long k) { return (k < 0 || k >= words) ? fill : row[k]; };
+    if (bit == 0) return at(index);
+    return (at(index) >> bit) | (at(index + 1) << (64 - bit));
+}
+
+//Copies a row into scratch[1..words] with a fill word on each side;
+//when eroding, the bits past the width are set so they never erode.
+static inline const uint64_t* padRow(const uint64_t* in,uint64_t* scratch,int width,bool dilate) {
+    const int words = (width + 63) / 64;
+    const uint64_t fill = dilate ? 0 : ~0ULL;
+    scratch[0] = scratch[words + 1] = fill;
+    std::memcpy(scratch + 1,in,(size_t)words * sizeof(uint64_t));
+    if (!dilate) scratch[words] |= ~tailMask(width);
+    return scratch + 1;
+}
+
+//out = padded OR/AND itself shifted by 1..left and 1..right pixels.
+//Reaches stay below 64, so each word only needs its two neighbours,
+//which padRow() provides at both ends.
+static inline void combineShifts(const uint64_t* padded,uint64_t* out,int words,int left,int right,bool dilate) {
+    int w = 0;
+#if defined(__AVX2__)
+    for (; w + 4 <= words; w += 4) {
+        const __m256i current = _mm256_loadu_si256((const __m256i*)(padded + w));
+        const __m256i previous = _mm256_loadu_si256((const __m256i*)(padded + w - 1));
+        const __m256i next = _mm256_loadu_si256((const __m256i*)(padded + w + 1));
+        __m256i acc = current;
+        for (int d = 1; d <= right; d++) {
+            const __m256i v = _mm256_or_si256(_mm256_srl_epi64(current,_mm_cvtsi32_si128(d)),
+                                              _mm256_sll_epi64(next,_mm_cvtsi32_si128(64 - d)));
+            acc = dilate ? _mm256_or_si256(acc,v) : _mm256_and_si256(acc,v);
+        }
+        for (int d = 1; d <= left; d++) {
+            const __m256i v = _mm256_or_si256(_mm256_sll_epi64(current,_mm_cvtsi32_si128(d)),
+                                              _mm256_srl_epi64(previous,_mm_cvtsi32_si128(64 - d)));
+            acc = dilate ? _mm256_or_si256(acc,v) : _mm256_and_si256(acc,v);
+        }
+        _mm256_storeu_si256((__m256i*)(out + w),acc);
+    }
+#endif
+    for (; w < words; w++) {
+        const uint64_t previous = padded[w - 1], current = padded[w], next = padded[w + 1];
+        uint64_t acc = current;
+        if (dilate) {
+            for (int d = 1; d <= right; d++) acc |= (current >> d) | (next << (64 - d));
+            for (int d = 1; d <= left; d++)  acc |= (current << d) | (previous >> (64 - d));
+        } else {
+            for (int d = 1; d <= right; d++) acc &= (current >> d) | (next << (64 - d));
+            for (int d = 1; d <= left; d++)  acc &= (current << d) | (previous >> (64 - d));
+        }
+        out[w] = acc;
+    }
+}
+
+//One row through a 1 x kx window anchored at kx / 2. `scratch` holds
+//wordsPerRow + 2 words.
+static inline void morphRowH(const uint64_t* in,uint64_t* out,uint64_t* scratch,int width,int kx,bool dilate) {
+    const int words = (width + 63) / 64;
+    const int left = kx / 2, right = kx - 1 - left;
+    const uint64_t* padded = padRow(in,scratch,width,dilate);
+    if (left < 64 && right < 64) {
+        combineShifts(padded,out,words,left,right,dilate);
+    } else {
+        const uint64_t fill = dilate ? 0 : ~0ULL;
+        for (int w = 0; w < words; w++) {
+            uint64_t acc = padded[w];
+            for (int i = -left; i <= right; i++) {
+                const uint64_t v = shiftedWord(padded,words,w,i,fill);
+                acc = dilate ? (acc | v) : (acc & v);
+            }
+            out[w] = acc;
+        }
+    }
+    out[words - 1] &= tailMask(width);
+}
+
+// ============================================================== //
+// |                         MORPHOLOGY                         | //
+// ============================================================== //
+//kx x ky rectangle, separable: rows first, then columns. src may equal dst.
+static inline void morphRect(const BitMask& src,BitMask& dst,int kx,int ky,bool dilate) {
+    const int width = src.width, height = src.height, words = src.wordsPerRow;
+    const int ry = ky / 2;
+    BitMask rows;
+    rows.resize(width,height);
+    #ifdef USE_OMP
+    #pragma omp parallel
+    #endif
+    {
+        std::vector<uint64_t> scratch((size_t)words + 2);
+        #ifdef USE_OMP
+        #pragma omp for schedule(static)
+        #endif
+        for (int y = 0; y < height; y++) morphRowH(src.row(y),rows.row(y),scratch.data(),width,kx,dilate);
+    }
+    if (&dst != &src) dst.resize(width,height);
+    #ifdef USE_OMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (int y = 0; y < height; y++) {
+        const int lo = std::max(0,y - ry), hi = std::min(height - 1,y - ry + ky - 1);
+        uint64_t* out = dst.row(y);
+        std::memcpy(out,rows.row(lo),(size_t)words * sizeof(uint64_t));
+        for (int j = lo + 1; j <= hi; j++) {
+            const uint64_t* in = rows.row(j);
+            if (dilate) for (int w = 0; w < words; w++) out[w] |= in[w];
+            else        for (int w = 0; w < words; w++) out[w] &= in[w];
+        }
+    }
+}
+
+//Disc of radius r. Each source row is widened once to every half-width
+//0..r (level h = level h-1 combined with the row shifted by +-h); an
+//output row then combines level halfWidth(|dy|) of rows y + dy. Each
+//thread keeps the levels of its last 2r + 1 source rows in a ring.
+static inline void morphDisc(const BitMask& src,BitMask& dst,int radius,bool dilate) {
+    const int width = src.width, height = src.height, words = src.wordsPerRow;
+    if (radius <= 0) {
+        if (&dst != &src) dst = src;
+        return;
+    }
+    std::vector<int> halfWidth((size_t)radius + 1);
+    for (int dy = 0; dy <= radius; dy++) halfWidth[dy] = (int)std::sqrt((double)radius * radius - (double)dy * dy);
+
+    BitMask out;
+    out.resize(width,height);
+    const int ringRows = 2 * radius + 1;
+    const size_t levelWords = (size_t)(radius + 1) * words;
+    #ifdef USE_OMP
+    #pragma omp parallel
+    #endif
+    {
+        const uint64_t fill = dilate ? 0 : ~0ULL;
+        std::vector<uint64_t> scratch((size_t)words + 2);
+        std::vector<uint64_t> ring((size_t)ringRows * levelWords);
+        std::vector<int> ringSource(ringRows,-1);
+        auto levels = [&](int j) -> const uint64_t* {
+            uint64_t* slot = &ring[(size_t)(j % ringRows) * levelWords];
+            if (ringSource[j % ringRows] == j) return slot;
+            const uint64_t* padded = padRow(src.row(j),scratch.data(),width,dilate);
+            std::memcpy(slot,padded,(size_t)words * sizeof(uint64_t));
+            for (int h = 1; h <= radius; h++) {
+                const uint64_t* narrower = slot + (size_t)(h - 1) * words;
+                uint64_t* level = slot + (size_t)h * words;
+                for (int w = 0; w < words; w++) {
+                    const uint64_t a = shiftedWord(padded,words,w,h,fill), b = shiftedWord(padded,words,w,-h,fill);
+                    level[w] = dilate ? (narrower[w] | a | b) : (narrower[w] & a & b);
+                }
+            }
+            ringSource[j % ringRows] = j;
+            return slot;
+        };
+        #ifdef USE_OMP
+        #pragma omp for schedule(static)
+        #endif
+        for (int y = 0; y < height; y++) {
+            uint64_t* row = out.row(y);
+            bool first = true;
+            for (int dy = -radius; dy <= radius; dy++) {
+                const int j = y + dy;
+                if (j < 0 || j >= height) continue;   // Outside rows are ignored
+                const uint64_t* level = levels(j) + (size_t)halfWidth[std::abs(dy)] * words;
+                if (first) { std::memcpy(row,level,(size_t)words * sizeof(uint64_t)); first = false; }
+                else if (dilate) for (int w = 0; w < words; w++) row[w] |= level[w];
+                else             for (int w = 0; w < words; w++) row[w] &= level[w];
+            }
+            row[words - 1] &= tailMask(width);
+        }
+    }
+    dst = std::move(out);
+}
+
+static inline void morph(const BitMask& src,BitMask& dst,const Kernel& kernel,bool dilate) {
+    if (kernel.shape == Kernel::Disc) morphDisc(src,dst,kernel.radius,dilate);
+    else                              morphRect(src,dst,kernel.kx,kernel.ky,dilate);
+}
+
+static inline void erode(const BitMask& src,BitMask& dst,const Kernel& kernel)  { morph(src,dst,kernel,false); }
+static inline void dilate(const BitMask& src,BitMask& dst,const Kernel& kernel) { morph(src,dst,kernel,true); }
+
+//MORPH_OPEN / MORPH_CLOSE; like cv2, `iterations` repeats each step.
+static inline void open(const BitMask& src,BitMask& dst,const Kernel& kernel,int iterations = 1) {
+    if (&dst != &src) dst = src;
+    for (int i = 0; i < iterations; i++) erode(dst,dst,kernel);
+    for (int i = 0; i < iterations; i++) dilate(dst,dst,kernel);
+}
+
+static inline void close(const BitMask& src,BitMask& dst,const Kernel& kernel,int iterations = 1) {
+    if (&dst != &src) dst = src;
+    for (int i = 0; i < iterations; i++) dilate(dst,dst,kernel);
+    for (int i = 0; i < iterations; i++) erode(dst,dst,kernel);
+}
+
+} // namespace bitmask
+
+#endif // LIVE_SKYBOXES_BIT_MASK_H
@@ -0,0 +1,228 @@
+//Bit-Packed Mask Checks
+//Engine
+//Chris D. | Version 2 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Functional launch
+//  Version 1 (10/18/2026): Disc kernels, open/close and bit scanning.
+//  Version 2 (10/18/2026): clearRange().
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Deterministic checks for bitMask.h against byte-per-pixel
+//  references on small random images, including widths that end
+//  mid-word:
+//
+//    pack / unpack   packThreshold() then unpack() equals src > level,
+//                    and bits past the width stay clear
+//    bit scanning    nextSetBit()/nextClearBit() against a per-pixel
+//                    scan from every start column; clearRange()
+//                    clears exactly [x0, x1) and nothing else
+//    morphology      erode()/dilate() with rect and disc kernels, and
+//                    open()/close() with 2 iterations, against a
+//                    direct window scan with cv2's default border
+//
+//  Prints one line per check and exits 1 if any failed.
+
+// ============================================================== //
+// |                     COMPILE BASH SCRIPT                    | //
+// ============================================================== //
+// g++ bitMaskTests.cpp -o bitMaskTests -std=c++17 -O2 -Wall && ./bitMaskTests
+// (multi-threaded) add: -fopenmp -DUSE_OMP
+// (AVX2 row shifts) add: -mavx2
+
+// ============================================================== //
+// |                      INCLUDE / DEFINE                      | //
+// ============================================================== //
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <random>
+#include <stdexcept>
+#include <algorithm>
+
+#include "bitMask.h"
+
+static const std::string kScriptName = "CHRIS'S KIT";
+static int gFailures = 0;
+
+static void check(bool ok,const std::string& what) {
+    std::printf("[%s] %s %s\n",kScriptName.c_str(),ok ? "PASS" : "FAIL",what.c_str());
+    if (!ok) gFailures++;
+}
+
+//Sizes cover single pixels, exact words and ragged tails.
+static const int kSizes[][2] = {{1,1},{7,5},{33,17},{64,9},{65,31},{130,40},{201,77}};
+
+static std::vector<uint8_t> randomImage(std::mt19937& rng,int width,int height) {
+    std::vector<uint8_t> image((size_t)width * height);
+    for (uint8_t& v : image) v = (uint8_t)(rng() & 255);
+    return image;
+}
+
+//0/255 mask with a given fill fraction, in clumps so morphology sees
+//more than salt noise.
+static std::vector<uint8_t> randomMask(std::mt19937& rng,int width,int height,double fill) {
+    std::vector<uint8_t> mask((size_t)width * height,0);
+    std::uniform_real_distribution<double> u(0.0,1.0);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const bool left = x > 0 && mask[(size_t)y * width + x - 1];
+            const bool up = y > 0 && mask[(size_t)(y - 1) * width + x];
+            const double p = (left || up) ? std::min(0.9,fill * 2.5) : fill * 0.5;
+            mask[(size_t)y * width + x] = u(rng) < p ? 255 : 0;
+        }
+    }
+    return mask;
+}
+
+// ============================================================== //
+// |                       PACK / UNPACK                        | //
+// ============================================================== //
+static void checkPacking() {
+    std::mt19937 rng(5);
+    bool ok = true;
+    for (const auto& size : kSizes) {
+        const int width = size[0], height = size[1];
+        const std::vector<uint8_t> gray = randomImage(rng,width,height);
+        std::vector<uint8_t> unpacked((size_t)width * height);
+        bitmask::BitMask mask;
+        for (int level : {-1,0,1,127,254,255,300}) {
+            bitmask::packThreshold(gray.data(),width,height,level,mask);
+            bitmask::unpack(mask,unpacked.data());
+            for (size_t i = 0; i < gray.size(); i++) ok &= unpacked[i] == (gray[i] > level ? 255 : 0);
+            for (int y = 0; y < height; y++) ok &= (mask.row(y)[mask.wordsPerRow - 1] & ~bitmask::tailMask(width)) == 0;
+        }
+    }
+    check(ok,"packThreshold()/unpack() equal src > level, tail bits clear");
+}
+
+// ============================================================== //
+// |                        BIT SCANNING                        | //
+// ============================================================== //
+static void checkScanning() {
+    std::mt19937 rng(6);
+    bool ok = true;
+    for (const auto& size : kSizes) {
+        const int width = size[0], height = size[1];
+        for (double fill : {0.02,0.5,0.98}) {
+            const std::vector<uint8_t> src = randomMask(rng,width,height,fill);
+            bitmask::BitMask mask;
+            bitmask::packThreshold(src.data(),width,height,127,mask);
+            for (int y = 0; y < height; y++) {
+                const uint64_t* row = mask.row(y);
+                for (int x = 0; x <= width; x++) {
+                    int set = x, clear = x;
+                    while (set < width && !mask.test(set,y)) set++;
+                    while (clear < width && mask.test(clear,y)) clear++;
+                    ok &= bitmask::nextSetBit(row,width,x) == set && bitmask::nextClearBit(row,width,x) == clear;
+                }
+            }
+        }
+    }
+    check(ok,"nextSetBit()/nextClearBit() equal a per-pixel scan");
+
+    bool clearOk = true;
+    for (const auto& size : kSizes) {
+        const int width = size[0], height = size[1];
+        const std::vector<uint8_t> gray = randomImage(rng,width,height);
+        bitmask::BitMask mask;
+        for (int i = 0; i < 50; i++) {
+            bitmask::packThreshold(gray.data(),width,height,0,mask);
+            const int y = (int)(rng() % height), x0 = (int)(rng() % (width + 1)), x1 = (int)(rng() % (width + 1));
+            bitmask::clearRange(mask.row(y),x0,x1);
+            for (int x = 0; x < width; x++) clearOk &= mask.test(x,y) == (gray[(size_t)y * width + x] > 0 && (x < x0 || x >= x1));
+            clearOk &= (mask.row(y)[mask.wordsPerRow - 1] & ~bitmask::tailMask(width)) == 0;
+        }
+    }
+    check(clearOk,"clearRange() clears exactly [x0, x1)");
+}
+
+// ============================================================== //
+// |                         MORPHOLOGY                         | //
+// ============================================================== //
+//Reference erode/dilate: outside pixels never dilate or erode anything.
+//Disc rows use the same integer half-widths as cv2.circle.
+static std::vector<uint8_t> morphReference(const std::vector<uint8_t>& src,int width,int height,const bitmask::Kernel& kernel,bool dilate) {
+    std::vector<uint8_t> out((size_t)width * height);
+    const bool isDisc = kernel.shape == bitmask::Kernel::Disc;
+    const int top = kernel.ky / 2, bottom = kernel.ky - 1 - top;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            bool result = !dilate;
+            for (int dy = -top; dy <= bottom; dy++) {
+                const int left = isDisc ? (int)std::sqrt((double)(kernel.radius * kernel.radius - dy * dy)) : kernel.kx / 2;
+                const int right = isDisc ? left : kernel.kx - 1 - left;
+                for (int dx = -left; dx <= right; dx++) {
+                    const int xx = x + dx, yy = y + dy;
+                    if (xx < 0 || yy < 0 || xx >= width || yy >= height) continue;
+                    const bool set = src[(size_t)yy * width + xx] != 0;
+                    if (dilate) result |= set; else result &= set;
+                }
+            }
+            out[(size_t)y * width + x] = result ? 255 : 0;
+        }
+    }
+    return out;
+}
+
+static void checkMorphology() {
+    std::mt19937 rng(7);
+    const std::vector<bitmask::Kernel> kernels = {
+        bitmask::Kernel::rect(1,1),bitmask::Kernel::rect(3,3),bitmask::Kernel::rect(2,4),bitmask::Kernel::rect(7,1),
+        bitmask::Kernel::rect(1,5),bitmask::Kernel::rect(9,6),bitmask::Kernel::rect(70,3),
+        bitmask::Kernel::disc(1),bitmask::Kernel::disc(2),bitmask::Kernel::disc(5),bitmask::Kernel::disc(12),
+    };
+    bool ok = true, openCloseOk = true;
+    for (const auto& size : kSizes) {
+        const int width = size[0], height = size[1];
+        std::vector<uint8_t> unpacked((size_t)width * height);
+        for (double fill : {0.1,0.5,0.9}) {
+            const std::vector<uint8_t> src = randomMask(rng,width,height,fill);
+            bitmask::BitMask packed, out;
+            bitmask::packThreshold(src.data(),width,height,127,packed);
+            for (const bitmask::Kernel& kernel : kernels) {
+                for (bool dilate : {false,true}) {
+                    if (dilate) bitmask::dilate(packed,out,kernel); else bitmask::erode(packed,out,kernel);
+                    bitmask::unpack(out,unpacked.data());
+                    ok &= unpacked == morphReference(src,width,height,kernel,dilate);
+                }
+                bitmask::open(packed,out,kernel,2);
+                bitmask::unpack(out,unpacked.data());
+                std::vector<uint8_t> reference = src;
+                for (int i = 0; i < 2; i++) reference = morphReference(reference,width,height,kernel,false);
+                for (int i = 0; i < 2; i++) reference = morphReference(reference,width,height,kernel,true);
+                openCloseOk &= unpacked == reference;
+                bitmask::close(packed,out,kernel,2);
+                bitmask::unpack(out,unpacked.data());
+                reference = src;
+                for (int i = 0; i < 2; i++) reference = morphReference(reference,width,height,kernel,true);
+                for (int i = 0; i < 2; i++) reference = morphReference(reference,width,height,kernel,false);
+                openCloseOk &= unpacked == reference;
+            }
+        }
+    }
+    check(ok,"erode()/dilate() equal a window scan (rect and disc kernels)");
+    check(openCloseOk,"open()/close() with 2 iterations equal the reference");
+}
+
+// ============================================================== //
+// |                        MAIN PROGRAM                        | //
+// ============================================================== //
+int main() {
+    try {
+        checkPacking();
+        checkScanning();
+        checkMorphology();
+    } catch (const std::exception& e) {
+        std::fprintf(stderr,"Error: %s\n",e.what());
+        return 1;
+    }
+    std::printf("[%s] %s\n",kScriptName.c_str(),gFailures == 0 ? "All checks passed" : (std::to_string(gFailures) + " checks failed").c_str());
+    return gFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,178 @@
+//Star Catalog Cross-Match
+//Engine
+//Chris D. | Version 1 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Functional launch
+//  Version 1 (10/18/2026): --unique resolution moved to healpixIndex.h
+//      A failed or short write of the matches is an error.
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Names detected stars after a reference catalog. The detections
+//  are a star table exported by starDetection.py in equatorial mode
+//  (or a solved .stc), whose names are the placeholder A1, B1, ...
+//  labels; each is paired with the nearest catalog star on the sky
+//  within --radius and takes that star's name.
+//
+//  Matching is done on the sphere with the HEALPix index
+//  (healpixIndex.h), so it does not care which disc or projection a
+//  detection came from, and scales to catalogs with millions of
+//  stars. Detections are matched in parallel (USE_OMP).
+//
+//  --unique keeps one detection per catalog star (the closest); the
+//  others stay unmatched.
+//
+//  Output is the same tab-separated star table with the name column
+//  replaced by the match, plus catalog_id and separation_arcsec
+//  (both empty for unmatched detections, which keep their label).
+
+// ============================================================== //
+// |                     COMPILE BASH SCRIPT                    | //
+// ============================================================== //
+// g++ catalogCrossMatch.cpp -o catalogCrossMatch -std=c++17 -O3 -Wall
+// (multi-threaded) add: -fopenmp -DUSE_OMP
+// (checks) g++ healpixIndexTests.cpp -o healpixIndexTests -std=c++17 -O2 -Wall && ./healpixIndexTests
+
+// ============================================================== //
+// |                      INCLUDE / DEFINE                      | //
+// ============================================================== //
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#include "starTable.h"
+#include "healpixIndex.h"
+
+static const std::string kScriptName = "CHRIS'S KIT";
+static constexpr double kArcsecToRad = M_PI / (180.0 * 3600.0);
+static constexpr double kRadToArcsec = 180.0 * 3600.0 / M_PI;
+
+// ============================================================== //
+// |                          OPTIONS                           | //
+// ============================================================== //
+struct Options {
+    std::string detectionsPath;
+    std::string catalogPath;
+    std::string outPath;            // Empty = <detections stem>_matched.tsv
+    double radiusArcsec = 600.0;    // About two pixels of a 2048 px hemisphere disc
+    int order = -1;                 // -1 = picked from the catalog size
+    bool unique = false;
+};
+
+// ============================================================== //
+// |                          WRITERS                           | //
+// ============================================================== //
+static void writeMatches(const std::string& path,const StarTable& detections,const StarTable& catalog,
+                         const std::vector<healpix::Match>& matches) {
+    FILE* out = std::fopen(path.c_str(),"wb");
+    if (!out) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + path);
+    std::fprintf(out,"id\tname\txpix\typix\tra_deg\tdec_deg\tcatalog_id\tseparation_arcsec\n");
+    for (size_t i = 0; i < detections.size(); i++) {
+        const healpix::Match& match = matches[i];
+        const std::string& name = match.row >= 0 ? catalog.names[(size_t)match.row] : detections.names[i];
+        std::fprintf(out,"%s\t%s\t%.3f\t%.3f\t%.8f\t%.8f\t",detections.ids[i].c_str(),name.c_str(),
+                     detections.xPix[i],detections.yPix[i],detections.rightAscension[i],detections.declination[i]);
+        if (match.row >= 0) std::fprintf(out,"%s\t%.3f\n",catalog.ids[(size_t)match.row].c_str(),match.separation * kRadToArcsec);
+        else std::fprintf(out,"\t\n");
+    }
+    //A full disk can fail any fprintf() above or only the final flush.
+    const bool failed = std::ferror(out) != 0;
+    if (std::fclose(out) != 0 || failed) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + path);
+}
+
+// ============================================================== //
+// |                        CLI PARSING                         | //
+// ============================================================== //
+static void usage(const char* argv0) {
+    std::fprintf(stderr,
+        "Usage: %s <detections starTable> --catalog <catalog starTable>\n"
+        "     [--radius <arcsec>] (default 600) [--unique]\n"
+        "     [--order N] (HEALPix order, default from the catalog size)\n"
+        "     [--out <matched.tsv>] (default <detections>_matched.tsv)\n",
+        argv0);
+}
+
+static Options parseArguments(int argc,char** argv) {
+    Options opt;
+    if (argc < 2) {
+        usage(argv[0]);
+        std::exit(1);
+    }
+    int i = 1;
+    if (argv[1][0] != '-') opt.detectionsPath = argv[i++];
+    for (; i < argc; i++) {
+        std::string key = argv[i];
+        auto need = [&](bool has) { if (!has) throw std::runtime_error("[" + kScriptName + "]: Missing value for " + key); };
+        if (key == "--catalog") { need(i + 1 < argc); opt.catalogPath = argv[++i]; }
+        else if (key == "--out") { need(i + 1 < argc); opt.outPath = argv[++i]; }
+        else if (key == "--radius") { need(i + 1 < argc); opt.radiusArcsec = std::stod(argv[++i]); }
+        else if (key == "--order") { need(i + 1 < argc); opt.order = std::stoi(argv[++i]); }
+        else if (key == "--unique") opt.unique = true;
+        else { usage(argv[0]); throw std::runtime_error("[" + kScriptName + "]: Unknown argument: " + key); }
+    }
+    if (opt.detectionsPath.empty()) throw std::runtime_error("[" + kScriptName + "]: Give a detections star table.");
+    if (opt.catalogPath.empty()) throw std::runtime_error("[" + kScriptName + "]: Give a --catalog star table.");
+    if (!(opt.radiusArcsec > 0.0)) throw std::runtime_error("[" + kScriptName + "]: --radius must be positive.");
+    if (opt.order > healpix::kMaxOrder) throw std::runtime_error("[" + kScriptName + "]: --order must be at most 29.");
+    if (opt.outPath.empty()) {
+        std::string stem = opt.detectionsPath;
+        size_t slash = stem.find_last_of("/\\"), dot = stem.find_last_of('.');
+        if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) stem.erase(dot);
+        opt.outPath = stem + "_matched.tsv";
+    }
+    return opt;
+}
+
+// ============================================================== //
+// |                        MAIN PROGRAM                        | //
+// ============================================================== //
+int main(int argc,char** argv) {
+    try {
+        Options opt = parseArguments(argc,argv);
+
+        auto t0 = std::chrono::steady_clock::now();
+        StarTable catalog = loadStarTable(opt.catalogPath);
+        StarTable detections = loadStarTable(opt.detectionsPath);
+        auto t1 = std::chrono::steady_clock::now();
+        healpix::Index index;
+        index.build(catalog.rightAscension,catalog.declination,opt.order);
+        auto t2 = std::chrono::steady_clock::now();
+        std::vector<healpix::Match> matches = index.crossMatch(detections.rightAscension,detections.declination,
+                                                               opt.radiusArcsec * kArcsecToRad);
+        int dropped = opt.unique ? healpix::keepClosestPerStar(matches) : 0;
+        auto t3 = std::chrono::steady_clock::now();
+
+        std::vector<double> separations;
+        for (const healpix::Match& match : matches) if (match.row >= 0) separations.push_back(match.separation * kRadToArcsec);
+        std::sort(separations.begin(),separations.end());
+        std::printf("[%s] Catalog: %zu stars, HEALPix order %d (load %.1f ms, index %.1f ms)\n",kScriptName.c_str(),
+                    catalog.size(),index.order(),std::chrono::duration<double,std::milli>(t1 - t0).count(),
+                    std::chrono::duration<double,std::milli>(t2 - t1).count());
+        std::printf("[%s] Matched %zu of %zu detections within %.1f arcsec (%.1f ms)",kScriptName.c_str(),separations.size(),
+                    detections.size(),opt.radiusArcsec,std::chrono::duration<double,std::milli>(t3 - t2).count());
+        if (!separations.empty()) std::printf(", median separation %.1f arcsec",separations[separations.size() / 2]);
+        if (opt.unique) std::printf(", %d duplicates dropped",dropped);
+        std::printf("\n");
+
+        writeMatches(opt.outPath,detections,catalog,matches);
+        std::printf("Wrote: %s\n",opt.outPath.c_str());
+        return 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr,"Error: %s\n",e.what());
+        return 1;
+    }
+}
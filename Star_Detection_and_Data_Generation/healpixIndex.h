@@ -0,0 +1,424 @@
+//Star Detection
+//HEALPix Index (Shared Header)
+//Chris D. | Version 1 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Nested HEALPix index with cone, nearest
+//      and batch cross-match queries
+//  Version 1 (10/18/2026): keepClosestPerStar() for one-to-one matches
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Spatial index over unit-vector star positions for neighbor
+//  queries on the sphere, where pixel-space matching breaks across
+//  discs and projections.
+//
+//  Stars are binned into HEALPix pixels (nested scheme, Gorski et al.
+//  2005) at one order and stored sorted by pixel number, positions as
+//  unit vectors. In the nested scheme a pixel's 4^k descendants are a
+//  contiguous run of numbers, so any coarse pixel is one contiguous
+//  slice of the sorted stars.
+//
+//  A cone query descends from the 12 base pixels, dropping a pixel
+//  once its bounding circle (center + maxPixelRadius()) misses the
+//  cone and stopping once it lies wholly inside. Every star in the
+//  surviving slices is then tested by its dot product with the cone
+//  axis. Results are exact; the pixels only prune.
+//
+//    cone()        every star within a radius (visitor or list)
+//    nearest()     closest star within a radius
+//    nearestK()    k closest stars (cone widened until k are found)
+//    crossMatch()  nearest() for a batch of RA/Dec, in parallel
+//                  (USE_OMP), visited in pixel order for locality
+//
+//  keepClosestPerStar() then makes a batch one-to-one: of the
+//  queries sharing a catalog star only the closest keeps it.
+//
+//  raDecToPixel() / pixelToRaDec() / coneRanges() are exposed for
+//  callers that bin by pixel (tile-binned rendering, per-pixel
+//  catalog slices).
+
+#ifndef LIVE_SKYBOXES_HEALPIX_INDEX_H
+#define LIVE_SKYBOXES_HEALPIX_INDEX_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+namespace healpix {
+
+static const int kMaxOrder = 29;    // nside = 2^29; pixel numbers fit 64 bits
+
+struct Vec { double x = 0.0, y = 0.0, z = 0.0; };
+
+static inline Vec raDecToVec(double raDegrees,double decDegrees) {
+    const double ra = raDegrees * M_PI / 180.0, dec = decDegrees * M_PI / 180.0;
+    return {std::cos(dec) * std::cos(ra),std::cos(dec) * std::sin(ra),std::sin(dec)};
+}
+
+static inline void vecToRaDec(const Vec& v,double& raDegrees,double& decDegrees) {
+    raDegrees = std::atan2(v.y,v.x) * 180.0 / M_PI;
+    if (raDegrees < 0.0) raDegrees += 360.0;
+    decDegrees = std::atan2(v.z,std::sqrt(v.x * v.x + v.y * v.y)) * 180.0 / M_PI;
+}
+
+//Angle between two unit vectors, accurate at small separations.
+static inline double angleBetween(const Vec& a,const Vec& b) {
+    const double cx = a.y * b.z - a.z * b.y, cy = a.z * b.x - a.x * b.z, cz = a.x * b.y - a.y * b.x;
+    return std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz),a.x * b.x + a.y * b.y + a.z * b.z);
+}
+
+// ============================================================== //
+// |                      NESTED PIXELS                         | //
+// ============================================================== //
+//Interleave: bit i of v goes to bit 2i.
+static inline uint64_t spreadBits(uint64_t v) {
+    v &= 0xffffffffULL;
+    v = (v | (v << 16)) & 0x0000ffff0000ffffULL;
+    v = (v | (v << 8))  & 0x00ff00ff00ff00ffULL;
+    v = (v | (v << 4))  & 0x0f0f0f0f0f0f0f0fULL;
+    v = (v | (v << 2))  & 0x3333333333333333ULL;
+    v = (v | (v << 1))  & 0x5555555555555555ULL;
+    return v;
+}
+
+static inline uint64_t compressBits(uint64_t v) {
+    v &= 0x5555555555555555ULL;
+    v = (v | (v >> 1))  & 0x3333333333333333ULL;
+    v = (v | (v >> 2))  & 0x0f0f0f0f0f0f0f0fULL;
+    v = (v | (v >> 4))  & 0x00ff00ff00ff00ffULL;
+    v = (v | (v >> 8))  & 0x0000ffff0000ffffULL;
+    v = (v | (v >> 16)) & 0x00000000ffffffffULL;
+    return v;
+}
+
+static inline uint64_t pixelCount(int order) { return 12ULL << (2 * order); }
+
+static inline uint64_t xyfToNest(int order,int64_t ix,int64_t iy,int face) {
+    return ((uint64_t)face << (2 * order)) + spreadBits((uint64_t)ix) + (spreadBits((uint64_t)iy) << 1);
+}
+
+//Nested pixel of a direction (need not be normalized).
+static inline uint64_t vecToPixel(int order,const Vec& v) {
+    const int64_t nside = 1LL << order;
+    const double length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+    const double z = v.z / length, za = std::fabs(z);
+    const double sinTheta = std::sqrt(v.x * v.x + v.y * v.y) / length;
+    double tt = std::atan2(v.y,v.x) * (2.0 / M_PI);    // phi / (pi / 2)
+    tt = tt - 4.0 * std::floor(tt / 4.0);
+    if (tt >= 4.0) tt = 0.0;
+
+    if (za <= 2.0 / 3.0) {
+        // ----- Equatorial belt ----- //
+        const double temp1 = nside * (0.5 + tt), temp2 = nside * (z * 0.75);
+        const int64_t jp = (int64_t)(temp1 - temp2), jm = (int64_t)(temp1 + temp2);
+        const int64_t ifp = jp >> order, ifm = jm >> order;
+        const int face = (ifp == ifm) ? (int)(ifp | 4) : ((ifp < ifm) ? (int)ifp : (int)(ifm + 8));
+        const int64_t ix = jm & (nside - 1), iy = nside - (jp & (nside - 1)) - 1;
+        return xyfToNest(order,ix,iy,face);
+    }
+    // ----- Polar caps ----- //
+    const int ntt = std::min(3,(int)tt);
+    const double tp = tt - ntt;
+    const double tmp = (za < 0.99) ? nside * std::sqrt(3.0 * (1.0 - za)) : nside * sinTheta / std::sqrt((1.0 + za) / 3.0);
+    const int64_t jp = std::min(nside - 1,(int64_t)(tp * tmp)), jm = std::min(nside - 1,(int64_t)((1.0 - tp) * tmp));
+    return (z >= 0.0) ? xyfToNest(order,nside - jm - 1,nside - jp - 1,ntt) : xyfToNest(order,jp,jm,ntt + 8);
+}
+
+static inline uint64_t raDecToPixel(int order,double raDegrees,double decDegrees) {
+    return vecToPixel(order,raDecToVec(raDegrees,decDegrees));
+}
+
+//Center of a nested pixel.
+static inline Vec pixelToVec(int order,uint64_t pixel) {
+    static const int jrll[12] = {2,2,2,2,3,3,3,3,4,4,4,4};
+    static const int jpll[12] = {1,3,5,7,0,2,4,6,1,3,5,7};
+    const int64_t nside = 1LL << order;
+    const double fact2 = 4.0 / (double)pixelCount(order), fact1 = (double)(nside << 1) * fact2;
+    const int face = (int)(pixel >> (2 * order));
+    const uint64_t inFace = pixel & ((1ULL << (2 * order)) - 1);
+    const int64_t ix = (int64_t)compressBits(inFace), iy = (int64_t)compressBits(inFace >> 1);
+
+    const int64_t jr = ((int64_t)jrll[face] << order) - ix - iy - 1;
+    int64_t nr;
+    double z, sinTheta;
+    if (jr < nside) {
+        nr = jr;
+        const double tmp = (double)(nr * nr) * fact2;
+        z = 1.0 - tmp;
+        sinTheta = std::sqrt(tmp * (2.0 - tmp));
+    } else if (jr > 3 * nside) {
+        nr = nside * 4 - jr;
+        const double tmp = (double)(nr * nr) * fact2;
+        z = tmp - 1.0;
+        sinTheta = std::sqrt(tmp * (2.0 - tmp));
+    } else {
+        nr = nside;
+        z = (double)(2 * nside - jr) * fact1;
+        sinTheta = std::sqrt((1.0 - z) * (1.0 + z));
+    }
+    int64_t tmp = (int64_t)jpll[face] * nr + ix - iy;
+    if (tmp < 0) tmp += 8 * nr;
+    const double phi = (nr == nside) ? 0.75 * (M_PI / 2.0) * (double)tmp * fact1 : (0.5 * (M_PI / 2.0) * (double)tmp) / (double)nr;
+    return {sinTheta * std::cos(phi),sinTheta * std::sin(phi),z};
+}
+
+static inline void pixelToRaDec(int order,uint64_t pixel,double& raDegrees,double& decDegrees) {
+    vecToRaDec(pixelToVec(order,pixel),raDegrees,decDegrees);
+}
+
+//Largest angle (radians) between a pixel's center and any point of
+//it, over all pixels of the order.
+static inline double computeMaxPixelRadius(int order) {
+    const double nside = (double)(1LL << order);
+    auto fromZPhi = [](double z,double phi) {
+        const double s = std::sqrt((1.0 - z) * (1.0 + z));
+        return Vec{s * std::cos(phi),s * std::sin(phi),z};
+    };
+    double t1 = 1.0 - 1.0 / nside;
+    t1 *= t1;
+    return angleBetween(fromZPhi(2.0 / 3.0,M_PI / (4.0 * nside)),fromZPhi(1.0 - t1 / 3.0,0.0));
+}
+
+static inline double maxPixelRadius(int order) {
+    struct Table {
+        double radius[kMaxOrder + 1];
+        Table() { for (int o = 0; o <= kMaxOrder; o++) radius[o] = computeMaxPixelRadius(o); }
+    };
+    static const Table table;
+    return table.radius[order];
+}
+
+//Pixel centers of the coarse levels every cone descent walks through.
+static const int kCenterTableOrder = 4;
+
+static inline const Vec& coarsePixelCenter(int level,uint64_t pixel) {
+    struct Table {
+        std::vector<Vec> centers;
+        uint64_t offset[kCenterTableOrder + 1];
+        Table() {
+            for (int level = 0; level <= kCenterTableOrder; level++) {
+                offset[level] = centers.size();
+                for (uint64_t p = 0; p < pixelCount(level); p++) centers.push_back(pixelToVec(level,p));
+            }
+        }
+    };
+    static const Table table;
+    return table.centers[table.offset[level] + pixel];
+}
+
+//Sorted, merged [first, last) runs of nested pixels at `order` that
+//cover the cone (a superset: edge pixels are included whole). Axis is
+//a unit vector. Descent stops early at pixels smaller than a tenth of
+//the radius. Tests are done on cosines, thresholds once per level.
+static inline void coneRanges(int order,const Vec& axis,double radius,std::vector<std::pair<uint64_t,uint64_t>>& ranges) {
+    ranges.clear();
+    double outsideCos[kMaxOrder + 1], insideCos[kMaxOrder + 1];
+    bool stopAt[kMaxOrder + 1];
+    for (int level = 0; level <= order; level++) {
+        const double pixelRadius = maxPixelRadius(level) * (1.0 + 1e-9) + 1e-12;
+        outsideCos[level] = (radius + pixelRadius >= M_PI) ? -2.0 : std::cos(radius + pixelRadius);
+        insideCos[level] = (radius - pixelRadius < 0.0) ? 2.0 : std::cos(radius - pixelRadius);
+        stopAt[level] = level == order || pixelRadius < 0.1 * radius;
+        if (stopAt[level]) break;
+    }
+
+    struct Item { int level; uint64_t pixel; };
+    Item stack[4 * (kMaxOrder + 1) + 12];    // Depth-first: at most 3 siblings wait per level
+    int top = 0;
+    for (int face = 11; face >= 0; face--) stack[top++] = {0,(uint64_t)face};
+    while (top > 0) {
+        const Item item = stack[--top];
+        const Vec center = (item.level <= kCenterTableOrder) ? coarsePixelCenter(item.level,item.pixel) : pixelToVec(item.level,item.pixel);
+        const double c = axis.x * center.x + axis.y * center.y + axis.z * center.z;
+        if (c < outsideCos[item.level]) continue;
+        if (c >= insideCos[item.level] || stopAt[item.level]) {
+            const int shift = 2 * (order - item.level);
+            const uint64_t first = item.pixel << shift, last = (item.pixel + 1) << shift;
+            if (!ranges.empty() && ranges.back().second == first) ranges.back().second = last;
+            else ranges.push_back({first,last});
+            continue;
+        }
+        for (int child = 3; child >= 0; child--) stack[top++] = {item.level + 1,(item.pixel << 2) + (uint64_t)child};
+    }
+}
+
+// ============================================================== //
+// |                           INDEX                            | //
+// ============================================================== //
+struct Match {
+    int64_t row = -1;           // Index row, -1 when nothing is within the radius
+    double separation = 0.0;    // Radians
+};
+
+class Index {
+public:
+    //order < 0 picks the finest order with at least ~4 stars per pixel
+    //(capped at 12).
+    void build(const std::vector<Vec>& stars,int order = -1) {
+        if (stars.size() > 0xffffffffULL) throw std::runtime_error("healpix::Index: more than 2^32 stars");
+        if (order < 0) {
+            order = 0;
+            while (order < 12 && (double)pixelCount(order + 1) * 4.0 <= (double)stars.size()) order++;
+        }
+        if (order > kMaxOrder) throw std::runtime_error("healpix::Index: order above 29");
+        order_ = order;
+
+        const size_t n = stars.size();
+        std::vector<std::pair<uint64_t,uint32_t>> keyed(n);
+        #ifdef USE_OMP
+        #pragma omp parallel for schedule(static)
+        #endif
+        for (long long i = 0; i < (long long)n; i++) keyed[i] = {vecToPixel(order_,stars[i]),(uint32_t)i};
+        std::sort(keyed.begin(),keyed.end());
+
+        pixels_.resize(n); rows_.resize(n); positionOf_.resize(n);
+        x_.resize(n); y_.resize(n); z_.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            const Vec& v = stars[keyed[i].second];
+            const double length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+            pixels_[i] = keyed[i].first;
+            rows_[i] = keyed[i].second;
+            positionOf_[keyed[i].second] = (uint32_t)i;
+            x_[i] = v.x / length; y_[i] = v.y / length; z_[i] = v.z / length;
+        }
+    }
+
+    void build(const std::vector<double>& raDegrees,const std::vector<double>& decDegrees,int order = -1) {
+        if (raDegrees.size() != decDegrees.size()) throw std::runtime_error("healpix::Index: RA and Dec counts differ");
+        std::vector<Vec> stars(raDegrees.size());
+        for (size_t i = 0; i < stars.size(); i++) stars[i] = raDecToVec(raDegrees[i],decDegrees[i]);
+        build(stars,order);
+    }
+
+    size_t size() const { return rows_.size(); }
+    int order() const { return order_; }
+
+    //visit(row, cosine of the separation) for every star within radius
+    //(radians) of axis (a unit vector), in pixel order.
+    template <class Visit>
+    void cone(const Vec& axis,double radius,Visit visit) const {
+        scan(axis,radius,[&](size_t i,double c) { visit(rows_[i],c); });
+    }
+
+    std::vector<uint32_t> cone(const Vec& axis,double radius) const {
+        std::vector<uint32_t> rows;
+        cone(axis,radius,[&](uint32_t row,double) { rows.push_back(row); });
+        return rows;
+    }
+
+    //Closest star within radius; ties go to the lower row.
+    Match nearest(const Vec& axis,double radius) const {
+        Match match;
+        double best = -2.0;
+        size_t bestAt = 0;
+        scan(axis,radius,[&](size_t i,double c) {
+            if (c > best || (c == best && (int64_t)rows_[i] < match.row)) { best = c; bestAt = i; match.row = rows_[i]; }
+        });
+        if (match.row >= 0) match.separation = angleBetween(axis,{x_[bestAt],y_[bestAt],z_[bestAt]});
+        return match;
+    }
+
+    //Up to k (cosine, row) pairs, closest first. The cone starts at the
+    //radius k stars would fill on average and doubles until it holds k.
+    void nearestK(const Vec& axis,size_t k,std::vector<std::pair<double,uint32_t>>& out) const {
+        out.clear();
+        if (k == 0 || rows_.empty()) return;
+        k = std::min(k,rows_.size());
+        double radius = std::min(M_PI,1.5 * std::sqrt(4.0 * (double)k / (double)rows_.size()));
+        while (true) {
+            out.clear();
+            cone(axis,radius,[&](uint32_t row,double c) { out.push_back({c,row}); });
+            if (out.size() >= k || radius >= M_PI) break;
+            radius = std::min(M_PI,radius * 2.0);
+        }
+        std::sort(out.begin(),out.end(),[](const std::pair<double,uint32_t>& a,const std::pair<double,uint32_t>& b) {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        });
+        if (out.size() > k) out.resize(k);
+    }
+
+    //nearest() for each (RA, Dec) in degrees; radius in radians.
+    std::vector<Match> crossMatch(const std::vector<double>& raDegrees,const std::vector<double>& decDegrees,double radius) const {
+        if (raDegrees.size() != decDegrees.size()) throw std::runtime_error("healpix::Index: RA and Dec counts differ");
+        const size_t n = raDegrees.size();
+        std::vector<Match> matches(n);
+        std::vector<std::pair<uint64_t,uint32_t>> order(n);
+        for (size_t i = 0; i < n; i++) order[i] = {raDecToPixel(order_,raDegrees[i],decDegrees[i]),(uint32_t)i};
+        std::sort(order.begin(),order.end());
+        #ifdef USE_OMP
+        #pragma omp parallel for schedule(dynamic,256)
+        #endif
+        for (long long q = 0; q < (long long)n; q++) {
+            const uint32_t i = order[q].second;
+            matches[i] = nearest(raDecToVec(raDegrees[i],decDegrees[i]),radius);
+        }
+        return matches;
+    }
+
+    //Unit vector of an index row (rows are the build() positions).
+    Vec star(uint32_t row) const {
+        const uint32_t i = positionOf_[row];
+        return {x_[i],y_[i],z_[i]};
+    }
+
+private:
+    //visit(storage position, cosine) for every star within the cone.
+    template <class Visit>
+    void scan(const Vec& axis,double radius,Visit visit) const {
+        if (rows_.empty() || radius < 0.0) return;
+        const double minCos = std::cos(std::min(radius,M_PI));
+        std::vector<std::pair<uint64_t,uint64_t>> ranges;
+        coneRanges(order_,axis,radius,ranges);
+        for (const std::pair<uint64_t,uint64_t>& range : ranges) {
+            size_t i = (size_t)(std::lower_bound(pixels_.begin(),pixels_.end(),range.first) - pixels_.begin());
+            for (; i < pixels_.size() && pixels_[i] < range.second; i++) {
+                const double c = axis.x * x_[i] + axis.y * y_[i] + axis.z * z_[i];
+                if (c >= minCos) visit(i,c);
+            }
+        }
+    }
+
+    int order_ = 0;
+    std::vector<uint64_t> pixels_;          // Sorted nested pixel of each stored star
+    std::vector<uint32_t> rows_;            // build() row of each stored star
+    std::vector<double> x_, y_, z_;         // Unit vectors, same order
+    std::vector<uint32_t> positionOf_;      // Storage position of each build() row
+};
+
+//Drops every match but the closest on catalog stars claimed more
+//than once (ties go to the earlier query). Returns how many were
+//dropped.
+static inline int keepClosestPerStar(std::vector<Match>& matches) {
+    std::vector<size_t> order;
+    for (size_t i = 0; i < matches.size(); i++) if (matches[i].row >= 0) order.push_back(i);
+    std::sort(order.begin(),order.end(),[&](size_t a,size_t b) {
+        if (matches[a].row != matches[b].row) return matches[a].row < matches[b].row;
+        return matches[a].separation != matches[b].separation ? matches[a].separation < matches[b].separation : a < b;
+    });
+    int dropped = 0;
+    int64_t previous = -1;
+    for (size_t i : order) {
+        if (matches[i].row == previous) { matches[i] = Match(); dropped++; }
+        else previous = matches[i].row;
+    }
+    return dropped;
+}
+
+} // namespace healpix
+
+#endif // LIVE_SKYBOXES_HEALPIX_INDEX_H
@@ -0,0 +1,181 @@
+//HEALPix Index Checks
+//Engine
+//Chris D. | Version 0 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Functional launch
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Deterministic checks for healpixIndex.h against brute force on
+//  random unit vectors:
+//
+//    pixels         pixel -> center -> pixel round trip, every point
+//                   within maxPixelRadius() of its pixel center
+//    index          coneRanges() merged, cone() / nearest() /
+//                   nearestK() / crossMatch() equal to a full scan
+//    one-to-one     keepClosestPerStar() on a hand-made batch
+//
+//  Prints one line per check and exits 1 if any failed.
+
+// ============================================================== //
+// |                     COMPILE BASH SCRIPT                    | //
+// ============================================================== //
+// g++ healpixIndexTests.cpp -o healpixIndexTests -std=c++17 -O2 -Wall && ./healpixIndexTests
+// (multi-threaded) add: -fopenmp -DUSE_OMP
+
+// ============================================================== //
+// |                      INCLUDE / DEFINE                      | //
+// ============================================================== //
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <random>
+#include <utility>
+#include <stdexcept>
+#include <algorithm>
+
+#include "healpixIndex.h"
+
+static const std::string kScriptName = "CHRIS'S KIT";
+static int gFailures = 0;
+
+static void check(bool ok,const std::string& what) {
+    std::printf("[%s] %s %s\n",kScriptName.c_str(),ok ? "PASS" : "FAIL",what.c_str());
+    if (!ok) gFailures++;
+}
+
+static healpix::Vec randomUnit(std::mt19937_64& rng) {
+    std::normal_distribution<double> normal;
+    healpix::Vec v{normal(rng),normal(rng),normal(rng)};
+    const double length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+    return {v.x / length,v.y / length,v.z / length};
+}
+
+static double dot(const healpix::Vec& a,const healpix::Vec& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+// ============================================================== //
+// |                          HEALPIX                           | //
+// ============================================================== //
+static void checkPixels() {
+    std::mt19937_64 rng(11);
+    bool roundTrip = true, within = true;
+    for (int order = 0; order <= 10; order++) {
+        const uint64_t count = healpix::pixelCount(order);
+        const uint64_t step = std::max<uint64_t>(1,count / 20000);
+        for (uint64_t p = 0; p < count; p += step) roundTrip &= healpix::vecToPixel(order,healpix::pixelToVec(order,p)) == p;
+        const double radius = healpix::maxPixelRadius(order) * (1.0 + 1e-9);
+        for (int i = 0; i < 20000; i++) {
+            const healpix::Vec v = randomUnit(rng);
+            const uint64_t p = healpix::vecToPixel(order,v);
+            within &= p < count && healpix::angleBetween(v,healpix::pixelToVec(order,p)) <= radius;
+        }
+    }
+    for (int order : {20,29}) {
+        for (int i = 0; i < 20000; i++) {
+            const uint64_t p = healpix::vecToPixel(order,randomUnit(rng));
+            roundTrip &= healpix::vecToPixel(order,healpix::pixelToVec(order,p)) == p;
+        }
+    }
+    //Poles land in a polar base pixel and RA wraps at 360.
+    roundTrip &= healpix::vecToPixel(0,{0,0,1}) < 4 && healpix::vecToPixel(0,{0,0,-1}) >= 8;
+    roundTrip &= healpix::raDecToPixel(4,0.0,0.0) == healpix::raDecToPixel(4,360.0,0.0);
+    check(roundTrip,"HEALPix pixel -> center -> pixel, orders 0-10, 20, 29");
+    check(within,"HEALPix points lie within maxPixelRadius() of their pixel center");
+}
+
+static void checkIndex() {
+    std::mt19937_64 rng(13);
+    const size_t n = 200000;
+    std::vector<healpix::Vec> stars(n);
+    for (healpix::Vec& v : stars) v = randomUnit(rng);
+    //A few exact duplicates exercise the row tie-break.
+    for (size_t i = 0; i < 50; i++) stars[n - 1 - i] = stars[i];
+    healpix::Index index;
+    index.build(stars);
+
+    bool rangesOk = true, coneOk = true, nearestOk = true, nearestKOk = true;
+    std::vector<std::pair<uint64_t,uint64_t>> ranges;
+    std::vector<std::pair<double,uint32_t>> all(n), found;
+    for (int q = 0; q < 60; q++) {
+        const healpix::Vec axis = (q < 50) ? randomUnit(rng) : stars[q];
+        const double radius = std::pow(10.0,-3.5 + 3.5 * (q % 20) / 19.0);
+
+        healpix::coneRanges(index.order(),axis,radius,ranges);
+        for (size_t i = 0; i < ranges.size(); i++) {
+            rangesOk &= ranges[i].first < ranges[i].second && (i == 0 || ranges[i - 1].second < ranges[i].first);
+        }
+
+        std::vector<uint32_t> cone = index.cone(axis,radius), brute;
+        std::sort(cone.begin(),cone.end());
+        const double minCos = std::cos(radius);
+        for (size_t i = 0; i < n; i++) all[i] = {dot(axis,index.star((uint32_t)i)),(uint32_t)i};
+        for (size_t i = 0; i < n; i++) if (all[i].first >= minCos) brute.push_back((uint32_t)i);
+        coneOk &= cone == brute;
+
+        std::sort(all.begin(),all.end(),[](const std::pair<double,uint32_t>& a,const std::pair<double,uint32_t>& b) {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        });
+        const healpix::Match match = index.nearest(axis,radius);
+        nearestOk &= brute.empty() ? match.row < 0 : match.row == (int64_t)all[0].second;
+
+        const size_t k = 1 + q % 12;
+        index.nearestK(axis,k,found);
+        nearestKOk &= found.size() == k;
+        for (size_t i = 0; i < found.size() && i < k; i++) nearestKOk &= found[i].second == all[i].second;
+    }
+    check(rangesOk,"HEALPix coneRanges() are sorted, non-empty and merged");
+    check(coneOk,"HEALPix cone() matches brute force (60 cones, 0.0003-1 rad)");
+    check(nearestOk,"HEALPix nearest() matches brute force");
+    check(nearestKOk,"HEALPix nearestK() matches brute force, including ties");
+
+    //crossMatch() is nearest() per query, in any thread order.
+    std::vector<double> ra(2000), dec(2000);
+    for (size_t i = 0; i < ra.size(); i++) healpix::vecToRaDec(randomUnit(rng),ra[i],dec[i]);
+    const double radius = 0.01;
+    std::vector<healpix::Match> matches = index.crossMatch(ra,dec,radius);
+    bool crossOk = matches.size() == ra.size();
+    for (size_t i = 0; crossOk && i < ra.size(); i++) {
+        const healpix::Match single = index.nearest(healpix::raDecToVec(ra[i],dec[i]),radius);
+        crossOk = matches[i].row == single.row && matches[i].separation == single.separation;
+    }
+    check(crossOk,"HEALPix crossMatch() equals nearest() per query");
+}
+
+static void checkKeepClosest() {
+    auto match = [](int64_t row,double separation) { healpix::Match m; m.row = row; m.separation = separation; return m; };
+    std::vector<healpix::Match> matches = {
+        match(5,0.3),   // Loses star 5 to query 2
+        match(7,0.1),
+        match(5,0.2),
+        match(-1,0.0),
+        match(7,0.1),   // Ties query 1 and loses (later query)
+        match(9,0.5),
+    };
+    const int dropped = healpix::keepClosestPerStar(matches);
+    const int64_t expected[6] = {-1,7,5,-1,-1,9};
+    bool ok = dropped == 2;
+    for (int i = 0; i < 6; i++) ok &= matches[i].row == expected[i];
+    check(ok,"keepClosestPerStar() keeps the closest (then earliest) query per star");
+}
+
+// ============================================================== //
+// |                        MAIN PROGRAM                        | //
+// ============================================================== //
+int main() {
+    try {
+        checkPixels();
+        checkIndex();
+        checkKeepClosest();
+    } catch (const std::exception& e) {
+        std::fprintf(stderr,"Error: %s\n",e.what());
+        return 1;
+    }
+    std::printf("[%s] %s\n",kScriptName.c_str(),gFailures == 0 ? "All checks passed" : (std::to_string(gFailures) + " checks failed").c_str());
+    return gFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,430 @@
+//Star Detection
+//Overlay Renderer (Shared Header)
+//Chris D. | Version 0 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Tiled marker and label rasteriser
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Draws the detection overlay (a filled marker per star plus an
+//  outlined label) into an RGBA buffer, either over the source image
+//  for the preview or on transparency for the exported PNG.
+//
+//    Markers  antialiased discs, coverage from the distance to the
+//             pixel center (pixel (i,j) is centered on (i,j), the
+//             detection centroid convention).
+//    Labels   a baked 5x7 bitmap font. The atlas holds one fill and
+//             one outline coverage bitmap per glyph, supersampled 4x4
+//             at the requested size, so each label is a few blits.
+//
+//  Marker and label boxes are binned into tiles (lists kept in draw
+//  order) and the tiles are composited in parallel; tiles with
+//  nothing on them are a straight copy of the background.
+
+#ifndef LIVE_SKYBOXES_OVERLAY_RENDERER_H
+#define LIVE_SKYBOXES_OVERLAY_RENDERER_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+namespace overlay {
+
+static const int kGlyphColumns = 5, kGlyphRows = 7;
+static const int kFirstGlyph = 32, kGlyphCount = 95;   // Printable ASCII
+static const int kSupersample = 4;
+
+//Row bitmaps, bit 4 is the leftmost column.
+static const uint8_t kFont5x7[kGlyphCount][kGlyphRows] = {
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00}, // ' '
+    {0x04,0x04,0x04,0x04,0x04,0x00,0x04}, // '!'
+    {0x0A,0x0A,0x0A,0x00,0x00,0x00,0x00}, // '"'
+    {0x0A,0x0A,0x1F,0x0A,0x1F,0x0A,0x0A}, // '#'
+    {0x04,0x0F,0x14,0x0E,0x05,0x1E,0x04}, // '$'
+    {0x18,0x19,0x02,0x04,0x08,0x13,0x03}, // '%'
+    {0x0C,0x12,0x14,0x08,0x15,0x12,0x0D}, // '&'
+    {0x04,0x04,0x08,0x00,0x00,0x00,0x00}, // '\''
+    {0x02,0x04,0x08,0x08,0x08,0x04,0x02}, // '('
+    {0x08,0x04,0x02,0x02,0x02,0x04,0x08}, // ')'
+    {0x00,0x04,0x15,0x0E,0x15,0x04,0x00}, // '*'
+    {0x00,0x04,0x04,0x1F,0x04,0x04,0x00}, // '+'
+    {0x00,0x00,0x00,0x00,0x0C,0x04,0x08}, // ','
+    {0x00,0x00,0x00,0x1F,0x00,0x00,0x00}, // '-'
+    {0x00,0x00,0x00,0x00,0x00,0x0C,0x0C}, // '.'
+    {0x00,0x01,0x02,0x04,0x08,0x10,0x00}, // '/'
+    {0x0E,0x11,0x13,0x15,0x19,0x11,0x0E}, // '0'
+    {0x04,0x0C,0x04,0x04,0x04,0x04,0x0E}, // '1'
+    {0x0E,0x11,0x01,0x02,0x04,0x08,0x1F}, // '2'
+    {0x1F,0x02,0x04,0x02,0x01,0x11,0x0E}, // '3'
+    {0x02,0x06,0x0A,0x12,0x1F,0x02,0x02}, // '4'
+    {0x1F,0x10,0x1E,0x01,0x01,0x11,0x0E}, // '5'
+    {0x06,0x08,0x10,0x1E,0x11,0x11,0x0E}, // '6'
+    {0x1F,0x01,0x02,0x04,0x08,0x08,0x08}, // '7'
+    {0x0E,0x11,0x11,0x0E,0x11,0x11,0x0E}, // '8'
+    {0x0E,0x11,0x11,0x0F,0x01,0x02,0x0C}, // '9'
+    {0x00,0x0C,0x0C,0x00,0x0C,0x0C,0x00}, // ':'
+    {0x00,0x0C,0x0C,0x00,0x0C,0x04,0x08}, // ';'
+    {0x02,0x04,0x08,0x10,0x08,0x04,0x02}, // '<'
+    {0x00,0x00,0x1F,0x00,0x1F,0x00,0x00}, // '='
+    {0x08,0x04,0x02,0x01,0x02,0x04,0x08}, // '>'
+    {0x0E,0x11,0x01,0x02,0x04,0x00,0x04}, // '?'
+    {0x0E,0x11,0x01,0x0D,0x15,0x15,0x0E}, // '@'
+    {0x0E,0x11,0x11,0x1F,0x11,0x11,0x11}, // 'A'
+    {0x1E,0x11,0x11,0x1E,0x11,0x11,0x1E}, // 'B'
+    {0x0E,0x11,0x10,0x10,0x10,0x11,0x0E}, // 'C'
+    {0x1C,0x12,0x11,0x11,0x11,0x12,0x1C}, // 'D'
+    {0x1F,0x10,0x10,0x1E,0x10,0x10,0x1F}, // 'E'
+    {0x1F,0x10,0x10,0x1E,0x10,0x10,0x10}, // 'F'
+    {0x0E,0x11,0x10,0x17,0x11,0x11,0x0F}, // 'G'
+    {0x11,0x11,0x11,0x1F,0x11,0x11,0x11}, // 'H'
+    {0x0E,0x04,0x04,0x04,0x04,0x04,0x0E}, // 'I'
+    {0x07,0x02,0x02,0x02,0x02,0x12,0x0C}, // 'J'
+    {0x11,0x12,0x14,0x18,0x14,0x12,0x11}, // 'K'
+    {0x10,0x10,0x10,0x10,0x10,0x10,0x1F}, // 'L'
+    {0x11,0x1B,0x15,0x15,0x11,0x11,0x11}, // 'M'
+    {0x11,0x11,0x19,0x15,0x13,0x11,0x11}, // 'N'
+    {0x0E,0x11,0x11,0x11,0x11,0x11,0x0E}, // 'O'
+    {0x1E,0x11,0x11,0x1E,0x10,0x10,0x10}, // 'P'
+    {0x0E,0x11,0x11,0x11,0x15,0x12,0x0D}, // 'Q'
+    {0x1E,0x11,0x11,0x1E,0x14,0x12,0x11}, // 'R'
+    {0x0F,0x10,0x10,0x0E,0x01,0x01,0x1E}, // 'S'
+    {0x1F,0x04,0x04,0x04,0x04,0x04,0x04}, // 'T'
+    {0x11,0x11,0x11,0x11,0x11,0x11,0x0E}, // 'U'
+    {0x11,0x11,0x11,0x11,0x11,0x0A,0x04}, // 'V'
+    {0x11,0x11,0x11,0x15,0x15,0x15,0x0A}, // 'W'
+    {0x11,0x11,0x0A,0x04,0x0A,0x11,0x11}, // 'X'
+    {0x11,0x11,0x0A,0x04,0x04,0x04,0x04}, // 'Y'
+    {0x1F,0x01,0x02,0x04,0x08,0x10,0x1F}, // 'Z'
+    {0x0E,0x08,0x08,0x08,0x08,0x08,0x0E}, // '['
+    {0x00,0x10,0x08,0x04,0x02,0x01,0x00}, // '\\'
+    {0x0E,0x02,0x02,0x02,0x02,0x02,0x0E}, // ']'
+    {0x04,0x0A,0x11,0x00,0x00,0x00,0x00}, // '^'
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x1F}, // '_'
+    {0x08,0x04,0x02,0x00,0x00,0x00,0x00}, // '`'
+    {0x00,0x00,0x0E,0x01,0x0F,0x11,0x0F}, // 'a'
+    {0x10,0x10,0x16,0x19,0x11,0x11,0x1E}, // 'b'
+    {0x00,0x00,0x0E,0x10,0x10,0x11,0x0E}, // 'c'
+    {0x01,0x01,0x0D,0x13,0x11,0x11,0x0F}, // 'd'
+    {0x00,0x00,0x0E,0x11,0x1F,0x10,0x0E}, // 'e'
+    {0x06,0x09,0x08,0x1C,0x08,0x08,0x08}, // 'f'
+    {0x00,0x0F,0x11,0x11,0x0F,0x01,0x0E}, // 'g'
+    {0x10,0x10,0x16,0x19,0x11,0x11,0x11}, // 'h'
+    {0x04,0x00,0x0C,0x04,0x04,0x04,0x0E}, // 'i'
+    {0x02,0x00,0x06,0x02,0x02,0x12,0x0C}, // 'j'
+    {0x10,0x10,0x12,0x14,0x18,0x14,0x12}, // 'k'
+    {0x0C,0x04,0x04,0x04,0x04,0x04,0x0E}, // 'l'
+    {0x00,0x00,0x1A,0x15,0x15,0x11,0x11}, // 'm'
+    {0x00,0x00,0x16,0x19,0x11,0x11,0x11}, // 'n'
+    {0x00,0x00,0x0E,0x11,0x11,0x11,0x0E}, // 'o'
+    {0x00,0x00,0x1E,0x11,0x1E,0x10,0x10}, // 'p'
+    {0x00,0x00,0x0D,0x13,0x0F,0x01,0x01}, // 'q'
+    {0x00,0x00,0x16,0x19,0x10,0x10,0x10}, // 'r'
+    {0x00,0x00,0x0E,0x10,0x0E,0x01,0x1E}, // 's'
+    {0x08,0x08,0x1C,0x08,0x08,0x09,0x06}, // 't'
+    {0x00,0x00,0x11,0x11,0x11,0x13,0x0D}, // 'u'
+    {0x00,0x00,0x11,0x11,0x11,0x0A,0x04}, // 'v'
+    {0x00,0x00,0x11,0x11,0x15,0x15,0x0A}, // 'w'
+    {0x00,0x00,0x11,0x0A,0x04,0x0A,0x11}, // 'x'
+    {0x00,0x00,0x11,0x11,0x0F,0x01,0x0E}, // 'y'
+    {0x00,0x00,0x1F,0x02,0x04,0x08,0x1F}, // 'z'
+    {0x02,0x04,0x04,0x08,0x04,0x04,0x02}, // '{'
+    {0x04,0x04,0x04,0x04,0x04,0x04,0x04}, // '|'
+    {0x08,0x04,0x04,0x02,0x04,0x04,0x08}, // '}'
+    {0x00,0x00,0x08,0x15,0x02,0x00,0x00}  // '~'
+};
+
+struct Rgba { uint8_t r, g, b, a; };
+
+struct Style {
+    Rgba marker = {255,200,0,255};
+    Rgba text = {255,255,255,255};
+    Rgba outline = {0,0,0,180};
+    double labelPixels = 12.0;      // Glyph height; <= 0 draws no labels
+    double outlineRadius = 1.0;     // Outline reach around each glyph
+    int tileSize = 256;
+};
+
+//Structure of arrays, one entry per star; labels may be null.
+struct Markers {
+    const double* x = nullptr;
+    const double* y = nullptr;
+    const double* radius = nullptr;
+    const char* const* labels = nullptr;
+    size_t count = 0;
+};
+
+//Fill and outline coverage (0-255) per glyph, all glyphs the same box.
+struct GlyphAtlas {
+    int width = 0, height = 0;      // Bitmap box including the outline pad
+    int pad = 0, glyphHeight = 0, advance = 0;
+    std::vector<uint8_t> fill, edge;
+
+    const uint8_t* fillOf(int glyph) const { return &fill[(size_t)glyph * width * height]; }
+    const uint8_t* edgeOf(int glyph) const { return &edge[(size_t)glyph * width * height]; }
+
+    static int glyphIndex(unsigned char c) {
+        if (c >= kFirstGlyph && c < kFirstGlyph + kGlyphCount) return c - kFirstGlyph;
+        return '?' - kFirstGlyph;
+    }
+
+    void build(double labelPixels,double outlineRadius) {
+        const double s = labelPixels / kGlyphRows;   // Cell edge in pixels
+        const double reach = std::max(0.0,outlineRadius);
+        glyphHeight = (int)std::ceil(kGlyphRows * s);
+        advance = std::max(1,(int)std::lround((kGlyphColumns + 1) * s));
+        pad = (int)std::ceil(reach) + 1;
+        width = (int)std::ceil(kGlyphColumns * s) + 2 * pad;
+        height = glyphHeight + 2 * pad;
+        fill.assign((size_t)kGlyphCount * width * height,0);
+        edge.assign(fill.size(),0);
+
+        const double step = 1.0 / kSupersample;
+        const int samples = kSupersample * kSupersample;
+        for (int glyph = 0; glyph < kGlyphCount; glyph++) {
+            const uint8_t* rows = kFont5x7[glyph];
+            auto on = [&](int cx,int cy) {
+                return cx >= 0 && cx < kGlyphColumns && cy >= 0 && cy < kGlyphRows && ((rows[cy] >> (kGlyphColumns - 1 - cx)) & 1);
+            };
+            uint8_t* f = &fill[(size_t)glyph * width * height];
+            uint8_t* e = &edge[(size_t)glyph * width * height];
+            for (int j = 0; j < height; j++) {
+                for (int i = 0; i < width; i++) {
+                    int inside = 0, near = 0;
+                    for (int sy = 0; sy < kSupersample; sy++) {
+                        const double v = j - pad + (sy + 0.5) * step;
+                        for (int sx = 0; sx < kSupersample; sx++) {
+                            const double u = i - pad + (sx + 0.5) * step;
+                            if (on((int)std::floor(u / s),(int)std::floor(v / s))) { inside++; near++; continue; }
+                            //Any lit cell within reach of the sample:
+                            bool hit = false;
+                            const int cx0 = (int)std::floor((u - reach) / s), cx1 = (int)std::floor((u + reach) / s);
+                            const int cy0 = (int)std::floor((v - reach) / s), cy1 = (int)std::floor((v + reach) / s);
+                            for (int cy = cy0; cy <= cy1 && !hit; cy++) {
+                                for (int cx = cx0; cx <= cx1 && !hit; cx++) {
+                                    if (!on(cx,cy)) continue;
+                                    const double dx = std::max({cx * s - u,0.0,u - (cx + 1) * s});
+                                    const double dy = std::max({cy * s - v,0.0,v - (cy + 1) * s});
+                                    hit = dx * dx + dy * dy <= reach * reach;
+                                }
+                            }
+                            near += hit;
+                        }
+                    }
+                    f[(size_t)j * width + i] = (uint8_t)((inside * 255 + samples / 2) / samples);
+                    e[(size_t)j * width + i] = (uint8_t)((near * 255 + samples / 2) / samples);
+                }
+            }
+        }
+    }
+};
+
+//Label pen position (left end of the baseline), as the Qt preview
+//placed it: up and to the right of the marker.
+static inline void labelOrigin(double x,double y,double radius,int& penX,int& baseline) {
+    penX = (int)(x + radius + 4);
+    baseline = (int)(y - radius - 4);
+}
+
+//Glyphs in a UTF-8 label; each non-ASCII character draws as '?'.
+static inline size_t glyphLength(const char* text) {
+    size_t n = 0;
+    for (const unsigned char* c = (const unsigned char*)text; *c; c++) n += (*c & 0xC0) != 0x80;
+    return n;
+}
+
+struct Box { int x0, y0, x1, y1; };   // Half-open pixel bounds
+
+static inline Box markerBox(double x,double y,double radius) {
+    return {(int)std::floor(x - radius - 1),(int)std::floor(y - radius - 1),
+            (int)std::floor(x + radius + 1) + 1,(int)std::floor(y + radius + 1) + 1};
+}
+
+static inline Box labelBox(const GlyphAtlas& atlas,int penX,int baseline,size_t length) {
+    const int x0 = penX - atlas.pad, y0 = baseline - atlas.glyphHeight - atlas.pad;
+    return {x0,y0,x0 + (int)(length ? length - 1 : 0) * atlas.advance + atlas.width,y0 + atlas.height};
+}
+
+//Premultiplied "over" of straight color c at coverage alpha a.
+static inline void blend(float* dst,const float c[3],float a) {
+    const float keep = 1.0f - a;
+    dst[0] = c[0] * a + dst[0] * keep;
+    dst[1] = c[1] * a + dst[1] * keep;
+    dst[2] = c[2] * a + dst[2] * keep;
+    dst[3] = a + dst[3] * keep;
+}
+
+//background: 1/3/4 channel pixels (BGR order when bgr) under the
+//overlay, or null for a transparent buffer. rgba receives straight
+//(non-premultiplied) RGBA rows rgbaStride bytes apart.
+static inline void render(const Markers& markers,const Style& style,int width,int height,
+                          const uint8_t* background,int channels,size_t strideBytes,bool bgr,
+                          uint8_t* rgba,size_t rgbaStride) {
+    if (width <= 0 || height <= 0 || !rgba) throw std::runtime_error("overlay::render: empty target");
+    if (markers.count && (!markers.x || !markers.y || !markers.radius)) throw std::runtime_error("overlay::render: missing marker columns");
+    if (background && channels != 1 && channels != 3 && channels != 4) throw std::runtime_error("overlay::render: channels must be 1, 3 or 4");
+    if (rgbaStride < (size_t)width * 4) throw std::runtime_error("overlay::render: stride smaller than a row");
+
+    const bool withLabels = markers.labels && style.labelPixels > 0.0;
+    GlyphAtlas atlas;
+    if (withLabels) atlas.build(style.labelPixels,style.outlineRadius);
+
+    // ----- Bin marker (kind 0) and label (kind 1) boxes, draw order kept ----- //
+    const int size = std::max(16,style.tileSize);
+    const int columns = (width + size - 1) / size, rows = (height + size - 1) / size;
+    const size_t tiles = (size_t)columns * rows;
+    std::vector<size_t> tileStart(tiles + 1,0);
+    std::vector<uint32_t> entries;
+    auto forTiles = [&](const Box& box,auto&& visit) {
+        const int x0 = std::max(0,box.x0), y0 = std::max(0,box.y0);
+        const int x1 = std::min(width,box.x1), y1 = std::min(height,box.y1);
+        if (x0 >= x1 || y0 >= y1) return;
+        for (int ty = y0 / size; ty <= (y1 - 1) / size; ty++) {
+            for (int tx = x0 / size; tx <= (x1 - 1) / size; tx++) visit((size_t)ty * columns + tx);
+        }
+    };
+    for (int pass = 0; pass < 2; pass++) {
+        std::vector<size_t> cursor;
+        if (pass == 1) {
+            for (size_t t = 0; t < tiles; t++) tileStart[t + 1] += tileStart[t];
+            entries.resize(tileStart[tiles]);
+            cursor.assign(tileStart.begin(),tileStart.end() - 1);
+        }
+        for (size_t i = 0; i < markers.count; i++) {
+            for (int kind = 0; kind < 2; kind++) {
+                Box box;
+                if (kind == 0) {
+                    box = markerBox(markers.x[i],markers.y[i],markers.radius[i]);
+                } else {
+                    if (!withLabels || !markers.labels[i] || !markers.labels[i][0]) continue;
+                    int penX, baseline;
+                    labelOrigin(markers.x[i],markers.y[i],markers.radius[i],penX,baseline);
+                    box = labelBox(atlas,penX,baseline,glyphLength(markers.labels[i]));
+                }
+                const uint32_t entry = (uint32_t)(i << 1) | (uint32_t)kind;
+                forTiles(box,[&](size_t t) {
+                    if (pass == 0) tileStart[t + 1]++;
+                    else entries[cursor[t]++] = entry;
+                });
+            }
+        }
+    }
+
+    const float toUnit = 1.0f / 255.0f;
+    const float markerColor[3] = {style.marker.r * toUnit,style.marker.g * toUnit,style.marker.b * toUnit};
+    const float textColor[3] = {style.text.r * toUnit,style.text.g * toUnit,style.text.b * toUnit};
+    const float outlineColor[3] = {style.outline.r * toUnit,style.outline.g * toUnit,style.outline.b * toUnit};
+    const int r = bgr ? 2 : 0, b = bgr ? 0 : 2;
+
+    // ----- Tiles (parallel) ----- //
+    #ifdef USE_OMP
+    #pragma omp parallel
+    #endif
+    {
+        std::vector<float> buffer((size_t)size * size * 4);
+        #ifdef USE_OMP
+        #pragma omp for schedule(dynamic,4)
+        #endif
+        for (long long t = 0; t < (long long)tiles; t++) {
+            const int tx0 = (int)(t % columns) * size, ty0 = (int)(t / columns) * size;
+            const int tileWidth = std::min(size,width - tx0), tileHeight = std::min(size,height - ty0);
+
+            if (tileStart[t] == tileStart[t + 1]) {
+                for (int y = 0; y < tileHeight; y++) {
+                    uint8_t* out = rgba + (size_t)(ty0 + y) * rgbaStride + (size_t)tx0 * 4;
+                    if (!background) { std::memset(out,0,(size_t)tileWidth * 4); continue; }
+                    const uint8_t* in = background + (size_t)(ty0 + y) * strideBytes + (size_t)tx0 * channels;
+                    for (int x = 0; x < tileWidth; x++, in += channels, out += 4) {
+                        if (channels == 1) { out[0] = out[1] = out[2] = in[0]; }
+                        else { out[0] = in[r]; out[1] = in[1]; out[2] = in[b]; }
+                        out[3] = 255;
+                    }
+                }
+                continue;
+            }
+
+            for (int y = 0; y < tileHeight; y++) {
+                float* dst = &buffer[(size_t)y * size * 4];
+                if (!background) { std::fill(dst,dst + (size_t)tileWidth * 4,0.0f); continue; }
+                const uint8_t* in = background + (size_t)(ty0 + y) * strideBytes + (size_t)tx0 * channels;
+                for (int x = 0; x < tileWidth; x++, in += channels, dst += 4) {
+                    dst[0] = in[channels == 1 ? 0 : r] * toUnit;
+                    dst[1] = in[channels == 1 ? 0 : 1] * toUnit;
+                    dst[2] = in[channels == 1 ? 0 : b] * toUnit;
+                    dst[3] = 1.0f;
+                }
+            }
+
+            for (size_t k = tileStart[t]; k < tileStart[t + 1]; k++) {
+                const size_t i = entries[k] >> 1;
+                const double cx = markers.x[i], cy = markers.y[i], radius = markers.radius[i];
+                if ((entries[k] & 1) == 0) {
+                    const Box box = markerBox(cx,cy,radius);
+                    const int x0 = std::max(box.x0,tx0), x1 = std::min(box.x1,tx0 + tileWidth);
+                    const int y0 = std::max(box.y0,ty0), y1 = std::min(box.y1,ty0 + tileHeight);
+                    const float alpha = style.marker.a * toUnit;
+                    for (int y = y0; y < y1; y++) {
+                        const double dy = y - cy;
+                        float* row = &buffer[((size_t)(y - ty0) * size) * 4];
+                        for (int x = x0; x < x1; x++) {
+                            const double dx = x - cx;
+                            const double coverage = radius + 0.5 - std::sqrt(dx * dx + dy * dy);
+                            if (coverage <= 0.0) continue;
+                            blend(row + (size_t)(x - tx0) * 4,markerColor,alpha * (float)std::min(1.0,coverage));
+                        }
+                    }
+                    continue;
+                }
+
+                int penX, baseline;
+                labelOrigin(cx,cy,radius,penX,baseline);
+                const char* text = markers.labels[i];
+                //Outline under every glyph first, so neighbours never cover a fill:
+                for (int layer = 0; layer < 2; layer++) {
+                    const float* color = layer == 0 ? outlineColor : textColor;
+                    const float alpha = (layer == 0 ? style.outline.a : style.text.a) * toUnit * toUnit;
+                    int glyphX = penX - atlas.pad;
+                    const int glyphY = baseline - atlas.glyphHeight - atlas.pad;
+                    for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+                        if ((*c & 0xC0) == 0x80) continue;
+                        const int glyph = GlyphAtlas::glyphIndex(*c);
+                        const uint8_t* coverage = layer == 0 ? atlas.edgeOf(glyph) : atlas.fillOf(glyph);
+                        const int x0 = std::max(glyphX,tx0), x1 = std::min(glyphX + atlas.width,tx0 + tileWidth);
+                        const int y0 = std::max(glyphY,ty0), y1 = std::min(glyphY + atlas.height,ty0 + tileHeight);
+                        for (int y = y0; y < y1; y++) {
+                            const uint8_t* src = coverage + (size_t)(y - glyphY) * atlas.width - glyphX;
+                            float* row = &buffer[((size_t)(y - ty0) * size) * 4];
+                            for (int x = x0; x < x1; x++) {
+                                if (src[x]) blend(row + (size_t)(x - tx0) * 4,color,alpha * src[x]);
+                            }
+                        }
+                        glyphX += atlas.advance;
+                    }
+                }
+            }
+
+            for (int y = 0; y < tileHeight; y++) {
+                const float* src = &buffer[(size_t)y * size * 4];
+                uint8_t* out = rgba + (size_t)(ty0 + y) * rgbaStride + (size_t)tx0 * 4;
+                for (int x = 0; x < tileWidth; x++, src += 4, out += 4) {
+                    const float a = src[3];
+                    const float scale = a > 0.0f ? 255.0f / a : 0.0f;
+                    out[0] = (uint8_t)std::min(255.0f,src[0] * scale + 0.5f);
+                    out[1] = (uint8_t)std::min(255.0f,src[1] * scale + 0.5f);
+                    out[2] = (uint8_t)std::min(255.0f,src[2] * scale + 0.5f);
+                    out[3] = (uint8_t)std::min(255.0f,a * 255.0f + 0.5f);
+                }
+            }
+        }
+    }
+}
+
+} // namespace overlay
+
+#endif // LIVE_SKYBOXES_OVERLAY_RENDERER_H
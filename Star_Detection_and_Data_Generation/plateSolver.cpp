@@ -0,0 +1,803 @@
+//Stereographic Hemisphere Plate Solver
+//Engine
+//Chris D. | Version 3 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Functional launch
+//  Version 1 (10/18/2026): Detections can be a columnar .stc table
+//      (starColumns.h)
+//  Version 2 (10/18/2026): Quad neighbors come from a HEALPix index
+//      instead of a scan of every star
+//  Version 3 (10/18/2026): Lookups probe ceil(tolerance / bin) bins
+//      per code dimension; --index files are checked against their
+//      size before anything is allocated
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Recovers the ProjectionMeta of a stereographic hemisphere image
+//  (rightAscensionNaught, declinationNaught, positionAngle and the
+//  disc centerX/centerY/radius) from its detected stars and a
+//  reference star catalog, so starDetection.py no longer needs
+//  them typed in by hand.
+//
+//  1. Index: every catalog star and 3 of its nearest neighbors form
+//     a quad. A quad's hash is the position of its two inner stars
+//     in the frame where its widest pair sits at (0,0) and (1,1),
+//     measured in the tangent plane at the quad's center, so it does
+//     not depend on where the quad lies on the sky. Hashes are
+//     stored sorted in a 4-D grid (--buildIndex saves them).
+//  2. Match: quads of the brightest detections are hashed the same
+//     way after lifting pixels onto the sphere with the disc guess.
+//     Each hash hit proposes a rotation, which is verified by
+//     projecting the catalog into the image and counting matches.
+//  3. Refine: Levenberg-Marquardt on the rotation and disc geometry
+//     minimizes pixel residuals of all matched stars.
+//
+//  The model is imageXYtoEquatorial() from starDetection.py:
+//    sky = Rz(RA0) * Rx(90 - Dec0) * Rz(-PA) * inverseStereo(u,v)
+//
+//  Several detection files solve as a sequence; each frame first
+//  tries the previous frame's solution before falling back to hashing.
+
+// ============================================================== //
+// |                     COMPILE BASH SCRIPT                    | //
+// ============================================================== //
+// g++ plateSolver.cpp -o plateSolver -std=c++17 -O3 -Wall
+
+// ============================================================== //
+// |                      INCLUDE / DEFINE                      | //
+// ============================================================== //
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#include "starTable.h"
+#include "healpixIndex.h"
+
+static const std::string kScriptName = "CHRIS'S KIT";
+static constexpr double kDegToRad = M_PI / 180.0;
+static constexpr double kRadToDeg = 180.0 / M_PI;
+
+// ============================================================== //
+// |                        SMALL MATH                          | //
+// ============================================================== //
+struct Vec3 { double x = 0.0, y = 0.0, z = 0.0; };
+using Mat3 = std::array<std::array<double,3>,3>;
+
+static inline Vec3 operator+(Vec3 a,Vec3 b) { return {a.x + b.x,a.y + b.y,a.z + b.z}; }
+static inline Vec3 operator-(Vec3 a,Vec3 b) { return {a.x - b.x,a.y - b.y,a.z - b.z}; }
+static inline Vec3 operator*(Vec3 a,double s) { return {a.x * s,a.y * s,a.z * s}; }
+static inline double dot(Vec3 a,Vec3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+static inline Vec3 cross(Vec3 a,Vec3 b) { return {a.y * b.z - a.z * b.y,a.z * b.x - a.x * b.z,a.x * b.y - a.y * b.x}; }
+static inline Vec3 normalize(Vec3 a) { double n = std::sqrt(dot(a,a)); return n > 0 ? a * (1.0 / n) : a; }
+
+static inline Vec3 mul(const Mat3& m,Vec3 v) {
+    return {m[0][0] * v.x + m[0][1] * v.y + m[0][2] * v.z,
+            m[1][0] * v.x + m[1][1] * v.y + m[1][2] * v.z,
+            m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.z};
+}
+static inline Vec3 mulT(const Mat3& m,Vec3 v) {
+    return {m[0][0] * v.x + m[1][0] * v.y + m[2][0] * v.z,
+            m[0][1] * v.x + m[1][1] * v.y + m[2][1] * v.z,
+            m[0][2] * v.x + m[1][2] * v.y + m[2][2] * v.z};
+}
+static inline Mat3 mul(const Mat3& a,const Mat3& b) {
+    Mat3 m{};
+    for (int i = 0; i < 3; i++) for (int j = 0; j < 3; j++) for (int k = 0; k < 3; k++) m[i][j] += a[i][k] * b[k][j];
+    return m;
+}
+static inline Mat3 rotZ(double a) { double c = std::cos(a), s = std::sin(a); return Mat3{{{c,-s,0},{s,c,0},{0,0,1}}}; }
+static inline Mat3 rotX(double a) { double c = std::cos(a), s = std::sin(a); return Mat3{{{1,0,0},{0,c,-s},{0,s,c}}}; }
+
+//Rotation by the vector w (axis * angle), Rodrigues' formula.
+static inline Mat3 rotVector(Vec3 w) {
+    double angle = std::sqrt(dot(w,w));
+    if (angle < 1e-15) return Mat3{{{1,0,0},{0,1,0},{0,0,1}}};
+    Vec3 k = w * (1.0 / angle);
+    double c = std::cos(angle), s = std::sin(angle), t = 1.0 - c;
+    return Mat3{{{t * k.x * k.x + c,t * k.x * k.y - s * k.z,t * k.x * k.z + s * k.y},
+                 {t * k.x * k.y + s * k.z,t * k.y * k.y + c,t * k.y * k.z - s * k.x},
+                 {t * k.x * k.z - s * k.y,t * k.y * k.z + s * k.x,t * k.z * k.z + c}}};
+}
+
+static inline Vec3 raDecToVec(double ra,double dec) {
+    double r = ra * kDegToRad, d = dec * kDegToRad;
+    return {std::cos(d) * std::cos(r),std::cos(d) * std::sin(r),std::sin(d)};
+}
+
+// ============================================================== //
+// |                    PROJECTION GEOMETRY                     | //
+// ============================================================== //
+struct Disc { double centerX = 0.0, centerY = 0.0, radius = 1.0; };
+
+struct Solution {
+    Mat3 rotation{};            // Camera sphere -> equatorial
+    Disc disc;
+    double rightAscensionNaught = 0.0, declinationNaught = 90.0, positionAngle = 0.0;
+    int matches = 0;
+    double rmsPixels = 0.0;
+    bool solved = false;
+};
+
+static inline Vec3 pixelToCamera(const Disc& disc,double x,double y) {
+    double u = (x - disc.centerX) / disc.radius, v = (disc.centerY - y) / disc.radius;
+    double r2 = u * u + v * v, denom = 1.0 + r2;
+    return {2.0 * u / denom,2.0 * v / denom,(1.0 - r2) / denom};
+}
+
+//False for directions too far behind the disc to land near it.
+static inline bool cameraToPixel(const Disc& disc,Vec3 c,double& x,double& y) {
+    if (c.z < -0.3) return false;
+    double u = c.x / (1.0 + c.z), v = c.y / (1.0 + c.z);
+    x = disc.centerX + u * disc.radius;
+    y = disc.centerY - v * disc.radius;
+    return true;
+}
+
+static Mat3 metaToRotation(double ra0,double dec0,double positionAngle) {
+    return mul(mul(rotZ(ra0 * kDegToRad),rotX((90.0 - dec0) * kDegToRad)),rotZ(-positionAngle * kDegToRad));
+}
+
+//Inverts metaToRotation() as Z-X-Z Euler angles. Within ~0.1° of a pole only
+//RA0 -/+ PA is defined, so the hinted PA is kept.
+static void rotationToMeta(Solution& solution,double hintPositionAngle) {
+    const Mat3& m = solution.rotation;
+    double tilt = std::acos(std::max(-1.0,std::min(1.0,m[2][2])));
+    double a, b;
+    if (std::sin(tilt) > 2e-3) {
+        a = std::atan2(m[0][2],-m[1][2]);
+        b = std::atan2(m[2][0],m[2][1]);
+    } else {
+        b = -hintPositionAngle * kDegToRad;
+        double phi = std::atan2(m[1][0],m[0][0]);
+        a = (m[2][2] > 0) ? phi - b : phi + b;
+    }
+    auto wrap = [](double degrees) { degrees = std::fmod(degrees,360.0); return degrees < 0 ? degrees + 360.0 : degrees; };
+    solution.rightAscensionNaught = wrap(a * kRadToDeg);
+    solution.declinationNaught = 90.0 - tilt * kRadToDeg;
+    solution.positionAngle = wrap(-b * kRadToDeg);
+}
+
+// ============================================================== //
+// |                        QUAD HASHES                         | //
+// ============================================================== //
+static constexpr double kCodeMin = -0.5;   // Inner stars lie within [-0.21,1.21]
+
+struct Quad {
+    uint32_t star[4];           // A, B (widest pair), C, D
+    float code[4];              // xC, yC, xD, yD
+    uint32_t key;               // Quantized code, 8 bits per dimension
+};
+
+static inline uint32_t quantize(double value,double bin) {
+    long q = (long)std::floor((value - kCodeMin) / bin);
+    return (uint32_t)std::max(0L,std::min(255L,q));
+}
+
+static inline uint32_t codeKey(const float code[4],double bin) {
+    return (quantize(code[0],bin) << 24) | (quantize(code[1],bin) << 16) | (quantize(code[2],bin) << 8) | quantize(code[3],bin);
+}
+
+//Hashes 4 unit vectors. Returns false for quads whose inner stars fall
+//outside the circle on the widest pair (their code is not stable).
+static bool hashQuad(const Vec3 v[4],const uint32_t ids[4],Quad& quad) {
+    // ----- Widest pair ----- //
+    int ia = 0, ib = 1;
+    double best = 2.0;
+    for (int i = 0; i < 4; i++) for (int j = i + 1; j < 4; j++) {
+        double d = dot(v[i],v[j]);
+        if (d < best) { best = d; ia = i; ib = j; }
+    }
+    int rest[2], n = 0;
+    for (int i = 0; i < 4; i++) if (i != ia && i != ib) rest[n++] = i;
+
+    // ----- Tangent plane at the quad center ----- //
+    Vec3 center = normalize(v[0] + v[1] + v[2] + v[3]);
+    Vec3 e1 = normalize(cross(std::fabs(center.z) < 0.9 ? Vec3{0,0,1} : Vec3{1,0,0},center));
+    Vec3 e2 = cross(center,e1);
+    double px[4], py[4];
+    for (int i = 0; i < 4; i++) {
+        double w = dot(v[i],center);
+        if (w <= 0.0) return false;
+        px[i] = dot(v[i],e1) / w;
+        py[i] = dot(v[i],e2) / w;
+    }
+
+    //z' = (z - A) / (B - A) * (1 + i) maps A to 0 and B to 1 + i.
+    double bx = px[ib] - px[ia], by = py[ib] - py[ia];
+    double scale = bx * bx + by * by;
+    if (scale <= 0.0) return false;
+    double code[4];
+    for (int k = 0; k < 2; k++) {
+        double zx = px[rest[k]] - px[ia], zy = py[rest[k]] - py[ia];
+        double qx = (zx * bx + zy * by) / scale, qy = (zy * bx - zx * by) / scale;
+        code[2 * k] = qx - qy;
+        code[2 * k + 1] = qx + qy;
+        double dx = code[2 * k] - 0.5, dy = code[2 * k + 1] - 0.5;
+        if (dx * dx + dy * dy > 0.5) return false;
+    }
+
+    // ----- Symmetry breaking: xC + xD <= 1, then xC <= xD ----- //
+    uint32_t a = ids[ia], b = ids[ib], c = ids[rest[0]], d = ids[rest[1]];
+    if (code[0] + code[2] > 1.0) {
+        std::swap(a,b);
+        for (double& value : code) value = 1.0 - value;
+    }
+    if (code[0] > code[2]) {
+        std::swap(c,d);
+        std::swap(code[0],code[2]);
+        std::swap(code[1],code[3]);
+    }
+    quad.star[0] = a; quad.star[1] = b; quad.star[2] = c; quad.star[3] = d;
+    for (int i = 0; i < 4; i++) quad.code[i] = (float)code[i];
+    return true;
+}
+
+//Quads of each star with every 3 of its nearest neighbors.
+static std::vector<Quad> buildQuads(const std::vector<Vec3>& points,int neighbors,double bin) {
+    std::vector<Quad> quads;
+    std::vector<healpix::Vec> unit(points.size());
+    for (size_t i = 0; i < points.size(); i++) unit[i] = {points[i].x,points[i].y,points[i].z};
+    healpix::Index sky;
+    sky.build(unit);
+
+    //Candidates from the index, re-ranked on the original vectors so
+    //ties break exactly as a full scan would (a spare covers rounding).
+    std::vector<std::pair<double,uint32_t>> candidates, near;
+    for (uint32_t i = 0; i < points.size(); i++) {
+        sky.nearestK(unit[i],(size_t)std::max(neighbors,0) + 2,candidates);
+        near.clear();
+        for (const std::pair<double,uint32_t>& candidate : candidates) {
+            uint32_t j = candidate.second;
+            if (j != i) near.emplace_back(-dot(points[i],points[j]),j);
+        }
+        size_t count = std::min<size_t>(neighbors,near.size());
+        if (count < 3) continue;
+        std::partial_sort(near.begin(),near.begin() + count,near.end());
+        for (size_t a = 0; a < count; a++) for (size_t b = a + 1; b < count; b++) for (size_t c = b + 1; c < count; c++) {
+            uint32_t ids[4] = {i,near[a].second,near[b].second,near[c].second};
+            Vec3 v[4] = {points[ids[0]],points[ids[1]],points[ids[2]],points[ids[3]]};
+            Quad quad;
+            if (!hashQuad(v,ids,quad)) continue;
+            quad.key = codeKey(quad.code,bin);
+            quads.push_back(quad);
+        }
+    }
+    return quads;
+}
+
+// ============================================================== //
+// |                         QUAD INDEX                         | //
+// ============================================================== //
+//  .psi layout (little-endian):
+//    char magic[8] "LSPSIDX1" | uint32 starCount | uint32 quadCount
+//    double bin | double[3] per star (unit vector) | Quad[quadCount]
+struct QuadIndex {
+    std::vector<Vec3> stars;
+    std::vector<Quad> quads;    // Sorted by key
+    double bin = 0.02;
+    static constexpr int kMaxProbeBins = 3;    // (2 * 3 + 1)^4 keys per probe at most
+
+    void sortQuads() {
+        std::sort(quads.begin(),quads.end(),[](const Quad& a,const Quad& b) { return a.key < b.key; });
+    }
+
+    //Bins to probe on each side so every code within tolerance is reached.
+    int probeBins(double tolerance) const { return std::max(1,(int)std::ceil(tolerance / bin - 1e-9)); }
+
+    template <class Visit>
+    void lookup(const Quad& probe,double tolerance,Visit visit) const {
+        const int r = probeBins(tolerance);
+        uint32_t q[4];
+        for (int i = 0; i < 4; i++) q[i] = quantize(probe.code[i],bin);
+        for (int d0 = -r; d0 <= r; d0++) for (int d1 = -r; d1 <= r; d1++)
+        for (int d2 = -r; d2 <= r; d2++) for (int d3 = -r; d3 <= r; d3++) {
+            long k0 = (long)q[0] + d0, k1 = (long)q[1] + d1, k2 = (long)q[2] + d2, k3 = (long)q[3] + d3;
+            if (k0 < 0 || k1 < 0 || k2 < 0 || k3 < 0 || k0 > 255 || k1 > 255 || k2 > 255 || k3 > 255) continue;
+            uint32_t key = (uint32_t)((k0 << 24) | (k1 << 16) | (k2 << 8) | k3);
+            auto range = std::equal_range(quads.begin(),quads.end(),key,KeyLess());
+            for (auto it = range.first; it != range.second; ++it) {
+                double e = 0.0;
+                for (int i = 0; i < 4; i++) e += (it->code[i] - probe.code[i]) * (it->code[i] - probe.code[i]);
+                if (e <= tolerance * tolerance) visit(*it);
+            }
+        }
+    }
+
+    struct KeyLess {
+        bool operator()(const Quad& a,uint32_t key) const { return a.key < key; }
+        bool operator()(uint32_t key,const Quad& a) const { return key < a.key; }
+    };
+};
+
+static QuadIndex buildIndex(const StarTable& catalog,size_t indexStars,int neighbors,double bin) {
+    QuadIndex index;
+    index.bin = bin;
+    size_t count = std::min(indexStars,catalog.size());
+    for (size_t i = 0; i < count; i++) index.stars.push_back(raDecToVec(catalog.rightAscension[i],catalog.declination[i]));
+    index.quads = buildQuads(index.stars,neighbors,bin);
+    index.sortQuads();
+    return index;
+}
+
+static void saveIndex(const std::string& path,const QuadIndex& index) {
+    std::ofstream file(path,std::ios::binary);
+    if (!file) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + path);
+    uint32_t starCount = (uint32_t)index.stars.size(), quadCount = (uint32_t)index.quads.size();
+    file.write("LSPSIDX1",8);
+    file.write((const char*)&starCount,4);
+    file.write((const char*)&quadCount,4);
+    file.write((const char*)&index.bin,8);
+    for (const Vec3& star : index.stars) file.write((const char*)&star,sizeof(Vec3));
+    file.write((const char*)index.quads.data(),(std::streamsize)(index.quads.size() * sizeof(Quad)));
+    if (!file) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + path);
+}
+
+static QuadIndex loadIndex(const std::string& path) {
+    std::ifstream file(path,std::ios::binary);
+    if (!file) throw std::runtime_error("[" + kScriptName + "]: Failed to open index: " + path);
+    char magic[8];
+    uint32_t starCount = 0, quadCount = 0;
+    QuadIndex index;
+    file.read(magic,8);
+    if (!file || std::memcmp(magic,"LSPSIDX1",8) != 0) throw std::runtime_error("[" + kScriptName + "]: Not a plate-solver index: " + path);
+    file.read((char*)&starCount,4);
+    file.read((char*)&quadCount,4);
+    file.read((char*)&index.bin,8);
+    if (!file) throw std::runtime_error("[" + kScriptName + "]: Truncated index: " + path);
+    if (!(index.bin > 0.0) || !std::isfinite(index.bin)) throw std::runtime_error("[" + kScriptName + "]: Bad code bin in index: " + path);
+
+    //Counts must account for the file exactly before anything is allocated.
+    const std::streamoff headerBytes = file.tellg();
+    file.seekg(0,std::ios::end);
+    const uint64_t fileBytes = (uint64_t)file.tellg();
+    file.seekg(headerBytes);
+    const uint64_t expectedBytes = (uint64_t)headerBytes + (uint64_t)starCount * sizeof(Vec3) + (uint64_t)quadCount * sizeof(Quad);
+    if (!file || fileBytes != expectedBytes) {
+        throw std::runtime_error("[" + kScriptName + "]: Index size does not match its " + std::to_string(starCount) + " stars and " +
+                                 std::to_string(quadCount) + " quads: " + path);
+    }
+    index.stars.resize(starCount);
+    index.quads.resize(quadCount);
+    file.read((char*)index.stars.data(),(std::streamsize)(starCount * sizeof(Vec3)));
+    file.read((char*)index.quads.data(),(std::streamsize)(quadCount * sizeof(Quad)));
+    if (!file) throw std::runtime_error("[" + kScriptName + "]: Truncated index: " + path);
+    for (const Quad& quad : index.quads) {
+        for (int i = 0; i < 4; i++) {
+            if (quad.star[i] >= starCount) throw std::runtime_error("[" + kScriptName + "]: Quad star out of range in index: " + path);
+        }
+    }
+    return index;
+}
+
+// ============================================================== //
+// |                         DETECTIONS                         | //
+// ============================================================== //
+struct Detections {
+    std::vector<double> x, y;   // Brightest first
+};
+
+//Text detections: xpix/ypix (starDetection.py exports) or centerX/centerY,
+//with the sum/flux column when present (else -row, keeping file order).
+static std::vector<std::array<double,3>> loadDetectionRows(const std::string& path) {
+    std::ifstream file(path,std::ios::binary);
+    if (!file) throw std::runtime_error("[" + kScriptName + "]: Failed to open detections: " + path);
+    std::string line;
+    if (!std::getline(file,line)) throw std::runtime_error("[" + kScriptName + "]: Empty detections: " + path);
+    std::vector<std::string> header = splitTabs(line);
+    auto column = [&](std::initializer_list<const char*> names) {
+        for (const char* name : names) for (size_t i = 0; i < header.size(); i++) if (header[i] == name) return (int)i;
+        return -1;
+    };
+    int xCol = column({"xpix","centerX","x"}), yCol = column({"ypix","centerY","y"});
+    int fluxCol = column({"sum","flux"});
+    if (xCol < 0 || yCol < 0) throw std::runtime_error("[" + kScriptName + "]: Detections need xpix and ypix columns: " + path);
+
+    std::vector<std::array<double,3>> rows;
+    while (std::getline(file,line)) {
+        if (line.empty() || line == "\r") continue;
+        std::vector<std::string> fields = splitTabs(line);
+        if (xCol >= (int)fields.size() || yCol >= (int)fields.size()) continue;
+        double flux = (fluxCol >= 0 && fluxCol < (int)fields.size()) ? std::atof(fields[fluxCol].c_str()) : -(double)rows.size();
+        rows.push_back({std::atof(fields[xCol].c_str()),std::atof(fields[yCol].c_str()),flux});
+    }
+    return rows;
+}
+
+//Reads text detections or a columnar .stc table (x, y, optional flux),
+//brightest first.
+static Detections loadDetections(const std::string& path,size_t maxDetections) {
+    std::vector<std::array<double,3>> rows;
+    if (StarColumnsFile::probe(path)) {
+        StarColumnsFile columns(path);
+        if (!columns.has("x") || !columns.has("y")) throw std::runtime_error("[" + kScriptName + "]: Detections need x and y columns: " + path);
+        ColumnSpan<double> x = columns.float64("x"), y = columns.float64("y");
+        ColumnSpan<double> flux = columns.has("flux") ? columns.float64("flux") : ColumnSpan<double>();
+        rows.reserve(columns.rows());
+        for (size_t i = 0; i < columns.rows(); i++) rows.push_back({x[i],y[i],flux.empty() ? -(double)i : flux[i]});
+    } else {
+        rows = loadDetectionRows(path);
+    }
+    std::stable_sort(rows.begin(),rows.end(),[](const std::array<double,3>& a,const std::array<double,3>& b) { return a[2] > b[2]; });
+    Detections detections;
+    for (size_t i = 0; i < rows.size() && i < maxDetections; i++) {
+        detections.x.push_back(rows[i][0]);
+        detections.y.push_back(rows[i][1]);
+    }
+    return detections;
+}
+
+// ============================================================== //
+// |                  VERIFICATION AND REFINEMENT               | //
+// ============================================================== //
+struct Options {
+    std::vector<std::string> detectionPaths;
+    std::string catalogPath;
+    std::string indexPath;
+    std::string buildIndexPath;
+    std::string outPath;
+    int width = 0, height = 0;
+    double centerX = NAN, centerY = NAN, radius = NAN;
+    double rightAscensionHint = NAN, declinationHint = NAN;
+    double positionAngleHint = 0.0;
+    size_t maxDetections = 40;
+    size_t indexStars = 0;          // 0 = 2.5 * maxDetections
+    int neighbors = 7;
+    double codeTolerance = 0.02;
+    double matchPixels = 0.0;       // 0 = 1% of the disc radius
+    int minMatches = 8;
+    bool fixDisc = false;
+};
+
+//Pairs each catalog star that lands in the disc with its nearest
+//detection inside the match radius (one catalog star per detection).
+struct Matcher {
+    const QuadIndex& index;
+    const Detections& detections;
+    std::vector<std::pair<uint32_t,uint32_t>> pairs;   // (detection, star)
+
+    int match(const Mat3& rotation,const Disc& disc,double radiusPixels) {
+        pairs.clear();
+        std::vector<double> bestDistance(detections.x.size(),radiusPixels * radiusPixels);
+        std::vector<int> bestStar(detections.x.size(),-1);
+        for (uint32_t s = 0; s < index.stars.size(); s++) {
+            Vec3 c = mulT(rotation,index.stars[s]);
+            double x, y;
+            if (!cameraToPixel(disc,c,x,y)) continue;
+            for (size_t d = 0; d < detections.x.size(); d++) {
+                double dx = detections.x[d] - x, dy = detections.y[d] - y;
+                double e = dx * dx + dy * dy;
+                if (e < bestDistance[d]) { bestDistance[d] = e; bestStar[d] = (int)s; }
+            }
+        }
+        for (size_t d = 0; d < detections.x.size(); d++) {
+            if (bestStar[d] >= 0) pairs.emplace_back((uint32_t)d,(uint32_t)bestStar[d]);
+        }
+        return (int)pairs.size();
+    }
+};
+
+//Rotation taking camera vectors a,b onto sky vectors A,B (TRIAD).
+static Mat3 triad(Vec3 a,Vec3 b,Vec3 skyA,Vec3 skyB) {
+    Vec3 c1 = a, c2 = normalize(cross(a,b)), c3 = cross(c1,c2);
+    Vec3 s1 = skyA, s2 = normalize(cross(skyA,skyB)), s3 = cross(s1,s2);
+    Mat3 m{};
+    for (int i = 0; i < 3; i++) {
+        double si[3] = {(&s1.x)[i],(&s2.x)[i],(&s3.x)[i]};
+        for (int j = 0; j < 3; j++) {
+            m[i][j] = si[0] * (&c1.x)[j] + si[1] * (&c2.x)[j] + si[2] * (&c3.x)[j];
+        }
+    }
+    return m;
+}
+
+//Levenberg-Marquardt on (rotation vector, centerX, centerY, radius).
+static double refine(Solution& solution,const Matcher& matcher,const Detections& detections,bool fixDisc) {
+    const int parameters = fixDisc ? 3 : 6;
+    auto residuals = [&](const Mat3& rotation,const Disc& disc,std::vector<double>& out) {
+        out.clear();
+        for (const auto& pair : matcher.pairs) {
+            double x, y;
+            Vec3 c = mulT(rotation,matcher.index.stars[pair.second]);
+            if (!cameraToPixel(disc,c,x,y)) { x = 1e6; y = 1e6; }
+            out.push_back(x - detections.x[pair.first]);
+            out.push_back(y - detections.y[pair.first]);
+        }
+    };
+    auto apply = [&](const double* p,Mat3& rotation,Disc& disc) {
+        rotation = mul(solution.rotation,rotVector({p[0],p[1],p[2]}));
+        disc = solution.disc;
+        if (parameters == 6) { disc.centerX += p[3]; disc.centerY += p[4]; disc.radius += p[5]; }
+    };
+    auto cost = [](const std::vector<double>& r) { double s = 0.0; for (double v : r) s += v * v; return s; };
+
+    std::vector<double> r0, r1;
+    residuals(solution.rotation,solution.disc,r0);
+    double current = cost(r0), lambda = 1e-3;
+    const double steps[6] = {1e-7,1e-7,1e-7,1e-4,1e-4,1e-4};
+    for (int iteration = 0; iteration < 20; iteration++) {
+        // ----- Numeric Jacobian ----- //
+        std::vector<std::vector<double>> jacobian(parameters);
+        for (int k = 0; k < parameters; k++) {
+            double p[6] = {0,0,0,0,0,0};
+            p[k] = steps[k];
+            Mat3 rotation; Disc disc;
+            apply(p,rotation,disc);
+            residuals(rotation,disc,r1);
+            jacobian[k].resize(r1.size());
+            for (size_t i = 0; i < r1.size(); i++) jacobian[k][i] = (r1[i] - r0[i]) / steps[k];
+        }
+        double a[6][7] = {};
+        for (int i = 0; i < parameters; i++) {
+            for (int j = 0; j < parameters; j++) {
+                double s = 0.0;
+                for (size_t n = 0; n < r0.size(); n++) s += jacobian[i][n] * jacobian[j][n];
+                a[i][j] = s;
+            }
+            double g = 0.0;
+            for (size_t n = 0; n < r0.size(); n++) g += jacobian[i][n] * r0[n];
+            a[i][parameters] = -g;
+        }
+        for (int i = 0; i < parameters; i++) a[i][i] *= (1.0 + lambda);
+
+        // ----- Gaussian elimination with partial pivoting ----- //
+        bool singular = false;
+        for (int col = 0; col < parameters && !singular; col++) {
+            int pivot = col;
+            for (int row = col + 1; row < parameters; row++) if (std::fabs(a[row][col]) > std::fabs(a[pivot][col])) pivot = row;
+            if (std::fabs(a[pivot][col]) < 1e-300) { singular = true; break; }
+            for (int k = 0; k <= parameters; k++) std::swap(a[col][k],a[pivot][k]);
+            for (int row = 0; row < parameters; row++) {
+                if (row == col) continue;
+                double f = a[row][col] / a[col][col];
+                for (int k = col; k <= parameters; k++) a[row][k] -= f * a[col][k];
+            }
+        }
+        if (singular) break;
+        double p[6] = {0,0,0,0,0,0};
+        for (int i = 0; i < parameters; i++) p[i] = a[i][parameters] / a[i][i];
+
+        Mat3 rotation; Disc disc;
+        apply(p,rotation,disc);
+        residuals(rotation,disc,r1);
+        double next = cost(r1);
+        if (next < current) {
+            solution.rotation = rotation;
+            solution.disc = disc;
+            bool done = (current - next) < 1e-10 * (current + 1e-12);
+            current = next;
+            r0.swap(r1);
+            lambda = std::max(lambda * 0.3,1e-9);
+            if (done) break;
+        } else {
+            lambda *= 10.0;
+            if (lambda > 1e8) break;
+        }
+    }
+    return matcher.pairs.empty() ? 0.0 : std::sqrt(current / matcher.pairs.size());
+}
+
+// ============================================================== //
+// |                          SOLVING                           | //
+// ============================================================== //
+//Refines a candidate with alternating re-matching and least squares.
+static void polish(Solution& solution,Matcher& matcher,const Detections& detections,const Options& opt,double matchPixels) {
+    for (int round = 0; round < 3; round++) {
+        solution.matches = matcher.match(solution.rotation,solution.disc,matchPixels);
+        if (solution.matches < 3) return;
+        bool fixDisc = opt.fixDisc || solution.matches < opt.minMatches;
+        solution.rmsPixels = refine(solution,matcher,detections,fixDisc);
+    }
+    solution.matches = matcher.match(solution.rotation,solution.disc,matchPixels);
+}
+
+static Solution solveFrame(const QuadIndex& index,const Detections& detections,const Disc& guess,
+                           const Solution* previous,const Options& opt) {
+    const double matchPixels = opt.matchPixels > 0.0 ? opt.matchPixels : std::max(2.0,0.01 * guess.radius);
+    Matcher matcher{index,detections,{}};
+    Solution best;
+    best.disc = guess;
+
+    // ----- Previous frame first ----- //
+    if (previous && previous->solved) {
+        Solution candidate = *previous;
+        if (!(candidate.disc.radius > 1.0)) candidate.disc = guess;
+        polish(candidate,matcher,detections,opt,matchPixels);
+        if (candidate.matches >= opt.minMatches) {
+            candidate.solved = true;
+            rotationToMeta(candidate,previous->positionAngle);
+            return candidate;
+        }
+    }
+
+    // ----- Hash the detections ----- //
+    std::vector<Vec3> camera(detections.x.size());
+    for (size_t i = 0; i < camera.size(); i++) camera[i] = pixelToCamera(guess,detections.x[i],detections.y[i]);
+    std::vector<Quad> probes = buildQuads(camera,opt.neighbors,index.bin);
+
+    const double cornerCos = std::cos(std::max(0.05,3.0 * matchPixels / guess.radius));
+    const int enough = std::max(opt.minMatches,(int)(0.5 * detections.x.size()));
+    for (const Quad& probe : probes) {
+        bool stop = false;
+        index.lookup(probe,opt.codeTolerance,[&](const Quad& hit) {
+            if (stop) return;
+            //Probe A/B could pair with hit B/A when xC + xD is close to 1.
+            for (int flip = 0; flip < 2; flip++) {
+                uint32_t pa = probe.star[flip ? 1 : 0], pb = probe.star[flip ? 0 : 1];
+                Mat3 rotation = triad(camera[pa],camera[pb],index.stars[hit.star[0]],index.stars[hit.star[1]]);
+                // ----- Cheap check on the inner stars ----- //
+                Vec3 c = mul(rotation,camera[probe.star[2]]);
+                Vec3 d = mul(rotation,camera[probe.star[3]]);
+                if (dot(c,index.stars[hit.star[2]]) < cornerCos || dot(d,index.stars[hit.star[3]]) < cornerCos) continue;
+
+                Solution candidate;
+                candidate.rotation = rotation;
+                candidate.disc = guess;
+                int matches = matcher.match(rotation,guess,matchPixels * 3.0);
+                if (matches < std::min(opt.minMatches,best.matches + 1)) continue;
+                polish(candidate,matcher,detections,opt,matchPixels);
+                if (candidate.matches > best.matches) {
+                    best = candidate;
+                    if (best.matches >= enough) stop = true;
+                }
+            }
+        });
+        if (stop) break;
+    }
+    best.solved = best.matches >= opt.minMatches;
+    if (best.solved) rotationToMeta(best,opt.positionAngleHint);
+    return best;
+}
+
+// ============================================================== //
+// |                        CLI PARSING                         | //
+// ============================================================== //
+static void usage(const char* argv0) {
+    std::fprintf(stderr,
+        "Usage: %s <detections.txt> [more frames...] (--catalog <starTable.txt> | --index <file.psi>)\n"
+        "     --width <px> --height <px>       (disc guess: centered, radius = min/2)\n"
+        "     [--centerX <px>] [--centerY <px>] [--radius <px>] [--fixDisc]\n"
+        "     [--rightAscensionNaught <deg> --declinationNaught <deg>] (tried before hashing)\n"
+        "     [--positionAngle <deg>] (kept when the disc is centered on a pole, default 0)\n"
+        "     [--maxDetections N] (default 40) [--indexStars N] (default 2.5 x maxDetections)\n"
+        "     [--neighbors N] (default 7) [--codeTolerance <t>] (default 0.02)\n"
+        "     [--matchPixels <px>] (default 1%% of radius) [--minMatches N] (default 8)\n"
+        "     [--buildIndex <file.psi>] (save the catalog index; detections optional)\n"
+        "     [--out <solutions.tsv>]\n",
+        argv0);
+}
+
+static Options parseArguments(int argc,char** argv) {
+    Options opt;
+    if (argc < 2) {
+        usage(argv[0]);
+        std::exit(1);
+    }
+    for (int i = 1; i < argc; i++) {
+        std::string key = argv[i];
+        auto need = [&](bool has) { if (!has) throw std::runtime_error("[" + kScriptName + "]: Missing value for " + key); };
+        if (key.rfind("--",0) != 0) { opt.detectionPaths.push_back(key); continue; }
+        if (key == "--catalog") { need(i + 1 < argc); opt.catalogPath = argv[++i]; }
+        else if (key == "--index") { need(i + 1 < argc); opt.indexPath = argv[++i]; }
+        else if (key == "--buildIndex") { need(i + 1 < argc); opt.buildIndexPath = argv[++i]; }
+        else if (key == "--out") { need(i + 1 < argc); opt.outPath = argv[++i]; }
+        else if (key == "--width") { need(i + 1 < argc); opt.width = std::stoi(argv[++i]); }
+        else if (key == "--height") { need(i + 1 < argc); opt.height = std::stoi(argv[++i]); }
+        else if (key == "--centerX") { need(i + 1 < argc); opt.centerX = std::stod(argv[++i]); }
+        else if (key == "--centerY") { need(i + 1 < argc); opt.centerY = std::stod(argv[++i]); }
+        else if (key == "--radius") { need(i + 1 < argc); opt.radius = std::stod(argv[++i]); }
+        else if (key == "--fixDisc") { opt.fixDisc = true; }
+        else if (key == "--rightAscensionNaught") { need(i + 1 < argc); opt.rightAscensionHint = std::stod(argv[++i]); }
+        else if (key == "--declinationNaught") { need(i + 1 < argc); opt.declinationHint = std::stod(argv[++i]); }
+        else if (key == "--positionAngle") { need(i + 1 < argc); opt.positionAngleHint = std::stod(argv[++i]); }
+        else if (key == "--maxDetections") { need(i + 1 < argc); opt.maxDetections = (size_t)std::stoll(argv[++i]); }
+        else if (key == "--indexStars") { need(i + 1 < argc); opt.indexStars = (size_t)std::stoll(argv[++i]); }
+        else if (key == "--neighbors") { need(i + 1 < argc); opt.neighbors = std::stoi(argv[++i]); }
+        else if (key == "--codeTolerance") { need(i + 1 < argc); opt.codeTolerance = std::stod(argv[++i]); }
+        else if (key == "--matchPixels") { need(i + 1 < argc); opt.matchPixels = std::stod(argv[++i]); }
+        else if (key == "--minMatches") { need(i + 1 < argc); opt.minMatches = std::stoi(argv[++i]); }
+        else { usage(argv[0]); throw std::runtime_error("[" + kScriptName + "]: Unknown argument: " + key); }
+    }
+    if (opt.catalogPath.empty() && opt.indexPath.empty()) throw std::runtime_error("[" + kScriptName + "]: --catalog or --index is required.");
+    if (opt.detectionPaths.empty() && opt.buildIndexPath.empty()) throw std::runtime_error("[" + kScriptName + "]: No detection files given.");
+    if (opt.indexStars == 0) opt.indexStars = (size_t)(2.5 * opt.maxDetections);
+    if (opt.neighbors < 3) throw std::runtime_error("[" + kScriptName + "]: --neighbors must be at least 3.");
+    if (!(opt.codeTolerance > 0.0)) throw std::runtime_error("[" + kScriptName + "]: --codeTolerance must be positive.");
+    return opt;
+}
+
+// ============================================================== //
+// |                        MAIN PROGRAM                        | //
+// ============================================================== //
+int main(int argc,char** argv) {
+    try {
+        Options opt = parseArguments(argc,argv);
+        auto t0 = std::chrono::steady_clock::now();
+        QuadIndex index = opt.indexPath.empty()
+            ? buildIndex(loadStarTable(opt.catalogPath),opt.indexStars,opt.neighbors,opt.codeTolerance)
+            : loadIndex(opt.indexPath);
+        auto t1 = std::chrono::steady_clock::now();
+        if (index.probeBins(opt.codeTolerance) > QuadIndex::kMaxProbeBins) {
+            throw std::runtime_error("[" + kScriptName + "]: --codeTolerance " + std::to_string(opt.codeTolerance) +
+                                     " is more than " + std::to_string(QuadIndex::kMaxProbeBins) + "x the index bin (" +
+                                     std::to_string(index.bin) + "); rebuild the index with this tolerance");
+        }
+        std::printf("[%s] Index: %zu stars, %zu quads (%.1f ms)\n",kScriptName.c_str(),index.stars.size(),
+                    index.quads.size(),std::chrono::duration<double,std::milli>(t1 - t0).count());
+        if (!opt.buildIndexPath.empty()) {
+            saveIndex(opt.buildIndexPath,index);
+            std::printf("Wrote: %s\n",opt.buildIndexPath.c_str());
+        }
+        if (opt.detectionPaths.empty()) return 0;
+
+        FILE* out = nullptr;
+        if (!opt.outPath.empty()) {
+            out = std::fopen(opt.outPath.c_str(),"wb");
+            if (!out) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + opt.outPath);
+            std::fprintf(out,"frame\tsolved\trightAscensionNaught\tdeclinationNaught\tpositionAngle\tcenterX\tcenterY\tradius\tmatches\trmsPixels\tms\n");
+        }
+
+        //A typed-in meta seeds the first frame like a previous solution.
+        Solution previous;
+        if (!std::isnan(opt.rightAscensionHint) && !std::isnan(opt.declinationHint)) {
+            previous.rotation = metaToRotation(opt.rightAscensionHint,opt.declinationHint,opt.positionAngleHint);
+            previous.positionAngle = opt.positionAngleHint;
+            previous.solved = true;
+        }
+        int solvedFrames = 0;
+        for (const std::string& path : opt.detectionPaths) {
+            auto start = std::chrono::steady_clock::now();
+            Detections detections = loadDetections(path,opt.maxDetections);
+            Disc guess;
+            if (opt.width > 0 && opt.height > 0) {
+                guess.centerX = opt.width / 2.0;
+                guess.centerY = opt.height / 2.0;
+                guess.radius = std::min(opt.width,opt.height) / 2.0;
+            }
+            if (!std::isnan(opt.centerX)) guess.centerX = opt.centerX;
+            if (!std::isnan(opt.centerY)) guess.centerY = opt.centerY;
+            if (!std::isnan(opt.radius)) guess.radius = opt.radius;
+            if (!(guess.radius > 1.0)) throw std::runtime_error("[" + kScriptName + "]: Give --width/--height or --radius.");
+
+            Solution solution = solveFrame(index,detections,guess,&previous,opt);
+            double ms = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (solution.solved) {
+                previous = solution;
+                solvedFrames++;
+                std::printf("SOLVED %s rightAscensionNaught=%.6f declinationNaught=%.6f positionAngle=%.6f "
+                            "centerX=%.3f centerY=%.3f radius=%.3f matches=%d rmsPixels=%.3f ms=%.1f\n",
+                            path.c_str(),solution.rightAscensionNaught,solution.declinationNaught,solution.positionAngle,
+                            solution.disc.centerX,solution.disc.centerY,solution.disc.radius,solution.matches,solution.rmsPixels,ms);
+            } else {
+                std::printf("FAILED %s best matches=%d ms=%.1f\n",path.c_str(),solution.matches,ms);
+            }
+            if (out) {
+                std::fprintf(out,"%s\t%d\t%.6f\t%.6f\t%.6f\t%.3f\t%.3f\t%.3f\t%d\t%.3f\t%.1f\n",path.c_str(),solution.solved ? 1 : 0,
+                             solution.rightAscensionNaught,solution.declinationNaught,solution.positionAngle,
+                             solution.disc.centerX,solution.disc.centerY,solution.disc.radius,solution.matches,solution.rmsPixels,ms);
+            }
+        }
+        if (out && std::fclose(out) != 0) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + opt.outPath);
+        std::printf("[%s] Solved %d of %zu frames\n",kScriptName.c_str(),solvedFrames,opt.detectionPaths.size());
+        return solvedFrames > 0 ? 0 : 2;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr,"Error: %s\n",e.what());
+        return 1;
+    }
+} // END OF MAIN PROGRAM
@@ -0,0 +1,293 @@
+//Star Detection
+//PSF Centroid Refinement (Shared Header)
+//Chris D. | Version 1 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Batched moment and Gaussian PSF fits
+//  Version 1 (10/18/2026): Moments only weight pixels above a noise
+//      floor from the sigma map; flux and FWHM from an aperture.
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Sub-pixel star positions from a (2r+1) x (2r+1) window of
+//  gray - background around each detection:
+//    RefineMoments   centroid and second moment weighted by the pixels
+//                    more than 3 sigma above background (the sigma map),
+//                    flux and width over a 4-sigma aperture
+//    RefineGaussian  moments, then Gauss-Newton on
+//                    A * exp(-((x-x0)^2 + (y-y0)^2) / (2 s^2))
+//  Both report flux (aperture sum, or 2 pi A s^2 for the fit) and FWHM
+//  (2.3548 s). A fit that diverges, leaves the window or ends with
+//  an implausible width falls back to the moment result.
+//
+//  Stars are processed kBatch at a time with every per-star value
+//  stored lane-wise (stamp[pixel][lane], ...), so the inner loops
+//  run over lanes and vectorize; batches run in parallel. The
+//  separable Gaussian is evaluated per axis with a product
+//  recurrence, three exp() calls per axis per iteration.
+
+#ifndef LIVE_SKYBOXES_PSF_REFINE_H
+#define LIVE_SKYBOXES_PSF_REFINE_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+namespace psf {
+
+enum RefineMode { RefineOff = 0, RefineMoments = 1, RefineGaussian = 2 };
+
+static const int kBatch = 8;
+static const int kIterations = 6;
+static const float kSigmaToFwhm = 2.35482f;
+static const float kNoiseFloor = 3.0f;      // Moment pixels: gray - background > 3 * sigma map
+static const float kApertureSigmas = 4.0f;  // Flux / FWHM aperture radius, in moment sigmas
+
+//Structure of arrays, one entry per star. x/y go in as the detection
+//centroid and come out refined.
+struct Centroids {
+    std::vector<double> x, y, flux, fwhm;
+    std::vector<uint8_t> fitted;   // 1 when the Gaussian fit was kept
+    void resize(size_t n) { x.resize(n); y.resize(n); flux.assign(n,0.0); fwhm.assign(n,0.0); fitted.assign(n,0); }
+    size_t size() const { return x.size(); }
+};
+
+//4x4 symmetric solve by Cholesky; false if not positive definite.
+static inline bool solve4(float h[10],float g[4],float out[4]) {
+    //h packed as 00 01 02 03 11 12 13 22 23 33
+    float a[4][4] = {{h[0],h[1],h[2],h[3]},{h[1],h[4],h[5],h[6]},{h[2],h[5],h[7],h[8]},{h[3],h[6],h[8],h[9]}};
+    float l[4][4] = {};
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j <= i; j++) {
+            float sum = a[i][j];
+            for (int k = 0; k < j; k++) sum -= l[i][k] * l[j][k];
+            if (i == j) {
+                if (!(sum > 0.0f)) return false;
+                l[i][i] = std::sqrt(sum);
+            } else {
+                l[i][j] = sum / l[j][j];
+            }
+        }
+    }
+    float z[4];
+    for (int i = 0; i < 4; i++) {
+        float sum = g[i];
+        for (int k = 0; k < i; k++) sum -= l[i][k] * z[k];
+        z[i] = sum / l[i][i];
+    }
+    for (int i = 3; i >= 0; i--) {
+        float sum = z[i];
+        for (int k = i + 1; k < 4; k++) sum -= l[k][i] * out[k];
+        out[i] = sum / l[i][i];
+    }
+    return true;
+}
+
+//e[k] = exp(-(k - r - center)^2 / (2 s^2)) for k = 0..2r, per lane.
+static inline void axisGaussian(const float* center,const float* sigma,int r,float* e) {
+    const int n = 2 * r + 1;
+    for (int lane = 0; lane < kBatch; lane++) {
+        const float c = 0.5f / (sigma[lane] * sigma[lane]);
+        const float d0 = (float)-r - center[lane];
+        float value = std::exp(-d0 * d0 * c);
+        float ratio = std::exp(-(2.0f * d0 + 1.0f) * c);
+        const float step = std::exp(-2.0f * c);
+        for (int k = 0; k < n; k++) {
+            e[k * kBatch + lane] = value;
+            value *= ratio;
+            ratio *= step;
+        }
+    }
+}
+
+//Refines one batch of up to kBatch stars starting at `first`.
+static inline void refineBatch(const uint8_t* gray,const uint8_t* background,const uint8_t* noise,int width,int height,int r,int mode,
+                               Centroids& stars,size_t first,std::vector<float>& stamp) {
+    const int n = 2 * r + 1, pixels = n * n;
+    const size_t count = std::min<size_t>(kBatch,stars.size() - first);
+    int originX[kBatch], originY[kBatch];
+    float* weight = &stamp[(size_t)pixels * kBatch];
+
+    // ----- Stamps (lanes past `count` stay empty) ----- //
+    std::fill(stamp.begin(),stamp.end(),0.0f);
+    for (size_t lane = 0; lane < count; lane++) {
+        originX[lane] = (int)std::lround(stars.x[first + lane]);
+        originY[lane] = (int)std::lround(stars.y[first + lane]);
+        for (int j = 0; j < n; j++) {
+            const int y = originY[lane] + j - r;
+            if (y < 0 || y >= height) continue;
+            const size_t row = (size_t)y * width;
+            for (int i = 0; i < n; i++) {
+                const int x = originX[lane] + i - r;
+                if (x < 0 || x >= width) continue;
+                const float v = (float)gray[row + x] - (float)background[row + x];
+                stamp[(size_t)(j * n + i) * kBatch + lane] = v;
+                weight[(size_t)(j * n + i) * kBatch + lane] = (v > kNoiseFloor * std::max((float)noise[row + x],1.0f)) ? v : 0.0f;
+            }
+        }
+    }
+
+    // ----- Moments (pixels above the noise floor) ----- //
+    float m0[kBatch] = {}, mx[kBatch] = {}, my[kBatch] = {}, mrr[kBatch] = {};
+    for (int p = 0; p < pixels; p++) {
+        const float dx = (float)(p % n - r), dy = (float)(p / n - r);
+        const float* v = &weight[(size_t)p * kBatch];
+        #ifdef USE_OMP
+        #pragma omp simd
+        #endif
+        for (int lane = 0; lane < kBatch; lane++) {
+            const float w = v[lane];
+            m0[lane] += w; mx[lane] += w * dx; my[lane] += w * dy;
+        }
+    }
+    float cx[kBatch], cy[kBatch], sigma[kBatch];
+    for (int lane = 0; lane < kBatch; lane++) {
+        const bool ok = m0[lane] > 0.0f;
+        cx[lane] = ok ? mx[lane] / m0[lane] : 0.0f;
+        cy[lane] = ok ? my[lane] / m0[lane] : 0.0f;
+    }
+    for (int p = 0; p < pixels; p++) {
+        const float dx = (float)(p % n - r), dy = (float)(p / n - r);
+        const float* v = &weight[(size_t)p * kBatch];
+        #ifdef USE_OMP
+        #pragma omp simd
+        #endif
+        for (int lane = 0; lane < kBatch; lane++) {
+            const float w = v[lane];
+            const float ex = dx - cx[lane], ey = dy - cy[lane];
+            mrr[lane] += w * (ex * ex + ey * ey);
+        }
+    }
+    for (int lane = 0; lane < kBatch; lane++) {
+        sigma[lane] = (m0[lane] > 0.0f) ? std::sqrt(0.5f * mrr[lane] / m0[lane]) : 1.0f;
+    }
+
+    // ----- Flux and width (every pixel of a circular aperture) ----- //
+    //The floor clips the wings, so flux and second moment come from the
+    //unclipped stamp inside kApertureSigmas * sigma of the centroid.
+    float apertureFlux[kBatch] = {}, apertureRr[kBatch] = {}, apertureSquared[kBatch];
+    for (int lane = 0; lane < kBatch; lane++) {
+        const float radius = std::min((float)r,kApertureSigmas * sigma[lane]);
+        apertureSquared[lane] = radius * radius;
+    }
+    for (int p = 0; p < pixels; p++) {
+        const float dx = (float)(p % n - r), dy = (float)(p / n - r);
+        const float* v = &stamp[(size_t)p * kBatch];
+        #ifdef USE_OMP
+        #pragma omp simd
+        #endif
+        for (int lane = 0; lane < kBatch; lane++) {
+            const float ex = dx - cx[lane], ey = dy - cy[lane], rr = ex * ex + ey * ey;
+            const float w = (rr <= apertureSquared[lane]) ? v[lane] : 0.0f;
+            apertureFlux[lane] += w; apertureRr[lane] += w * rr;
+        }
+    }
+    for (size_t lane = 0; lane < count; lane++) {
+        if (!(m0[lane] > 0.0f)) continue;   // Nothing above the floor: keep the detection centroid
+        const bool aperture = apertureFlux[lane] > 0.0f && apertureRr[lane] > 0.0f;
+        stars.x[first + lane] = originX[lane] + cx[lane];
+        stars.y[first + lane] = originY[lane] + cy[lane];
+        stars.flux[first + lane] = aperture ? apertureFlux[lane] : m0[lane];
+        stars.fwhm[first + lane] = kSigmaToFwhm * (aperture ? std::sqrt(0.5f * apertureRr[lane] / apertureFlux[lane]) : sigma[lane]);
+    }
+    if (mode != RefineGaussian) return;
+
+    // ----- Gaussian fit (Gauss-Newton, lightly damped) ----- //
+    float amplitude[kBatch], x0[kBatch], y0[kBatch], s[kBatch];
+    for (int lane = 0; lane < kBatch; lane++) {
+        s[lane] = std::min(std::max(sigma[lane],0.5f),(float)r);
+        x0[lane] = cx[lane]; y0[lane] = cy[lane];
+        amplitude[lane] = std::max(m0[lane],1.0f) / (2.0f * (float)M_PI * s[lane] * s[lane]);
+    }
+    std::vector<float> ex((size_t)n * kBatch), ey((size_t)n * kBatch);
+    for (int iteration = 0; iteration < kIterations; iteration++) {
+        axisGaussian(x0,s,r,ex.data());
+        axisGaussian(y0,s,r,ey.data());
+        float h[10][kBatch] = {}, g[4][kBatch] = {};
+        float inverse[kBatch], inverseCube[kBatch];
+        for (int lane = 0; lane < kBatch; lane++) {
+            inverse[lane] = 1.0f / (s[lane] * s[lane]);
+            inverseCube[lane] = inverse[lane] / s[lane];
+        }
+        for (int j = 0; j < n; j++) {
+            const float* eyRow = &ey[(size_t)j * kBatch];
+            for (int i = 0; i < n; i++) {
+                const float* v = &stamp[(size_t)(j * n + i) * kBatch];
+                const float* exRow = &ex[(size_t)i * kBatch];
+                #ifdef USE_OMP
+                #pragma omp simd
+                #endif
+                for (int lane = 0; lane < kBatch; lane++) {
+                    const float gauss = exRow[lane] * eyRow[lane];
+                    const float model = amplitude[lane] * gauss;
+                    const float dx = (float)(i - r) - x0[lane], dy = (float)(j - r) - y0[lane];
+                    const float j0 = gauss, j1 = model * dx * inverse[lane], j2 = model * dy * inverse[lane];
+                    const float j3 = model * (dx * dx + dy * dy) * inverseCube[lane];
+                    const float residual = v[lane] - model;
+                    h[0][lane] += j0 * j0; h[1][lane] += j0 * j1; h[2][lane] += j0 * j2; h[3][lane] += j0 * j3;
+                    h[4][lane] += j1 * j1; h[5][lane] += j1 * j2; h[6][lane] += j1 * j3;
+                    h[7][lane] += j2 * j2; h[8][lane] += j2 * j3; h[9][lane] += j3 * j3;
+                    g[0][lane] += j0 * residual; g[1][lane] += j1 * residual;
+                    g[2][lane] += j2 * residual; g[3][lane] += j3 * residual;
+                }
+            }
+        }
+        for (int lane = 0; lane < kBatch; lane++) {
+            float hl[10], gl[4], step[4];
+            for (int k = 0; k < 10; k++) hl[k] = h[k][lane];
+            for (int k = 0; k < 4; k++) gl[k] = g[k][lane];
+            hl[0] *= 1.001f; hl[4] *= 1.001f; hl[7] *= 1.001f; hl[9] *= 1.001f;
+            if (!solve4(hl,gl,step)) continue;
+            amplitude[lane] += step[0];
+            x0[lane] += std::min(std::max(step[1],-0.5f),0.5f);
+            y0[lane] += std::min(std::max(step[2],-0.5f),0.5f);
+            s[lane] = std::min(std::max(s[lane] + std::min(std::max(step[3],-0.5f),0.5f),0.3f),(float)r);
+        }
+    }
+    for (size_t lane = 0; lane < count; lane++) {
+        const bool plausible = std::isfinite(amplitude[lane]) && std::isfinite(x0[lane]) && std::isfinite(y0[lane]) &&
+                               amplitude[lane] > 0.0f && s[lane] > 0.3f && s[lane] < (float)r &&
+                               std::fabs(x0[lane]) <= 0.5f * r && std::fabs(y0[lane]) <= 0.5f * r;
+        if (!plausible || !(m0[lane] > 0.0f)) continue;
+        stars.x[first + lane] = originX[lane] + x0[lane];
+        stars.y[first + lane] = originY[lane] + y0[lane];
+        stars.flux[first + lane] = 2.0 * M_PI * amplitude[lane] * s[lane] * s[lane];
+        stars.fwhm[first + lane] = kSigmaToFwhm * s[lane];
+        stars.fitted[first + lane] = 1;
+    }
+}
+
+//Refines every star in place; `radius` is the window half-size and
+//`noise` the engine's sigma map, which sets the moment floor.
+static inline void refine(const uint8_t* gray,const uint8_t* background,const uint8_t* noise,int width,int height,int radius,int mode,
+                          Centroids& stars) {
+    if (mode == RefineOff || stars.size() == 0) return;
+    const int r = std::max(1,radius), n = 2 * r + 1;
+    const long long batches = (long long)((stars.size() + kBatch - 1) / kBatch);
+    #ifdef USE_OMP
+    #pragma omp parallel
+    #endif
+    {
+        std::vector<float> stamp((size_t)2 * n * n * kBatch);
+        #ifdef USE_OMP
+        #pragma omp for schedule(dynamic,8)
+        #endif
+        for (long long b = 0; b < batches; b++) refineBatch(gray,background,noise,width,height,r,mode,stars,(size_t)b * kBatch,stamp);
+    }
+}
+
+} // namespace psf
+
+#endif // LIVE_SKYBOXES_PSF_REFINE_H
@@ -0,0 +1,475 @@
+//Star Detection
+//Sequence Detection (Shared Header)
+//Chris D. | Version 1 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Temporal-prior tracking across rotation
+//      time-lapses
+//  Version 1 (10/18/2026): Refinement stamps carry the track's sigma
+//      for the moment noise floor
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Detects stars across a rotation time-lapse of stereographic
+//  hemisphere frames without analysing every frame from scratch. On
+//  a hemisphere disc the sky's rotation is a rotation about the disc
+//  centre (the pole), so frame N + 1's stars are frame N's turned by
+//  one step:
+//
+//    1. Full scan: StarDetectionEngine over the whole frame (discs
+//       applied). Runs on frame 0 and every fullScanEvery frames
+//       after it, and is what picks up stars rising into the discs.
+//    2. Tracked frames: each star is rotated about its disc centre to
+//       a predicted position, and only a small window around it is
+//       read. The background and sigma maps are bgKernel-wide
+//       smoothings that turn with the sky, so each star carries the
+//       values the full scan measured under it and the window reuses
+//       them. Then the same z threshold, open/blur cleanup, halo
+//       suppression
+//       (at the full scan's frame-wide bright level, for bright
+//       sources inside the window), labelling and area filter as the
+//       engine, keeping the component nearest the prediction (within
+//       searchRadius). Stars whose prediction leaves the disc or that
+//       are not found are dropped until the next full scan.
+//    3. The per-disc step is re-measured from each frame's matched
+//       stars (least squares angle about the centre), so a rough
+//       rotation is enough. With no rotation given, frame 1 is also a
+//       full scan and the step is found by searching angles up to
+//       maxRotationDegrees for the one matching the most stars.
+//
+//  Rows carry track ids: a star keeps its id across tracked frames
+//  and through full scans that find it near its prediction.
+//
+//  Positive angles turn clockwise as displayed (image y points down).
+//  The sidereal step is 360 * frameSeconds / 86164.1 degrees; its
+//  sign depends on the hemisphere and on --southMirror.
+
+#ifndef LIVE_SKYBOXES_SEQUENCE_DETECTION_H
+#define LIVE_SKYBOXES_SEQUENCE_DETECTION_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include "starDetectionEngine.h"
+#include "tiledDetection.h"
+
+namespace sequence {
+
+struct SequenceOptions {
+    int fullScanEvery = 10;                 // Full scan every K frames (<= 0: frame 0 only)
+    int searchRadius = 6;                   // How far a star may stray from its prediction (px)
+    int windowMargin = 6;                   // Cleanup and bright-source context beyond the search area (px)
+    std::vector<double> rotationDegrees;    // Per disc, per frame; empty: estimated from frames 0 and 1
+    double maxRotationDegrees = 5.0;        // Search range of the estimate
+};
+
+struct Track {
+    int64_t id = 0;
+    int disc = 0;
+    StarRow row;
+    uint8_t background = 0, sigma = 1;      // Engine maps under the star at its last full scan
+};
+
+struct FrameResult {
+    std::vector<StarRow> rows;              // Brightest first
+    std::vector<int64_t> ids;               // Track id of each row
+    bool fullScan = false;
+    int predicted = 0, recovered = 0;       // Tracked frames: stars looked for / found
+    int newcomers = 0;                      // Full scans: stars not matched to a track
+    size_t pixelsRead = 0;                  // Window (or frame) pixels processed
+};
+
+//Rotation about (cx, cy) by angle radians, clockwise as displayed.
+static inline void rotateAbout(double cx,double cy,double angle,double& x,double& y) {
+    const double c = std::cos(angle), s = std::sin(angle);
+    const double dx = x - cx, dy = y - cy;
+    x = cx + c * dx - s * dy;
+    y = cy + s * dx + c * dy;
+}
+
+class SequenceDetector {
+public:
+    //Discs are the rotation centres and, when given, the detection
+    //footprint; without them the frame centre is the pole.
+    SequenceDetector(const DetectionParams& params,const SequenceOptions& options,const std::vector<detection::Disc>& discs)
+        : params_(params), options_(options), discs_(discs) {
+        if (options_.searchRadius < 1) throw std::runtime_error("SequenceDetector: searchRadius must be >= 1");
+        if (options_.windowMargin < 0) throw std::runtime_error("SequenceDetector: windowMargin must be >= 0");
+        engine_.setDiscs(discs_);
+    }
+
+    FrameResult detect(const uint8_t* pixels,int width,int height,int channels,size_t strideBytes,bool bgr) {
+        if (!pixels || width <= 0 || height <= 0) throw std::runtime_error("SequenceDetector: empty image");
+        if (width != width_ || height != height_) {
+            if (frame_ > 0) throw std::runtime_error("SequenceDetector: frame size changed mid-sequence");
+            width_ = width;
+            height_ = height;
+            poles_ = discs_;
+            if (poles_.empty()) poles_.push_back({width / 2.0,height / 2.0,std::hypot((double)width,(double)height)});
+            steps_.assign(poles_.size(),0.0);
+            for (size_t d = 0; d < poles_.size() && d < options_.rotationDegrees.size(); d++) {
+                steps_[d] = options_.rotationDegrees[d] * M_PI / 180.0;
+            }
+        }
+
+        const bool estimating = frame_ == 1 && options_.rotationDegrees.empty();
+        const bool fullScan = frame_ == 0 || estimating || tracks_.empty() ||
+                              (options_.fullScanEvery > 0 && frame_ % options_.fullScanEvery == 0);
+        FrameResult result = fullScan ? scanFrame(pixels,width,height,channels,strideBytes,bgr,estimating)
+                                      : trackFrame(pixels,channels,strideBytes,bgr);
+        result.fullScan = fullScan;
+        frame_++;
+        return result;
+    }
+
+    double rotationDegrees(int disc) const { return steps_[disc] * 180.0 / M_PI; }
+    int discCount() const { return (int)poles_.size(); }
+    const StarDetectionEngine& engine() const { return engine_; }
+
+private:
+    DetectionParams params_;
+    SequenceOptions options_;
+    std::vector<detection::Disc> discs_;    // Detection footprint (may be empty)
+    std::vector<detection::Disc> poles_;    // Rotation centres (never empty)
+    std::vector<double> steps_;             // Radians per frame, per pole
+    std::vector<Track> tracks_;
+    StarDetectionEngine engine_;
+    int width_ = 0, height_ = 0, frame_ = 0;
+    int brightLevel_ = 255;                 // Frame-wide level of the last full scan
+    int64_t nextId_ = 1;
+
+    // ----- Window scratch ----- //
+    std::vector<uint8_t> gray_, inside_, row_;
+    bitmask::BitMask mask_, bright_;
+
+    // ----- Refinement stamps of the frame's tracked stars ----- //
+    std::vector<uint8_t> stampGray_, stampBackground_, stampSigma_;
+    psf::Centroids stamps_;
+    std::vector<std::pair<int,int>> stampOrigin_;   // Frame = stamp image + origin
+
+    int poleOf(double x,double y) const {
+        int best = 0;
+        double bestDistance = std::numeric_limits<double>::max();
+        for (size_t d = 0; d < poles_.size(); d++) {
+            const double distance = std::hypot(x - poles_[d].centerX,y - poles_[d].centerY) - poles_[d].radius;
+            if (distance < bestDistance) { bestDistance = distance; best = (int)d; }
+        }
+        return best;
+    }
+
+    void predict(const Track& track,double angle,double& x,double& y) const {
+        x = track.row.centerX;
+        y = track.row.centerY;
+        rotateAbout(poles_[track.disc].centerX,poles_[track.disc].centerY,angle,x,y);
+    }
+
+    //Least squares angle taking previous positions onto current ones
+    //about the pole; needs three pairs to replace the running step.
+    void remeasure(int disc,const std::vector<std::pair<StarRow,StarRow>>& pairs) {
+        if (pairs.size() < 3) return;
+        const double cx = poles_[disc].centerX, cy = poles_[disc].centerY;
+        double cross = 0.0, dot = 0.0;
+        for (const auto& pair : pairs) {
+            const double ax = pair.first.centerX - cx, ay = pair.first.centerY - cy;
+            const double bx = pair.second.centerX - cx, by = pair.second.centerY - cy;
+            cross += ax * by - ay * bx;
+            dot += ax * bx + ay * by;
+        }
+        steps_[disc] = std::atan2(cross,dot);
+    }
+
+    //Angle matching the most previous stars to the new ones within
+    //searchRadius; trials are spaced so their search circles overlap
+    //at the outermost star.
+    double searchStep(int disc,const std::vector<StarRow>& stars) const {
+        const double cx = poles_[disc].centerX, cy = poles_[disc].centerY;
+        double reach = 0.0;
+        for (const Track& track : tracks_) {
+            if (track.disc == disc) reach = std::max(reach,std::hypot(track.row.centerX - cx,track.row.centerY - cy));
+        }
+        if (reach < options_.searchRadius || stars.empty()) return steps_[disc];
+        const double limit = options_.maxRotationDegrees * M_PI / 180.0, spacing = options_.searchRadius / reach;
+        const double radiusSquared = (double)options_.searchRadius * options_.searchRadius;
+        double best = 0.0;
+        int bestCount = -1;
+        for (double angle = -limit; angle <= limit + 1e-12; angle += spacing) {
+            int count = 0;
+            for (const Track& track : tracks_) {
+                if (track.disc != disc) continue;
+                double x, y;
+                predict(track,angle,x,y);
+                for (const StarRow& star : stars) {
+                    const double dx = star.centerX - x, dy = star.centerY - y;
+                    if (dx * dx + dy * dy <= radiusSquared) { count++; break; }
+                }
+            }
+            if (count > bestCount) { bestCount = count; best = angle; }
+        }
+        return best;
+    }
+
+    // ----- Full scan ----- //
+    FrameResult scanFrame(const uint8_t* pixels,int width,int height,int channels,size_t strideBytes,bool bgr,bool estimating) {
+        //The level is fixed here so tracked windows threshold bright
+        //sources exactly as this scan did.
+        DetectionParams params = params_;
+        if (params.suppressHalo) {
+            if (params.brightLevel < 0) {
+                params.brightLevel = tiled::frameBrightLevel(pixels,width,height,channels,strideBytes,bgr,params.brightPercentile,discs_);
+            }
+            brightLevel_ = params.brightLevel;
+        }
+        engine_.setImage(pixels,width,height,channels,strideBytes,bgr);
+        const std::vector<StarRow>& selection = engine_.run(params);
+        FrameResult result;
+        result.pixelsRead = (size_t)width * height;
+
+        if (estimating) {
+            for (size_t d = 0; d < poles_.size(); d++) steps_[d] = searchStep((int)d,selection);
+        }
+
+        //Closest (track, star) pairs first, each used once.
+        struct Candidate { double distanceSquared; size_t track, star; };
+        std::vector<Candidate> candidates;
+        const double radiusSquared = (double)options_.searchRadius * options_.searchRadius;
+        for (size_t t = 0; t < tracks_.size(); t++) {
+            double x, y;
+            predict(tracks_[t],steps_[tracks_[t].disc],x,y);
+            for (size_t s = 0; s < selection.size(); s++) {
+                const double dx = selection[s].centerX - x, dy = selection[s].centerY - y;
+                const double distanceSquared = dx * dx + dy * dy;
+                if (distanceSquared <= radiusSquared) candidates.push_back({distanceSquared,t,s});
+            }
+        }
+        std::sort(candidates.begin(),candidates.end(),[](const Candidate& a,const Candidate& b) { return a.distanceSquared < b.distanceSquared; });
+        std::vector<int64_t> idOf(selection.size(),0);
+        std::vector<bool> trackUsed(tracks_.size(),false);
+        std::vector<std::vector<std::pair<StarRow,StarRow>>> pairs(poles_.size());
+        for (const Candidate& c : candidates) {
+            if (trackUsed[c.track] || idOf[c.star]) continue;
+            trackUsed[c.track] = true;
+            idOf[c.star] = tracks_[c.track].id;
+            pairs[tracks_[c.track].disc].push_back({tracks_[c.track].row,selection[c.star]});
+        }
+        for (size_t d = 0; d < poles_.size(); d++) remeasure((int)d,pairs[d]);
+
+        std::vector<Track> tracks;
+        for (size_t s = 0; s < selection.size(); s++) {
+            Track track;
+            track.row = selection[s];
+            track.disc = poleOf(track.row.centerX,track.row.centerY);
+            const size_t at = (size_t)detection::clampIndex((int)std::lround(track.row.centerY),height) * width +
+                              detection::clampIndex((int)std::lround(track.row.centerX),width);
+            track.background = engine_.background()[at];
+            track.sigma = engine_.sigma()[at];
+            if (!idOf[s]) { idOf[s] = nextId_++; result.newcomers++; }
+            track.id = idOf[s];
+            tracks.push_back(track);
+            result.rows.push_back(track.row);
+            result.ids.push_back(track.id);
+        }
+        tracks_.swap(tracks);
+        return result;
+    }
+
+    // ----- Tracked frame ----- //
+    FrameResult trackFrame(const uint8_t* pixels,int channels,size_t strideBytes,bool bgr) {
+        FrameResult result;
+        std::vector<Track> found;
+        std::vector<StarRow> previous;
+        stampGray_.clear();
+        stampBackground_.clear();
+        stampSigma_.clear();
+        stampOrigin_.clear();
+        stamps_.resize(0);
+        for (const Track& track : tracks_) {
+            double x, y;
+            predict(track,steps_[track.disc],x,y);
+            const detection::Disc& pole = poles_[track.disc];
+            if (std::hypot(x - pole.centerX,y - pole.centerY) > pole.radius - 1.0) continue;   // Rotated out of the disc
+            if (x < 0.0 || y < 0.0 || x >= width_ || y >= height_) continue;
+            result.predicted++;
+            StarRow row;
+            if (!findInWindow(pixels,channels,strideBytes,bgr,track,x,y,row,result.pixelsRead)) continue;
+            result.recovered++;
+            previous.push_back(track.row);
+            Track next = track;
+            next.row = row;
+            found.push_back(next);
+        }
+
+        if (params_.refine != psf::RefineOff && !found.empty()) {
+            const int n = 2 * std::max(1,params_.refineRadius) + 1;
+            psf::refine(stampGray_.data(),stampBackground_.data(),stampSigma_.data(),n,n * (int)found.size(),params_.refineRadius,params_.refine,stamps_);
+            for (size_t i = 0; i < found.size(); i++) {
+                StarRow& row = found[i].row;
+                row.centerX = stamps_.x[i] + stampOrigin_[i].first;
+                row.centerY = stamps_.y[i] + stampOrigin_[i].second;
+                row.flux = stamps_.flux[i];
+                row.fwhm = stamps_.fwhm[i];
+            }
+        }
+        std::vector<std::vector<std::pair<StarRow,StarRow>>> pairs(poles_.size());
+        for (size_t i = 0; i < found.size(); i++) pairs[found[i].disc].push_back({previous[i],found[i].row});
+        for (size_t d = 0; d < poles_.size(); d++) remeasure((int)d,pairs[d]);
+
+        //filterBySeparation() again, in case two tracks converged.
+        std::stable_sort(found.begin(),found.end(),[](const Track& a,const Track& b) { return a.row.sumIntensity > b.row.sumIntensity; });
+        const double minSeparationSquared = params_.minSeparation * params_.minSeparation;
+        std::vector<Track> tracks;
+        for (const Track& track : found) {
+            bool ok = true;
+            for (const Track& kept : tracks) {
+                const double dx = track.row.centerX - kept.row.centerX, dy = track.row.centerY - kept.row.centerY;
+                if (dx * dx + dy * dy < minSeparationSquared) { ok = false; break; }
+            }
+            if (!ok) continue;
+            tracks.push_back(track);
+            result.rows.push_back(track.row);
+            result.ids.push_back(track.id);
+        }
+        tracks_.swap(tracks);
+        return result;
+    }
+
+    //Detects inside the window around (px, py) and returns the area-
+    //filtered component nearest the prediction, in frame coordinates.
+    bool findInWindow(const uint8_t* pixels,int channels,size_t strideBytes,bool bgr,const Track& track,double px,double py,
+                      StarRow& out,size_t& pixelsRead) {
+        const StarRow& previous = track.row;
+        const int extent = std::max(previous.right - previous.left,previous.bottom - previous.top) / 2 + 1;
+        const int half = options_.searchRadius + extent + options_.windowMargin;
+        const int x0 = std::max(0,(int)std::floor(px) - half), y0 = std::max(0,(int)std::floor(py) - half);
+        const int x1 = std::min(width_,(int)std::floor(px) + half + 1), y1 = std::min(height_,(int)std::floor(py) + half + 1);
+        const int w = x1 - x0, h = y1 - y0;
+        if (w < 3 || h < 3) return false;
+        const size_t count = (size_t)w * h;
+        pixelsRead += count;
+
+        gray_.resize(count);
+        detection::toGray(pixels + (size_t)y0 * strideBytes + (size_t)x0 * channels,w,h,channels,strideBytes,bgr,gray_.data());
+
+        //Only in-disc pixels feed the statistics and the mask.
+        inside_.assign(count,1);
+        size_t insideCount = count;
+        if (!discs_.empty()) {
+            const detection::Disc& disc = poles_[track.disc];
+            const double r2 = disc.radius * disc.radius;
+            for (int y = 0; y < h; y++) {
+                for (int x = 0; x < w; x++) {
+                    const double dx = x0 + x - disc.centerX, dy = y0 + y - disc.centerY;
+                    if (dx * dx + dy * dy > r2) { inside_[(size_t)y * w + x] = 0; insideCount--; }
+                }
+            }
+            if (insideCount == 0) return false;
+        }
+
+        const float background = (float)track.background, sigma = std::max((float)track.sigma,1.0f);
+        auto zOf = [&](size_t i) { return ((float)gray_[i] - background) / sigma; };
+        auto clearOutside = [&](bitmask::BitMask& mask) {
+            for (int y = 0; y < h; y++) {
+                const uint8_t* in = &inside_[(size_t)y * w];
+                for (int x = 0; x < w; x++) if (!in[x]) mask.row(y)[x >> 6] &= ~(1ULL << (x & 63));
+            }
+        };
+        const float threshold = (float)params_.snrThreshold;
+        mask_.resize(w,h);
+        row_.resize(w);
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                const size_t i = (size_t)y * w + x;
+                row_[x] = (inside_[i] && zOf(i) > threshold) ? 1 : 0;
+            }
+            bitmask::packThreshold(row_.data(),w,0,mask_.row(y));
+        }
+        const int blur = (params_.blur > 1) ? (params_.blur | 1) : 0;
+        if (blur) {
+            bitmask::open(mask_,mask_,bitmask::Kernel::rect(3,3));
+            detection::gaussianThreshold(mask_,blur);
+            clearOutside(mask_);
+        }
+
+        //Halos: pixels near a bright source need twice the threshold.
+        if (params_.suppressHalo) {
+            bitmask::packThreshold(gray_.data(),w,h,brightLevel_,bright_);
+            clearOutside(bright_);
+            bitmask::close(bright_,bright_,bitmask::Kernel::rect(9,9));
+            const float veryHigh = (float)(params_.snrThreshold * 2.0);
+            for (const detection::Component& c : detection::connectedComponents(bright_,gray_.data())) {
+                if (c.area < 50) continue;
+                const double sourceRadius = std::max(1.0,std::sqrt(std::max((double)c.area,1.0) / M_PI));
+                const int radius = (int)std::max(10.0,params_.haloScale * sourceRadius);
+                const int hx = (int)(c.sumX / c.area), hy = (int)(c.sumY / c.area);
+                for (int y = std::max(0,hy - radius); y <= std::min(h - 1,hy + radius); y++) {
+                    const int dy = y - hy;
+                    const int span = (int)std::sqrt((double)radius * radius - (double)dy * dy);
+                    uint64_t* bits = mask_.row(y);
+                    for (int x = std::max(0,hx - span); x <= std::min(w - 1,hx + span); x++) {
+                        const size_t i = (size_t)y * w + x;
+                        const uint64_t bit = 1ULL << (x & 63);
+                        bits[x >> 6] = (inside_[i] && zOf(i) > veryHigh) ? (bits[x >> 6] | bit) : (bits[x >> 6] & ~bit);
+                    }
+                }
+            }
+        }
+
+        std::vector<StarRow> stars = detection::starsFromComponents(detection::connectedComponents(mask_,gray_.data()),
+                                                                    params_.minArea,params_.maxArea);
+        const double lx = px - x0, ly = py - y0;
+        const double radiusSquared = (double)options_.searchRadius * options_.searchRadius;
+        int best = -1;
+        double bestDistance = radiusSquared;
+        for (size_t i = 0; i < stars.size(); i++) {
+            const double dx = stars[i].centerX - lx, dy = stars[i].centerY - ly;
+            const double distanceSquared = dx * dx + dy * dy;
+            if (distanceSquared <= bestDistance) { bestDistance = distanceSquared; best = (int)i; }
+        }
+        if (best < 0) return false;
+        out = stars[best];
+
+        if (params_.refine != psf::RefineOff) queueStamp(out,track.background,track.sigma,w,h,x0,y0);
+        out.centerX += x0; out.centerY += y0;
+        out.left += x0; out.right += x0;
+        out.top += y0; out.bottom += y0;
+        return true;
+    }
+
+    //Stacks the star's refinement stamp (centred where psf::refine()
+    //will centre it) under the frame's earlier ones, so one refine()
+    //call fits them in batches. Pixels beyond the window hold the
+    //background, i.e. no signal, as refine() treats the frame edge.
+    void queueStamp(const StarRow& local,uint8_t background,uint8_t sigma,int w,int h,int x0,int y0) {
+        const int r = std::max(1,params_.refineRadius), n = 2 * r + 1;
+        const int ox = (int)std::lround(local.centerX), oy = (int)std::lround(local.centerY);
+        const int index = (int)stampOrigin_.size();
+        const size_t base = stampGray_.size();
+        stampGray_.resize(base + (size_t)n * n,background);
+        stampBackground_.resize(base + (size_t)n * n,background);
+        stampSigma_.resize(base + (size_t)n * n,sigma);
+        for (int j = 0; j < n; j++) {
+            const int y = oy + j - r;
+            if (y < 0 || y >= h) continue;
+            for (int i = 0; i < n; i++) {
+                const int x = ox + i - r;
+                if (x >= 0 && x < w) stampGray_[base + (size_t)j * n + i] = gray_[(size_t)y * w + x];
+            }
+        }
+        stamps_.x.push_back(local.centerX - ox + r);
+        stamps_.y.push_back(local.centerY - oy + r + (double)index * n);
+        stamps_.flux.push_back(0.0);
+        stamps_.fwhm.push_back(0.0);
+        stamps_.fitted.push_back(0);
+        stampOrigin_.push_back({x0 + ox - r,y0 + oy - r - index * n});
+    }
+};
+
+} // namespace sequence
+
+#endif // LIVE_SKYBOXES_SEQUENCE_DETECTION_H
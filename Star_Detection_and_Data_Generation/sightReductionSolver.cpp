@@ -0,0 +1,539 @@
+//Batch Sight Reduction
+//Engine
+//Chris D. | Version 1 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Functional launch
+//  Version 1 (10/18/2026): Error statistics cover converged fixes
+//      only; singular, unconverged and false-minimum fixes
+//      (--maxResidualArcmin) are counted apart. Recorded sights must
+//      be finite.
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Regression harness for celestial navigation in our skies.
+//  Observer positions are solved from sets of observed star
+//  altitudes with iterated least-squares intercept fixes
+//  (Gauss-Newton on latitude/longitude), using the same altitude
+//  formula as equatorialToHorizontal() in starDetection.py:
+//    LHA = GHA + longitude (east positive), GHA = GST - RA
+//    sin(Hc) = sin(lat)sin(dec) + cos(lat)cos(dec)cos(LHA)
+//
+//  Two sources of sights:
+//    synthetic (default)  --fixes N random observers and times; each
+//                         sees --starsPerFix stars from the star table
+//                         above --minAltitude, with Gaussian altitude
+//                         noise of --sigmaArcmin, and starts from a
+//                         dead-reckoning guess --guessErrorDeg away.
+//    --sights <tsv>       recorded sights, one per line:
+//                         fix, gha_deg, dec_deg, alt_deg
+//                         [, true_lat, true_lon] [, dr_lat, dr_lon]
+//
+//  Fixes are solved independently across threads and summarized as
+//  position error statistics (arcminutes of arc on the planet, and
+//  kilometers with --planetRadiusKm) over the converged fixes.
+//  Fixes that fail are reported apart: singular (fewer than two
+//  sights, e.g. no visible star, or stars in a line), not converged
+//  within --maxIterations, and converged on a false minimum (final
+//  RMS intercept above --maxResidualArcmin, typical of a far-off
+//  dead-reckoning start).
+
+// ============================================================== //
+// |                     COMPILE BASH SCRIPT                    | //
+// ============================================================== //
+// g++ sightReductionSolver.cpp -o sightReductionSolver -std=c++17 -O3 -Wall
+// (multi-threaded) add: -fopenmp -DUSE_OMP
+
+// ============================================================== //
+// |                      INCLUDE / DEFINE                      | //
+// ============================================================== //
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <unordered_map>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#include "starTable.h"
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+static const std::string kScriptName = "CHRIS'S KIT";
+static constexpr double kDegToRad = M_PI / 180.0;
+static constexpr double kRadToDeg = 180.0 / M_PI;
+
+// ============================================================== //
+// |                          OPTIONS                           | //
+// ============================================================== //
+struct Options {
+    std::string starTablePath;
+    std::string sightsPath;
+    std::string csvPath;
+    long long fixes = 100000;
+    int starsPerFix = 6;
+    double minAltitude = 15.0;      // Degrees
+    double sigmaArcmin = 0.5;       // Altitude noise (1 sigma)
+    double guessErrorDeg = 2.0;     // Dead-reckoning error radius
+    int maxIterations = 12;
+    double toleranceArcmin = 1e-4;  // Stop when the step is below this
+    double maxResidualArcmin = 30.0;// Converged fixes above this are false minima
+    double planetRadiusKm = 0.0;    // 0 = report arcminutes only
+    uint64_t seed = 1;
+};
+
+// ============================================================== //
+// |                          SIGHTS                            | //
+// ============================================================== //
+//Sights are stored flat; fix f owns sights [first[f], first[f+1]).
+struct SightBatch {
+    std::vector<double> gha, dec, altitude;     // Degrees
+    std::vector<size_t> first;
+    std::vector<double> trueLat, trueLon;       // NaN when unknown
+    std::vector<double> guessLat, guessLon;     // NaN = start from the sights
+
+    size_t fixCount() const { return first.empty() ? 0 : first.size() - 1; }
+};
+
+struct FixResult {
+    double latitude = 0.0, longitude = 0.0;
+    double residualArcmin = 0.0;    // RMS of final altitude intercepts
+    double errorArcmin = NAN;       // Great-circle distance to truth
+    int iterations = 0;
+    bool converged = false;
+    bool singular = false;          // Fewer than 2 sights or degenerate geometry
+};
+
+// ----- Small deterministic RNG so results do not depend on thread count ----- //
+struct SplitMix {
+    uint64_t state;
+    explicit SplitMix(uint64_t seed) : state(seed) {}
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+    double gaussian() {
+        double u1 = std::max(uniform(),1e-300), u2 = uniform();
+        return std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
+    }
+};
+
+static inline double wrap180(double degrees) {
+    degrees = std::fmod(degrees + 180.0,360.0);
+    if (degrees < 0) degrees += 360.0;
+    return degrees - 180.0;
+}
+
+static inline double computedAltitude(double lat,double lon,double gha,double dec) {
+    double lha = (gha + lon) * kDegToRad;
+    double sinAltitude = std::sin(dec * kDegToRad) * std::sin(lat * kDegToRad)
+                       + std::cos(dec * kDegToRad) * std::cos(lat * kDegToRad) * std::cos(lha);
+    return std::asin(std::max(-1.0,std::min(1.0,sinAltitude))) * kRadToDeg;
+}
+
+static inline double greatCircleDegrees(double lat1,double lon1,double lat2,double lon2) {
+    double p1 = lat1 * kDegToRad, p2 = lat2 * kDegToRad;
+    double dp = p2 - p1, dl = (lon2 - lon1) * kDegToRad;
+    double h = std::sin(dp / 2) * std::sin(dp / 2) + std::cos(p1) * std::cos(p2) * std::sin(dl / 2) * std::sin(dl / 2);
+    return 2.0 * std::asin(std::min(1.0,std::sqrt(h))) * kRadToDeg;
+}
+
+static SightBatch makeSyntheticSights(const StarTable& stars,const Options& opt) {
+    SightBatch batch;
+    const long long fixes = opt.fixes;
+    const int perFix = opt.starsPerFix;
+    batch.gha.assign((size_t)fixes * perFix,0.0);
+    batch.dec.assign((size_t)fixes * perFix,0.0);
+    batch.altitude.assign((size_t)fixes * perFix,0.0);
+    batch.first.resize((size_t)fixes + 1);
+    batch.trueLat.resize(fixes); batch.trueLon.resize(fixes);
+    batch.guessLat.resize(fixes); batch.guessLon.resize(fixes);
+    for (long long f = 0; f <= fixes; f++) batch.first[f] = (size_t)f * perFix;
+    std::vector<int> sightCount((size_t)fixes,0);
+
+    std::vector<double> sinDec(stars.size()), cosDec(stars.size());
+    for (size_t s = 0; s < stars.size(); s++) {
+        sinDec[s] = std::sin(stars.declination[s] * kDegToRad);
+        cosDec[s] = std::cos(stars.declination[s] * kDegToRad);
+    }
+    const double sinMin = std::sin(opt.minAltitude * kDegToRad), sinMax = std::sin(88.0 * kDegToRad);
+
+    #ifdef USE_OMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (long long f = 0; f < fixes; f++) {
+        SplitMix rng(opt.seed * 0x100000001B3ULL + (uint64_t)f);
+        // ----- Uniform observer on the sphere, random sidereal time ----- //
+        double lat = std::asin(2.0 * rng.uniform() - 1.0) * kRadToDeg;
+        double lon = rng.uniform() * 360.0 - 180.0;
+        double gst = rng.uniform() * 360.0;
+        batch.trueLat[f] = lat;
+        batch.trueLon[f] = lon;
+
+        // ----- Visible stars, chosen by rejection ----- //
+        size_t base = batch.first[f];
+        double sinLat = std::sin(lat * kDegToRad), cosLat = std::cos(lat * kDegToRad);
+        int found = 0;
+        for (int attempt = 0; found < perFix && attempt < perFix * 400; attempt++) {
+            size_t s = std::min(stars.size() - 1,(size_t)(rng.uniform() * stars.size()));
+            double gha = std::fmod(gst - stars.rightAscension[s] + 360.0,360.0);
+            double sinAltitude = sinLat * sinDec[s] + cosLat * cosDec[s] * std::cos((gha + lon) * kDegToRad);
+            if (sinAltitude < sinMin || sinAltitude > sinMax) continue;
+            double altitude = std::asin(std::min(1.0,sinAltitude)) * kRadToDeg;
+            batch.gha[base + found] = gha;
+            batch.dec[base + found] = stars.declination[s];
+            batch.altitude[base + found] = altitude + rng.gaussian() * opt.sigmaArcmin / 60.0;
+            found++;
+        }
+        //Sparse tables can leave a fix short; duplicate what it has. A
+        //fix with no visible star keeps no sights and is reported as
+        //singular rather than solved from zeros.
+        sightCount[f] = found > 0 ? perFix : 0;
+        for (int k = found; k < perFix && found > 0; k++) {
+            batch.gha[base + k] = batch.gha[base + k % found];
+            batch.dec[base + k] = batch.dec[base + k % found];
+            batch.altitude[base + k] = batch.altitude[base + k % found];
+        }
+
+        // ----- Dead-reckoning guess: random direction, fixed distance ----- //
+        double bearing = rng.uniform() * 2.0 * M_PI;
+        double distance = opt.guessErrorDeg * kDegToRad;
+        double p1 = lat * kDegToRad;
+        double p2 = std::asin(std::sin(p1) * std::cos(distance) + std::cos(p1) * std::sin(distance) * std::cos(bearing));
+        double dl = std::atan2(std::sin(bearing) * std::sin(distance) * std::cos(p1),
+                               std::cos(distance) - std::sin(p1) * std::sin(p2));
+        batch.guessLat[f] = p2 * kRadToDeg;
+        batch.guessLon[f] = wrap180(lon + dl * kRadToDeg);
+    }
+
+    // ----- Drop the sight slots of fixes that found no star ----- //
+    size_t kept = 0;
+    for (long long f = 0; f < fixes; f++) {
+        const size_t begin = batch.first[f];
+        batch.first[f] = kept;
+        for (int k = 0; k < sightCount[f]; k++, kept++) {
+            batch.gha[kept] = batch.gha[begin + k];
+            batch.dec[kept] = batch.dec[begin + k];
+            batch.altitude[kept] = batch.altitude[begin + k];
+        }
+    }
+    batch.first[fixes] = kept;
+    batch.gha.resize(kept); batch.dec.resize(kept); batch.altitude.resize(kept);
+    return batch;
+}
+
+static SightBatch loadSights(const std::string& path) {
+    std::ifstream file(path,std::ios::binary);
+    if (!file) throw std::runtime_error("[" + kScriptName + "]: Failed to open sights: " + path);
+    std::string line;
+    if (!std::getline(file,line)) throw std::runtime_error("[" + kScriptName + "]: Empty sights file: " + path);
+    std::vector<std::string> header = splitTabs(line);
+    auto column = [&](const char* name) {
+        for (size_t i = 0; i < header.size(); i++) if (header[i] == name) return (int)i;
+        return -1;
+    };
+    int fixCol = column("fix"), ghaCol = column("gha_deg"), decCol = column("dec_deg"), altCol = column("alt_deg");
+    int trueLatCol = column("true_lat"), trueLonCol = column("true_lon");
+    int drLatCol = column("dr_lat"), drLonCol = column("dr_lon");
+    if (fixCol < 0 || ghaCol < 0 || decCol < 0 || altCol < 0) {
+        throw std::runtime_error("[" + kScriptName + "]: Sights need fix, gha_deg, dec_deg and alt_deg columns: " + path);
+    }
+
+    SightBatch batch;
+    std::unordered_map<std::string,size_t> fixIndex;
+    std::vector<std::vector<size_t>> fixSights;
+    std::vector<double> gha, dec, altitude;
+    int lineNumber = 1;
+    while (std::getline(file,line)) {
+        ++lineNumber;
+        if (line.empty() || line == "\r") continue;
+        std::vector<std::string> fields = splitTabs(line);
+        //Optional columns may be empty (NaN = unknown); anything given must be finite.
+        auto number = [&](int col,bool required) {
+            if (col < 0 || col >= (int)fields.size() || fields[col].empty()) {
+                if (!required) return (double)NAN;
+                throw std::runtime_error("[" + kScriptName + "]: Missing value on line " + std::to_string(lineNumber) + " of " + path);
+            }
+            char* end = nullptr;
+            double value = std::strtod(fields[col].c_str(),&end);
+            if (end == fields[col].c_str()) {
+                throw std::runtime_error("[" + kScriptName + "]: Bad number on line " + std::to_string(lineNumber) + " of " + path);
+            }
+            if (!std::isfinite(value)) {
+                throw std::runtime_error("[" + kScriptName + "]: Non-finite number on line " + std::to_string(lineNumber) + " of " + path);
+            }
+            return value;
+        };
+        if (fixCol >= (int)fields.size()) continue;
+        auto inserted = fixIndex.emplace(fields[fixCol],fixSights.size());
+        if (inserted.second) {
+            fixSights.emplace_back();
+            batch.trueLat.push_back(number(trueLatCol,false));
+            batch.trueLon.push_back(number(trueLonCol,false));
+            batch.guessLat.push_back(number(drLatCol,false));
+            batch.guessLon.push_back(number(drLonCol,false));
+        }
+        fixSights[inserted.first->second].push_back(gha.size());
+        gha.push_back(number(ghaCol,true));
+        dec.push_back(number(decCol,true));
+        altitude.push_back(number(altCol,true));
+    }
+
+    // ----- Group sights by fix ----- //
+    batch.first.push_back(0);
+    for (const std::vector<size_t>& sights : fixSights) {
+        for (size_t i : sights) {
+            batch.gha.push_back(gha[i]);
+            batch.dec.push_back(dec[i]);
+            batch.altitude.push_back(altitude[i]);
+        }
+        batch.first.push_back(batch.gha.size());
+    }
+    return batch;
+}
+
+// ============================================================== //
+// |                      GAUSS-NEWTON FIX                      | //
+// ============================================================== //
+//Minimizes sum (Ho - Hc)^2 over latitude and longitude. Each
+//intercept's partials come from differentiating the altitude formula:
+//  cos(H) dH = (cos(lat)sin(dec) - sin(lat)cos(dec)cos(LHA)) dLat
+//            - cos(lat)cos(dec)sin(LHA) dLHA
+static FixResult solveFix(const SightBatch& batch,size_t fix,const Options& opt) {
+    FixResult result;
+    const size_t begin = batch.first[fix], end = batch.first[fix + 1];
+    if (end - begin < 2) {
+        result.singular = true;
+        return result;
+    }
+
+    double lat = batch.guessLat[fix], lon = batch.guessLon[fix];
+    if (std::isnan(lat) || std::isnan(lon)) {
+        //No DR position: start at the highest star's geographic position,
+        //which is always within its zenith distance of the observer.
+        size_t best = begin;
+        for (size_t i = begin; i < end; i++) if (batch.altitude[i] > batch.altitude[best]) best = i;
+        lat = batch.dec[best];
+        lon = wrap180(-batch.gha[best]);
+    }
+
+    const double tolerance = opt.toleranceArcmin / 60.0;
+    for (int iteration = 1; iteration <= opt.maxIterations; iteration++) {
+        double sinLat = std::sin(lat * kDegToRad), cosLat = std::cos(lat * kDegToRad);
+        double a11 = 0.0, a12 = 0.0, a22 = 0.0, b1 = 0.0, b2 = 0.0;
+        for (size_t i = begin; i < end; i++) {
+            double lha = (batch.gha[i] + lon) * kDegToRad;
+            double sinDec = std::sin(batch.dec[i] * kDegToRad), cosDec = std::cos(batch.dec[i] * kDegToRad);
+            double cosLha = std::cos(lha), sinLha = std::sin(lha);
+            double sinH = sinLat * sinDec + cosLat * cosDec * cosLha;
+            sinH = std::max(-1.0,std::min(1.0,sinH));
+            double cosH = std::max(1e-9,std::sqrt(1.0 - sinH * sinH));
+            double hc = std::asin(sinH) * kRadToDeg;
+            double jLat = (cosLat * sinDec - sinLat * cosDec * cosLha) / cosH;
+            double jLon = (-cosLat * cosDec * sinLha) / cosH;
+            double r = batch.altitude[i] - hc;
+            a11 += jLat * jLat; a12 += jLat * jLon; a22 += jLon * jLon;
+            b1 += jLat * r; b2 += jLon * r;
+        }
+        double det = a11 * a22 - a12 * a12;
+        if (!(std::fabs(det) > 1e-14)) {       // Degenerate geometry (stars in a line)
+            result.singular = true;
+            break;
+        }
+        double dLat = (a22 * b1 - a12 * b2) / det;
+        double dLon = (a11 * b2 - a12 * b1) / det;
+
+        //Cap the step so a far-off start cannot overshoot a pole.
+        double stepLength = std::sqrt(dLat * dLat + dLon * dLon * cosLat * cosLat);
+        if (stepLength > 10.0) { dLat *= 10.0 / stepLength; dLon *= 10.0 / stepLength; }
+        lat += dLat;
+        lon += dLon;
+        if (lat > 90.0) { lat = 180.0 - lat; lon += 180.0; }
+        if (lat < -90.0) { lat = -180.0 - lat; lon += 180.0; }
+        lon = wrap180(lon);
+        result.iterations = iteration;
+        if (stepLength < tolerance) {
+            result.converged = true;
+            break;
+        }
+    }
+
+    double sumSquares = 0.0;
+    for (size_t i = begin; i < end; i++) {
+        double r = batch.altitude[i] - computedAltitude(lat,lon,batch.gha[i],batch.dec[i]);
+        sumSquares += r * r;
+    }
+    result.latitude = lat;
+    result.longitude = lon;
+    result.residualArcmin = std::sqrt(sumSquares / (double)(end - begin)) * 60.0;
+    if (!std::isnan(batch.trueLat[fix]) && !std::isnan(batch.trueLon[fix])) {
+        result.errorArcmin = greatCircleDegrees(lat,lon,batch.trueLat[fix],batch.trueLon[fix]) * 60.0;
+    }
+    return result;
+}
+
+// ============================================================== //
+// |                         STATISTICS                         | //
+// ============================================================== //
+static double percentile(std::vector<double>& values,double p) {
+    if (values.empty()) return NAN;
+    size_t k = (size_t)std::min<double>((double)values.size() - 1,std::floor(p / 100.0 * (values.size() - 1) + 0.5));
+    std::nth_element(values.begin(),values.begin() + k,values.end());
+    return values[k];
+}
+
+static void printReport(const std::vector<FixResult>& results,const Options& opt,double solveSeconds) {
+    size_t converged = 0, singular = 0, unconverged = 0, falseMinimum = 0;
+    double iterationSum = 0.0, residualSum = 0.0;
+    std::vector<double> errors;
+    errors.reserve(results.size());
+    for (const FixResult& result : results) {
+        if (result.singular) { singular++; continue; }
+        if (!result.converged) { unconverged++; continue; }
+        if (result.residualArcmin > opt.maxResidualArcmin) { falseMinimum++; continue; }
+        converged++;
+        iterationSum += result.iterations;
+        residualSum += result.residualArcmin;
+        if (!std::isnan(result.errorArcmin)) errors.push_back(result.errorArcmin);
+    }
+    size_t n = std::max<size_t>(1,results.size()), nConverged = std::max<size_t>(1,converged);
+    std::printf("[%s] Sight reduction: %zu fixes in %.3f s (%.0f fixes/s)\n",
+                kScriptName.c_str(),results.size(),solveSeconds,results.size() / std::max(solveSeconds,1e-9));
+    std::printf("  converged: %zu (%.2f%%)  mean iterations: %.2f  mean residual: %.3f'\n",
+                converged,100.0 * converged / n,iterationSum / nConverged,residualSum / nConverged);
+    std::printf("  failed: %zu singular (too few sights or stars in a line), %zu not converged in %d iterations, "
+                "%zu false minima (residual > %.1f')\n",singular,unconverged,opt.maxIterations,falseMinimum,opt.maxResidualArcmin);
+    if (errors.empty()) return;
+
+    double sum = 0.0, sumSquares = 0.0, worst = 0.0;
+    for (double e : errors) { sum += e; sumSquares += e * e; worst = std::max(worst,e); }
+    double mean = sum / errors.size(), rms = std::sqrt(sumSquares / errors.size());
+    double p50 = percentile(errors,50.0), p95 = percentile(errors,95.0), p99 = percentile(errors,99.0);
+    std::printf("  position error of converged fixes (arcmin): mean %.3f  rms %.3f  p50 %.3f  p95 %.3f  p99 %.3f  max %.3f\n",
+                mean,rms,p50,p95,p99,worst);
+    if (opt.planetRadiusKm > 0.0) {
+        double km = opt.planetRadiusKm * kDegToRad / 60.0;
+        std::printf("  position error of converged fixes (km):     mean %.3f  rms %.3f  p50 %.3f  p95 %.3f  p99 %.3f  max %.3f\n",
+                    mean * km,rms * km,p50 * km,p95 * km,p99 * km,worst * km);
+    }
+}
+
+static void writeCsv(const std::string& path,const SightBatch& batch,const std::vector<FixResult>& results) {
+    FILE* file = std::fopen(path.c_str(),"wb");
+    if (!file) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + path);
+    std::fprintf(file,"fix,sights,lat,lon,true_lat,true_lon,error_arcmin,residual_arcmin,iterations,converged\n");
+    for (size_t f = 0; f < results.size(); f++) {
+        const FixResult& r = results[f];
+        std::fprintf(file,"%zu,%zu,%.6f,%.6f,%.6f,%.6f,%.4f,%.4f,%d,%d\n",f,batch.first[f + 1] - batch.first[f],
+                     r.latitude,r.longitude,batch.trueLat[f],batch.trueLon[f],r.errorArcmin,r.residualArcmin,
+                     r.iterations,r.converged ? 1 : 0);
+    }
+    if (std::fclose(file) != 0) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + path);
+}
+
+// ============================================================== //
+// |                        CLI PARSING                         | //
+// ============================================================== //
+static void usage(const char* argv0) {
+    std::fprintf(stderr,
+        "Usage: %s <starTable.txt> [options]      (synthetic sights)\n"
+        "       %s --sights <sights.tsv> [options]  (recorded sights)\n"
+        "     [--fixes N] (default 100000)\n"
+        "     [--starsPerFix K] (default 6)\n"
+        "     [--minAltitude <deg>] (default 15)\n"
+        "     [--sigmaArcmin <arcmin>] (altitude noise, default 0.5)\n"
+        "     [--guessErrorDeg <deg>] (dead-reckoning error, default 2)\n"
+        "     [--maxIterations N] (default 12) [--toleranceArcmin <arcmin>] (default 1e-4)\n"
+        "     [--maxResidualArcmin <arcmin>] (converged fixes above this are false minima, default 30)\n"
+        "     [--planetRadiusKm <km>] [--seed N] [--csv <path>]\n",
+        argv0,argv0);
+}
+
+static Options parseArguments(int argc,char** argv) {
+    Options opt;
+    if (argc < 2) {
+        usage(argv[0]);
+        std::exit(1);
+    }
+    int i = 1;
+    if (argv[1][0] != '-') opt.starTablePath = argv[i++];
+    for (; i < argc; i++) {
+        std::string key = argv[i];
+        auto need = [&](bool has) { if (!has) throw std::runtime_error("[" + kScriptName + "]: Missing value for " + key); };
+        if (key == "--sights") { need(i + 1 < argc); opt.sightsPath = argv[++i]; }
+        else if (key == "--csv") { need(i + 1 < argc); opt.csvPath = argv[++i]; }
+        else if (key == "--fixes") { need(i + 1 < argc); opt.fixes = std::stoll(argv[++i]); }
+        else if (key == "--starsPerFix") { need(i + 1 < argc); opt.starsPerFix = std::stoi(argv[++i]); }
+        else if (key == "--minAltitude") { need(i + 1 < argc); opt.minAltitude = std::stod(argv[++i]); }
+        else if (key == "--sigmaArcmin") { need(i + 1 < argc); opt.sigmaArcmin = std::stod(argv[++i]); }
+        else if (key == "--guessErrorDeg") { need(i + 1 < argc); opt.guessErrorDeg = std::stod(argv[++i]); }
+        else if (key == "--maxIterations") { need(i + 1 < argc); opt.maxIterations = std::stoi(argv[++i]); }
+        else if (key == "--toleranceArcmin") { need(i + 1 < argc); opt.toleranceArcmin = std::stod(argv[++i]); }
+        else if (key == "--maxResidualArcmin") { need(i + 1 < argc); opt.maxResidualArcmin = std::stod(argv[++i]); }
+        else if (key == "--planetRadiusKm") { need(i + 1 < argc); opt.planetRadiusKm = std::stod(argv[++i]); }
+        else if (key == "--seed") { need(i + 1 < argc); opt.seed = std::stoull(argv[++i]); }
+        else { usage(argv[0]); throw std::runtime_error("[" + kScriptName + "]: Unknown argument: " + key); }
+    }
+    if (opt.starTablePath.empty() && opt.sightsPath.empty()) {
+        throw std::runtime_error("[" + kScriptName + "]: Give a star table or --sights.");
+    }
+    if (opt.starsPerFix < 2) throw std::runtime_error("[" + kScriptName + "]: --starsPerFix must be at least 2.");
+    if (opt.fixes < 1) throw std::runtime_error("[" + kScriptName + "]: --fixes must be at least 1.");
+    return opt;
+}
+
+// ============================================================== //
+// |                        MAIN PROGRAM                        | //
+// ============================================================== //
+int main(int argc,char** argv) {
+    try {
+        Options opt = parseArguments(argc,argv);
+
+        auto t0 = std::chrono::steady_clock::now();
+        SightBatch batch;
+        if (!opt.sightsPath.empty()) {
+            batch = loadSights(opt.sightsPath);
+        } else {
+            StarTable stars = loadStarTable(opt.starTablePath);
+            if (stars.size() < 2) throw std::runtime_error("[" + kScriptName + "]: Need at least 2 stars in " + opt.starTablePath);
+            batch = makeSyntheticSights(stars,opt);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+
+        const long long fixes = (long long)batch.fixCount();
+        std::vector<FixResult> results((size_t)fixes);
+        #ifdef USE_OMP
+        #pragma omp parallel for schedule(dynamic,1024)
+        #endif
+        for (long long f = 0; f < fixes; f++) results[f] = solveFix(batch,(size_t)f,opt);
+        auto t2 = std::chrono::steady_clock::now();
+
+        std::printf("[%s] Prepared %zu sights in %.3f s\n",kScriptName.c_str(),batch.gha.size(),
+                    std::chrono::duration<double>(t1 - t0).count());
+        printReport(results,opt,std::chrono::duration<double>(t2 - t1).count());
+        if (!opt.csvPath.empty()) {
+            writeCsv(opt.csvPath,batch,results);
+            std::printf("Wrote: %s\n",opt.csvPath.c_str());
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr,"Error: %s\n",e.what());
+        return 1;
+    }
+} // END OF MAIN PROGRAM
@@ -0,0 +1,508 @@
+//Star Detection
+//Columnar Star Table (Shared Header)
+//Chris D. | Version 1 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Functional launch
+//  Version 1 (10/18/2026): open() checks every string offset and
+//      rejects column sizes that overflow
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Binary star tables (.stc) for the native tools. A fixed header, a
+//  column directory and one array per column: StarColumnsFile maps
+//  the file and hands out typed spans straight into the mapping, so
+//  a million-row table opens without parsing a single field.
+//
+//  Little-endian layout, every column aligned to 64 bytes:
+//    StarColumnsHeader                   magic "LSSTCOL1", row and column counts
+//    StarColumnEntry[columnCount]        name, type, codec, offset, bytes
+//    column data
+//
+//  Standard columns (any subset, any order; other names are kept):
+//    id     int64     1-based detection number
+//    label  string    star name, or the detection label ("A1")
+//    x, y   float64   detection pixel coordinates
+//    ra,dec float64   degrees
+//    flux   float64   summed (or PSF-fitted) intensity
+//    area   int32     pixels
+//    frame  int32     source frame of a sequence
+//    track  int32     track id across frames, -1 for none
+//  Strings are uint64 offsets[rowCount + 1] followed by the bytes.
+//
+//  Each column may be compressed; it is then decoded once, on first
+//  access, into a buffer owned by the reader:
+//    CodecRaw    the array as it sits in memory (zero-copy)
+//    CodecDelta  integers: zigzag(row - previous row) as LEB128
+//                varints; frame and track shrink to a byte per row
+//    CodecXor    float64: bits XOR the previous row's, stored as a
+//                significant-byte count and those low bytes, for
+//                smooth sequences (tracks sorted by frame)
+
+#ifndef LIVE_SKYBOXES_STAR_COLUMNS_H
+#define LIVE_SKYBOXES_STAR_COLUMNS_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <string_view>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// ============================================================== //
+// |                         FILE LAYOUT                        | //
+// ============================================================== //
+enum StarColumnType : uint32_t { ColumnInt32 = 1, ColumnInt64 = 2, ColumnFloat64 = 3, ColumnString = 4 };
+enum StarColumnCodec : uint32_t { CodecRaw = 0, CodecDelta = 1, CodecXor = 2 };
+
+struct StarColumnsHeader {
+    char magic[8];              // "LSSTCOL1"
+    uint32_t version;
+    uint32_t headerBytes;
+    uint64_t rowCount;
+    uint32_t columnCount;
+    uint32_t entryBytes;
+    uint64_t directoryOffset;
+    uint8_t reserved[24];
+};
+
+struct StarColumnEntry {
+    char name[24];              // '\0'-terminated
+    uint32_t type;              // StarColumnType
+    uint32_t codec;             // StarColumnCodec
+    uint64_t offset;            // From the start of the file
+    uint64_t bytes;             // Stored (possibly compressed) size
+    uint64_t rawBytes;          // Decoded size
+    uint64_t reserved;
+};
+
+static_assert(sizeof(StarColumnsHeader) == 64,"StarColumnsHeader must stay 64 bytes");
+static_assert(sizeof(StarColumnEntry) == 64,"StarColumnEntry must stay 64 bytes");
+
+namespace starcolumns {
+
+static inline uint64_t alignUp(uint64_t value) { return (value + 63) & ~uint64_t(63); }
+
+static inline bool littleEndian() {
+    const uint16_t one = 1;
+    uint8_t first;
+    std::memcpy(&first,&one,1);
+    return first == 1;
+}
+
+//False when a * b does not fit 64 bits.
+static inline bool multiply(uint64_t a,uint64_t b,uint64_t& product) {
+    if (a != 0 && b > UINT64_MAX / a) return false;
+    product = a * b;
+    return true;
+}
+
+static inline size_t elementBytes(uint32_t type) {
+    return (type == ColumnInt32) ? 4 : (type == ColumnString) ? 1 : 8;
+}
+
+// ----- CodecDelta ----- //
+static inline void encodeDelta(const int64_t* values,size_t count,std::vector<uint8_t>& out) {
+    int64_t previous = 0;
+    for (size_t i = 0; i < count; i++) {
+        const uint64_t delta = (uint64_t)values[i] - (uint64_t)previous;
+        uint64_t zigzag = (delta << 1) ^ (uint64_t)((int64_t)delta >> 63);
+        previous = values[i];
+        while (zigzag >= 0x80) {
+            out.push_back((uint8_t)(zigzag | 0x80));
+            zigzag >>= 7;
+        }
+        out.push_back((uint8_t)zigzag);
+    }
+}
+
+static inline void decodeDelta(const uint8_t* in,size_t bytes,int64_t* values,size_t count) {
+    const uint8_t* end = in + bytes;
+    int64_t previous = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t zigzag = 0;
+        int shift = 0;
+        while (true) {
+            if (in >= end || shift > 63) throw std::runtime_error("Star columns: truncated delta column");
+            const uint8_t byte = *in++;
+            zigzag |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) break;
+            shift += 7;
+        }
+        const uint64_t delta = (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+        previous = (int64_t)((uint64_t)previous + delta);
+        values[i] = previous;
+    }
+}
+
+// ----- CodecXor ----- //
+static inline void encodeXor(const double* values,size_t count,std::vector<uint8_t>& out) {
+    uint64_t previous = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t bits;
+        std::memcpy(&bits,&values[i],8);
+        uint64_t x = bits ^ previous;
+        previous = bits;
+        uint8_t significant = 0;
+        for (uint64_t v = x; v; v >>= 8) significant++;
+        out.push_back(significant);
+        for (uint8_t b = 0; b < significant; b++, x >>= 8) out.push_back((uint8_t)x);
+    }
+}
+
+static inline void decodeXor(const uint8_t* in,size_t bytes,double* values,size_t count) {
+    const uint8_t* end = in + bytes;
+    uint64_t previous = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (in >= end || *in > 8 || end - in - 1 < *in) throw std::runtime_error("Star columns: truncated xor column");
+        const uint8_t significant = *in++;
+        uint64_t x = 0;
+        for (uint8_t b = 0; b < significant; b++) x |= (uint64_t)(*in++) << (8 * b);
+        previous ^= x;
+        std::memcpy(&values[i],&previous,8);
+    }
+}
+
+} // namespace starcolumns
+
+// ============================================================== //
+// |                           WRITER                           | //
+// ============================================================== //
+//Collects columns of one row count and writes them in a single pass.
+class StarColumnsWriter {
+public:
+    explicit StarColumnsWriter(size_t rows) : rows_(rows) {}
+
+    void addInt32(const std::string& name,const std::vector<int32_t>& values,uint32_t codec = CodecRaw) {
+        std::vector<int64_t> wide(values.begin(),values.end());
+        add(name,ColumnInt32,codec,values.data(),values.size(),wide.data(),nullptr);
+    }
+    void addInt64(const std::string& name,const std::vector<int64_t>& values,uint32_t codec = CodecRaw) {
+        add(name,ColumnInt64,codec,values.data(),values.size(),values.data(),nullptr);
+    }
+    void addFloat64(const std::string& name,const std::vector<double>& values,uint32_t codec = CodecRaw) {
+        add(name,ColumnFloat64,codec,values.data(),values.size(),nullptr,values.data());
+    }
+    void addStrings(const std::string& name,const std::vector<std::string>& values) {
+        if (values.size() != rows_) throw std::runtime_error("Star columns: '" + name + "' has the wrong row count");
+        Column column = begin(name,ColumnString,CodecRaw);
+        uint64_t offset = 0;
+        column.data.resize((values.size() + 1) * sizeof(uint64_t));
+        for (size_t i = 0; i <= values.size(); i++) {
+            std::memcpy(&column.data[i * sizeof(uint64_t)],&offset,sizeof(uint64_t));
+            if (i < values.size()) offset += values[i].size();
+        }
+        for (const std::string& value : values) column.data.insert(column.data.end(),value.begin(),value.end());
+        column.rawBytes = column.data.size();
+        columns_.push_back(std::move(column));
+    }
+
+    void write(const std::string& path) const {
+        if (!starcolumns::littleEndian()) throw std::runtime_error("Star columns: big-endian hosts are not supported");
+        StarColumnsHeader header;
+        std::memset(&header,0,sizeof(header));
+        std::memcpy(header.magic,"LSSTCOL1",8);
+        header.version = 1;
+        header.headerBytes = sizeof(StarColumnsHeader);
+        header.rowCount = rows_;
+        header.columnCount = (uint32_t)columns_.size();
+        header.entryBytes = sizeof(StarColumnEntry);
+        header.directoryOffset = sizeof(StarColumnsHeader);
+
+        std::vector<StarColumnEntry> entries(columns_.size());
+        uint64_t offset = starcolumns::alignUp(header.directoryOffset + entries.size() * sizeof(StarColumnEntry));
+        for (size_t i = 0; i < columns_.size(); i++) {
+            std::memset(&entries[i],0,sizeof(StarColumnEntry));
+            std::memcpy(entries[i].name,columns_[i].name.c_str(),columns_[i].name.size());
+            entries[i].type = columns_[i].type;
+            entries[i].codec = columns_[i].codec;
+            entries[i].offset = offset;
+            entries[i].bytes = columns_[i].data.size();
+            entries[i].rawBytes = columns_[i].rawBytes;
+            offset = starcolumns::alignUp(offset + entries[i].bytes);
+        }
+
+        FILE* file = std::fopen(path.c_str(),"wb");
+        if (!file) throw std::runtime_error("Failed to write star columns: " + path);
+        uint64_t position = 0;
+        auto put = [&](uint64_t at,const void* data,size_t bytes) {
+            static const char zeros[64] = {0};
+            while (position < at) {
+                size_t pad = (size_t)std::min<uint64_t>(64,at - position);
+                std::fwrite(zeros,1,pad,file);
+                position += pad;
+            }
+            if (bytes && std::fwrite(data,1,bytes,file) != bytes) {
+                std::fclose(file);
+                throw std::runtime_error("Failed to write star columns: " + path);
+            }
+            position += bytes;
+        };
+        put(0,&header,sizeof(header));
+        put(header.directoryOffset,entries.data(),entries.size() * sizeof(StarColumnEntry));
+        for (size_t i = 0; i < columns_.size(); i++) put(entries[i].offset,columns_[i].data.data(),columns_[i].data.size());
+        if (std::fclose(file) != 0) throw std::runtime_error("Failed to write star columns: " + path);
+    }
+
+private:
+    struct Column {
+        std::string name;
+        uint32_t type = 0, codec = 0;
+        std::vector<uint8_t> data;
+        uint64_t rawBytes = 0;
+    };
+
+    Column begin(const std::string& name,uint32_t type,uint32_t codec) const {
+        if (name.empty() || name.size() >= sizeof(StarColumnEntry::name)) throw std::runtime_error("Star columns: bad column name '" + name + "'");
+        for (const Column& column : columns_) {
+            if (column.name == name) throw std::runtime_error("Star columns: duplicate column '" + name + "'");
+        }
+        Column column;
+        column.name = name;
+        column.type = type;
+        column.codec = codec;
+        return column;
+    }
+
+    void add(const std::string& name,uint32_t type,uint32_t codec,const void* raw,size_t count,
+             const int64_t* integers,const double* reals) {
+        if (count != rows_) throw std::runtime_error("Star columns: '" + name + "' has the wrong row count");
+        if ((codec == CodecDelta && !integers) || (codec == CodecXor && !reals) || codec > CodecXor) {
+            throw std::runtime_error("Star columns: codec does not fit column '" + name + "'");
+        }
+        Column column = begin(name,type,codec);
+        column.rawBytes = (uint64_t)count * starcolumns::elementBytes(type);
+        if (codec == CodecDelta) starcolumns::encodeDelta(integers,count,column.data);
+        else if (codec == CodecXor) starcolumns::encodeXor(reals,count,column.data);
+        else column.data.assign((const uint8_t*)raw,(const uint8_t*)raw + column.rawBytes);
+        columns_.push_back(std::move(column));
+    }
+
+    size_t rows_ = 0;
+    std::vector<Column> columns_;
+};
+
+// ============================================================== //
+// |                           READER                           | //
+// ============================================================== //
+template <class T>
+struct ColumnSpan {
+    const T* data = nullptr;
+    size_t count = 0;
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const T& operator[](size_t i) const { return data[i]; }
+    const T* begin() const { return data; }
+    const T* end() const { return data + count; }
+};
+
+struct StringColumnSpan {
+    const uint64_t* offsets = nullptr;
+    const char* bytes = nullptr;
+    size_t count = 0;
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    std::string_view operator[](size_t i) const { return std::string_view(bytes + offsets[i],(size_t)(offsets[i + 1] - offsets[i])); }
+};
+
+//Read-only mapping of a .stc file. Raw columns are views into the
+//mapping; compressed ones are decoded on first access (not
+//thread-safe until then, so touch them once before sharing).
+class StarColumnsFile {
+public:
+    StarColumnsFile() = default;
+    explicit StarColumnsFile(const std::string& path) { open(path); }
+    ~StarColumnsFile() { close(); }
+    StarColumnsFile(const StarColumnsFile&) = delete;
+    StarColumnsFile& operator=(const StarColumnsFile&) = delete;
+
+    //True when the file starts with the .stc magic.
+    static bool probe(const std::string& path) {
+        FILE* file = std::fopen(path.c_str(),"rb");
+        if (!file) return false;
+        char magic[8] = {0};
+        const bool ok = std::fread(magic,1,8,file) == 8 && std::memcmp(magic,"LSSTCOL1",8) == 0;
+        std::fclose(file);
+        return ok;
+    }
+
+    void open(const std::string& path) {
+        close();
+        if (!starcolumns::littleEndian()) throw std::runtime_error("Star columns: big-endian hosts are not supported");
+        map(path);
+        auto fail = [&](const std::string& why) {
+            close();
+            throw std::runtime_error("Bad star columns file (" + why + "): " + path);
+        };
+        if (size_ < sizeof(StarColumnsHeader)) fail("truncated header");
+        std::memcpy(&header_,data_,sizeof(header_));
+        if (std::memcmp(header_.magic,"LSSTCOL1",8) != 0) fail("magic");
+        if (header_.version != 1 || header_.entryBytes != sizeof(StarColumnEntry)) fail("version");
+        if (header_.directoryOffset > size_ || header_.columnCount > (size_ - header_.directoryOffset) / sizeof(StarColumnEntry)) {
+            fail("directory");
+        }
+        entries_.resize(header_.columnCount);
+        std::memcpy(entries_.data(),data_ + header_.directoryOffset,entries_.size() * sizeof(StarColumnEntry));
+        decoded_.clear();
+        decoded_.resize(entries_.size());
+        for (StarColumnEntry& entry : entries_) {
+            entry.name[sizeof(entry.name) - 1] = '\0';
+            if (entry.type < ColumnInt32 || entry.type > ColumnString || entry.codec > CodecXor) fail(std::string(entry.name) + " type");
+            if (entry.offset % 8 != 0 || entry.offset > size_ || entry.bytes > size_ - entry.offset) fail(std::string(entry.name) + " bounds");
+            if (entry.type != ColumnString) {
+                uint64_t expected = 0;
+                if (!starcolumns::multiply(header_.rowCount,starcolumns::elementBytes(entry.type),expected)) fail(std::string(entry.name) + " size");
+                if (entry.rawBytes != expected) fail(std::string(entry.name) + " size");
+            }
+            if (entry.codec == CodecRaw && entry.rawBytes != entry.bytes) fail(std::string(entry.name) + " size");
+            if (entry.type == ColumnString) {
+                //Offsets must rise monotonically within the blob, or views
+                //would reach past it.
+                uint64_t offsetBytes = 0;
+                if (header_.rowCount == UINT64_MAX || !starcolumns::multiply(header_.rowCount + 1,sizeof(uint64_t),offsetBytes)) {
+                    fail(std::string(entry.name) + " strings");
+                }
+                if (entry.codec != CodecRaw || entry.bytes < offsetBytes) fail(std::string(entry.name) + " strings");
+                const uint64_t blobBytes = entry.bytes - offsetBytes;
+                const uint64_t* offsets = reinterpret_cast<const uint64_t*>(data_ + entry.offset);
+                uint64_t previous = 0;
+                for (uint64_t i = 0; i <= header_.rowCount; i++) {
+                    if (offsets[i] < previous || offsets[i] > blobBytes) fail(std::string(entry.name) + " strings");
+                    previous = offsets[i];
+                }
+            }
+        }
+        path_ = path;
+    }
+
+    void close() {
+        #if defined(_WIN32)
+        if (data_) UnmapViewOfFile(data_);
+        #else
+        if (data_) munmap((void*)data_,size_);
+        #endif
+        data_ = nullptr;
+        size_ = 0;
+        entries_.clear();
+        decoded_.clear();
+        path_.clear();
+    }
+
+    size_t rows() const { return (size_t)header_.rowCount; }
+    const std::vector<StarColumnEntry>& columns() const { return entries_; }
+    bool has(const std::string& name) const { return find(name) >= 0; }
+
+    ColumnSpan<int32_t> int32(const std::string& name) const { return span<int32_t>(name,ColumnInt32); }
+    ColumnSpan<int64_t> int64(const std::string& name) const { return span<int64_t>(name,ColumnInt64); }
+    ColumnSpan<double> float64(const std::string& name) const { return span<double>(name,ColumnFloat64); }
+
+    StringColumnSpan strings(const std::string& name) const {
+        const StarColumnEntry& entry = require(name,ColumnString);
+        StringColumnSpan out;
+        out.offsets = reinterpret_cast<const uint64_t*>(data_ + entry.offset);
+        out.bytes = reinterpret_cast<const char*>(out.offsets + header_.rowCount + 1);
+        out.count = rows();
+        return out;
+    }
+
+private:
+    int find(const std::string& name) const {
+        for (size_t i = 0; i < entries_.size(); i++) if (name == entries_[i].name) return (int)i;
+        return -1;
+    }
+
+    const StarColumnEntry& require(const std::string& name,uint32_t type) const {
+        const int index = find(name);
+        if (index < 0) throw std::runtime_error("Star columns: no column '" + name + "' in " + path_);
+        if (entries_[index].type != type) throw std::runtime_error("Star columns: column '" + name + "' has another type in " + path_);
+        return entries_[index];
+    }
+
+    template <class T>
+    ColumnSpan<T> span(const std::string& name,uint32_t type) const {
+        const StarColumnEntry& entry = require(name,type);
+        const size_t index = (size_t)(&entry - entries_.data());
+        ColumnSpan<T> out;
+        out.count = rows();
+        if (entry.codec == CodecRaw) {
+            out.data = reinterpret_cast<const T*>(data_ + entry.offset);
+            return out;
+        }
+        if (!decoded_[index]) {
+            std::unique_ptr<uint8_t[]> buffer(new uint8_t[(size_t)entry.rawBytes + 8]);
+            const uint8_t* stored = data_ + entry.offset;
+            if (entry.codec == CodecXor) {
+                starcolumns::decodeXor(stored,(size_t)entry.bytes,reinterpret_cast<double*>(buffer.get()),rows());
+            } else {
+                std::vector<int64_t> wide(rows());
+                starcolumns::decodeDelta(stored,(size_t)entry.bytes,wide.data(),rows());
+                if (type == ColumnInt32) {
+                    for (size_t i = 0; i < rows(); i++) reinterpret_cast<int32_t*>(buffer.get())[i] = (int32_t)wide[i];
+                } else {
+                    std::memcpy(buffer.get(),wide.data(),wide.size() * sizeof(int64_t));
+                }
+            }
+            decoded_[index] = std::move(buffer);
+        }
+        out.data = reinterpret_cast<const T*>(decoded_[index].get());
+        return out;
+    }
+
+    void map(const std::string& path) {
+        #if defined(_WIN32)
+        HANDLE file = CreateFileA(path.c_str(),GENERIC_READ,FILE_SHARE_READ,nullptr,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+        if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Failed to open star columns: " + path);
+        LARGE_INTEGER bytes;
+        GetFileSizeEx(file,&bytes);
+        size_ = (size_t)bytes.QuadPart;
+        HANDLE mapping = size_ ? CreateFileMappingA(file,nullptr,PAGE_READONLY,0,0,nullptr) : nullptr;
+        CloseHandle(file);
+        if (!mapping) throw std::runtime_error("Failed to map star columns: " + path);
+        data_ = (const uint8_t*)MapViewOfFile(mapping,FILE_MAP_READ,0,0,0);
+        CloseHandle(mapping);
+        #else
+        int fd = ::open(path.c_str(),O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Failed to open star columns: " + path);
+        struct stat info;
+        if (fstat(fd,&info) != 0 || info.st_size == 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to map star columns: " + path);
+        }
+        size_ = (size_t)info.st_size;
+        void* mapped = mmap(nullptr,size_,PROT_READ,MAP_PRIVATE,fd,0);
+        ::close(fd);
+        data_ = (mapped == MAP_FAILED) ? nullptr : (const uint8_t*)mapped;
+        #endif
+        if (!data_) {
+            size_ = 0;
+            throw std::runtime_error("Failed to map star columns: " + path);
+        }
+    }
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    std::string path_;
+    StarColumnsHeader header_ = {};
+    std::vector<StarColumnEntry> entries_;
+    mutable std::vector<std::unique_ptr<uint8_t[]>> decoded_;
+};
+
+#endif // LIVE_SKYBOXES_STAR_COLUMNS_H
@@ -0,0 +1,156 @@
+//Star Columns Checks
+//Engine
+//Chris D. | Version 0 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Functional launch
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Deterministic checks for starColumns.h and the .stc branch of
+//  starTable.h:
+//
+//    round trip   every column type and codec written and read back
+//                 bit for bit, and loadStarTable() on the same file
+//    corruption   open() rejects decreasing or out-of-blob string
+//                 offsets and row counts whose column size overflows
+//
+//  Prints one line per check and exits 1 if any failed.
+
+// ============================================================== //
+// |                     COMPILE BASH SCRIPT                    | //
+// ============================================================== //
+// g++ starColumnsTests.cpp -o starColumnsTests -std=c++17 -O2 -Wall && ./starColumnsTests
+
+// ============================================================== //
+// |                      INCLUDE / DEFINE                      | //
+// ============================================================== //
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <random>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <algorithm>
+#include <filesystem>
+
+#include "starTable.h"
+
+static const std::string kScriptName = "CHRIS'S KIT";
+static int gFailures = 0;
+
+static void check(bool ok,const std::string& what) {
+    std::printf("[%s] %s %s\n",kScriptName.c_str(),ok ? "PASS" : "FAIL",what.c_str());
+    if (!ok) gFailures++;
+}
+
+// ============================================================== //
+// |                       STAR COLUMNS                         | //
+// ============================================================== //
+static bool opens(const std::string& path) {
+    try {
+        StarColumnsFile file(path);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+static void checkStarColumns(const std::filesystem::path& folder) {
+    const size_t rows = 1000;
+    std::mt19937_64 rng(7);
+    std::vector<int32_t> small(rows);
+    std::vector<int64_t> ids(rows);
+    std::vector<double> ra(rows), dec(rows);
+    std::vector<std::string> labels(rows);
+    for (size_t i = 0; i < rows; i++) {
+        small[i] = (int32_t)(rng() % 2000) - 1000;
+        ids[i] = (int64_t)(i * 3 + 100000000000LL);
+        ra[i] = (double)(rng() % 36000000) / 100000.0;
+        dec[i] = (double)(rng() % 18000000) / 100000.0 - 90.0;
+        labels[i] = (i % 7 == 0) ? std::string() : "S" + std::to_string(i);
+    }
+    const std::string path = (folder / "roundTrip.stc").string();
+    StarColumnsWriter writer(rows);
+    writer.addInt32("small",small,CodecDelta);
+    writer.addInt64("id",ids,CodecDelta);
+    writer.addInt64("idRaw",ids);
+    writer.addFloat64("ra",ra,CodecXor);
+    writer.addFloat64("dec",dec);
+    writer.addStrings("label",labels);
+    writer.write(path);
+
+    {
+        StarColumnsFile file(path);
+        ColumnSpan<int32_t> s = file.int32("small");
+        ColumnSpan<int64_t> i = file.int64("id"), r = file.int64("idRaw");
+        ColumnSpan<double> a = file.float64("ra"), d = file.float64("dec");
+        StringColumnSpan l = file.strings("label");
+        bool same = file.rows() == rows;
+        for (size_t k = 0; same && k < rows; k++) {
+            same = s[k] == small[k] && i[k] == ids[k] && r[k] == ids[k] && a[k] == ra[k] && d[k] == dec[k] && l[k] == labels[k];
+        }
+        check(same,".stc round trip (int32/int64 delta, float64 xor, raw, strings)");
+    }
+
+    //Unlabelled rows fall back to their id, as in the text loader.
+    StarTable table = loadStarTable(path);
+    bool tableSame = table.size() == rows;
+    for (size_t k = 0; tableSame && k < rows; k++) {
+        tableSame = table.rightAscension[k] == ra[k] && table.declination[k] == dec[k] && table.ids[k] == std::to_string(ids[k])
+                 && table.names[k] == (labels[k].empty() ? table.ids[k] : labels[k]);
+    }
+    check(tableSame,"loadStarTable() on .stc");
+
+    // ----- Corruption ----- //
+    std::string good;
+    {
+        std::ifstream in(path,std::ios::binary);
+        good.assign(std::istreambuf_iterator<char>(in),std::istreambuf_iterator<char>());
+    }
+    StarColumnsHeader header;
+    std::memcpy(&header,good.data(),sizeof(header));
+    std::vector<StarColumnEntry> entries(header.columnCount);
+    std::memcpy(entries.data(),good.data() + header.directoryOffset,entries.size() * sizeof(StarColumnEntry));
+    uint64_t offsetsAt = 0;
+    for (const StarColumnEntry& entry : entries) if (std::strcmp(entry.name,"label") == 0) offsetsAt = entry.offset;
+
+    const std::string bad = (folder / "corrupt.stc").string();
+    auto corrupt = [&](size_t at,uint64_t value) {
+        std::string bytes = good;
+        std::memcpy(&bytes[at],&value,sizeof(value));
+        std::ofstream(bad,std::ios::binary) << bytes;
+        return opens(bad);
+    };
+    check(opens(path),".stc opens untouched");
+    check(!corrupt(offsetsAt + 8 * 10,1),".stc rejects a decreasing string offset");
+    check(!corrupt(offsetsAt + 8 * 10,1u << 20),".stc rejects a middle string offset past the blob");
+    check(!corrupt(offsetsAt + 8 * rows,1u << 20),".stc rejects a last string offset past the blob");
+    const size_t rowCountAt = (size_t)((const char*)&header.rowCount - (const char*)&header);
+    check(!corrupt(rowCountAt,(1ULL << 61) + 1),".stc rejects a row count whose column size overflows");
+    check(!corrupt(rowCountAt,UINT64_MAX),".stc rejects the largest row count");
+}
+
+// ============================================================== //
+// |                        MAIN PROGRAM                        | //
+// ============================================================== //
+int main() {
+    try {
+        const std::filesystem::path folder = std::filesystem::temp_directory_path() / "starColumnsTests";
+        std::filesystem::create_directories(folder);
+        checkStarColumns(folder);
+        std::filesystem::remove_all(folder);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr,"Error: %s\n",e.what());
+        return 1;
+    }
+    std::printf("[%s] %s\n",kScriptName.c_str(),gFailures == 0 ? "All checks passed" : (std::to_string(gFailures) + " checks failed").c_str());
+    return gFailures == 0 ? 0 : 1;
+}
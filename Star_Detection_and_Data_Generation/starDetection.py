@@ -10,9 +10,14 @@
 # maps.
 
 import argparse
+import ctypes
 import os
+import shutil
+import subprocess
 import sys
 import math
+import struct
+import tempfile
 from typing import List, Tuple, Optional, Dict
 import cv2
 import numpy as np
@@ -55,6 +60,160 @@ def dmsToDegrees(dms: str) -> float:
     else:
         return float(dms)
 
+def findPlateSolver():
+    exe = "plateSolver.exe" if os.name == "nt" else "plateSolver"
+    bundled = os.path.join(os.path.dirname(os.path.abspath(__file__)),exe)
+    if os.path.exists(bundled):
+        return bundled
+    return shutil.which(exe) or exe
+
+# ------------------------ NATIVE DETECTOR ---------------------- #
+class SdParams(ctypes.Structure):
+    _fields_ = [("bgKernel",ctypes.c_int32),("blur",ctypes.c_int32),("minArea",ctypes.c_int32),
+                ("maxArea",ctypes.c_int32),("maxStars",ctypes.c_int32),("suppressHalo",ctypes.c_int32),
+                ("snrThreshold",ctypes.c_double),("brightPercentile",ctypes.c_double),
+                ("haloScale",ctypes.c_double),("minSeparation",ctypes.c_double),
+                ("refine",ctypes.c_int32),("refineRadius",ctypes.c_int32)]
+
+class SdResult(ctypes.Structure):
+    _fields_ = [("count",ctypes.c_int32),("candidates",ctypes.c_int32),
+                ("centerX",ctypes.POINTER(ctypes.c_double)),("centerY",ctypes.POINTER(ctypes.c_double)),
+                ("area",ctypes.POINTER(ctypes.c_int32)),("sumIntensity",ctypes.POINTER(ctypes.c_double)),
+                ("meanIntensity",ctypes.POINTER(ctypes.c_double)),("mask",ctypes.POINTER(ctypes.c_uint8)),
+                ("maskWidth",ctypes.c_int32),("maskHeight",ctypes.c_int32),("maskStride",ctypes.c_int64),
+                ("recomputedStages",ctypes.c_uint32),
+                ("flux",ctypes.POINTER(ctypes.c_double)),("fwhm",ctypes.POINTER(ctypes.c_double))]
+
+class SdOverlay(ctypes.Structure):
+    _fields_ = [("count",ctypes.c_int32),("centerX",ctypes.POINTER(ctypes.c_double)),
+                ("centerY",ctypes.POINTER(ctypes.c_double)),("radius",ctypes.POINTER(ctypes.c_double)),
+                ("labels",ctypes.POINTER(ctypes.c_char_p)),("markerRgba",ctypes.c_uint8 * 4),
+                ("textRgba",ctypes.c_uint8 * 4),("outlineRgba",ctypes.c_uint8 * 4),
+                ("labelPixels",ctypes.c_double),("outlineRadius",ctypes.c_double)]
+
+def findNativeDetector():
+    names = {"nt": "starDetection.dll","posix": "libstarDetection.dylib" if sys.platform == "darwin" else "libstarDetection.so"}
+    bundled = os.path.join(os.path.dirname(os.path.abspath(__file__)),names.get(os.name,"libstarDetection.so"))
+    return bundled if os.path.exists(bundled) else None
+
+class NativeDetector:
+    """ctypes wrapper for starDetectionCAPI. Pixels are passed by pointer and
+    the results (columns and snrMask) are NumPy views of engine-owned memory,
+    valid until the next setImage()/detect()."""
+    def __init__(self,path):
+        lib = ctypes.CDLL(path)
+        lib.sdAbiVersion.restype = ctypes.c_int32
+        if lib.sdAbiVersion() != 5:
+            raise RuntimeError(f"Unsupported native detector ABI in {path}")
+        lib.sdCreate.restype = ctypes.c_void_p
+        lib.sdDestroy.argtypes = [ctypes.c_void_p]
+        lib.sdSetImage.argtypes = [ctypes.c_void_p,ctypes.c_void_p,ctypes.c_int32,ctypes.c_int32,
+                                   ctypes.c_int32,ctypes.c_int64,ctypes.c_int32]
+        lib.sdSetImage.restype = ctypes.c_int32
+        lib.sdSetDiscs.argtypes = [ctypes.c_void_p,ctypes.POINTER(ctypes.c_double),ctypes.c_int32]
+        lib.sdSetDiscs.restype = ctypes.c_int32
+        lib.sdRun.argtypes = [ctypes.c_void_p,ctypes.POINTER(SdParams),ctypes.POINTER(SdResult)]
+        lib.sdRun.restype = ctypes.c_int32
+        lib.sdRenderOverlay.argtypes = [ctypes.c_void_p,ctypes.POINTER(SdOverlay),ctypes.c_int32,ctypes.c_int32,ctypes.c_void_p,
+                                        ctypes.c_int32,ctypes.c_int64,ctypes.c_int32,ctypes.c_void_p,ctypes.c_int64]
+        lib.sdRenderOverlay.restype = ctypes.c_int32
+        lib.sdWriteOverlayPng.argtypes = [ctypes.c_void_p,ctypes.POINTER(SdOverlay),ctypes.c_int32,ctypes.c_int32,ctypes.c_char_p]
+        lib.sdWriteOverlayPng.restype = ctypes.c_int32
+        lib.sdLastError.argtypes = [ctypes.c_void_p]
+        lib.sdLastError.restype = ctypes.c_char_p
+        self.lib = lib
+        self.handle = lib.sdCreate()
+        if not self.handle:
+            raise RuntimeError("sdCreate() failed")
+        self.image = None
+        self.discs = None
+
+    def __del__(self):
+        if getattr(self,"handle",None):
+            self.lib.sdDestroy(self.handle)
+            self.handle = None
+
+    def error(self):
+        return self.lib.sdLastError(self.handle).decode(errors="replace")
+
+    def setImage(self,bgr):
+        #Any row stride works; only pixels within a row must be packed:
+        if bgr.dtype != np.uint8 or bgr.strides[-1] != 1 or (bgr.ndim == 3 and bgr.strides[1] != bgr.shape[2]):
+            bgr = np.ascontiguousarray(bgr,dtype=np.uint8)
+        self.image = bgr #Keeps the buffer alive for the call
+        height,width = bgr.shape[:2]
+        channels = bgr.shape[2] if bgr.ndim == 3 else 1
+        if self.lib.sdSetImage(self.handle,bgr.ctypes.data,width,height,channels,bgr.strides[0],1) != 0:
+            raise RuntimeError(self.error())
+
+    def setDiscs(self,discs):
+        #[(centerX,centerY,radius),...] in pixels; [] processes the whole frame:
+        discs = [tuple(float(v) for v in disc) for disc in discs]
+        if discs == self.discs:
+            return
+        flat = (ctypes.c_double * (3 * len(discs)))(*[v for disc in discs for v in disc])
+        if self.lib.sdSetDiscs(self.handle,flat,len(discs)) != 0:
+            raise RuntimeError(self.error())
+        self.discs = discs
+
+    def detect(self,*,minArea,maxArea,blur,snrThreshold,bgKernel,brightPercentile,haloScale,suppressHalo,
+               minSeparation,maxStars,refine=0,refineRadius=6):
+        params = SdParams(refine=int(refine),refineRadius=int(refineRadius),bgKernel=int(bgKernel),blur=int(blur),minArea=int(minArea),maxArea=int(maxArea),
+                          maxStars=int(maxStars),suppressHalo=int(bool(suppressHalo)),
+                          snrThreshold=float(snrThreshold),brightPercentile=float(brightPercentile),
+                          haloScale=float(haloScale),minSeparation=float(minSeparation))
+        result = SdResult()
+        if self.lib.sdRun(self.handle,ctypes.byref(params),ctypes.byref(result)) != 0:
+            raise RuntimeError(self.error())
+        n = result.count
+        view = lambda ptr: np.ctypeslib.as_array(ptr,shape=(n,)) if n else np.empty(0)
+        columns = dict(centerX=view(result.centerX),centerY=view(result.centerY),area=view(result.area),
+                       sumIntensity=view(result.sumIntensity),meanIntensity=view(result.meanIntensity),
+                       flux=view(result.flux),fwhm=view(result.fwhm))
+        mask = np.lib.stride_tricks.as_strided(
+            np.ctypeslib.as_array(result.mask,shape=(result.maskHeight * result.maskStride,)),
+            shape=(result.maskHeight,result.maskWidth),strides=(result.maskStride,1),writeable=False)
+        return columns,mask
+
+    @staticmethod
+    def overlay(markers,color,labelPixels):
+        #markers: (centerX,centerY,radius,label or None) per star; the arrays
+        #are returned with the struct so they outlive the call:
+        n = len(markers)
+        arrays = [np.ascontiguousarray([m[k] for m in markers],dtype=np.float64) for k in range(3)]
+        labels = (ctypes.c_char_p * max(1,n))(*[(m[3] or "").encode() for m in markers])
+        withLabels = any(m[3] for m in markers)
+        pointer = lambda a: a.ctypes.data_as(ctypes.POINTER(ctypes.c_double))
+        spec = SdOverlay(count=n,centerX=pointer(arrays[0]),centerY=pointer(arrays[1]),radius=pointer(arrays[2]),
+                         labels=ctypes.cast(labels,ctypes.POINTER(ctypes.c_char_p)) if withLabels else None,
+                         markerRgba=(ctypes.c_uint8 * 4)(*color),textRgba=(ctypes.c_uint8 * 4)(255,255,255,255),
+                         outlineRgba=(ctypes.c_uint8 * 4)(0,0,0,180),labelPixels=float(labelPixels),outlineRadius=1.0)
+        return spec,(arrays,labels)
+
+    def renderOverlay(self,bgr,markers,color,labelPixels,transparent=False):
+        #RGBA image of the markers drawn over bgr (or on transparency):
+        height,width = bgr.shape[:2]
+        spec,keep = self.overlay(markers,color,labelPixels)
+        rgba = np.empty((height,width,4),dtype=np.uint8)
+        if transparent:
+            status = self.lib.sdRenderOverlay(self.handle,ctypes.byref(spec),width,height,None,0,0,0,rgba.ctypes.data,rgba.strides[0])
+        else:
+            if bgr.dtype != np.uint8 or bgr.strides[-1] != 1 or (bgr.ndim == 3 and bgr.strides[1] != bgr.shape[2]):
+                bgr = np.ascontiguousarray(bgr,dtype=np.uint8)
+            channels = bgr.shape[2] if bgr.ndim == 3 else 1
+            status = self.lib.sdRenderOverlay(self.handle,ctypes.byref(spec),width,height,bgr.ctypes.data,channels,
+                                              bgr.strides[0],1,rgba.ctypes.data,rgba.strides[0])
+        if status != 0:
+            raise RuntimeError(self.error())
+        return rgba
+
+    def writeOverlayPng(self,path,width,height,markers,color,labelPixels):
+        spec,keep = self.overlay(markers,color,labelPixels)
+        if self.lib.sdWriteOverlayPng(self.handle,ctypes.byref(spec),width,height,path.encode()) != 0:
+            raise RuntimeError(self.error())
+
+NATIVE_DETECTOR_PATH = findNativeDetector()
+
 def circleRadiusFromArea(area: float) -> float:
     return max(1.0,math.sqrt(max(area, 1.0) / math.pi))
 
@@ -246,6 +405,40 @@ def equatorialToHorizontal(rightAscension: float,declination: float,latitude: fl
     return (azimuth,altitude)
 
 
+# -------------------- COLUMNAR STAR TABLE --------------------- #
+STAR_COLUMN_TYPES = {"int32": (1,np.int32),"int64": (2,np.int64),"float64": (3,np.float64),"string": (4,None)}
+
+def writeStarColumns(path,rowCount,columns):
+    """Writes a .stc table (layout in starColumns.h), every column uncompressed.
+    columns: [(name,type,values)] with type int32/int64/float64/string."""
+    payloads = []
+    for name,kind,values in columns:
+        code,dtype = STAR_COLUMN_TYPES[kind]
+        if len(values) != rowCount:
+            raise ValueError(f"Column {name} has {len(values)} rows, expected {rowCount}")
+        if dtype is None:
+            encoded = [str(v).encode("utf-8") for v in values]
+            offsets = np.zeros(rowCount + 1,dtype="<u8")
+            offsets[1:] = np.cumsum([len(b) for b in encoded]) if encoded else []
+            data = offsets.tobytes() + b"".join(encoded)
+        else:
+            data = np.asarray(values,dtype=np.dtype(dtype).newbyteorder("<")).tobytes()
+        payloads.append((name.encode("ascii"),code,data))
+
+    alignUp = lambda value: (value + 63) & ~63
+    offset = alignUp(64 + 64 * len(payloads))
+    entries = b""
+    for name,code,data in payloads:
+        entries += struct.pack("<24sIIQQQQ",name,code,0,offset,len(data),len(data),0)
+        offset = alignUp(offset + len(data))
+    header = struct.pack("<8sIIQIIQ24x",b"LSSTCOL1",1,64,rowCount,len(payloads),64,64)
+    with open(path,"wb") as file:
+        file.write(header + entries)
+        for name,code,data in payloads:
+            file.write(b"\0" * (alignUp(file.tell()) - file.tell()))
+            file.write(data)
+
+
 # ----------------------- DETECTION MODEL ---------------------- #
 class DetectionModel(QtCore.QAbstractTableModel):
     HEAD = ["ID","Name","Area","Mean","Sum","X","Y"]
@@ -318,6 +511,13 @@ class App(QtWidgets.QMainWindow):
         self.meta = None  # ProjectionMeta
         self.lastPix = None
         self.previewMode = "single" #Single (one hemisphere) or dual (both hemispheres)
+        self.native = None
+        if NATIVE_DETECTOR_PATH:
+            try:
+                self.native = NativeDetector(NATIVE_DETECTOR_PATH)
+            except (OSError,RuntimeError) as e:
+                print(f"Native detector unavailable, using OpenCV path: {e}",file=sys.stderr)
+        self.plateCatalog = None  # Reference star table for plate solving
 
         # ================== User Interface ================== #
         central = QtWidgets.QWidget()
@@ -356,6 +556,10 @@ class App(QtWidgets.QMainWindow):
         self.haloSuppression = QtWidgets.QCheckBox("Halo Suppression")
         self.haloSuppression.setChecked(True)
         right.addWidget(self.haloSuppression)
+        self.psfRefine = QtWidgets.QCheckBox("PSF Centroids (native)")
+        self.psfRefine.setToolTip("Refine positions with a Gaussian PSF fit and report flux/FWHM")
+        self.psfRefine.setEnabled(self.native is not None)
+        right.addWidget(self.psfRefine)
         self.minSeparation = self.addSlider(right,"Min Separation (px)",8,500,20)
         self.maxStars = self.addSlider(right,"Maximum Stars to Detect",10,500,150)
 
@@ -377,6 +581,8 @@ class App(QtWidgets.QMainWindow):
         # ----- Projection Meta Button ----- #
         self.metaBtn = QtWidgets.QPushButton("Projection / Coordinate Settings...")
         right.addWidget(self.metaBtn)
+        self.solveBtn = QtWidgets.QPushButton("Plate Solve Projection...")
+        right.addWidget(self.solveBtn)
 
         # ----- Table ----- #
         self.model = DetectionModel(self)
@@ -392,10 +598,12 @@ class App(QtWidgets.QMainWindow):
         self.saveTxtBtn.clicked.connect(self.onExportTxt)
         self.colorBtn.clicked.connect(self.onPickColor)
         self.metaBtn.clicked.connect(self.onEditMeta)
+        self.solveBtn.clicked.connect(self.onPlateSolve)
         for s in (self.threshold,self.minArea,self.maxArea,self.blur,self.scale,self.bgKernel,self.haloScale,self.brightPercentile,
                   self.minSeparation,self.maxStars):
             s.valueChanged.connect(self.onParams)
         self.haloSuppression.toggled.connect(self.onParams)
+        self.psfRefine.toggled.connect(self.onParams)
         self.live.toggled.connect(self.onParams)
         self.sizeMode.toggled.connect(self.onParams)
         self.showMask.toggled.connect(self.onParams)
@@ -448,6 +656,8 @@ class App(QtWidgets.QMainWindow):
             QtWidgets.QMessageBox.critical(self,"ERROR",f"Failed to load:\n{path}")
             return
         self.bgr = bgr
+        if self.native:
+            self.native.setImage(bgr)
         height,width = bgr.shape[:2]
         # Default projection meta as a disc inferred from bounds
         radius = min(width,height) / 2.0
@@ -480,6 +690,51 @@ class App(QtWidgets.QMainWindow):
             self.meta = dialog.value()
             self.updateView()
     
+    def onPlateSolve(self):
+        if self.bgr is None or self.meta is None:
+            return
+        rows = self.model.getRows()
+        if len(rows) < 8:
+            QtWidgets.QMessageBox.warning(self,"Plate Solve","Need at least 8 detected stars.")
+            return
+        if self.plateCatalog is None or not os.path.exists(self.plateCatalog):
+            path,_ = QtWidgets.QFileDialog.getOpenFileName(self,"Reference Star Catalog","","Text (*.txt *.tsv);;All Files (*)")
+            if not path:
+                return
+            self.plateCatalog = path
+
+        # ----- Current detections -> temporary table ----- #
+        with tempfile.NamedTemporaryFile("w",suffix=".txt",delete=False,newline="") as file:
+            detectionsPath = file.name
+            file.write("id\txpix\typix\tsum\n")
+            for row in rows:
+                file.write(f"{row['id']}\t{row['centerX']:.3f}\t{row['centerY']:.3f}\t{row['sumIntensity']:.3f}\n")
+        args = [findPlateSolver(),detectionsPath,"--catalog",self.plateCatalog,
+                "--width",str(self.meta.width),"--height",str(self.meta.height),
+                "--centerX",str(self.meta.centerX),"--centerY",str(self.meta.centerY),"--radius",str(self.meta.radius),
+                "--positionAngle",str(self.meta.positionAngle)]
+        try:
+            proc = subprocess.run(args,capture_output=True,text=True)
+        except Exception as e:
+            QtWidgets.QMessageBox.critical(self,"Plate Solve",f"Could not run the plate solver:\n{e}")
+            return
+        finally:
+            os.remove(detectionsPath)
+
+        solved = [line for line in (proc.stdout or "").splitlines() if line.startswith("SOLVED ")]
+        if not solved:
+            stderr = (proc.stderr or "").strip()
+            QtWidgets.QMessageBox.warning(self,"Plate Solve",stderr if stderr else (proc.stdout or "No solution found.").strip())
+            return
+        values = dict(item.split("=",1) for item in solved[0].split() if "=" in item)
+        for key in ("rightAscensionNaught","declinationNaught","positionAngle","centerX","centerY","radius"):
+            setattr(self.meta,key,float(values[key]))
+        self.updateView()
+        QtWidgets.QMessageBox.information(self,"Plate Solve",
+            f"RA0 {self.meta.rightAscensionNaught:.3f}°, Dec0 {self.meta.declinationNaught:.3f}°, "
+            f"PA {self.meta.positionAngle:.3f}°\n{values.get('matches','?')} stars matched, "
+            f"RMS {values.get('rmsPixels','?')} px")
+
     def resizeEvent(self,ev):
         super().resizeEvent(ev)
         if self.lastPix is not None:
@@ -513,6 +768,20 @@ class App(QtWidgets.QMainWindow):
             suppressHalo = self.haloSuppression.isChecked()
         )
 
+    def detectionDiscs(self):
+        #Projection discs the native detector is limited to (skips the transparent padding)
+        if self.meta is None:
+            return []
+        if self.previewMode == "dual":
+            #compositeDblHemispheres(): two size x size discs with 5% padding
+            height,width = self.bgr.shape[:2]
+            size = next((n for n in range(height,0,-1) if n + 2 * int(n * 0.05 + 0.5) <= height),0)
+            pad = int(size * 0.05 + 0.5)
+            if size and 2 * size + 3 * pad == width:
+                return [(pad + size / 2.0,pad + size / 2.0,size / 2.0),(2 * pad + size + size / 2.0,pad + size / 2.0,size / 2.0)]
+            return []
+        return [(self.meta.centerX,self.meta.centerY,self.meta.radius)]
+
     def updateView(self):
         if self.bgr is None:
             return
@@ -520,19 +789,36 @@ class App(QtWidgets.QMainWindow):
         self.sizeByBrightness = self.sizeMode.isChecked()
 
         _,minArea,maxArea,blur,_ = self.getParams()
-        rows,binimg = detectStars(
-            self.bgr,
-            threshold=0, #Ignored in SNR mode; keep for function signature compatibility
-            minArea=minArea,
-            maxArea=maxArea,
-            blur=blur,
-            **self.getDetectKwargs()
-        )
-        rows = filterBySeparation(
-            rows,
-            minSeparation=int(self.minSeparation.value()),
-            maxKeep=int(self.maxStars.value())
-        )
+        if self.native:
+            #Native engine applies filterBySeparation itself and caches unchanged stages:
+            self.native.setDiscs(self.detectionDiscs())
+            columns,binimg = self.native.detect(
+                minArea=minArea,
+                maxArea=maxArea,
+                blur=blur,
+                minSeparation=int(self.minSeparation.value()),
+                maxStars=int(self.maxStars.value()),
+                refine=2 if self.psfRefine.isChecked() else 0,
+                **self.getDetectKwargs()
+            )
+            rows = [dict(centerX=float(x),centerY=float(y),area=int(a),sumIntensity=float(s),meanIntensity=float(m),
+                         flux=float(f),fwhm=float(w))
+                    for x,y,a,s,m,f,w in zip(columns['centerX'],columns['centerY'],columns['area'],columns['sumIntensity'],
+                                             columns['meanIntensity'],columns['flux'],columns['fwhm'])]
+        else:
+            rows,binimg = detectStars(
+                self.bgr,
+                threshold=0, #Ignored in SNR mode; keep for function signature compatibility
+                minArea=minArea,
+                maxArea=maxArea,
+                blur=blur,
+                **self.getDetectKwargs()
+            )
+            rows = filterBySeparation(
+                rows,
+                minSeparation=int(self.minSeparation.value()),
+                maxKeep=int(self.maxStars.value())
+            )
         pts = [(row['centerX'],row['centerY']) for row in rows]
         mapping = matchPoints(self.prevPts,pts,maxDist=12.0)
 
@@ -562,8 +848,33 @@ class App(QtWidgets.QMainWindow):
         fullresPix = self.renderOverlay(self.bgr,outputRows,binimg if self.showMask.isChecked() else None)
         self.showScaled(fullresPix)
 
+    def overlayMarkers(self,rows,withLabels=True):
+        #(centerX,centerY,radius,label) per row, sized as the preview draws them:
+        markers = []
+        for row in rows:
+            factor = 1.0 + (row['meanIntensity'] / 255.0) if self.sizeByBrightness else 1.0
+            radius = circleRadiusFromArea(row['area']) * self.markerScale * factor
+            label = (row.get('name') or row.get('id','')) if withLabels else None
+            markers.append((row['centerX'],row['centerY'],radius,label))
+        return markers
+
+    def overlayRgba(self):
+        color = self.overlayColor
+        return (color.red(),color.green(),color.blue(),color.alpha())
+
     def renderOverlay(self,bgr,rows,binimg=None,transparent=False,withLabels=True):
         height, width = bgr.shape[:2]
+        if self.native:
+            #Native tiled rasteriser; only the mask inset goes through QPainter:
+            rgba = self.native.renderOverlay(bgr,self.overlayMarkers(rows,withLabels),self.overlayRgba(),
+                                             self.labelSize.value(),transparent=transparent)
+            qimg = QtGui.QImage(rgba.data,width,height,rgba.strides[0],QtGui.QImage.Format.Format_RGBA8888)
+            pix = QtGui.QPixmap.fromImage(qimg)
+            if binimg is not None and not transparent:
+                painter = QtGui.QPainter(pix)
+                self.drawMaskInset(painter,binimg,width,height)
+                painter.end()
+            return pix
         if transparent:
             pix = QtGui.QPixmap(width,height)
             pix.fill(QtCore.Qt.transparent)
@@ -580,19 +891,13 @@ class App(QtWidgets.QMainWindow):
         font.setBold(True)
         painter.setFont(font)
 
-        for row in rows:
-            centerX,centerY = row['centerX'], row['centerY']
-            baseRadius = circleRadiusFromArea(row['area'])
-            factor = 1.0 + (row['meanIntensity'] / 255.0) if self.sizeByBrightness else 1.0
-            radius = baseRadius * self.markerScale * factor
-
+        for centerX,centerY,radius,text in self.overlayMarkers(rows,withLabels):
             # ----- Fill Marker ----- #
             painter.setPen(QtCore.Qt.NoPen)
             painter.setBrush(brush)
             painter.drawEllipse(QtCore.QPointF(centerX,centerY),radius,radius)
 
             if withLabels:
-                text = row.get('name') or row.get('id', '')
                 #Text with soft outline:
                 painter.setPen(QtGui.QPen(QtGui.QColor(0,0,0,180),3))
                 painter.drawText(int(centerX + radius + 4),int(centerY - radius - 4),text)
@@ -601,31 +906,34 @@ class App(QtWidgets.QMainWindow):
 
         # Inset mask for preview only:
         if binimg is not None and not transparent:
-            scaledWidth = int(width * 0.28)
-            scaledHeight = int(scaledWidth * binimg.shape[0] / binimg.shape[1])
-            binRGB = cv2.cvtColor(binimg,cv2.COLOR_GRAY2RGB)
-            maskPreviewImg = QtGui.QImage(binRGB.data,binRGB.shape[1],binRGB.shape[0],binRGB.strides[0],
-                            QtGui.QImage.Format.Format_RGB888)
-            iPix = QtGui.QPixmap.fromImage(maskPreviewImg).scaled(
-                scaledWidth,scaledHeight,QtCore.Qt.KeepAspectRatio,QtCore.Qt.SmoothTransformation
-            )
-            margin = 12
-            x0 = margin
-            y0 = height - iPix.height() - margin
-            painter.setPen(QtGui.QPen(QtGui.QColor(0,0,0,160),2))
-            painter.setBrush(QtGui.QBrush(QtGui.QColor(0,0,0,120)))
-            painter.drawRect(x0 - 4, y0 - 4,iPix.width() + 8,iPix.height() + 8)
-            painter.drawPixmap(x0,y0,iPix)
-            # ----- Inset SNR Mask ----- #
-            painter.setPen(QtGui.QPen(QtGui.QColor(255,255,255,220)))
-            font = QtGui.QFont()
-            font.setPointSize(int(self.labelSize.value()))
-            font.setBold(True)
-            painter.setFont(font)
-            painter.drawText(x0 + 6,y0 + 16,"SNR Mask")
+            self.drawMaskInset(painter,binimg,width,height)
 
         painter.end()
         return pix
+
+    def drawMaskInset(self,painter,binimg,width,height):
+        scaledWidth = int(width * 0.28)
+        scaledHeight = int(scaledWidth * binimg.shape[0] / binimg.shape[1])
+        binRGB = cv2.cvtColor(binimg,cv2.COLOR_GRAY2RGB)
+        maskPreviewImg = QtGui.QImage(binRGB.data,binRGB.shape[1],binRGB.shape[0],binRGB.strides[0],
+                        QtGui.QImage.Format.Format_RGB888)
+        iPix = QtGui.QPixmap.fromImage(maskPreviewImg).scaled(
+            scaledWidth,scaledHeight,QtCore.Qt.KeepAspectRatio,QtCore.Qt.SmoothTransformation
+        )
+        margin = 12
+        x0 = margin
+        y0 = height - iPix.height() - margin
+        painter.setPen(QtGui.QPen(QtGui.QColor(0,0,0,160),2))
+        painter.setBrush(QtGui.QBrush(QtGui.QColor(0,0,0,120)))
+        painter.drawRect(x0 - 4, y0 - 4,iPix.width() + 8,iPix.height() + 8)
+        painter.drawPixmap(x0,y0,iPix)
+        # ----- Inset SNR Mask ----- #
+        painter.setPen(QtGui.QPen(QtGui.QColor(255,255,255,220)))
+        font = QtGui.QFont()
+        font.setPointSize(int(self.labelSize.value()))
+        font.setBold(True)
+        painter.setFont(font)
+        painter.drawText(x0 + 6,y0 + 16,"SNR Mask")
     
     def showScaled(self,fullresPix: QtGui.QPixmap):
         self.lastPix = fullresPix
@@ -651,6 +959,22 @@ class App(QtWidgets.QMainWindow):
             return
         outPath,withLabels = dialog.filepath(),dialog.includeLabels()
 
+        if self.native:
+            #Rendered and written natively; no full-size QPixmap round trip:
+            height,width = self.bgr.shape[:2]
+            try:
+                self.native.writeOverlayPng(outPath,width,height,self.overlayMarkers(self.model.getRows(),withLabels),
+                                            self.overlayRgba(),self.labelSize.value())
+                exportSuccessful = True
+            except RuntimeError as e:
+                print(f"Overlay export failed: {e}",file=sys.stderr)
+                exportSuccessful = False
+            QtWidgets.QMessageBox.information(
+                self,"Export Overlay",
+                "Saved:\n" + outPath if exportSuccessful else "Failed to save."
+            )
+            return
+
         pix = self.renderOverlay(self.bgr,self.model.getRows(),binimg=None,
                                  transparent=True,withLabels=withLabels)
         exportSuccessful = pix.save(outPath,"PNG")
@@ -670,46 +994,72 @@ class App(QtWidgets.QMainWindow):
         mode = dialog.mode()  # "equatorial" or "horizontal"
         includeGHA = dialog.includeGHA()  # Greenwich Hour Angle
 
-        path,_ = QtWidgets.QFileDialog.getSaveFileName(self,"Save Catalog",".","Text (*.txt)")
+        path,_ = QtWidgets.QFileDialog.getSaveFileName(self,"Save Catalog",".","Text (*.txt);;Star Columns (*.stc)")
         if not path:
             return
 
+        if mode != "equatorial":
+            # Horizontal requires latitude + local sidereal time (LST)
+            if meta.observerLatitude is None:
+                QtWidgets.QMessageBox.warning(self,"Horizontal Export",
+                                            "Observer latitude is required.")
+                return
+            # Interpret greenwichSiderealTime as LST if longitude is None; otherwise LST = GST + longitude
+            if meta.greenwichSiderealTime is None and meta.observerLongitude is None:
+                QtWidgets.QMessageBox.warning(self,"Horizontal Export",
+                                            "Provide LST (or GST and observer longitude).")
+                return
+            if meta.greenwichSiderealTime is not None:
+                lst = (meta.greenwichSiderealTime + (meta.observerLongitude or 0.0)) % 360.0 #Local Sidereal Time
+            else:
+                lst = 0.0
+
         rows = self.model.getRows()
+        angles = []
+        for row in rows:
+            ra,dec = imageXYtoEquatorial(meta,row['centerX'],row['centerY'])
+            if mode == "equatorial":
+                gha = (meta.greenwichSiderealTime - ra) % 360.0 if includeGHA and meta.greenwichSiderealTime is not None else None
+                angles.append((ra,dec,gha))
+            else:
+                az,alt = equatorialToHorizontal(
+                    ra,dec,meta.observerLatitude,meta.observerLongitude or 0.0,lst
+                )
+                angles.append((az,alt,None))
+
+        if path.lower().endswith(".stc"):
+            #Columnar table for the native tools (starColumns.h), no text parsing on load
+            first,second = ("ra","dec") if mode == "equatorial" else ("az","alt")
+            columns = [("id","int64",list(range(1,len(rows) + 1))),
+                       ("label","string",[row.get('name') or row['id'] for row in rows]),
+                       ("x","float64",[row['centerX'] for row in rows]),
+                       ("y","float64",[row['centerY'] for row in rows]),
+                       (first,"float64",[a[0] for a in angles]),
+                       (second,"float64",[a[1] for a in angles]),
+                       ("flux","float64",[row.get('sumIntensity',0.0) if row.get('flux') is None else row['flux'] for row in rows]),
+                       ("area","int32",[row.get('area',0) for row in rows]),
+                       ("frame","int32",[0] * len(rows)),
+                       ("track","int32",[-1] * len(rows))]
+            if mode == "equatorial" and includeGHA and meta.greenwichSiderealTime is not None:
+                columns.append(("gha","float64",[a[2] for a in angles]))
+            writeStarColumns(path,len(rows),columns)
+            QtWidgets.QMessageBox.information(self, "Export Catalog", f"Saved:\n{path}")
+            return
+
         with open(path,"w",newline="") as file:
             writeOut = lambda s: file.write(s + "\n")
             if mode == "equatorial":
                 header = "id\tname\txpix\typix\tra_deg\tdec_deg" + ("\tgha_deg" if includeGHA else "")
                 writeOut(header)
-                for row in rows:
-                    ra,dec = imageXYtoEquatorial(meta,row['centerX'],row['centerY'])
+                for row,(ra,dec,gha) in zip(rows,angles):
                     line = f"{row['id']}\t{row.get('name','')}\t{row['centerX']:.3f}\t{row['centerY']:.3f}\t{ra:.6f}\t{dec:.6f}"
-                    if includeGHA and meta.greenwichSiderealTime is not None:
-                        gha = (meta.greenwichSiderealTime - ra) % 360.0
+                    if gha is not None:
                         line += f"\t{gha:.6f}"
                     writeOut(line)
             else:
-                # Horizontal requires latitude + local sidereal time (LST)
-                if meta.observerLatitude is None:
-                    QtWidgets.QMessageBox.warning(self,"Horizontal Export",
-                                                "Observer latitude is required.")
-                    return
-                # Interpret greenwichSiderealTime as LST if longitude is None; otherwise LST = GST + longitude
-                if meta.greenwichSiderealTime is None and meta.observerLongitude is None:
-                    QtWidgets.QMessageBox.warning(self,"Horizontal Export",
-                                                "Provide LST (or GST and observer longitude).")
-                    return
-                if meta.greenwichSiderealTime is not None:
-                    lst = (meta.greenwichSiderealTime + (meta.observerLongitude or 0.0)) % 360.0 #Local Sidereal Time
-                else:
-                    lst = 0.0
-
                 header = "id\tname\txpix\typix\taz_deg\talt_deg"
                 writeOut(header)
-                for row in rows:
-                    ra,dec = imageXYtoEquatorial(meta,row['centerX'],row['centerY'])
-                    az,alt = equatorialToHorizontal(
-                        ra,dec,meta.observerLatitude,meta.observerLongitude or 0.0,lst
-                    )
+                for row,(az,alt,_) in zip(rows,angles):
                     writeOut(f"{row['id']}\t{row.get('name','')}\t{row['centerX']:.3f}\t{row['centerY']:.3f}\t{az:.6f}\t{alt:.6f}")
         QtWidgets.QMessageBox.information(self, "Export Catalog", f"Saved:\n{path}")
 
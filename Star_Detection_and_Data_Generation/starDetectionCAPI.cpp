@@ -0,0 +1,264 @@
+//Star Detection
+//C ABI (Shared Library)
+//Chris D. | Version 4 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Functional launch
+//  Version 1 (10/18/2026): refine parameters; flux and fwhm in SdResult (ABI 2)
+//  Version 2 (10/18/2026): sdSetDiscs() for projection discs (ABI 3)
+//  Version 3 (10/18/2026): Overlay rendering (ABI 4)
+//  Version 4 (10/18/2026): sdCopyStars() copies flux and fwhm too (ABI 5)
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Implements starDetectionCAPI.h on top of StarDetectionEngine.
+//  The selected rows are mirrored into column vectors owned by the
+//  handle, so Python can view them (and the candidate mask) with
+//  numpy.ctypeslib.as_array() instead of copying.
+//
+//  The overlay calls wrap overlayRenderer.h so the Python preview
+//  and overlay export skip QPainter's per-star loop.
+
+// ============================================================== //
+// |                     COMPILE BASH SCRIPT                    | //
+// ============================================================== //
+// Linux:   g++ starDetectionCAPI.cpp -o libstarDetection.so -std=c++17 -O3 -Wall -shared -fPIC
+// macOS:   clang++ starDetectionCAPI.cpp -o libstarDetection.dylib -std=c++17 -O3 -Wall -shared -fPIC
+// Windows: g++ starDetectionCAPI.cpp -o starDetection.dll -std=c++17 -O3 -Wall -shared
+// (multi-threaded) add: -fopenmp -DUSE_OMP
+// (AVX2 mask shifts) add: -mavx2
+
+// ============================================================== //
+// |                      INCLUDE / DEFINE                      | //
+// ============================================================== //
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+
+#include "starDetectionCAPI.h"
+#include "starDetectionEngine.h"
+#include "overlayRenderer.h"
+#include "../Stereographic_Projection/stb_image_write.h"
+
+struct SdEngine {
+    StarDetectionEngine engine;
+    std::vector<double> centerX, centerY, sumIntensity, meanIntensity, flux, fwhm;
+    std::vector<int32_t> area;
+    std::string error;
+};
+
+static DetectionParams toDetectionParams(const SdParams& in) {
+    DetectionParams params;
+    params.bgKernel = in.bgKernel;
+    params.blur = in.blur;
+    params.minArea = in.minArea;
+    params.maxArea = in.maxArea;
+    params.maxStars = in.maxStars;
+    params.suppressHalo = in.suppressHalo != 0;
+    params.snrThreshold = in.snrThreshold;
+    params.brightPercentile = in.brightPercentile;
+    params.haloScale = in.haloScale;
+    params.minSeparation = in.minSeparation;
+    params.refine = in.refine;
+    params.refineRadius = in.refineRadius;
+    return params;
+}
+
+static overlay::Markers toMarkers(const SdOverlay& in,overlay::Style& style) {
+    if (in.count < 0 || (in.count > 0 && (!in.centerX || !in.centerY || !in.radius))) {
+        throw std::runtime_error("overlay: bad marker arrays");
+    }
+    style.marker = {in.markerRgba[0],in.markerRgba[1],in.markerRgba[2],in.markerRgba[3]};
+    style.text = {in.textRgba[0],in.textRgba[1],in.textRgba[2],in.textRgba[3]};
+    style.outline = {in.outlineRgba[0],in.outlineRgba[1],in.outlineRgba[2],in.outlineRgba[3]};
+    style.labelPixels = in.labelPixels;
+    style.outlineRadius = in.outlineRadius;
+    overlay::Markers markers;
+    markers.x = in.centerX;
+    markers.y = in.centerY;
+    markers.radius = in.radius;
+    markers.labels = in.labels;
+    markers.count = (size_t)in.count;
+    return markers;
+}
+
+// ============================================================== //
+// |                          C ABI                             | //
+// ============================================================== //
+extern "C" {
+
+SD_API int32_t sdAbiVersion(void) { return SD_ABI_VERSION; }
+
+SD_API void sdDefaultParams(SdParams* params) {
+    if (!params) return;
+    DetectionParams defaults;
+    params->bgKernel = defaults.bgKernel;
+    params->blur = defaults.blur;
+    params->minArea = defaults.minArea;
+    params->maxArea = defaults.maxArea;
+    params->maxStars = defaults.maxStars;
+    params->suppressHalo = defaults.suppressHalo ? 1 : 0;
+    params->snrThreshold = defaults.snrThreshold;
+    params->brightPercentile = defaults.brightPercentile;
+    params->haloScale = defaults.haloScale;
+    params->minSeparation = defaults.minSeparation;
+    params->refine = defaults.refine;
+    params->refineRadius = defaults.refineRadius;
+}
+
+SD_API SdEngine* sdCreate(void) {
+    try {
+        return new SdEngine();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+SD_API void sdDestroy(SdEngine* engine) { delete engine; }
+
+SD_API int32_t sdSetImage(SdEngine* engine,const uint8_t* pixels,int32_t width,int32_t height,
+                          int32_t channels,int64_t strideBytes,int32_t bgr) {
+    if (!engine) return -1;
+    try {
+        if (strideBytes < (int64_t)width * channels) throw std::runtime_error("sdSetImage: stride smaller than a row");
+        engine->engine.setImage(pixels,width,height,channels,(size_t)strideBytes,bgr != 0);
+        engine->error.clear();
+        return 0;
+    } catch (const std::exception& e) {
+        engine->error = e.what();
+        return -1;
+    }
+}
+
+SD_API int32_t sdSetDiscs(SdEngine* engine,const double* discs,int32_t count) {
+    if (!engine) return -1;
+    try {
+        if (count < 0 || (count > 0 && !discs)) throw std::runtime_error("sdSetDiscs: bad disc list");
+        std::vector<detection::Disc> items((size_t)count);
+        for (int32_t i = 0; i < count; i++) items[i] = {discs[3 * i],discs[3 * i + 1],discs[3 * i + 2]};
+        engine->engine.setDiscs(items);
+        engine->error.clear();
+        return 0;
+    } catch (const std::exception& e) {
+        engine->error = e.what();
+        return -1;
+    }
+}
+
+SD_API int32_t sdRun(SdEngine* engine,const SdParams* params,SdResult* result) {
+    if (!engine) return -1;
+    try {
+        if (!params || !result) throw std::runtime_error("sdRun: null params or result");
+        const std::vector<StarRow>& rows = engine->engine.run(toDetectionParams(*params));
+
+        // ----- Mirror the rows as columns owned by the handle ----- //
+        const size_t n = rows.size();
+        engine->centerX.resize(n); engine->centerY.resize(n);
+        engine->sumIntensity.resize(n); engine->meanIntensity.resize(n);
+        engine->area.resize(n); engine->flux.resize(n); engine->fwhm.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            engine->centerX[i] = rows[i].centerX;
+            engine->centerY[i] = rows[i].centerY;
+            engine->area[i] = rows[i].area;
+            engine->sumIntensity[i] = rows[i].sumIntensity;
+            engine->meanIntensity[i] = rows[i].meanIntensity;
+            engine->flux[i] = rows[i].flux;
+            engine->fwhm[i] = rows[i].fwhm;
+        }
+
+        result->count = (int32_t)n;
+        result->candidates = (int32_t)engine->engine.stars().size();
+        result->centerX = engine->centerX.data();
+        result->centerY = engine->centerY.data();
+        result->area = engine->area.data();
+        result->sumIntensity = engine->sumIntensity.data();
+        result->meanIntensity = engine->meanIntensity.data();
+        result->mask = engine->engine.candidateMask();
+        result->maskWidth = engine->engine.width();
+        result->maskHeight = engine->engine.height();
+        result->maskStride = engine->engine.width();
+        result->recomputedStages = engine->engine.recomputedStages();
+        result->flux = engine->flux.data();
+        result->fwhm = engine->fwhm.data();
+        engine->error.clear();
+        return 0;
+    } catch (const std::exception& e) {
+        engine->error = e.what();
+        return -1;
+    }
+}
+
+SD_API int32_t sdCopyStars(const SdEngine* engine,int32_t capacity,double* centerX,double* centerY,
+                           int32_t* area,double* sumIntensity,double* meanIntensity,double* flux,double* fwhm) {
+    if (!engine || capacity < 0) return -1;
+    int32_t n = std::min<int32_t>(capacity,(int32_t)engine->centerX.size());
+    for (int32_t i = 0; i < n; i++) {
+        if (centerX) centerX[i] = engine->centerX[i];
+        if (centerY) centerY[i] = engine->centerY[i];
+        if (area) area[i] = engine->area[i];
+        if (sumIntensity) sumIntensity[i] = engine->sumIntensity[i];
+        if (meanIntensity) meanIntensity[i] = engine->meanIntensity[i];
+        if (flux) flux[i] = engine->flux[i];
+        if (fwhm) fwhm[i] = engine->fwhm[i];
+    }
+    return n;
+}
+
+SD_API int32_t sdRenderOverlay(SdEngine* engine,const SdOverlay* overlay,int32_t width,int32_t height,
+                               const uint8_t* background,int32_t channels,int64_t strideBytes,int32_t bgr,
+                               uint8_t* rgba,int64_t rgbaStride) {
+    if (!engine) return -1;
+    try {
+        if (!overlay) throw std::runtime_error("sdRenderOverlay: null overlay");
+        if (background && strideBytes < (int64_t)width * channels) throw std::runtime_error("sdRenderOverlay: stride smaller than a row");
+        overlay::Style style;
+        const overlay::Markers markers = toMarkers(*overlay,style);
+        overlay::render(markers,style,width,height,background,channels,(size_t)std::max<int64_t>(0,strideBytes),bgr != 0,
+                        rgba,(size_t)std::max<int64_t>(0,rgbaStride));
+        engine->error.clear();
+        return 0;
+    } catch (const std::exception& e) {
+        engine->error = e.what();
+        return -1;
+    }
+}
+
+SD_API int32_t sdWriteOverlayPng(SdEngine* engine,const SdOverlay* overlay,int32_t width,int32_t height,const char* path) {
+    if (!engine) return -1;
+    try {
+        if (!overlay || !path) throw std::runtime_error("sdWriteOverlayPng: null overlay or path");
+        if (width <= 0 || height <= 0) throw std::runtime_error("sdWriteOverlayPng: empty image");
+        overlay::Style style;
+        const overlay::Markers markers = toMarkers(*overlay,style);
+        std::vector<uint8_t> rgba((size_t)width * height * 4);
+        overlay::render(markers,style,width,height,nullptr,0,0,false,rgba.data(),(size_t)width * 4);
+        if (!stbi_write_png(path,width,height,4,rgba.data(),width * 4)) {
+            throw std::runtime_error(std::string("sdWriteOverlayPng: failed to write ") + path);
+        }
+        engine->error.clear();
+        return 0;
+    } catch (const std::exception& e) {
+        engine->error = e.what();
+        return -1;
+    }
+}
+
+SD_API double sdStageMilliseconds(const SdEngine* engine,int32_t stage) {
+    if (!engine || stage < 0 || stage >= StageCount) return 0.0;
+    return engine->engine.stageMilliseconds(stage);
+}
+
+SD_API const char* sdStageName(int32_t stage) {
+    return (stage >= 0 && stage < StageCount) ? kDetectionStageNames[stage] : "";
+}
+
+SD_API const char* sdLastError(const SdEngine* engine) {
+    return engine ? engine->error.c_str() : "null engine";
+}
+
+} // extern "C"
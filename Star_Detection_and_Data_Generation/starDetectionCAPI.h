@@ -0,0 +1,132 @@
+/* Star Detection
+   C ABI (Shared Library Header)
+   Chris D. | Version 4 | Version Date: 10/18/2026 */
+
+/* ============================================================== */
+/* |                      VERSION HISTORY                       | */
+/* ============================================================== */
+/*  Version 0 (10/18/2026): Functional launch (ABI 1)
+    Version 1 (10/18/2026): refine/refineRadius in SdParams; flux
+        and fwhm in SdResult (ABI 2)
+    Version 2 (10/18/2026): sdSetDiscs() (ABI 3)
+    Version 3 (10/18/2026): SdOverlay, sdRenderOverlay() and
+        sdWriteOverlayPng() (ABI 4)
+    Version 4 (10/18/2026): sdCopyStars() copies flux and fwhm; a
+        bgKernel past 255 makes sdRun() fail (ABI 5)                 */
+
+/* ============================================================== */
+/* |                    PROGRAM DESCRIPTION                     | */
+/* ============================================================== */
+/*  Plain C interface to starDetectionEngine.h for ctypes (see
+    NativeDetector in starDetection.py) and any other FFI.
+
+    Ownership:
+      - sdSetImage() reads the caller's pixels in place (any row
+        stride, 1/3/4 channels) and keeps no pointer to them.
+      - sdRun() fills an SdResult whose arrays and mask belong to the
+        engine. They stay valid until the next sdRun()/sdSetImage()/
+        sdDestroy() on that handle, so they can be wrapped as NumPy
+        views without copying.
+      - sdCopyStars() copies the same columns (flux and fwhm included)
+        into caller-allocated arrays instead; NULL skips a column.
+      - sdRenderOverlay() draws into a caller-allocated RGBA buffer;
+        sdWriteOverlayPng() writes the transparent overlay itself.
+        Neither keeps the SdOverlay arrays.
+    A handle is not thread-safe; use one per thread.                 */
+
+#ifndef LIVE_SKYBOXES_STAR_DETECTION_CAPI_H
+#define LIVE_SKYBOXES_STAR_DETECTION_CAPI_H
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define SD_API __declspec(dllexport)
+#else
+#define SD_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SD_ABI_VERSION 5
+
+typedef struct SdParams {
+    int32_t bgKernel;               /* Forced odd, >= 3; past 255 sdRun() fails */
+    int32_t blur;
+    int32_t minArea;
+    int32_t maxArea;
+    int32_t maxStars;
+    int32_t suppressHalo;
+    double snrThreshold;
+    double brightPercentile;
+    double haloScale;
+    double minSeparation;
+    int32_t refine;                 /* 0 off, 1 moments, 2 Gaussian PSF */
+    int32_t refineRadius;
+} SdParams;
+
+/* Structure-of-arrays view of the selected stars, brightest first. */
+typedef struct SdResult {
+    int32_t count;
+    int32_t candidates;             /* Stars before filterBySeparation */
+    const double* centerX;
+    const double* centerY;
+    const int32_t* area;
+    const double* sumIntensity;
+    const double* meanIntensity;
+    const uint8_t* mask;            /* Final candidate mask, 0/255 */
+    int32_t maskWidth;
+    int32_t maskHeight;
+    int64_t maskStride;             /* Bytes between mask rows */
+    uint32_t recomputedStages;      /* Bit per DetectionStage */
+    const double* flux;             /* 0 unless refine != 0 */
+    const double* fwhm;
+} SdResult;
+
+/* Markers for overlayRenderer.h, one entry per star. */
+typedef struct SdOverlay {
+    int32_t count;
+    const double* centerX;
+    const double* centerY;
+    const double* radius;
+    const char* const* labels;      /* UTF-8, NULL for markers only */
+    uint8_t markerRgba[4];
+    uint8_t textRgba[4];
+    uint8_t outlineRgba[4];
+    double labelPixels;             /* Glyph height; <= 0 draws no labels */
+    double outlineRadius;
+} SdOverlay;
+
+typedef struct SdEngine SdEngine;
+
+SD_API int32_t sdAbiVersion(void);
+SD_API void sdDefaultParams(SdParams* params);
+SD_API SdEngine* sdCreate(void);
+SD_API void sdDestroy(SdEngine* engine);
+
+/* All calls below return 0 on success, -1 on error (see sdLastError). */
+SD_API int32_t sdSetImage(SdEngine* engine,const uint8_t* pixels,int32_t width,int32_t height,
+                          int32_t channels,int64_t strideBytes,int32_t bgr);
+/* discs: count (centerX, centerY, radius) triples in pixels; count 0
+   restores whole-frame detection. Kept across sdSetImage(). */
+SD_API int32_t sdSetDiscs(SdEngine* engine,const double* discs,int32_t count);
+SD_API int32_t sdRun(SdEngine* engine,const SdParams* params,SdResult* result);
+SD_API int32_t sdCopyStars(const SdEngine* engine,int32_t capacity,double* centerX,double* centerY,
+                           int32_t* area,double* sumIntensity,double* meanIntensity,double* flux,double* fwhm);
+/* background: 1/3/4 channel pixels under the overlay (BGR order when
+   bgr != 0), or NULL for a transparent buffer. rgba receives straight
+   RGBA rows rgbaStride bytes apart. */
+SD_API int32_t sdRenderOverlay(SdEngine* engine,const SdOverlay* overlay,int32_t width,int32_t height,
+                               const uint8_t* background,int32_t channels,int64_t strideBytes,int32_t bgr,
+                               uint8_t* rgba,int64_t rgbaStride);
+SD_API int32_t sdWriteOverlayPng(SdEngine* engine,const SdOverlay* overlay,int32_t width,int32_t height,const char* path);
+SD_API double sdStageMilliseconds(const SdEngine* engine,int32_t stage);
+SD_API const char* sdStageName(int32_t stage);
+SD_API const char* sdLastError(const SdEngine* engine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIVE_SKYBOXES_STAR_DETECTION_CAPI_H */
@@ -0,0 +1,509 @@
+//Star Detection
+//Native Engine
+//Chris D. | Version 7 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Functional launch
+//  Version 1 (10/18/2026): Bit-packed masks, with an -mavx2 build
+//      option for the row shifts
+//  Version 2 (10/18/2026): --refine / --refineRadius and the flux and
+//      fwhm columns
+//  Version 3 (10/18/2026): Tiled detection (--tile, --tileHaloMargin)
+//  Version 4 (10/18/2026): Projection discs (--disc)
+//  Version 5 (10/18/2026): Columnar .stc output
+//  Version 6 (10/18/2026): Stage-cache and latency metrics
+//      (--metricsPort, --metricsFile)
+//  Version 7 (10/18/2026): Sequence mode (--sequence) tracking stars
+//      through rotation time-lapses (sequenceDetection.h)
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Command-line front end for starDetectionEngine.h. Detects stars
+//  in a stereographic hemisphere image with the same parameters as
+//  the starDetection.py sliders and writes a detection table that
+//  plateSolver reads directly.
+//
+//  --sweep name=v1,v2,... reruns detection once per value on the
+//  same engine and reports which stages the cache had to recompute,
+//  e.g. --sweep snrThreshold=10,11,12 never recomputes the median.
+//
+//  --refine 1|2 replaces the mask centroids with intensity moments or
+//  a Gaussian PSF fit and fills the flux/fwhm columns.
+//
+//  --tile N detects over N x N tiles (tiledDetection.h) so peak memory
+//  follows the tile size rather than the panorama; --tileHaloMargin
+//  sets the bright-source context kept around each tile.
+//
+//  --disc cx,cy,r (repeatable) limits detection to projection discs,
+//  skipping the transparent padding; --disc auto is the centered disc
+//  starDetection.py assumes, --disc hemispheres the two discs of a
+//  *_stereoHemispheres.png composite.
+//
+//  An --out path ending in .stc writes the columnar table
+//  (starColumns.h) instead of text; plateSolver reads either.
+//
+//  --sequence frames.txt detects across a rotation time-lapse
+//  (sequenceDetection.h): full scans every --fullScanEvery frames,
+//  and in between only windows around each star's rotated position.
+//  --rotation gives the per-disc step in degrees per frame (estimated
+//  from the first two frames when omitted). --out takes a {frame}
+//  placeholder for the frame's file stem; the id column is then the
+//  star's track id, stable across frames.
+//
+//  --metricsPort N / --metricsFile F export Prometheus text
+//  (engineMetrics.h): per-stage recomputed vs cached runs, stage
+//  latency, and stars selected.
+
+// ============================================================== //
+// |                     COMPILE BASH SCRIPT                    | //
+// ============================================================== //
+// g++ starDetectionEngine.cpp -o starDetectionEngine -std=c++17 -O3 -Wall
+// (multi-threaded) add: -fopenmp -DUSE_OMP
+// (AVX2 mask shifts) add: -mavx2
+// (Windows/MinGW) add: -lws2_32
+// (checks) g++ starDetectionTests.cpp -o starDetectionTests -std=c++17 -O2 -Wall && ./starDetectionTests
+// (checks) g++ bitMaskTests.cpp -o bitMaskTests -std=c++17 -O2 -Wall && ./bitMaskTests
+// (checks) g++ starColumnsTests.cpp -o starColumnsTests -std=c++17 -O2 -Wall && ./starColumnsTests
+
+// ============================================================== //
+// |                      INCLUDE / DEFINE                      | //
+// ============================================================== //
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+#include <memory>
+#include <algorithm>
+
+#include "../Stereographic_Projection/stb_image.h"
+#include "../Stereographic_Projection/stb_image_write.h"
+#include "starDetectionEngine.h"
+#include "tiledDetection.h"
+#include "sequenceDetection.h"
+#include "starColumns.h"
+#include "../engineMetrics.h"
+
+static const std::string kScriptName = "CHRIS'S KIT";
+
+// ============================================================== //
+// |                          OPTIONS                           | //
+// ============================================================== //
+struct Options {
+    std::string input;
+    std::string outPath;
+    std::string maskPath;
+    std::string sweepName;
+    std::vector<double> sweepValues;
+    DetectionParams params;
+    tiled::TileOptions tiles;
+    bool tiled = false;
+    std::vector<std::string> discSpecs;
+    std::string sequence;           // Frame list, one image per line
+    sequence::SequenceOptions sequenceOptions;
+    int metricsPort = 0;
+    std::string metricsFile;
+};
+
+//Applies one named parameter; false if the name is unknown.
+static bool setParam(DetectionParams& params,const std::string& name,double value) {
+    if      (name == "bgKernel")         params.bgKernel = (int)value;
+    else if (name == "snrThreshold")     params.snrThreshold = value;
+    else if (name == "blur")             params.blur = (int)value;
+    else if (name == "brightPercentile") params.brightPercentile = value;
+    else if (name == "haloScale")        params.haloScale = value;
+    else if (name == "suppressHalo")     params.suppressHalo = (value != 0.0);
+    else if (name == "minArea")          params.minArea = (int)value;
+    else if (name == "maxArea")          params.maxArea = (int)value;
+    else if (name == "minSeparation")    params.minSeparation = value;
+    else if (name == "maxStars")         params.maxStars = (int)value;
+    else if (name == "refine")           params.refine = (int)value;
+    else if (name == "refineRadius")     params.refineRadius = (int)value;
+    else return false;
+    return true;
+}
+
+static void usage(const char* argv0) {
+    std::fprintf(stderr,
+        "Usage: %s <image> [--out detections.txt] [--mask mask.png]\n"
+        "       %s --sequence <frames.txt> [--out {frame}_detections.txt] [--fullScanEvery K] (default 10)\n"
+        "          [--rotation deg[,deg]] (per disc and frame; default: estimated) [--maxRotation deg] (default 5)\n"
+        "          [--searchRadius px] (default 6) [--windowMargin px] (default 6)\n"
+        "     [--bgKernel N] [--snrThreshold X] [--blur N] [--brightPercentile X] [--haloScale X]\n"
+        "     [--suppressHalo 0|1] [--minArea N] [--maxArea N] [--minSeparation X] [--maxStars N]\n"
+        "     [--refine 0|1|2] (off, moments, Gaussian PSF) [--refineRadius N]\n"
+        "     [--sweep name=v1,v2,...] (rerun on the cached engine, one value at a time)\n"
+        "     [--tile N] [--tileHaloMargin N] (overlapping N x N tiles for large panoramas)\n"
+        "     [--disc cx,cy,r | auto | hemispheres] (repeatable; detect inside projection discs only)\n"
+        "     [--metricsPort N] [--metricsFile metrics.prom] (Prometheus text)\n",
+        argv0,argv0);
+}
+
+static Options parseArguments(int argc,char** argv) {
+    Options opt;
+    if (argc < 2) {
+        usage(argv[0]);
+        std::exit(1);
+    }
+    int first = 1;
+    if (std::strncmp(argv[1],"--",2) != 0) { opt.input = argv[1]; first = 2; }
+    for (int i=first; i < argc; i++) {
+        std::string key = argv[i];
+        auto need = [&](bool has) { if (!has) throw std::runtime_error("[" + kScriptName + "]: Missing value for " + key); };
+        if (key == "--out") { need(i + 1 < argc); opt.outPath = argv[++i]; }
+        else if (key == "--mask") { need(i + 1 < argc); opt.maskPath = argv[++i]; }
+        else if (key == "--tile") { need(i + 1 < argc); opt.tiles.tileSize = std::stoi(argv[++i]); opt.tiled = true; }
+        else if (key == "--disc") { need(i + 1 < argc); opt.discSpecs.push_back(argv[++i]); }
+        else if (key == "--tileHaloMargin") { need(i + 1 < argc); opt.tiles.haloMargin = std::stoi(argv[++i]); }
+        else if (key == "--sequence") { need(i + 1 < argc); opt.sequence = argv[++i]; }
+        else if (key == "--fullScanEvery") { need(i + 1 < argc); opt.sequenceOptions.fullScanEvery = std::stoi(argv[++i]); }
+        else if (key == "--searchRadius") { need(i + 1 < argc); opt.sequenceOptions.searchRadius = std::stoi(argv[++i]); }
+        else if (key == "--windowMargin") { need(i + 1 < argc); opt.sequenceOptions.windowMargin = std::stoi(argv[++i]); }
+        else if (key == "--maxRotation") { need(i + 1 < argc); opt.sequenceOptions.maxRotationDegrees = std::stod(argv[++i]); }
+        else if (key == "--rotation") {
+            need(i + 1 < argc);
+            std::string list = argv[++i];
+            opt.sequenceOptions.rotationDegrees.clear();
+            for (size_t begin=0, end; begin <= list.size(); begin = end + 1) {
+                end = list.find(',',begin);
+                if (end == std::string::npos) end = list.size();
+                opt.sequenceOptions.rotationDegrees.push_back(std::stod(list.substr(begin,end - begin)));
+            }
+        }
+        else if (key == "--metricsPort") { need(i + 1 < argc); opt.metricsPort = std::stoi(argv[++i]); }
+        else if (key == "--metricsFile") { need(i + 1 < argc); opt.metricsFile = argv[++i]; }
+        else if (key == "--sweep") {
+            need(i + 1 < argc);
+            std::string spec = argv[++i];
+            size_t eq = spec.find('=');
+            if (eq == std::string::npos) throw std::runtime_error("[" + kScriptName + "]: --sweep expects name=v1,v2,...");
+            opt.sweepName = spec.substr(0,eq);
+            std::string list = spec.substr(eq + 1);
+            size_t start = 0;
+            while (start <= list.size()) {
+                size_t comma = list.find(',',start);
+                std::string item = list.substr(start,comma == std::string::npos ? std::string::npos : comma - start);
+                if (!item.empty()) opt.sweepValues.push_back(std::stod(item));
+                if (comma == std::string::npos) break;
+                start = comma + 1;
+            }
+            DetectionParams probe;
+            if (!setParam(probe,opt.sweepName,0.0)) throw std::runtime_error("[" + kScriptName + "]: Unknown sweep parameter: " + opt.sweepName);
+        }
+        else if (key.rfind("--",0) == 0 && i + 1 < argc && setParam(opt.params,key.substr(2),std::stod(argv[i + 1]))) { i++; }
+        else { usage(argv[0]); throw std::runtime_error("[" + kScriptName + "]: Unknown argument: " + key); }
+    }
+    if (opt.input.empty() == opt.sequence.empty()) throw std::runtime_error("[" + kScriptName + "]: Give exactly one of <image> or --sequence");
+    if (opt.tiled && (!opt.maskPath.empty() || !opt.sweepValues.empty() || opt.params.refine != psf::RefineOff)) {
+        throw std::runtime_error("[" + kScriptName + "]: --mask, --sweep and --refine need the full-frame engine; drop --tile");
+    }
+    if (!opt.sequence.empty()) {
+        if (opt.tiled || !opt.maskPath.empty() || !opt.sweepValues.empty()) {
+            throw std::runtime_error("[" + kScriptName + "]: --sequence does not combine with --tile, --mask or --sweep");
+        }
+        if (!opt.outPath.empty() && opt.outPath.find("{frame}") == std::string::npos) {
+            throw std::runtime_error("[" + kScriptName + "]: --sequence needs {frame} in --out");
+        }
+    }
+    return opt;
+}
+
+//Disc specs in image pixels. "hemispheres" inverts the layout of
+//compositeDblHemispheres(): two size x size discs, 5% padding.
+static std::vector<detection::Disc> resolveDiscs(const std::vector<std::string>& specs,int width,int height) {
+    std::vector<detection::Disc> discs;
+    for (const std::string& spec : specs) {
+        if (spec == "auto") {
+            discs.push_back({width / 2.0,height / 2.0,std::min(width,height) / 2.0});
+        } else if (spec == "hemispheres") {
+            int size = height;
+            while (size > 0 && size + 2 * (int)std::lround(size * 0.05) > height) size--;
+            const int pad = (int)std::lround(size * 0.05);
+            if (size <= 0 || 2 * size + 3 * pad != width) {
+                throw std::runtime_error("[" + kScriptName + "]: --disc hemispheres: " + std::to_string(width) + "x" +
+                                         std::to_string(height) + " is not a hemisphere composite");
+            }
+            discs.push_back({pad + size / 2.0,pad + size / 2.0,size / 2.0});
+            discs.push_back({2 * pad + size + size / 2.0,pad + size / 2.0,size / 2.0});
+        } else {
+            detection::Disc disc;
+            if (std::sscanf(spec.c_str(),"%lf,%lf,%lf",&disc.centerX,&disc.centerY,&disc.radius) != 3) {
+                throw std::runtime_error("[" + kScriptName + "]: --disc expects cx,cy,r, auto or hemispheres: " + spec);
+            }
+            discs.push_back(disc);
+        }
+    }
+    return discs;
+}
+
+// ============================================================== //
+// |                          OUTPUTS                           | //
+// ============================================================== //
+static void printRun(const StarDetectionEngine& engine,const char* label,double totalMs) {
+    std::string stages;
+    for (int s = 0; s < StageCount; s++) {
+        if (!(engine.recomputedStages() & (1u << s))) continue;
+        char buffer[64];
+        std::snprintf(buffer,sizeof(buffer),"%s%s %.1f",stages.empty() ? "" : ", ",kDetectionStageNames[s],engine.stageMilliseconds(s));
+        stages += buffer;
+    }
+    std::printf("[%s] %s: %zu stars (%zu candidates) in %.1f ms | recomputed: %s\n",kScriptName.c_str(),label,
+                engine.selection().size(),engine.stars().size(),totalMs,stages.empty() ? "nothing" : stages.c_str());
+}
+
+//A stage that was not recomputed counts as a cache hit.
+static void recordRun(const StarDetectionEngine& engine) {
+    metrics::Registry& registry = metrics::registry();
+    for (int s = 0; s < StageCount; s++) {
+        const std::string stage = std::string("stage=\"") + kDetectionStageNames[s] + "\"";
+        const bool recomputed = (engine.recomputedStages() & (1u << s)) != 0;
+        registry.counter("detection_stage_runs_total","Detection stages per run, recomputed or served from the stage cache.",
+                         stage + (recomputed ? ",result=\"recomputed\"" : ",result=\"cached\"")).add();
+        if (recomputed) {
+            registry.histogram("detection_stage_seconds","Wall time of recomputed stages.",stage).observe(engine.stageMilliseconds(s) * 1e-3);
+        }
+    }
+    registry.counter("detection_runs_total","Detection runs.").add();
+    registry.gauge("detection_stars_selected","Stars selected by the last run.").set((double)engine.selection().size());
+}
+
+//Same columns as the Python catalog export, plus the detection stats
+//(flux and fwhm are 0 unless --refine is on).
+//ids: track ids in sequence mode; empty numbers the rows from 1.
+static void writeDetections(const std::string& path,const std::vector<StarRow>& rows,const std::vector<int64_t>& ids) {
+    FILE* file = std::fopen(path.c_str(),"wb");
+    if (!file) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + path);
+    std::fprintf(file,"id\tname\txpix\typix\tarea\tmean\tsum\tflux\tfwhm\n");
+    for (size_t i = 0; i < rows.size(); i++) {
+        std::fprintf(file,"%lld\t\t%.3f\t%.3f\t%d\t%.3f\t%.1f\t%.1f\t%.3f\n",ids.empty() ? (long long)i + 1 : (long long)ids[i],rows[i].centerX,rows[i].centerY,
+                     rows[i].area,rows[i].meanIntensity,rows[i].sumIntensity,rows[i].flux,rows[i].fwhm);
+    }
+    if (std::fclose(file) != 0) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + path);
+}
+
+//The same rows as a columnar .stc table; flux is the PSF flux when
+//refined, else the summed intensity.
+static void writeDetectionColumns(const std::string& path,const std::vector<StarRow>& rows,const std::vector<int64_t>& ids) {
+    std::vector<int64_t> id(rows.size());
+    std::vector<int32_t> area(rows.size());
+    std::vector<double> x(rows.size()), y(rows.size()), flux(rows.size()), sum(rows.size()), mean(rows.size()), fwhm(rows.size());
+    for (size_t i = 0; i < rows.size(); i++) {
+        id[i] = ids.empty() ? (int64_t)i + 1 : ids[i];
+        x[i] = rows[i].centerX;
+        y[i] = rows[i].centerY;
+        area[i] = rows[i].area;
+        flux[i] = (rows[i].flux > 0.0) ? rows[i].flux : rows[i].sumIntensity;
+        sum[i] = rows[i].sumIntensity;
+        mean[i] = rows[i].meanIntensity;
+        fwhm[i] = rows[i].fwhm;
+    }
+    StarColumnsWriter writer(rows.size());
+    writer.addInt64("id",id,CodecDelta);
+    writer.addFloat64("x",x);
+    writer.addFloat64("y",y);
+    writer.addFloat64("flux",flux);
+    writer.addInt32("area",area,CodecDelta);
+    writer.addFloat64("sum",sum);
+    writer.addFloat64("mean",mean);
+    writer.addFloat64("fwhm",fwhm);
+    try {
+        writer.write(path);
+    } catch (const std::exception& e) {
+        throw std::runtime_error("[" + kScriptName + "]: " + e.what());
+    }
+}
+
+static void writeOutput(const std::string& path,const std::vector<StarRow>& rows,const std::vector<int64_t>& ids = {}) {
+    const bool columnar = path.size() >= 4 && path.compare(path.size() - 4,4,".stc") == 0;
+    if (columnar) writeDetectionColumns(path,rows,ids);
+    else writeDetections(path,rows,ids);
+}
+
+// ============================================================== //
+// |                       SEQUENCE DRIVER                      | //
+// ============================================================== //
+//Blank lines and # comments are skipped; relative paths resolve
+//against the list's folder.
+static std::vector<std::string> readFrameList(const std::string& path) {
+    std::ifstream list(path);
+    if (!list) throw std::runtime_error("[" + kScriptName + "]: Failed to load: " + path);
+    const std::filesystem::path folder = std::filesystem::path(path).parent_path();
+    std::vector<std::string> frames;
+    std::string line;
+    while (std::getline(list,line)) {
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) line.pop_back();
+        size_t first = line.find_first_not_of(" \t");
+        if (first == std::string::npos || line[first] == '#') continue;
+        std::filesystem::path frame(line.substr(first));
+        if (frame.is_relative()) frame = folder / frame;
+        frames.push_back(frame.string());
+    }
+    if (frames.empty()) throw std::runtime_error("[" + kScriptName + "]: No frames in " + path);
+    return frames;
+}
+
+//{frame} -> the frame's file stem; without --out, <stem>_detections.txt
+//next to the frame.
+static std::string sequenceOutput(const std::string& pattern,const std::string& frame) {
+    const std::filesystem::path path(frame);
+    if (pattern.empty()) return (path.parent_path() / (path.stem().string() + "_detections.txt")).string();
+    std::string out = pattern;
+    for (size_t at; (at = out.find("{frame}")) != std::string::npos;) out.replace(at,7,path.stem().string());
+    return out;
+}
+
+static void runSequence(const Options& opt) {
+    using Clock = std::chrono::steady_clock;
+    const std::vector<std::string> frames = readFrameList(opt.sequence);
+    metrics::Registry& registry = metrics::registry();
+    metrics::Counter& fullFrames = registry.counter("detection_sequence_frames_total","Sequence frames by how they were detected.","mode=\"full\"");
+    metrics::Counter& trackedFrames = registry.counter("detection_sequence_frames_total","","mode=\"tracked\"");
+    metrics::Counter& lostStars = registry.counter("detection_sequence_stars_lost_total","Tracked stars not found near their prediction.");
+    metrics::Histogram& fullSeconds = registry.histogram("detection_stage_seconds","Wall time of recomputed stages.","stage=\"sequenceFull\"");
+    metrics::Histogram& trackedSeconds = registry.histogram("detection_stage_seconds","","stage=\"sequenceTracked\"");
+
+    std::unique_ptr<sequence::SequenceDetector> detector;
+    double fullMs = 0.0, trackedMs = 0.0;
+    int fullCount = 0;
+    for (size_t f=0; f < frames.size(); f++) {
+        int width, height, channels;
+        stbi_uc* pixels = stbi_load(frames[f].c_str(),&width,&height,&channels,3);
+        if (!pixels) throw std::runtime_error("[" + kScriptName + "]: Failed to load: " + frames[f]);
+        sequence::FrameResult result;
+        auto start = Clock::now();
+        try {
+            if (!detector) detector.reset(new sequence::SequenceDetector(opt.params,opt.sequenceOptions,resolveDiscs(opt.discSpecs,width,height)));
+            start = Clock::now();
+            result = detector->detect(pixels,width,height,3,(size_t)width * 3,/*bgr=*/false);
+        } catch (...) {
+            stbi_image_free(pixels);
+            throw;
+        }
+        stbi_image_free(pixels);
+        const double ms = std::chrono::duration<double,std::milli>(Clock::now() - start).count();
+
+        std::string rotation;
+        for (int d = 0; d < detector->discCount(); d++) {
+            char buffer[32];
+            std::snprintf(buffer,sizeof(buffer),"%s%.4f",d ? "," : "",detector->rotationDegrees(d));
+            rotation += buffer;
+        }
+        if (result.fullScan) {
+            fullFrames.add();
+            fullSeconds.observe(ms * 1e-3);
+            fullMs += ms;
+            fullCount++;
+            std::printf("[%s] frame %zu (full scan): %zu stars, %d new in %.1f ms | rotation %s deg/frame\n",
+                        kScriptName.c_str(),f,result.rows.size(),result.newcomers,ms,rotation.c_str());
+        } else {
+            trackedFrames.add();
+            trackedSeconds.observe(ms * 1e-3);
+            lostStars.add((uint64_t)(result.predicted - result.recovered));
+            trackedMs += ms;
+            std::printf("[%s] frame %zu (tracked): %zu stars, %d/%d recovered in %.2f ms (%zu px read) | rotation %s deg/frame\n",
+                        kScriptName.c_str(),f,result.rows.size(),result.recovered,result.predicted,ms,result.pixelsRead,rotation.c_str());
+        }
+        registry.gauge("detection_stars_selected","Stars selected by the last run.").set((double)result.rows.size());
+
+        const std::string out = sequenceOutput(opt.outPath,frames[f]);
+        writeOutput(out,result.rows,result.ids);
+        std::printf("Wrote: %s\n",out.c_str());
+    }
+    const int trackedCount = (int)frames.size() - fullCount;
+    std::printf("[%s] %zu frames: %d full scans (%.1f ms mean), %d tracked (%.2f ms mean)\n",kScriptName.c_str(),frames.size(),
+                fullCount,fullCount ? fullMs / fullCount : 0.0,trackedCount,trackedCount ? trackedMs / trackedCount : 0.0);
+}
+
+// ============================================================== //
+// |                        MAIN PROGRAM                        | //
+// ============================================================== //
+int main(int argc,char** argv) {
+    try {
+        Options opt = parseArguments(argc,argv);
+        metrics::Exporter exporter;     // Final dump when main returns
+        exporter.start(opt.metricsPort,opt.metricsFile);
+        if (!opt.sequence.empty()) { runSequence(opt); return 0; }
+        int width, height, channels;
+        stbi_uc* pixels = stbi_load(opt.input.c_str(),&width,&height,&channels,3);
+        if (!pixels) throw std::runtime_error("[" + kScriptName + "]: Failed to load: " + opt.input);
+        std::vector<detection::Disc> discs;
+        try {
+            discs = resolveDiscs(opt.discSpecs,width,height);
+        } catch (...) {
+            stbi_image_free(pixels);
+            throw;
+        }
+
+        if (opt.tiled) {
+            auto start = std::chrono::steady_clock::now();
+            tiled::TiledDetection result;
+            try {
+                result = tiled::detect(pixels,width,height,3,(size_t)width * 3,/*bgr=*/false,opt.params,opt.tiles,discs);
+            } catch (...) {
+                stbi_image_free(pixels);
+                throw;
+            }
+            stbi_image_free(pixels);
+            double ms = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - start).count();
+            metrics::registry().histogram("detection_stage_seconds","Wall time of recomputed stages.","stage=\"tiled\"").observe(ms * 1e-3);
+            metrics::registry().counter("detection_tiles_total","Tiles detected in --tile mode.").add((uint64_t)result.tiles);
+            metrics::registry().gauge("detection_stars_selected","Stars selected by the last run.").set((double)result.selection.size());
+            std::printf("[%s] tiled: %zu stars (%zu candidates) in %.1f ms | %d tiles, margin %d, %.1f MB per tile\n",
+                        kScriptName.c_str(),result.selection.size(),result.stars.size(),ms,result.tiles,result.margin,
+                        result.tileBytes / (1024.0 * 1024.0));
+            if (!opt.outPath.empty()) {
+                writeOutput(opt.outPath,result.selection);
+                std::printf("Wrote: %s\n",opt.outPath.c_str());
+            }
+            return 0;
+        }
+
+        StarDetectionEngine engine;
+        engine.setDiscs(discs);
+        auto t0 = std::chrono::steady_clock::now();
+        engine.setImage(pixels,width,height,3,(size_t)width * 3,/*bgr=*/false);
+        stbi_image_free(pixels);
+        engine.run(opt.params);
+        auto t1 = std::chrono::steady_clock::now();
+        printRun(engine,"initial",std::chrono::duration<double,std::milli>(t1 - t0).count());
+        recordRun(engine);
+
+        for (double value : opt.sweepValues) {
+            DetectionParams params = opt.params;
+            setParam(params,opt.sweepName,value);
+            auto start = std::chrono::steady_clock::now();
+            engine.run(params);
+            double ms = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - start).count();
+            std::string label = opt.sweepName + "=" + std::to_string(value);
+            printRun(engine,label.c_str(),ms);
+            recordRun(engine);
+        }
+        if (!opt.sweepValues.empty()) engine.run(opt.params);
+
+        if (!opt.outPath.empty()) {
+            writeOutput(opt.outPath,engine.selection());
+            std::printf("Wrote: %s\n",opt.outPath.c_str());
+        }
+        if (!opt.maskPath.empty()) {
+            if (!stbi_write_png(opt.maskPath.c_str(),width,height,1,engine.candidateMask(),width)) {
+                throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + opt.maskPath);
+            }
+            std::printf("Wrote: %s\n",opt.maskPath.c_str());
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr,"Error: %s\n",e.what());
+        return 1;
+    }
+} // END OF MAIN PROGRAM
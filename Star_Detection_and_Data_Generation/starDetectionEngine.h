@@ -0,0 +1,1226 @@
+//Star Detection
+//Native Engine (Shared Header)
+//Chris D. | Version 8 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Port of detectStars() with a
+//      dependency-tracked stage cache.
+//  Version 1 (10/18/2026): Halo suppression as a row-band spatial
+//      query while extracting runs (no halo raster).
+//  Version 2 (10/18/2026): Bright mask thresholded straight into bits
+//      (bitMask.h); gray histogram built once per image.
+//  Version 3 (10/18/2026): SNR mask kept bit-packed too, from
+//      threshold through labelling.
+//  Version 4 (10/18/2026): Optional PSF centroid refinement stage
+//      (psfRefine.h) reporting flux and FWHM.
+//  Version 5 (10/18/2026): Shared star/selection helpers and a
+//      brightLevel override for tiled runs (tiledDetection.h).
+//  Version 6 (10/18/2026): Disc footprint: filters, thresholds and
+//      labelling restricted to each row's in-disc span.
+//  Version 7 (10/18/2026): background()/sigma() accessors for
+//      sequence tracking (sequenceDetection.h).
+//  Version 8 (10/18/2026): bgKernel past 255 is rejected instead of
+//      overflowing the median's 16-bit window counts.
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Native port of detectStars() and filterBySeparation() from
+//  starDetection.py. Every intermediate map is kept between runs
+//  and tagged with a key built from its parameters and the
+//  versions of its inputs, so a run only recomputes the stages
+//  downstream of what changed:
+//
+//    Gray ── Background(bgKernel) ── Sigma ── SnrMask(snrThreshold,blur) ─┐
+//     └───── BrightMask(brightPercentile) ──────────────────────────────── CandidateMask(haloScale,suppressHalo)
+//                                                                          └─ Components ── Stars(minArea,maxArea)
+//                                                                                           └─ Refine(refine,refineRadius)
+//                                                                                              └─ Selection(minSeparation,maxStars)
+//
+//  Moving the SNR threshold reruns the masks and labelling but not
+//  the median background; moving minArea only refilters components.
+//
+//  z = (gray - background) / max(sigma,1) is never stored; the masks
+//  evaluate it per pixel from the three 8-bit maps.
+//
+//  Halo discs are not rasterized. CandidateMask stores the candidate
+//  runs directly: rows no halo reaches are the SNR mask's runs, and
+//  only the spans inside halos are re-tested against 2 * snrThreshold.
+//  candidateMask() paints the runs into a raster on first request.
+//
+//  The SNR and bright masks are one bit per pixel (bitMask.h): z is
+//  thresholded straight into words, MORPH_OPEN/CLOSE run as word
+//  shifts, the blur/re-threshold step only evaluates pixels within
+//  blur / 2 of a set bit, and the labeller reads runs off the words.
+//
+//  setDiscs() takes the projection discs (ProjectionMeta centerX,
+//  centerY, radius; two for the side-by-side composite). Background
+//  and sigma are then computed only on each row's in-disc span, with
+//  the windows reflecting at the disc edge rather than averaging in
+//  the transparent padding; masks are thresholded and labelled on the
+//  same spans, and brightPercentile counts in-disc pixels only.
+
+#ifndef LIVE_SKYBOXES_STAR_DETECTION_ENGINE_H
+#define LIVE_SKYBOXES_STAR_DETECTION_ENGINE_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+#include "bitMask.h"
+#include "psfRefine.h"
+
+// ============================================================== //
+// |                      PARAMETERS / ROWS                     | //
+// ============================================================== //
+//Defaults follow the starDetection.py sliders.
+struct DetectionParams {
+    int bgKernel = 81;              // Forced odd, >= 3; at most kMaxBackgroundKernel
+    double snrThreshold = 12.0;
+    int blur = 3;                   // <= 1 disables the open/blur cleanup
+    double brightPercentile = 0.998;
+    double haloScale = 2.5;
+    bool suppressHalo = true;
+    int minArea = 12;
+    int maxArea = 50;
+    double minSeparation = 20.0;
+    int maxStars = 150;
+    int refine = psf::RefineOff;    // psf::RefineMode; off keeps detectStars()' plain centroids
+    int refineRadius = 6;           // Refinement window half-size
+    int brightLevel = -1;           // >= 0 overrides brightPercentile (tiles pass the frame-wide level)
+};
+
+//The median filters count each window in uint16_t bins, so k * k must
+//stay below 65536.
+static const int kMaxBackgroundKernel = 255;
+
+//Background window edge for bgKernel: forced odd and >= 3, rejected
+//past kMaxBackgroundKernel.
+static inline int backgroundKernel(const DetectionParams& params) {
+    const int k = std::max(3,params.bgKernel | 1);
+    if (k > kMaxBackgroundKernel) {
+        throw std::runtime_error("bgKernel must be at most " + std::to_string(kMaxBackgroundKernel) + " (got " + std::to_string(params.bgKernel) + ")");
+    }
+    return k;
+}
+
+struct StarRow {
+    double centerX = 0.0, centerY = 0.0;
+    int area = 0;
+    double sumIntensity = 0.0, meanIntensity = 0.0;
+    int left = 0, top = 0, right = 0, bottom = 0;   // Inclusive bounds
+    double flux = 0.0, fwhm = 0.0;                  // Set by the Refine stage
+};
+
+enum DetectionStage {
+    StageGray,
+    StageBackground,
+    StageSigma,
+    StageSnrMask,
+    StageBrightMask,
+    StageCandidateMask,
+    StageComponents,
+    StageStars,
+    StageRefine,
+    StageSelection,
+    StageCount
+};
+
+static const char* const kDetectionStageNames[StageCount] = {
+    "gray","background","sigma","snrMask","brightMask","candidateMask","components","stars","refine","selection"
+};
+
+// ============================================================== //
+// |                         IMAGE OPS                          | //
+// ============================================================== //
+namespace detection {
+
+static inline int threadCount() {
+    #ifdef USE_OMP
+    return omp_get_max_threads();
+    #else
+    return 1;
+    #endif
+}
+
+static inline int clampIndex(int i,int n) { return i < 0 ? 0 : (i >= n ? n - 1 : i); }
+
+//OpenCV BORDER_REFLECT_101: ... 2 1 | 0 1 2 ... n-1 | n-2 ...
+static inline int reflect101(int i,int n) {
+    if (n == 1) return 0;
+    while (i < 0 || i >= n) i = (i < 0) ? -i : 2 * n - 2 - i;
+    return i;
+}
+
+// ----- BGR/RGB/gray (any stride) -> 8-bit gray, cv2.COLOR_BGR2GRAY weights ----- //
+static inline void toGray(const uint8_t* pixels,int width,int height,int channels,size_t strideBytes,bool bgr,uint8_t* gray) {
+    const int rWeight = 4899, gWeight = 9617, bWeight = 1868; // 0.299, 0.587, 0.114 in Q14
+    #ifdef USE_OMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (int y = 0; y < height; y++) {
+        const uint8_t* row = pixels + (size_t)y * strideBytes;
+        uint8_t* out = gray + (size_t)y * width;
+        if (channels == 1) {
+            std::memcpy(out,row,(size_t)width);
+            continue;
+        }
+        const int r = bgr ? 2 : 0, b = bgr ? 0 : 2;
+        for (int x = 0; x < width; x++) {
+            const uint8_t* p = row + (size_t)x * channels;
+            out[x] = (uint8_t)((p[b] * bWeight + p[1] * gWeight + p[r] * rWeight + (1 << 13)) >> 14);
+        }
+    }
+}
+
+// ----- Median filter, BORDER_REPLICATE (cv2.medianBlur) ----- //
+//Constant-time median (Perreault & Hebert): one 256-bin histogram per
+//column slides down the strip, and the kernel histogram slides across
+//each row by adding one column and removing another. A 16-bin coarse
+//level keeps the median search short.
+static inline void medianFilter(const uint8_t* src,uint8_t* dst,int width,int height,int k) {
+    const int r = k / 2;
+    const int need = (k * k) / 2 + 1;  // Rank of the median (1-based)
+    const int stripRows = std::max(32,(height + threadCount() * 4 - 1) / (threadCount() * 4));
+    const int strips = (height + stripRows - 1) / stripRows;
+
+    #ifdef USE_OMP
+    #pragma omp parallel for schedule(dynamic,1)
+    #endif
+    for (int strip = 0; strip < strips; strip++) {
+        const int y0 = strip * stripRows, y1 = std::min(height,y0 + stripRows);
+        std::vector<uint16_t> fine((size_t)width * 256,0), coarse((size_t)width * 16,0);
+        auto addRow = [&](int y,int delta) {
+            const uint8_t* row = src + (size_t)clampIndex(y,height) * width;
+            for (int x = 0; x < width; x++) {
+                fine[(size_t)x * 256 + row[x]] += (uint16_t)delta;
+                coarse[(size_t)x * 16 + (row[x] >> 4)] += (uint16_t)delta;
+            }
+        };
+        for (int dy = -r; dy <= r; dy++) addRow(y0 + dy,1);
+
+        for (int y = y0; y < y1; y++) {
+            if (y > y0) {
+                addRow(y - r - 1,-1);
+                addRow(y + r,1);
+            }
+            alignas(32) uint16_t kernelFine[256];
+            alignas(32) uint16_t kernelCoarse[16];
+            std::memset(kernelFine,0,sizeof(kernelFine));
+            std::memset(kernelCoarse,0,sizeof(kernelCoarse));
+            for (int dx = -r; dx <= r; dx++) {
+                const uint16_t* f = &fine[(size_t)clampIndex(dx,width) * 256];
+                const uint16_t* c = &coarse[(size_t)clampIndex(dx,width) * 16];
+                for (int i = 0; i < 256; i++) kernelFine[i] += f[i];
+                for (int i = 0; i < 16; i++) kernelCoarse[i] += c[i];
+            }
+            uint8_t* out = dst + (size_t)y * width;
+            for (int x = 0; x < width; x++) {
+                if (x > 0) {
+                    const size_t add = (size_t)clampIndex(x + r,width), sub = (size_t)clampIndex(x - r - 1,width);
+                    if (add != sub) {
+                        const uint16_t* fa = &fine[add * 256]; const uint16_t* fs = &fine[sub * 256];
+                        const uint16_t* ca = &coarse[add * 16]; const uint16_t* cs = &coarse[sub * 16];
+                        for (int i = 0; i < 256; i++) kernelFine[i] = (uint16_t)(kernelFine[i] + fa[i] - fs[i]);
+                        for (int i = 0; i < 16; i++) kernelCoarse[i] = (uint16_t)(kernelCoarse[i] + ca[i] - cs[i]);
+                    }
+                }
+                int count = 0, bin = 0;
+                while (count + kernelCoarse[bin] < need) count += kernelCoarse[bin++];
+                int value = bin * 16;
+                while (count + kernelFine[value] < need) count += kernelFine[value++];
+                out[x] = (uint8_t)value;
+            }
+        }
+    }
+}
+
+// ----- sigma = box(|gray - background|), BORDER_REFLECT_101 (cv2.blur) ----- //
+static inline void absDiffBoxFilter(const uint8_t* a,const uint8_t* b,uint8_t* dst,int width,int height,int k) {
+    const int r = k / 2;
+    const double scale = 1.0 / ((double)k * k);
+    const int stripRows = std::max(32,(height + threadCount() * 4 - 1) / (threadCount() * 4));
+    const int strips = (height + stripRows - 1) / stripRows;
+
+    #ifdef USE_OMP
+    #pragma omp parallel for schedule(dynamic,1)
+    #endif
+    for (int strip = 0; strip < strips; strip++) {
+        const int y0 = strip * stripRows, y1 = std::min(height,y0 + stripRows);
+        std::vector<int> columnSum((size_t)width,0);
+        std::vector<int> padded((size_t)width + 2 * r);
+        auto addRow = [&](int y,int sign) {
+            const size_t offset = (size_t)reflect101(y,height) * width;
+            for (int x = 0; x < width; x++) columnSum[x] += sign * std::abs((int)a[offset + x] - (int)b[offset + x]);
+        };
+        for (int dy = -r; dy <= r; dy++) addRow(y0 + dy,1);
+        for (int y = y0; y < y1; y++) {
+            if (y > y0) {
+                addRow(y - r - 1,-1);
+                addRow(y + r,1);
+            }
+            for (int i = 0; i < width + 2 * r; i++) padded[i] = columnSum[reflect101(i - r,width)];
+            int sum = 0;
+            for (int i = 0; i < k; i++) sum += padded[i];
+            uint8_t* out = dst + (size_t)y * width;
+            for (int x = 0; x < width; x++) {
+                if (x > 0) sum += padded[x + k - 1] - padded[x - 1];
+                out[x] = (uint8_t)std::min(255L,std::lrint(sum * scale));
+            }
+        }
+    }
+}
+
+// ----- GaussianBlur(k x k) + threshold(127) on a binary mask ----- //
+static inline std::vector<double> gaussianKernel(int k) {
+    static const double small[4][7] = {
+        {1.0},
+        {0.25,0.5,0.25},
+        {0.0625,0.25,0.375,0.25,0.0625},
+        {0.03125,0.109375,0.21875,0.28125,0.21875,0.109375,0.03125}
+    };
+    std::vector<double> kernel((size_t)k);
+    if (k <= 7) {
+        for (int i = 0; i < k; i++) kernel[i] = small[k / 2][i];
+        return kernel;
+    }
+    double sigma = 0.3 * ((k - 1) * 0.5 - 1.0) + 0.8, sum = 0.0;
+    for (int i = 0; i < k; i++) {
+        double x = i - (k - 1) * 0.5;
+        kernel[i] = std::exp(-x * x / (2.0 * sigma * sigma));
+        sum += kernel[i];
+    }
+    for (double& w : kernel) w /= sum;
+    return kernel;
+}
+
+//GaussianBlur(k x k) then threshold(127) on a packed mask, BORDER_REFLECT_101.
+//A pixel survives when its blurred 0/1 weight * 255 >= 127.5. Only
+//pixels within k / 2 of a set bit can reach that, so the blur is
+//evaluated there alone, with the same float operations in the same
+//order as the separable row/column pass would use.
+static inline void gaussianThreshold(bitmask::BitMask& mask,int k) {
+    const std::vector<double> kernel64 = gaussianKernel(k);
+    const std::vector<float> kernel(kernel64.begin(),kernel64.end());
+    const int r = k / 2, width = mask.width, height = mask.height;
+    bitmask::BitMask support;
+    bitmask::dilate(mask,support,bitmask::Kernel::rect(k,k));
+    bitmask::BitMask out;
+    out.resize(width,height);
+    #ifdef USE_OMP
+    #pragma omp parallel for schedule(dynamic,16)
+    #endif
+    for (int y = 0; y < height; y++) {
+        const uint64_t* candidates = support.row(y);
+        uint64_t* result = out.row(y);
+        for (int w = 0; w < support.wordsPerRow; w++) {
+            uint64_t bits = candidates[w];
+            while (bits) {
+                const int x = 64 * w + bitmask::countTrailingZeros(bits);
+                bits &= bits - 1;
+                float sum = 0.0f;
+                for (int i = 0; i < k; i++) {
+                    const int sourceY = reflect101(y + i - r,height);
+                    float rowSum = 0.0f;
+                    for (int t = 0; t < k; t++) rowSum += kernel[t] * (mask.test(reflect101(x + t - r,width),sourceY) ? 1.0f : 0.0f);
+                    sum += kernel[i] * rowSum;
+                }
+                if (sum * 255.0f >= 127.5f) result[w] |= 1ULL << (x & 63);
+            }
+        }
+    }
+    mask = std::move(out);
+}
+
+// ----- percentile() from starDetection.py: 256-bin histogram, searchsorted ----- //
+//Per-thread histograms (four interleaved banks each, so runs of equal
+//pixels do not serialize on one counter), reduced into one.
+static inline std::vector<uint64_t> histogram256(const uint8_t* gray,size_t count) {
+    std::vector<uint64_t> histogram(256,0);
+    #ifdef USE_OMP
+    #pragma omp parallel
+    #endif
+    {
+        uint32_t banks[4][256] = {};
+        uint64_t local[256] = {};
+        const long long total = (long long)count;
+        #ifdef USE_OMP
+        #pragma omp for schedule(static)
+        #endif
+        for (long long block = 0; block < (total + 65535) / 65536; block++) {
+            const long long begin = block * 65536, end = std::min(total,begin + 65536);
+            long long i = begin;
+            for (; i + 4 <= end; i += 4) {
+                banks[0][gray[i]]++; banks[1][gray[i + 1]]++;
+                banks[2][gray[i + 2]]++; banks[3][gray[i + 3]]++;
+            }
+            for (; i < end; i++) banks[0][gray[i]]++;
+            for (int bin = 0; bin < 256; bin++) {
+                local[bin] += (uint64_t)banks[0][bin] + banks[1][bin] + banks[2][bin] + banks[3][bin];
+                banks[0][bin] = banks[1][bin] = banks[2][bin] = banks[3][bin] = 0;
+            }
+        }
+        #ifdef USE_OMP
+        #pragma omp critical
+        #endif
+        for (int bin = 0; bin < 256; bin++) histogram[bin] += local[bin];
+    }
+    return histogram;
+}
+
+static inline int percentileBin(const std::vector<uint64_t>& histogram,size_t count,double q) {
+    q = std::min(1.0,std::max(0.0,q));
+    double target = q * (double)count;
+    uint64_t cumulative = 0;
+    for (int bin = 0; bin < 256; bin++) {
+        cumulative += histogram[bin];
+        if ((double)cumulative >= target) return bin;
+    }
+    return 256;
+}
+
+// ============================================================== //
+// |                      DISC FOOTPRINT                        | //
+// ============================================================== //
+//Projection discs (ProjectionMeta centerX, centerY, radius). A pixel
+//belongs to a disc when (x - cx)^2 + (y - cy)^2 <= r^2, the test
+//makeDisc() uses, so the transparent corners are never filtered,
+//thresholded or labelled.
+struct Disc { double centerX = 0.0, centerY = 0.0, radius = 0.0; };
+
+//In-disc span of every row and every column (the disc is convex, so
+//each is one interval), clipped to the image.
+struct DiscSpans {
+    int top = 0, bottom = 0;        // Rows [top, bottom)
+    int left = 0, right = 0;        // Columns [left, right)
+    std::vector<int> x0, x1;        // Row y: [x0[y - top], x1[y - top])
+    std::vector<int> y0, y1;        // Column x: [y0[x - left], y1[x - left])
+
+    int rowBegin(int y) const { return x0[y - top]; }
+    int rowEnd(int y) const { return x1[y - top]; }
+    //Reflect-101 inside the row's span, then inside the column's span.
+    int reflectX(int x,int y) const { const int a = x0[y - top]; return a + reflect101(x - a,x1[y - top] - a); }
+    int reflectY(int y,int x) const { const int a = y0[x - left]; return a + reflect101(y - a,y1[x - left] - a); }
+    //Columns [c0, c1) that row y reads without reflecting: its own span.
+    void directColumns(int y,int c0,int c1,int& a,int& b) const {
+        a = b = c1;
+        if (y < top || y >= bottom) return;
+        a = std::max(c0,rowBegin(y)); b = std::min(c1,rowEnd(y));
+        if (a >= b) a = b = c1;
+    }
+};
+
+static inline DiscSpans discSpans(const Disc& disc,int width,int height) {
+    DiscSpans spans;
+    const double r2 = disc.radius * disc.radius;
+    auto inside = [&](int x,int y) {
+        const double dx = x - disc.centerX, dy = y - disc.centerY;
+        return dx * dx + dy * dy <= r2;
+    };
+    std::vector<int> x0, x1, rows;
+    const int yFirst = std::max(0,(int)std::ceil(disc.centerY - disc.radius));
+    const int yLast = std::min(height - 1,(int)std::floor(disc.centerY + disc.radius));
+    for (int y = yFirst; y <= yLast; y++) {
+        const double dy = y - disc.centerY;
+        const double half = std::sqrt(std::max(0.0,r2 - dy * dy));
+        int a = (int)std::ceil(disc.centerX - half), b = (int)std::floor(disc.centerX + half) + 1;
+        while (inside(a - 1,y)) a--;                        // Settle rounding at both ends
+        while (a < b && !inside(a,y)) a++;
+        while (inside(b,y)) b++;
+        while (b > a && !inside(b - 1,y)) b--;
+        a = std::max(a,0); b = std::min(b,width);
+        if (a >= b) continue;
+        if (!rows.empty() && rows.back() != y - 1) break;  // Convex: spans are contiguous
+        rows.push_back(y); x0.push_back(a); x1.push_back(b);
+    }
+    if (rows.empty()) return spans;
+    spans.top = rows.front();
+    spans.bottom = rows.back() + 1;
+    spans.x0 = x0; spans.x1 = x1;
+    spans.left = *std::min_element(x0.begin(),x0.end());
+    spans.right = *std::max_element(x1.begin(),x1.end());
+
+    //Column spans: walking down, columns first reached on row y start
+    //there; walking up, they end there. Both unions stay intervals.
+    const int columns = spans.right - spans.left, rowCount = (int)rows.size();
+    spans.y0.assign(columns,0);
+    spans.y1.assign(columns,0);
+    int lo = x0[0], hi = x1[0];
+    for (int x = lo; x < hi; x++) spans.y0[x - spans.left] = spans.top;
+    for (int i = 1; i < rowCount; i++) {
+        for (int x = x0[i]; x < lo; x++) spans.y0[x - spans.left] = spans.top + i;
+        for (int x = hi; x < x1[i]; x++) spans.y0[x - spans.left] = spans.top + i;
+        lo = std::min(lo,x0[i]); hi = std::max(hi,x1[i]);
+    }
+    lo = x0[rowCount - 1]; hi = x1[rowCount - 1];
+    for (int x = lo; x < hi; x++) spans.y1[x - spans.left] = spans.bottom;
+    for (int i = rowCount - 2; i >= 0; i--) {
+        for (int x = x0[i]; x < lo; x++) spans.y1[x - spans.left] = spans.top + i + 1;
+        for (int x = hi; x < x1[i]; x++) spans.y1[x - spans.left] = spans.top + i + 1;
+        lo = std::min(lo,x0[i]); hi = std::max(hi,x1[i]);
+    }
+    return spans;
+}
+
+//All discs of a frame, plus their spans merged per row.
+struct Footprint {
+    std::vector<DiscSpans> discs;
+    std::vector<std::pair<int,int>> spans;  // [x0, x1), sorted within a row
+    std::vector<size_t> rowStart;           // Spans of row y: [rowStart[y], rowStart[y + 1])
+    size_t pixels = 0;
+    bool restricted = false;                // False: the whole frame
+
+    bool active() const { return restricted; }
+
+    void build(const std::vector<Disc>& items,int width,int height) {
+        restricted = !items.empty();
+        discs.clear();
+        spans.clear();
+        rowStart.assign((size_t)height + 1,0);
+        pixels = 0;
+        for (const Disc& disc : items) {
+            if (!(disc.radius > 0.0)) throw std::runtime_error("Footprint: disc radius must be > 0");
+            DiscSpans d = discSpans(disc,width,height);
+            if (d.top < d.bottom) discs.push_back(std::move(d));
+        }
+        std::vector<std::pair<int,int>> row;
+        for (int y = 0; y < height; y++) {
+            rowStart[y] = spans.size();
+            row.clear();
+            for (const DiscSpans& d : discs) {
+                if (y >= d.top && y < d.bottom) row.push_back({d.rowBegin(y),d.rowEnd(y)});
+            }
+            std::sort(row.begin(),row.end());
+            for (size_t i = 0; i < row.size(); i++) {
+                if (i > 0 && row[i].first < row[i - 1].second) throw std::runtime_error("Footprint: discs overlap");
+                spans.push_back(row[i]);
+                pixels += (size_t)(row[i].second - row[i].first);
+            }
+        }
+        rowStart[height] = spans.size();
+    }
+
+    //Clears every bit of row y outside the footprint.
+    void clipRow(int y,int width,uint64_t* row) const {
+        int x = 0;
+        for (size_t i = rowStart[y]; i < rowStart[y + 1]; i++) {
+            bitmask::clearRange(row,x,spans[i].first);
+            x = spans[i].second;
+        }
+        bitmask::clearRange(row,x,width);
+    }
+
+    void clip(bitmask::BitMask& mask) const {
+        #ifdef USE_OMP
+        #pragma omp parallel for schedule(static)
+        #endif
+        for (int y = 0; y < mask.height; y++) clipRow(y,mask.width,mask.row(y));
+    }
+};
+
+//medianFilter() over one disc: only in-disc pixels are written, and
+//the window reflects (101) at the disc edge instead of reading the
+//padding. Strips only keep column histograms for the columns their
+//rows cover.
+static inline void medianFilterDisc(const uint8_t* src,uint8_t* dst,int width,const DiscSpans& disc,int k) {
+    const int r = k / 2;
+    const int need = (k * k) / 2 + 1;
+    const int rows = disc.bottom - disc.top;
+    const int stripRows = std::max(32,(rows + threadCount() * 4 - 1) / (threadCount() * 4));
+    const int strips = (rows + stripRows - 1) / stripRows;
+
+    #ifdef USE_OMP
+    #pragma omp parallel for schedule(dynamic,1)
+    #endif
+    for (int strip = 0; strip < strips; strip++) {
+        const int y0 = disc.top + strip * stripRows, y1 = std::min(disc.bottom,y0 + stripRows);
+        int c0 = width, c1 = 0;
+        for (int y = y0; y < y1; y++) { c0 = std::min(c0,disc.rowBegin(y)); c1 = std::max(c1,disc.rowEnd(y)); }
+        const int columns = c1 - c0;
+        std::vector<uint16_t> fine((size_t)columns * 256,0), coarse((size_t)columns * 16,0);
+        auto addColumn = [&](int x,uint8_t v,int delta) {
+            fine[(size_t)(x - c0) * 256 + v] += (uint16_t)delta;
+            coarse[(size_t)(x - c0) * 16 + (v >> 4)] += (uint16_t)delta;
+        };
+        auto addRow = [&](int y,int delta) {
+            int a, b;
+            disc.directColumns(y,c0,c1,a,b);
+            const uint8_t* row = src + (size_t)std::max(0,y) * width;
+            for (int x = c0; x < a; x++) addColumn(x,src[(size_t)disc.reflectY(y,x) * width + x],delta);
+            for (int x = a; x < b; x++) addColumn(x,row[x],delta);
+            for (int x = b; x < c1; x++) addColumn(x,src[(size_t)disc.reflectY(y,x) * width + x],delta);
+        };
+        for (int dy = -r; dy <= r; dy++) addRow(y0 + dy,1);
+
+        for (int y = y0; y < y1; y++) {
+            if (y > y0) {
+                addRow(y - r - 1,-1);
+                addRow(y + r,1);
+            }
+            const int a = disc.rowBegin(y), b = disc.rowEnd(y);
+            alignas(32) uint16_t kernelFine[256];
+            alignas(32) uint16_t kernelCoarse[16];
+            std::memset(kernelFine,0,sizeof(kernelFine));
+            std::memset(kernelCoarse,0,sizeof(kernelCoarse));
+            for (int dx = -r; dx <= r; dx++) {
+                const size_t column = (size_t)(disc.reflectX(a + dx,y) - c0);
+                const uint16_t* f = &fine[column * 256];
+                const uint16_t* c = &coarse[column * 16];
+                for (int i = 0; i < 256; i++) kernelFine[i] += f[i];
+                for (int i = 0; i < 16; i++) kernelCoarse[i] += c[i];
+            }
+            uint8_t* out = dst + (size_t)y * width;
+            for (int x = a; x < b; x++) {
+                if (x > a) {
+                    const size_t add = (size_t)(disc.reflectX(x + r,y) - c0), sub = (size_t)(disc.reflectX(x - r - 1,y) - c0);
+                    if (add != sub) {
+                        const uint16_t* fa = &fine[add * 256]; const uint16_t* fs = &fine[sub * 256];
+                        const uint16_t* ca = &coarse[add * 16]; const uint16_t* cs = &coarse[sub * 16];
+                        for (int i = 0; i < 256; i++) kernelFine[i] = (uint16_t)(kernelFine[i] + fa[i] - fs[i]);
+                        for (int i = 0; i < 16; i++) kernelCoarse[i] = (uint16_t)(kernelCoarse[i] + ca[i] - cs[i]);
+                    }
+                }
+                int count = 0, bin = 0;
+                while (count + kernelCoarse[bin] < need) count += kernelCoarse[bin++];
+                int value = bin * 16;
+                while (count + kernelFine[value] < need) count += kernelFine[value++];
+                out[x] = (uint8_t)value;
+            }
+        }
+    }
+}
+
+//absDiffBoxFilter() over one disc, reflecting at the disc edge.
+static inline void absDiffBoxFilterDisc(const uint8_t* a,const uint8_t* b,uint8_t* dst,int width,const DiscSpans& disc,int k) {
+    const int r = k / 2;
+    const double scale = 1.0 / ((double)k * k);
+    const int rows = disc.bottom - disc.top;
+    const int stripRows = std::max(32,(rows + threadCount() * 4 - 1) / (threadCount() * 4));
+    const int strips = (rows + stripRows - 1) / stripRows;
+
+    #ifdef USE_OMP
+    #pragma omp parallel for schedule(dynamic,1)
+    #endif
+    for (int strip = 0; strip < strips; strip++) {
+        const int y0 = disc.top + strip * stripRows, y1 = std::min(disc.bottom,y0 + stripRows);
+        int c0 = width, c1 = 0;
+        for (int y = y0; y < y1; y++) { c0 = std::min(c0,disc.rowBegin(y)); c1 = std::max(c1,disc.rowEnd(y)); }
+        std::vector<int> columnSum((size_t)(c1 - c0),0);
+        std::vector<int> padded((size_t)(c1 - c0) + 2 * r);
+        auto addRow = [&](int y,int sign) {
+            int d0, d1;
+            disc.directColumns(y,c0,c1,d0,d1);
+            auto add = [&](int x,size_t offset) { columnSum[x - c0] += sign * std::abs((int)a[offset] - (int)b[offset]); };
+            const size_t row = (size_t)std::max(0,y) * width;
+            for (int x = c0; x < d0; x++) add(x,(size_t)disc.reflectY(y,x) * width + x);
+            for (int x = d0; x < d1; x++) add(x,row + x);
+            for (int x = d1; x < c1; x++) add(x,(size_t)disc.reflectY(y,x) * width + x);
+        };
+        for (int dy = -r; dy <= r; dy++) addRow(y0 + dy,1);
+        for (int y = y0; y < y1; y++) {
+            if (y > y0) {
+                addRow(y - r - 1,-1);
+                addRow(y + r,1);
+            }
+            const int x0 = disc.rowBegin(y), n = disc.rowEnd(y) - x0;
+            for (int i = 0; i < n + 2 * r; i++) padded[i] = columnSum[x0 + reflect101(i - r,n) - c0];
+            int sum = 0;
+            for (int i = 0; i < k; i++) sum += padded[i];
+            uint8_t* out = dst + (size_t)y * width + x0;
+            for (int x = 0; x < n; x++) {
+                if (x > 0) sum += padded[x + k - 1] - padded[x - 1];
+                out[x] = (uint8_t)std::min(255L,std::lrint(sum * scale));
+            }
+        }
+    }
+}
+
+// ============================================================== //
+// |                 RUN-LENGTH CONNECTED COMPONENTS            | //
+// ============================================================== //
+//8-connected labelling over horizontal runs. Components are numbered
+//in raster order of their first pixel, like cv2.connectedComponents.
+struct Run { int y, x0, x1; };   // [x0, x1)
+
+struct Component {
+    int area = 0;
+    double sumX = 0.0, sumY = 0.0, sumIntensity = 0.0;
+    int left = 0, top = 0, right = 0, bottom = 0;
+};
+
+static inline int findRoot(std::vector<int>& parent,int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+static inline void uniteRoots(std::vector<int>& parent,int a,int b) {
+    a = findRoot(parent,a);
+    b = findRoot(parent,b);
+    if (a == b) return;
+    if (a < b) parent[b] = a; else parent[a] = b;
+}
+
+//Runs of one 0/255 mask row.
+static inline void extractRuns(const uint8_t* row,int width,int y,std::vector<Run>& runs) {
+    int x = 0;
+    while (x < width) {
+        while (x < width && !row[x]) x++;
+        if (x >= width) break;
+        int start = x;
+        while (x < width && row[x]) x++;
+        runs.push_back({y,start,x});
+    }
+}
+
+//Runs of one packed mask row, found word-wise with bit scans.
+static inline void extractRuns(const uint64_t* row,int width,int y,std::vector<Run>& runs) {
+    int x = bitmask::nextSetBit(row,width,0);
+    while (x < width) {
+        const int end = bitmask::nextClearBit(row,width,x);
+        runs.push_back({y,x,end});
+        x = bitmask::nextSetBit(row,width,end);
+    }
+}
+
+//Unions the runs of the current row with overlapping or diagonally
+//touching runs of the previous row.
+static inline void linkRows(const std::vector<Run>& runs,size_t previousBegin,size_t currentBegin,size_t currentEnd,
+                            std::vector<int>& parent) {
+    size_t p = previousBegin;
+    for (size_t c = currentBegin; c < currentEnd; c++) {
+        while (p < currentBegin && runs[p].x1 < runs[c].x0) p++;
+        for (size_t q = p; q < currentBegin && runs[q].x0 <= runs[c].x1; q++) uniteRoots(parent,(int)q,(int)c);
+    }
+}
+
+//Labels runs grouped by row; rowStart[y] is the first run of row y
+//and rowStart[height] == runs.size().
+static inline std::vector<Component> labelRuns(const std::vector<Run>& runs,const std::vector<size_t>& rowStart,
+                                               const uint8_t* gray,int width,int height) {
+    std::vector<int> parent(runs.size());
+    for (size_t i = 0; i < runs.size(); i++) parent[i] = (int)i;
+    for (int y = 1; y < height; y++) linkRows(runs,rowStart[y - 1],rowStart[y],rowStart[y + 1],parent);
+
+    std::vector<int> componentOf(runs.size(),-1);
+    std::vector<Component> components;
+    for (size_t i = 0; i < runs.size(); i++) {
+        int root = findRoot(parent,(int)i);
+        if (componentOf[root] < 0) {
+            componentOf[root] = (int)components.size();
+            Component c;
+            c.left = runs[i].x0; c.right = runs[i].x1 - 1; c.top = c.bottom = runs[i].y;
+            components.push_back(c);
+        }
+        Component& c = components[componentOf[root]];
+        const Run& run = runs[i];
+        const int length = run.x1 - run.x0;
+        c.area += length;
+        c.sumX += 0.5 * (double)(run.x0 + run.x1 - 1) * length;
+        c.sumY += (double)run.y * length;
+        const uint8_t* g = gray + (size_t)run.y * width;
+        uint32_t s = 0;
+        for (int x = run.x0; x < run.x1; x++) s += g[x];
+        c.sumIntensity += s;
+        c.left = std::min(c.left,run.x0);
+        c.right = std::max(c.right,run.x1 - 1);
+        c.bottom = std::max(c.bottom,run.y);
+    }
+    return components;
+}
+
+static inline std::vector<Component> connectedComponents(const uint8_t* mask,const uint8_t* gray,int width,int height) {
+    std::vector<Run> runs;
+    std::vector<size_t> rowStart((size_t)height + 1,0);
+    for (int y = 0; y < height; y++) {
+        rowStart[y] = runs.size();
+        extractRuns(mask + (size_t)y * width,width,y,runs);
+    }
+    rowStart[height] = runs.size();
+    return labelRuns(runs,rowStart,gray,width,height);
+}
+
+static inline std::vector<Component> connectedComponents(const bitmask::BitMask& mask,const uint8_t* gray) {
+    std::vector<Run> runs;
+    std::vector<size_t> rowStart((size_t)mask.height + 1,0);
+    for (int y = 0; y < mask.height; y++) {
+        rowStart[y] = runs.size();
+        extractRuns(mask.row(y),mask.width,y,runs);
+    }
+    rowStart[mask.height] = runs.size();
+    return labelRuns(runs,rowStart,gray,mask.width,mask.height);
+}
+
+// ============================================================== //
+// |                         HALO INDEX                         | //
+// ============================================================== //
+struct HaloDisc { int cx, cy, radius; };
+
+//Discs bucketed by the row bands their bounding boxes cover, so a
+//row only visits the halos that can reach it.
+struct HaloIndex {
+    static const int kBandRows = 32;
+    std::vector<HaloDisc> discs;
+    std::vector<int> bandStart, bandItems;   // CSR: discs per band
+
+    void build(const std::vector<HaloDisc>& items,int height) {
+        discs = items;
+        const int bands = (height + kBandRows - 1) / kBandRows;
+        bandStart.assign((size_t)bands + 1,0);
+        auto bandRange = [&](const HaloDisc& d,int& b0,int& b1) {
+            b0 = std::max(0,d.cy - d.radius) / kBandRows;
+            b1 = std::min(height - 1,d.cy + d.radius) / kBandRows;
+        };
+        for (const HaloDisc& d : discs) {
+            int b0, b1;
+            bandRange(d,b0,b1);
+            for (int b = b0; b <= b1; b++) bandStart[b + 1]++;
+        }
+        for (int b = 0; b < bands; b++) bandStart[b + 1] += bandStart[b];
+        bandItems.resize(bandStart[bands]);
+        std::vector<int> cursor(bandStart.begin(),bandStart.end() - 1);
+        for (size_t i = 0; i < discs.size(); i++) {
+            int b0, b1;
+            bandRange(discs[i],b0,b1);
+            for (int b = b0; b <= b1; b++) bandItems[cursor[b]++] = (int)i;
+        }
+    }
+
+    //Merged, sorted [x0, x1] spans of row y covered by any halo, using
+    //the same integer disc rows as cv2.circle(thickness=-1).
+    void spansOnRow(int y,int width,std::vector<std::pair<int,int>>& spans) const {
+        spans.clear();
+        const int band = y / kBandRows;
+        if (band + 1 >= (int)bandStart.size()) return;
+        for (int i = bandStart[band]; i < bandStart[band + 1]; i++) {
+            const HaloDisc& d = discs[bandItems[i]];
+            const int dy = y - d.cy;
+            if (dy < -d.radius || dy > d.radius) continue;
+            const int span = (int)std::sqrt((double)d.radius * d.radius - (double)dy * dy);
+            const int x0 = std::max(0,d.cx - span), x1 = std::min(width - 1,d.cx + span);
+            if (x0 <= x1) spans.push_back({x0,x1});
+        }
+        if (spans.size() < 2) return;
+        std::sort(spans.begin(),spans.end());
+        size_t merged = 0;
+        for (size_t i = 1; i < spans.size(); i++) {
+            if (spans[i].first <= spans[merged].second + 1) spans[merged].second = std::max(spans[merged].second,spans[i].second);
+            else spans[++merged] = spans[i];
+        }
+        spans.resize(merged + 1);
+    }
+};
+
+// ============================================================== //
+// |                     STARS / SELECTION                      | //
+// ============================================================== //
+//Area filter, then brightest first (sum, then area), like detectStars().
+static inline std::vector<StarRow> starsFromComponents(const std::vector<Component>& components,int minArea,int maxArea) {
+    std::vector<StarRow> stars;
+    for (const Component& c : components) {
+        if (c.area < minArea || c.area > maxArea) continue;
+        StarRow row;
+        row.centerX = c.sumX / c.area;
+        row.centerY = c.sumY / c.area;
+        row.area = c.area;
+        row.sumIntensity = c.sumIntensity;
+        row.meanIntensity = c.sumIntensity / c.area;
+        row.left = c.left; row.top = c.top; row.right = c.right; row.bottom = c.bottom;
+        stars.push_back(row);
+    }
+    std::stable_sort(stars.begin(),stars.end(),[](const StarRow& a,const StarRow& b) {
+        if (a.sumIntensity != b.sumIntensity) return a.sumIntensity > b.sumIntensity;
+        return a.area > b.area;
+    });
+    return stars;
+}
+
+//filterBySeparation(): greedy by sum, keeping stars at least
+//minSeparation from every star already kept.
+static inline std::vector<StarRow> selectBySeparation(const std::vector<StarRow>& stars,double minSeparation,int maxStars) {
+    std::vector<StarRow> selection;
+    std::vector<StarRow> sorted = stars;
+    std::stable_sort(sorted.begin(),sorted.end(),[](const StarRow& a,const StarRow& b) { return a.sumIntensity > b.sumIntensity; });
+    const double minSeparationSquared = minSeparation * minSeparation;
+    for (const StarRow& row : sorted) {
+        bool ok = true;
+        for (const StarRow& kept : selection) {
+            double dx = row.centerX - kept.centerX, dy = row.centerY - kept.centerY;
+            if (dx * dx + dy * dy < minSeparationSquared) { ok = false; break; }
+        }
+        if (!ok) continue;
+        selection.push_back(row);
+        if ((int)selection.size() >= maxStars) break;
+    }
+    return selection;
+}
+
+} // namespace detection
+
+// ============================================================== //
+// |                     STAR DETECTION ENGINE                  | //
+// ============================================================== //
+class StarDetectionEngine {
+public:
+    //Converts the caller's pixels (1, 3 or 4 channels, any row stride)
+    //to gray. The engine keeps no pointer to them afterwards.
+    void setImage(const uint8_t* pixels,int width,int height,int channels,size_t strideBytes,bool bgr = true) {
+        if (!pixels || width <= 0 || height <= 0) throw std::runtime_error("setImage: empty image");
+        if (channels != 1 && channels != 3 && channels != 4) throw std::runtime_error("setImage: channels must be 1, 3 or 4");
+        auto t0 = std::chrono::steady_clock::now();
+        if (width != width_ || height != height_) {
+            width_ = width;
+            height_ = height;
+            for (int s = 0; s < StageCount; s++) valid_[s] = false;
+        }
+        gray_.resize(pixelCount());
+        detection::toGray(pixels,width,height,channels,strideBytes,bgr,gray_.data());
+        histogram_ = detection::histogram256(gray_.data(),pixelCount());   // Reused by every brightPercentile
+        imageVersion_++;
+        imageChanged_ = true;
+        finish(StageGray,imageVersion_,t0);
+    }
+
+    //Restricts detection to the given discs (image pixels); an empty
+    //list processes the whole frame. Kept across setImage().
+    void setDiscs(const std::vector<detection::Disc>& discs) { discs_ = discs; }
+
+    //Runs every stage whose inputs changed and returns the selected stars
+    //(filterBySeparation() applied), brightest first.
+    const std::vector<StarRow>& run(const DetectionParams& params) {
+        if (gray_.empty()) throw std::runtime_error("run: no image");
+        updateFootprint();
+        recomputed_ = imageChanged_ ? (1u << StageGray) : 0;
+        imageChanged_ = false;
+        const int k = backgroundKernel(params);
+        const int blur = (params.blur > 1) ? (params.blur | 1) : 0;
+
+        // ----- Background ----- //
+        uint64_t key = Key().add(version(StageGray)).add(k).add(footprintVersion_).value;
+        if (stale(StageBackground,key)) {
+            auto t0 = now();
+            if (footprint_.active()) {
+                background_.assign(pixelCount(),0);
+                for (const detection::DiscSpans& disc : footprint_.discs) {
+                    detection::medianFilterDisc(gray_.data(),background_.data(),width_,disc,k);
+                }
+            } else {
+                background_.resize(pixelCount());
+                detection::medianFilter(gray_.data(),background_.data(),width_,height_,k);
+            }
+            finish(StageBackground,key,t0);
+        }
+
+        // ----- Sigma ----- //
+        key = Key().add(version(StageBackground)).value;
+        if (stale(StageSigma,key)) {
+            auto t0 = now();
+            if (footprint_.active()) {
+                sigma_.assign(pixelCount(),0);
+                for (const detection::DiscSpans& disc : footprint_.discs) {
+                    detection::absDiffBoxFilterDisc(gray_.data(),background_.data(),sigma_.data(),width_,disc,k);
+                }
+            } else {
+                sigma_.resize(pixelCount());
+                detection::absDiffBoxFilter(gray_.data(),background_.data(),sigma_.data(),width_,height_,k);
+            }
+            finish(StageSigma,key,t0);
+        }
+
+        // ----- SNR mask ----- //
+        key = Key().add(version(StageSigma)).add(params.snrThreshold).add(blur).value;
+        if (stale(StageSnrMask,key)) {
+            auto t0 = now();
+            thresholdZ((float)params.snrThreshold,snrMask_);
+            if (blur) {
+                bitmask::open(snrMask_,snrMask_,bitmask::Kernel::rect(3,3));
+                detection::gaussianThreshold(snrMask_,blur);
+                if (footprint_.active()) footprint_.clip(snrMask_);
+            }
+            finish(StageSnrMask,key,t0);
+        }
+
+        // ----- Bright mask (only needed for halos) ----- //
+        if (params.suppressHalo) {
+            key = Key().add(version(StageGray)).add(params.brightPercentile).add(params.brightLevel).add(footprintVersion_).value;
+            if (stale(StageBrightMask,key)) {
+                auto t0 = now();
+                int level = params.brightLevel;
+                if (level < 0 && footprint_.active()) level = detection::percentileBin(footprintHistogram(),footprint_.pixels,params.brightPercentile);
+                if (level < 0) level = detection::percentileBin(histogram_,pixelCount(),params.brightPercentile);
+                //MORPH_CLOSE 5x5, iterations=2 == one 9x9 close.
+                bitmask::packThreshold(gray_.data(),width_,height_,level,brightMask_);
+                if (footprint_.active()) footprint_.clip(brightMask_);
+                bitmask::close(brightMask_,brightMask_,bitmask::Kernel::rect(9,9));
+                finish(StageBrightMask,key,t0);
+            }
+        }
+
+        // ----- Candidate mask (halo suppression) ----- //
+        key = Key().add(version(StageSnrMask)).add(params.suppressHalo).value;
+        if (params.suppressHalo) {
+            key = Key(key).add(version(StageBrightMask)).add(params.haloScale).add(params.snrThreshold).value;
+        }
+        if (stale(StageCandidateMask,key)) {
+            auto t0 = now();
+            if (params.suppressHalo) suppressHalos(params);
+            else extractCandidateRuns(snrMask_);
+            finish(StageCandidateMask,key,t0);
+        }
+
+        // ----- Components ----- //
+        key = Key().add(version(StageCandidateMask)).value;
+        if (stale(StageComponents,key)) {
+            auto t0 = now();
+            components_ = detection::labelRuns(candidateRuns_,candidateRowStart_,gray_.data(),width_,height_);
+            finish(StageComponents,key,t0);
+        }
+
+        // ----- Stars (area filter, brightest first) ----- //
+        key = Key().add(version(StageComponents)).add(params.minArea).add(params.maxArea).value;
+        if (stale(StageStars,key)) {
+            auto t0 = now();
+            stars_ = detection::starsFromComponents(components_,params.minArea,params.maxArea);
+            finish(StageStars,key,t0);
+        }
+
+        // ----- Refine (sub-pixel centroids, flux, FWHM) ----- //
+        key = Key().add(version(StageStars)).add(params.refine).add(params.refineRadius).value;
+        if (stale(StageRefine,key)) {
+            auto t0 = now();
+            refined_ = stars_;
+            if (params.refine != psf::RefineOff) refineStars(params);
+            finish(StageRefine,key,t0);
+        }
+
+        // ----- Selection (filterBySeparation) ----- //
+        key = Key().add(version(StageRefine)).add(params.minSeparation).add(params.maxStars).value;
+        if (stale(StageSelection,key)) {
+            auto t0 = now();
+            selection_ = detection::selectBySeparation(refined_,params.minSeparation,params.maxStars);
+            finish(StageSelection,key,t0);
+        }
+        return selection_;
+    }
+
+    // ----- Results and cache introspection ----- //
+    int width() const { return width_; }
+    int height() const { return height_; }
+    const std::vector<StarRow>& stars() const { return refined_; }        // Before selection
+    const std::vector<StarRow>& selection() const { return selection_; }
+    const uint8_t* gray() const { return gray_.data(); }
+    const uint8_t* background() const { return background_.data(); }  // As of the last run()
+    const uint8_t* sigma() const { return sigma_.data(); }
+    const std::vector<detection::Run>& candidateRuns() const { return candidateRuns_; }   // Grouped by row
+    const detection::Footprint& footprint() const { return footprint_; }  // As of the last run()
+    const uint8_t* candidateMask() const;                                 // detectStars()' snrMask, painted on demand
+    uint32_t recomputedStages() const { return recomputed_; }             // Bit per DetectionStage
+    double stageMilliseconds(int stage) const { return milliseconds_[stage]; }
+    void invalidate() { for (int s = StageBackground; s < StageCount; s++) valid_[s] = false; }
+
+private:
+    //FNV-1a over parameter bytes and upstream versions.
+    struct Key {
+        uint64_t value = 1469598103934665603ULL;
+        Key() = default;
+        explicit Key(uint64_t seed) : value(seed) {}
+        template <class T> Key& add(const T& item) {
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&item);
+            for (size_t i = 0; i < sizeof(T); i++) value = (value ^ bytes[i]) * 1099511628211ULL;
+            return *this;
+        }
+    };
+
+    using Clock = std::chrono::steady_clock;
+    static Clock::time_point now() { return Clock::now(); }
+    size_t pixelCount() const { return (size_t)width_ * height_; }
+    uint64_t version(int stage) const { return versions_[stage]; }
+
+    bool stale(int stage,uint64_t key) const { return !valid_[stage] || keys_[stage] != key; }
+
+    void finish(int stage,uint64_t key,Clock::time_point t0) {
+        keys_[stage] = key;
+        versions_[stage] = ++versionCounter_;
+        valid_[stage] = true;
+        recomputed_ |= 1u << stage;
+        milliseconds_[stage] = std::chrono::duration<double,std::milli>(now() - t0).count();
+    }
+
+    //mask = z > threshold, z in float32 like the NumPy original, packed
+    //a row at a time.
+    void thresholdZ(float threshold,bitmask::BitMask& mask) const {
+        mask.resize(width_,height_);
+        #ifdef USE_OMP
+        #pragma omp parallel
+        #endif
+        {
+            std::vector<uint8_t> row(width_);
+            #ifdef USE_OMP
+            #pragma omp for schedule(static)
+            #endif
+            for (int y = 0; y < height_; y++) {
+                const size_t offset = (size_t)y * width_;
+                const uint8_t* g = &gray_[offset]; const uint8_t* b = &background_[offset]; const uint8_t* s = &sigma_[offset];
+                auto span = [&](int x0,int x1) {
+                    for (int x = x0; x < x1; x++) {
+                        float z = ((float)g[x] - (float)b[x]) / std::max((float)s[x],1.0f);
+                        row[x] = (z > threshold) ? 1 : 0;
+                    }
+                };
+                if (footprint_.active()) {
+                    std::fill(row.begin(),row.end(),0);
+                    for (size_t i = footprint_.rowStart[y]; i < footprint_.rowStart[y + 1]; i++) span(footprint_.spans[i].first,footprint_.spans[i].second);
+                } else {
+                    span(0,width_);
+                }
+                bitmask::packThreshold(row.data(),width_,0,mask.row(y));
+            }
+        }
+    }
+
+    void extractCandidateRuns(const bitmask::BitMask& mask) {
+        candidateRuns_.clear();
+        candidateRowStart_.assign((size_t)height_ + 1,0);
+        for (int y = 0; y < height_; y++) {
+            candidateRowStart_[y] = candidateRuns_.size();
+            detection::extractRuns(mask.row(y),width_,y,candidateRuns_);
+        }
+        candidateRowStart_[height_] = candidateRuns_.size();
+    }
+
+    //One disc per bright component (area >= 50) goes into a HaloIndex.
+    //Rows no halo reaches take the SNR mask's runs as they are; on the
+    //others, pixels inside a halo are kept only when z > 2 * snrThreshold.
+    void suppressHalos(const DetectionParams& params) {
+        std::vector<detection::Component> bright = detection::connectedComponents(brightMask_,gray_.data());
+        std::vector<detection::HaloDisc> discs;
+        for (const detection::Component& c : bright) {
+            if (c.area < 50) continue;
+            double sourceRadius = std::max(1.0,std::sqrt(std::max((double)c.area,1.0) / M_PI));
+            int radius = (int)std::max(10.0,params.haloScale * sourceRadius);
+            discs.push_back({(int)(c.sumX / c.area),(int)(c.sumY / c.area),radius});
+        }
+        detection::HaloIndex halos;
+        halos.build(discs,height_);
+
+        const float veryHigh = (float)(params.snrThreshold * 2.0);
+        std::vector<std::pair<int,int>> spans;
+        std::vector<uint64_t> row(snrMask_.wordsPerRow);
+        candidateRuns_.clear();
+        candidateRowStart_.assign((size_t)height_ + 1,0);
+        for (int y = 0; y < height_; y++) {
+            candidateRowStart_[y] = candidateRuns_.size();
+            const size_t offset = (size_t)y * width_;
+            halos.spansOnRow(y,width_,spans);
+            if (spans.empty()) {
+                detection::extractRuns(snrMask_.row(y),width_,y,candidateRuns_);
+                continue;
+            }
+            std::memcpy(row.data(),snrMask_.row(y),row.size() * sizeof(uint64_t));
+            const uint8_t* g = &gray_[offset]; const uint8_t* b = &background_[offset]; const uint8_t* s = &sigma_[offset];
+            for (const std::pair<int,int>& span : spans) {
+                for (int x = span.first; x <= span.second; x++) {
+                    float z = ((float)g[x] - (float)b[x]) / std::max((float)s[x],1.0f);
+                    const uint64_t bit = 1ULL << (x & 63);
+                    row[x >> 6] = (z > veryHigh) ? (row[x >> 6] | bit) : (row[x >> 6] & ~bit);
+                }
+            }
+            if (footprint_.active()) footprint_.clipRow(y,width_,row.data());
+            detection::extractRuns(row.data(),width_,y,candidateRuns_);
+        }
+        candidateRowStart_[height_] = candidateRuns_.size();
+    }
+
+    //Rebuilds the row spans when the discs or the image size changed.
+    void updateFootprint() {
+        Key key;
+        key.add(width_).add(height_);
+        for (const detection::Disc& disc : discs_) key.add(disc.centerX).add(disc.centerY).add(disc.radius);
+        if (footprintBuilt_ && key.value == footprintKey_) return;
+        footprint_.build(discs_,width_,height_);
+        footprintKey_ = key.value;
+        footprintBuilt_ = true;
+        footprintVersion_ = ++versionCounter_;
+    }
+
+    //Gray histogram of the in-disc pixels only.
+    std::vector<uint64_t> footprintHistogram() const {
+        std::vector<uint64_t> histogram(256,0);
+        for (int y = 0; y < height_; y++) {
+            const uint8_t* g = &gray_[(size_t)y * width_];
+            for (size_t i = footprint_.rowStart[y]; i < footprint_.rowStart[y + 1]; i++) {
+                for (int x = footprint_.spans[i].first; x < footprint_.spans[i].second; x++) histogram[g[x]]++;
+            }
+        }
+        return histogram;
+    }
+
+    void refineStars(const DetectionParams& params) {
+        psf::Centroids centroids;
+        centroids.resize(refined_.size());
+        for (size_t i = 0; i < refined_.size(); i++) {
+            centroids.x[i] = refined_[i].centerX;
+            centroids.y[i] = refined_[i].centerY;
+        }
+        psf::refine(gray_.data(),background_.data(),sigma_.data(),width_,height_,params.refineRadius,params.refine,centroids);
+        for (size_t i = 0; i < refined_.size(); i++) {
+            refined_[i].centerX = centroids.x[i];
+            refined_[i].centerY = centroids.y[i];
+            refined_[i].flux = centroids.flux[i];
+            refined_[i].fwhm = centroids.fwhm[i];
+        }
+    }
+
+    int width_ = 0, height_ = 0;
+    std::vector<uint8_t> gray_, background_, sigma_;
+    bitmask::BitMask snrMask_, brightMask_;
+    std::vector<uint64_t> histogram_;
+    std::vector<detection::Run> candidateRuns_;
+    std::vector<size_t> candidateRowStart_;
+    mutable std::vector<uint8_t> candidateMask_;
+    mutable uint64_t candidateMaskVersion_ = 0;
+    std::vector<detection::Component> components_;
+    std::vector<StarRow> stars_, refined_, selection_;
+    std::vector<detection::Disc> discs_;
+    detection::Footprint footprint_;
+    uint64_t footprintKey_ = 0, footprintVersion_ = 0;
+    bool footprintBuilt_ = false;
+
+    uint64_t imageVersion_ = 0, versionCounter_ = 0;
+    uint64_t keys_[StageCount] = {};
+    uint64_t versions_[StageCount] = {};
+    bool valid_[StageCount] = {};
+    double milliseconds_[StageCount] = {};
+    uint32_t recomputed_ = 0;
+    bool imageChanged_ = false;
+};
+
+inline const uint8_t* StarDetectionEngine::candidateMask() const {
+    if (candidateMaskVersion_ != version(StageCandidateMask)) {
+        candidateMask_.assign(pixelCount(),0);
+        for (const detection::Run& run : candidateRuns_) {
+            std::memset(&candidateMask_[(size_t)run.y * width_ + run.x0],255,(size_t)(run.x1 - run.x0));
+        }
+        candidateMaskVersion_ = version(StageCandidateMask);
+    }
+    return candidateMask_.data();
+}
+
+#endif // LIVE_SKYBOXES_STAR_DETECTION_ENGINE_H
@@ -0,0 +1,798 @@
+//Star Detection Checks
+//Engine
+//Chris D. | Version 8 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Functional launch
+//  Version 1 (10/18/2026): Halo index spans against rasterized discs.
+//  Version 2 (10/18/2026): Labelling of bit-packed masks.
+//  Version 3 (10/18/2026): Refinement accuracy on a faint star field.
+//  Version 4 (10/18/2026): Tiled detection against the full frame.
+//  Version 5 (10/18/2026): Disc footprints: spans, disc filters and
+//      tiled runs with discs.
+//  Version 6 (10/18/2026): Overlay tiling and marker coverage.
+//  Version 7 (10/18/2026): Largest background window, and rejection
+//      of larger ones.
+//  Version 8 (10/18/2026): Sequence tracking through a rotating
+//      field.
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Deterministic checks for starDetectionEngine.h, each against a
+//  plain reference on small random images or a synthetic star field:
+//
+//    filters      medianFilter() (BORDER_REPLICATE) and
+//                 absDiffBoxFilter() (BORDER_REFLECT_101) against
+//                 sorting / summing each window
+//    discs        Footprint spans against the pixel test, and
+//                 medianFilterDisc() / absDiffBoxFilterDisc() against
+//                 windows reflected inside each row and column span
+//    components   connectedComponents() on 0/255 and bit-packed
+//                 masks against an 8-connected flood fill
+//    halo index   HaloIndex::spansOnRow() against discs rasterized
+//                 one by one
+//    refinement   on a faint field, moments beat the plain centroids
+//                 and the Gaussian fit beats moments, with flux and
+//                 FWHM near the truth
+//    tiled        tiled::detect() over small tiles returns the
+//                 full-frame engine's stars and selection, with and
+//                 without projection discs
+//    overlay      overlay::render() gives the same pixels for every
+//                 tile size, and markers alone match a per-pixel
+//                 composite of their coverage in draw order
+//    stage cache  each parameter change recomputes exactly the stages
+//                 downstream of it, and the cached result equals a
+//                 fresh engine's
+//    sequence     SequenceDetector through a rotating field, with the
+//                 rotation given and estimated: every star found in
+//                 small windows under one track id, centroids as
+//                 close to the truth as a full-frame run's
+//
+//  Prints one line per check and exits 1 if any failed.
+
+// ============================================================== //
+// |                     COMPILE BASH SCRIPT                    | //
+// ============================================================== //
+// g++ starDetectionTests.cpp -o starDetectionTests -std=c++17 -O2 -Wall && ./starDetectionTests
+// (multi-threaded) add: -fopenmp -DUSE_OMP
+// (AVX2 mask shifts) add: -mavx2
+
+// ============================================================== //
+// |                      INCLUDE / DEFINE                      | //
+// ============================================================== //
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <random>
+#include <stdexcept>
+#include <algorithm>
+
+#include "starDetectionEngine.h"
+#include "tiledDetection.h"
+#include "overlayRenderer.h"
+#include "sequenceDetection.h"
+
+static const std::string kScriptName = "CHRIS'S KIT";
+static int gFailures = 0;
+
+static void check(bool ok,const std::string& what) {
+    std::printf("[%s] %s %s\n",kScriptName.c_str(),ok ? "PASS" : "FAIL",what.c_str());
+    if (!ok) gFailures++;
+}
+
+//Sizes cover single pixels, odd widths and ragged tails.
+static const int kSizes[][2] = {{1,1},{7,5},{33,17},{64,9},{65,31},{130,40},{201,77}};
+
+static std::vector<uint8_t> randomImage(std::mt19937& rng,int width,int height) {
+    std::vector<uint8_t> image((size_t)width * height);
+    for (uint8_t& v : image) v = (uint8_t)(rng() & 255);
+    return image;
+}
+
+//0/255 mask with a given fill fraction, in clumps so components see
+//more than salt noise.
+static std::vector<uint8_t> randomMask(std::mt19937& rng,int width,int height,double fill) {
+    std::vector<uint8_t> mask((size_t)width * height,0);
+    std::uniform_real_distribution<double> u(0.0,1.0);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const bool left = x > 0 && mask[(size_t)y * width + x - 1];
+            const bool up = y > 0 && mask[(size_t)(y - 1) * width + x];
+            const double p = (left || up) ? std::min(0.9,fill * 2.5) : fill * 0.5;
+            mask[(size_t)y * width + x] = u(rng) < p ? 255 : 0;
+        }
+    }
+    return mask;
+}
+
+//Gray star field: sloped sky, Gaussian noise, Gaussian stars of
+//random peak in [peakMin, peakMax] and width, and every 40th star
+//saturated with a halo.
+struct StarField {
+    int width = 0, height = 0;
+    std::vector<uint8_t> gray;
+    std::vector<double> x, y, flux, fwhm;   // Truth, per star
+};
+
+static StarField makeStarField(int width,int height,int stars,double noise,double peakMin,double peakMax,uint32_t seed) {
+    StarField field;
+    field.width = width; field.height = height;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> u(0.0,1.0);
+    std::normal_distribution<double> normal;
+    std::vector<double> sky((size_t)width * height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) sky[(size_t)y * width + x] = 20.0 + 15.0 * x / width + 10.0 * y / height + noise * normal(rng);
+    }
+    for (int s = 0; s < stars; s++) {
+        const bool bright = s % 40 == 0;
+        const double cx = 12.0 + u(rng) * (width - 24.0), cy = 12.0 + u(rng) * (height - 24.0);
+        const double sigma = bright ? 3.5 : 0.9 + 0.6 * u(rng);
+        const double peak = bright ? 600.0 : peakMin + (peakMax - peakMin) * u(rng);
+        const int r = (int)std::ceil(5.0 * sigma);
+        for (int y = std::max(0,(int)cy - r); y <= std::min(height - 1,(int)cy + r); y++) {
+            for (int x = std::max(0,(int)cx - r); x <= std::min(width - 1,(int)cx + r); x++) {
+                const double dx = x - cx, dy = y - cy;
+                sky[(size_t)y * width + x] += peak * std::exp(-(dx * dx + dy * dy) / (2.0 * sigma * sigma));
+            }
+        }
+        field.x.push_back(cx); field.y.push_back(cy);
+        field.flux.push_back(2.0 * M_PI * sigma * sigma * peak);
+        field.fwhm.push_back(2.0 * std::sqrt(2.0 * std::log(2.0)) * sigma);
+    }
+    field.gray.resize(sky.size());
+    for (size_t i = 0; i < sky.size(); i++) field.gray[i] = (uint8_t)std::max(0.0,std::min(255.0,std::round(sky[i])));
+    return field;
+}
+
+static bool sameStars(const std::vector<StarRow>& a,const std::vector<StarRow>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].centerX != b[i].centerX || a[i].centerY != b[i].centerY || a[i].area != b[i].area
+            || a[i].sumIntensity != b[i].sumIntensity || a[i].flux != b[i].flux || a[i].fwhm != b[i].fwhm) return false;
+    }
+    return true;
+}
+
+// ============================================================== //
+// |                          FILTERS                           | //
+// ============================================================== //
+static void checkFilters() {
+    std::mt19937 rng(3);
+    bool medianOk = true, boxOk = true;
+    for (const auto& size : kSizes) {
+        const int width = size[0], height = size[1];
+        const std::vector<uint8_t> a = randomImage(rng,width,height), b = randomImage(rng,width,height);
+        std::vector<uint8_t> out((size_t)width * height);
+        for (int k : {1,3,5,9,15}) {
+            const int r = k / 2;
+            detection::medianFilter(a.data(),out.data(),width,height,k);
+            std::vector<uint8_t> window;
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    window.clear();
+                    for (int dy = -r; dy <= r; dy++) {
+                        for (int dx = -r; dx <= r; dx++) {
+                            window.push_back(a[(size_t)detection::clampIndex(y + dy,height) * width + detection::clampIndex(x + dx,width)]);
+                        }
+                    }
+                    std::nth_element(window.begin(),window.begin() + window.size() / 2,window.end());
+                    medianOk &= out[(size_t)y * width + x] == window[window.size() / 2];
+                }
+            }
+
+            //Reflect-101 needs at least two pixels per axis once the window overhangs.
+            if (k > 1 && (width < 2 || height < 2)) continue;
+            detection::absDiffBoxFilter(a.data(),b.data(),out.data(),width,height,k);
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    long sum = 0;
+                    for (int dy = -r; dy <= r; dy++) {
+                        for (int dx = -r; dx <= r; dx++) {
+                            const size_t i = (size_t)detection::reflect101(y + dy,height) * width + detection::reflect101(x + dx,width);
+                            sum += std::abs((int)a[i] - (int)b[i]);
+                        }
+                    }
+                    boxOk &= out[(size_t)y * width + x] == (uint8_t)std::min(255L,std::lrint((double)sum / (k * k)));
+                }
+            }
+        }
+    }
+    check(medianOk,"medianFilter() equals the sorted window median (k = 1-15, replicate border)");
+    check(boxOk,"absDiffBoxFilter() equals the window mean of |a - b| (reflect-101 border)");
+
+    //At k = 255 a window fills 65025 of the 65535 counts a bin can hold.
+    const int width = 300, height = 280, k = kMaxBackgroundKernel, r = k / 2;
+    std::vector<uint8_t> image((size_t)width * height);
+    for (uint8_t& v : image) v = (uint8_t)(200 + rng() % 56);   // Most counts land in one coarse bin
+    std::vector<uint8_t> out(image.size());
+    detection::medianFilter(image.data(),out.data(),width,height,k);
+    bool largeOk = true;
+    std::vector<uint8_t> window;
+    for (int i = 0; i < 40; i++) {
+        const int x = (int)(rng() % width), y = (int)(rng() % height);
+        window.clear();
+        for (int dy = -r; dy <= r; dy++) {
+            for (int dx = -r; dx <= r; dx++) window.push_back(image[(size_t)detection::clampIndex(y + dy,height) * width + detection::clampIndex(x + dx,width)]);
+        }
+        std::nth_element(window.begin(),window.begin() + window.size() / 2,window.end());
+        largeOk &= out[(size_t)y * width + x] == window[window.size() / 2];
+    }
+    check(largeOk,"medianFilter() at the largest background window (255)");
+
+    StarDetectionEngine engine;
+    engine.setImage(image.data(),width,height,1,(size_t)width);
+    DetectionParams params;
+    bool rejected = true;
+    for (int bgKernel : {256,257,1001}) {
+        params.bgKernel = bgKernel;
+        try { engine.run(params); rejected = false; } catch (const std::runtime_error&) {}
+    }
+    params.bgKernel = 254;   // Forced up to 255
+    try { engine.run(params); } catch (const std::runtime_error&) { rejected = false; }
+    check(rejected,"run() rejects a background window past 255 and accepts 254/255");
+}
+
+// ============================================================== //
+// |                       DISC FOOTPRINT                       | //
+// ============================================================== //
+static bool insideDisc(const detection::Disc& disc,int x,int y) {
+    const double dx = x - disc.centerX, dy = y - disc.centerY;
+    return dx * dx + dy * dy <= disc.radius * disc.radius;
+}
+
+//In-disc interval [begin, end) of row y (or column x), by brute force.
+static void rowSpan(const detection::Disc& disc,int y,int width,int& begin,int& end) {
+    begin = end = 0;
+    for (int x = 0; x < width; x++) {
+        if (!insideDisc(disc,x,y)) continue;
+        if (begin == end) begin = x;
+        end = x + 1;
+    }
+}
+
+static void columnSpan(const detection::Disc& disc,int x,int height,int& begin,int& end) {
+    begin = end = 0;
+    for (int y = 0; y < height; y++) {
+        if (!insideDisc(disc,x,y)) continue;
+        if (begin == end) begin = y;
+        end = y + 1;
+    }
+}
+
+static void checkDiscs() {
+    std::mt19937 rng(13);
+    std::uniform_real_distribution<double> u(0.0,1.0);
+    bool footprintOk = true, medianOk = true, boxOk = true;
+    for (int trial = 0; trial < 24; trial++) {
+        const int width = 20 + (int)(rng() % 90), height = 20 + (int)(rng() % 70);
+        //Centres may sit off the image; radii from a few pixels to past the frame.
+        detection::Disc disc;
+        disc.centerX = -10.0 + u(rng) * (width + 20.0);
+        disc.centerY = -10.0 + u(rng) * (height + 20.0);
+        disc.radius = 3.0 + u(rng) * 0.8 * std::max(width,height);
+
+        detection::Footprint footprint;
+        footprint.build({disc},width,height);
+        size_t pixels = 0;
+        for (int y = 0; y < height; y++) {
+            int begin, end;
+            rowSpan(disc,y,width,begin,end);
+            pixels += (size_t)(end - begin);
+            const size_t count = footprint.rowStart[y + 1] - footprint.rowStart[y];
+            if (begin == end) footprintOk &= count == 0;
+            else footprintOk &= count == 1 && footprint.spans[footprint.rowStart[y]] == std::make_pair(begin,end);
+        }
+        footprintOk &= footprint.pixels == pixels;
+        if (footprint.discs.empty()) continue;
+        const detection::DiscSpans& spans = footprint.discs[0];
+
+        const std::vector<uint8_t> a = randomImage(rng,width,height), b = randomImage(rng,width,height);
+        for (int k : {3,5,9,15}) {
+            const int r = k / 2;
+            std::vector<uint8_t> median((size_t)width * height,7), box((size_t)width * height,7);
+            detection::medianFilterDisc(a.data(),median.data(),width,spans,k);
+            detection::absDiffBoxFilterDisc(a.data(),b.data(),box.data(),width,spans,k);
+            std::vector<uint8_t> window;
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    const size_t i = (size_t)y * width + x;
+                    if (!insideDisc(disc,x,y)) {
+                        //Padding is never written.
+                        medianOk &= median[i] == 7;
+                        boxOk &= box[i] == 7;
+                        continue;
+                    }
+                    int rowBegin, rowEnd;
+                    rowSpan(disc,y,width,rowBegin,rowEnd);
+                    window.clear();
+                    long sum = 0;
+                    for (int dx = -r; dx <= r; dx++) {
+                        const int xx = rowBegin + detection::reflect101(x + dx - rowBegin,rowEnd - rowBegin);
+                        int columnBegin, columnEnd;
+                        columnSpan(disc,xx,height,columnBegin,columnEnd);
+                        for (int dy = -r; dy <= r; dy++) {
+                            const int yy = columnBegin + detection::reflect101(y + dy - columnBegin,columnEnd - columnBegin);
+                            const size_t j = (size_t)yy * width + xx;
+                            window.push_back(a[j]);
+                            sum += std::abs((int)a[j] - (int)b[j]);
+                        }
+                    }
+                    std::nth_element(window.begin(),window.begin() + window.size() / 2,window.end());
+                    medianOk &= median[i] == window[window.size() / 2];
+                    boxOk &= box[i] == (uint8_t)std::min(255L,std::lrint((double)sum / (k * k)));
+                }
+            }
+        }
+    }
+    check(footprintOk,"Footprint spans and pixel count equal the per-pixel disc test");
+    check(medianOk,"medianFilterDisc() equals the median of the disc-reflected window");
+    check(boxOk,"absDiffBoxFilterDisc() equals the mean |a - b| of the disc-reflected window");
+}
+
+// ============================================================== //
+// |                         COMPONENTS                         | //
+// ============================================================== //
+static bool sameComponents(const std::vector<detection::Component>& a,const std::vector<detection::Component>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].area != b[i].area || a[i].sumX != b[i].sumX || a[i].sumY != b[i].sumY || a[i].sumIntensity != b[i].sumIntensity
+            || a[i].left != b[i].left || a[i].top != b[i].top || a[i].right != b[i].right || a[i].bottom != b[i].bottom) return false;
+    }
+    return true;
+}
+
+//8-connected flood fill from each unlabelled pixel in raster order.
+static std::vector<detection::Component> floodFill(const std::vector<uint8_t>& mask,const std::vector<uint8_t>& gray,int width,int height) {
+    std::vector<detection::Component> components;
+    std::vector<bool> seen(mask.size(),false);
+    std::vector<int> stack;
+    for (int start = 0; start < width * height; start++) {
+        if (!mask[start] || seen[start]) continue;
+        detection::Component c;
+        c.left = c.right = start % width;
+        c.top = c.bottom = start / width;
+        seen[start] = true;
+        stack.push_back(start);
+        while (!stack.empty()) {
+            const int i = stack.back(), x = i % width, y = i / width;
+            stack.pop_back();
+            c.area++;
+            c.sumX += x; c.sumY += y; c.sumIntensity += gray[i];
+            c.left = std::min(c.left,x); c.right = std::max(c.right,x);
+            c.top = std::min(c.top,y); c.bottom = std::max(c.bottom,y);
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    const int xx = x + dx, yy = y + dy;
+                    if (xx < 0 || yy < 0 || xx >= width || yy >= height) continue;
+                    const int j = yy * width + xx;
+                    if (mask[j] && !seen[j]) { seen[j] = true; stack.push_back(j); }
+                }
+            }
+        }
+        components.push_back(c);
+    }
+    return components;
+}
+
+static void checkComponents() {
+    std::mt19937 rng(9);
+    bool rasterOk = true, packedOk = true;
+    for (const auto& size : kSizes) {
+        const int width = size[0], height = size[1];
+        const std::vector<uint8_t> gray = randomImage(rng,width,height);
+        for (double fill : {0.05,0.3,0.6}) {
+            const std::vector<uint8_t> mask = randomMask(rng,width,height,fill);
+            const std::vector<detection::Component> reference = floodFill(mask,gray,width,height);
+            rasterOk &= sameComponents(detection::connectedComponents(mask.data(),gray.data(),width,height),reference);
+            bitmask::BitMask packed;
+            bitmask::packThreshold(mask.data(),width,height,127,packed);
+            packedOk &= sameComponents(detection::connectedComponents(packed,gray.data()),reference);
+        }
+    }
+    check(rasterOk,"connectedComponents() on a 0/255 mask equals an 8-connected flood fill");
+    check(packedOk,"connectedComponents() on a packed mask equals an 8-connected flood fill");
+}
+
+// ============================================================== //
+// |                         HALO INDEX                         | //
+// ============================================================== //
+static void checkHaloIndex() {
+    std::mt19937 rng(17);
+    bool ok = true;
+    for (const auto& size : kSizes) {
+        const int width = size[0], height = size[1];
+        for (int count : {0,1,5,40}) {
+            std::vector<detection::HaloDisc> discs;
+            for (int i = 0; i < count; i++) {
+                //Centres may sit off the image and radii may exceed a band.
+                discs.push_back({(int)(rng() % (width + 20)) - 10,(int)(rng() % (height + 20)) - 10,(int)(rng() % 70)});
+            }
+            std::vector<uint8_t> raster((size_t)width * height,0);
+            for (const detection::HaloDisc& d : discs) {
+                for (int y = 0; y < height; y++) {
+                    const int dy = y - d.cy;
+                    if (dy < -d.radius || dy > d.radius) continue;
+                    const int span = (int)std::sqrt((double)d.radius * d.radius - (double)dy * dy);
+                    for (int x = std::max(0,d.cx - span); x <= std::min(width - 1,d.cx + span); x++) raster[(size_t)y * width + x] = 1;
+                }
+            }
+            detection::HaloIndex index;
+            index.build(discs,height);
+            std::vector<std::pair<int,int>> spans;
+            for (int y = 0; y < height; y++) {
+                index.spansOnRow(y,width,spans);
+                std::vector<uint8_t> row((size_t)width,0);
+                for (size_t i = 0; i < spans.size(); i++) {
+                    //Spans come back sorted, disjoint and not touching.
+                    if (i > 0 && spans[i].first <= spans[i - 1].second + 1) ok = false;
+                    for (int x = spans[i].first; x <= spans[i].second; x++) row[x] = 1;
+                }
+                ok &= std::equal(row.begin(),row.end(),raster.begin() + (size_t)y * width);
+            }
+        }
+    }
+    check(ok,"HaloIndex::spansOnRow() equals the rasterized discs, merged and sorted");
+}
+
+// ============================================================== //
+// |                         REFINEMENT                         | //
+// ============================================================== //
+struct RefineScore { double rms = 0.0, flux = 0.0, fwhm = 0.0; int matched = 0; };
+
+//Detections within 2 px of an isolated true star: rms position error
+//and median flux / FWHM ratios to the truth.
+static RefineScore scoreRefinement(const StarField& field,const std::vector<StarRow>& stars) {
+    RefineScore score;
+    std::vector<double> flux, fwhm;
+    for (const StarRow& star : stars) {
+        int best = -1;
+        double bestDistance = 2.0;
+        for (size_t i = 0; i < field.x.size(); i++) {
+            const double distance = std::hypot(star.centerX - field.x[i],star.centerY - field.y[i]);
+            if (distance < bestDistance) { bestDistance = distance; best = (int)i; }
+        }
+        if (best < 0) continue;
+        bool blended = false;
+        for (size_t i = 0; i < field.x.size(); i++) {
+            if ((int)i != best && std::hypot(field.x[i] - field.x[best],field.y[i] - field.y[best]) < 10.0) blended = true;
+        }
+        if (blended) continue;
+        score.rms += bestDistance * bestDistance;
+        score.matched++;
+        flux.push_back(star.flux / field.flux[best]);
+        fwhm.push_back(star.fwhm / field.fwhm[best]);
+    }
+    if (score.matched == 0) return score;
+    score.rms = std::sqrt(score.rms / score.matched);
+    std::nth_element(flux.begin(),flux.begin() + flux.size() / 2,flux.end());
+    std::nth_element(fwhm.begin(),fwhm.begin() + fwhm.size() / 2,fwhm.end());
+    score.flux = flux[flux.size() / 2];
+    score.fwhm = fwhm[fwhm.size() / 2];
+    return score;
+}
+
+static void checkRefinement() {
+    //Faint stars (peak 4-17 sigma) in a window mostly made of sky, where
+    //any noise that enters the moments drags the centroid to the middle.
+    const StarField field = makeStarField(640,480,250,3.0,12.0,52.0,21);
+    DetectionParams params;
+    params.bgKernel = 21;
+    params.snrThreshold = 4.0;
+    params.minArea = 4;
+    params.maxArea = 400;
+    params.minSeparation = 0.0;
+    params.maxStars = 100000;
+
+    RefineScore scores[3];
+    for (int mode : {psf::RefineOff,psf::RefineMoments,psf::RefineGaussian}) {
+        params.refine = mode;
+        StarDetectionEngine engine;
+        engine.setImage(field.gray.data(),field.width,field.height,1,(size_t)field.width);
+        engine.run(params);
+        scores[mode] = scoreRefinement(field,engine.stars());
+    }
+    const RefineScore& off = scores[psf::RefineOff];
+    const RefineScore& moments = scores[psf::RefineMoments];
+    const RefineScore& gaussian = scores[psf::RefineGaussian];
+    std::printf("[%s]   rms px: plain %.3f, moments %.3f, gaussian %.3f (%d stars); moments flux x%.2f, fwhm x%.2f\n",
+                kScriptName.c_str(),off.rms,moments.rms,gaussian.rms,off.matched,moments.flux,moments.fwhm);
+    check(off.matched >= 20 && moments.rms < 0.75 * off.rms,"refine: moment centroids beat the plain centroids on a faint field");
+    check(gaussian.rms < moments.rms,"refine: the Gaussian fit beats the moment centroids");
+    check(std::fabs(moments.flux - 1.0) < 0.15 && std::fabs(moments.fwhm - 1.0) < 0.15,"refine: moment flux and FWHM within 15% of the truth");
+    check(std::fabs(gaussian.flux - 1.0) < 0.1 && std::fabs(gaussian.fwhm - 1.0) < 0.1,"refine: Gaussian flux and FWHM within 10% of the truth");
+}
+
+// ============================================================== //
+// |                           TILED                            | //
+// ============================================================== //
+static void checkTiled() {
+    const StarField field = makeStarField(333,251,180,3.0,60.0,220.0,33);
+    DetectionParams params;
+    params.bgKernel = 21;
+    params.snrThreshold = 6.0;
+    params.minArea = 4;
+    params.minSeparation = 6.0;
+
+    StarDetectionEngine engine;
+    engine.setImage(field.gray.data(),field.width,field.height,1,(size_t)field.width);
+    const std::vector<StarRow> selection = engine.run(params);
+    const std::vector<StarRow> stars = engine.stars();
+
+    //Tile sizes that put seams through stars and leave ragged last tiles.
+    auto matchesFullFrame = [&](const std::vector<detection::Disc>& discs,const std::vector<StarRow>& stars,
+                                const std::vector<StarRow>& selection) {
+        bool ok = !selection.empty();
+        for (int tileSize : {64,100,150,400}) {
+            tiled::TileOptions options;
+            options.tileSize = tileSize;
+            const tiled::TiledDetection result = tiled::detect(field.gray.data(),field.width,field.height,1,(size_t)field.width,true,
+                                                               params,options,discs);
+            if (!sameStars(result.stars,stars) || !sameStars(result.selection,selection)) {
+                std::printf("[%s]   tile %d, %zu discs: %zu stars / %zu selected, full frame %zu / %zu\n",kScriptName.c_str(),tileSize,
+                            discs.size(),result.stars.size(),result.selection.size(),stars.size(),selection.size());
+                ok = false;
+            }
+        }
+        return ok;
+    };
+    check(matchesFullFrame({},stars,selection),"tiled::detect() equals the full-frame run (tiles of 64-400 px)");
+
+    //Two hemispheres side by side, the second cut by the frame edge.
+    const std::vector<detection::Disc> discs = {{90.0,125.5,88.0},{262.0,120.0,80.5}};
+    engine.setDiscs(discs);
+    const std::vector<StarRow> discSelection = engine.run(params);
+    const std::vector<StarRow> discStars = engine.stars();
+    bool inside = true;
+    for (const StarRow& star : discStars) {
+        inside &= insideDisc(discs[0],(int)std::lround(star.centerX),(int)std::lround(star.centerY))
+               || insideDisc(discs[1],(int)std::lround(star.centerX),(int)std::lround(star.centerY));
+    }
+    check(inside && discStars.size() < stars.size(),"disc footprint: every star lies inside a disc");
+    check(matchesFullFrame(discs,discStars,discSelection),"tiled::detect() with discs equals the full-frame run with discs");
+}
+
+// ============================================================== //
+// |                          OVERLAY                           | //
+// ============================================================== //
+static void checkOverlay() {
+    std::mt19937 rng(29);
+    std::uniform_real_distribution<double> u(0.0,1.0);
+    const int width = 301, height = 203, count = 80;
+    std::vector<double> x(count), y(count), radius(count);
+    std::vector<std::string> text(count);
+    std::vector<const char*> labels(count);
+    for (int i = 0; i < count; i++) {
+        //Some markers and labels hang off the frame; a few labels are empty or null.
+        x[i] = -15.0 + u(rng) * (width + 30.0);
+        y[i] = -15.0 + u(rng) * (height + 30.0);
+        radius[i] = 0.5 + u(rng) * 12.0;
+        text[i] = (i % 9 == 0) ? std::string() : (i % 13 == 0) ? "\xCE\xA9" + std::to_string(i) : "S" + std::to_string(i);
+        labels[i] = (i % 17 == 0) ? nullptr : text[i].c_str();
+    }
+    overlay::Markers markers;
+    markers.x = x.data(); markers.y = y.data(); markers.radius = radius.data();
+    markers.labels = labels.data();
+    markers.count = count;
+    const std::vector<uint8_t> background = randomImage(rng,width * 3,height);
+
+    bool tilesOk = true;
+    for (const uint8_t* under : {background.data(),(const uint8_t*)nullptr}) {
+        std::vector<uint8_t> reference((size_t)width * height * 4), out(reference.size());
+        overlay::Style style;
+        style.tileSize = 4096;
+        overlay::render(markers,style,width,height,under,3,(size_t)width * 3,true,reference.data(),(size_t)width * 4);
+        for (int tileSize : {16,37,64}) {
+            style.tileSize = tileSize;
+            overlay::render(markers,style,width,height,under,3,(size_t)width * 3,true,out.data(),(size_t)width * 4);
+            tilesOk &= out == reference;
+        }
+    }
+    check(tilesOk,"overlay::render() is identical for tile sizes 16-4096 (with and without a background)");
+
+    //Markers only, on transparency: straight "over" of each disc's coverage.
+    markers.labels = nullptr;
+    overlay::Style style;
+    style.tileSize = 32;
+    std::vector<uint8_t> out((size_t)width * height * 4);
+    overlay::render(markers,style,width,height,nullptr,3,0,true,out.data(),(size_t)width * 4);
+    bool markersOk = true;
+    for (int py = 0; py < height; py++) {
+        for (int px = 0; px < width; px++) {
+            double alpha = 0.0;
+            for (int i = 0; i < count; i++) {
+                const double coverage = std::min(1.0,radius[i] + 0.5 - std::hypot(px - x[i],py - y[i]));
+                if (coverage > 0.0) alpha = coverage + alpha * (1.0 - coverage);
+            }
+            const uint8_t* p = &out[((size_t)py * width + px) * 4];
+            markersOk &= std::abs((int)p[3] - (int)std::lround(alpha * 255.0)) <= 1;
+            if (p[3] > 0) markersOk &= p[0] == style.marker.r && p[1] == style.marker.g && p[2] == style.marker.b;
+        }
+    }
+    check(markersOk,"overlay markers match the per-pixel coverage composite");
+}
+
+// ============================================================== //
+// |                        STAGE CACHE                         | //
+// ============================================================== //
+static uint32_t stages(std::initializer_list<int> list) {
+    uint32_t bits = 0;
+    for (int stage : list) bits |= 1u << stage;
+    return bits;
+}
+
+static void checkStageCache() {
+    const StarField field = makeStarField(320,240,150,3.0,60.0,220.0,21);
+    DetectionParams params;
+    params.bgKernel = 21;
+    params.snrThreshold = 6.0;
+    params.minArea = 4;
+
+    StarDetectionEngine engine;
+    engine.setImage(field.gray.data(),field.width,field.height,1,(size_t)field.width);
+    engine.run(params);
+    const uint32_t all = (1u << StageCount) - 1;
+    check(engine.recomputedStages() == all && !engine.selection().empty(),"stage cache: the first run computes every stage");
+    engine.run(params);
+    check(engine.recomputedStages() == 0,"stage cache: an unchanged rerun recomputes nothing");
+
+    //Each change, with the stages it must (and may only) recompute.
+    struct Step { const char* name; void (*apply)(DetectionParams&); uint32_t expected; };
+    const uint32_t fromSnr = stages({StageSnrMask,StageCandidateMask,StageComponents,StageStars,StageRefine,StageSelection});
+    const Step steps[] = {
+        {"maxStars",[](DetectionParams& p) { p.maxStars = 40; },stages({StageSelection})},
+        {"minSeparation",[](DetectionParams& p) { p.minSeparation = 8.0; },stages({StageSelection})},
+        {"minArea",[](DetectionParams& p) { p.minArea = 6; },stages({StageStars,StageRefine,StageSelection})},
+        {"haloScale",[](DetectionParams& p) { p.haloScale = 3.0; },
+            stages({StageCandidateMask,StageComponents,StageStars,StageRefine,StageSelection})},
+        {"brightPercentile",[](DetectionParams& p) { p.brightPercentile = 0.995; },
+            stages({StageBrightMask,StageCandidateMask,StageComponents,StageStars,StageRefine,StageSelection})},
+        {"snrThreshold",[](DetectionParams& p) { p.snrThreshold = 7.0; },fromSnr},
+        {"blur",[](DetectionParams& p) { p.blur = 5; },fromSnr},
+        {"bgKernel",[](DetectionParams& p) { p.bgKernel = 31; },stages({StageBackground,StageSigma}) | fromSnr},
+    };
+    bool recomputeOk = true, resultOk = true;
+    for (const Step& step : steps) {
+        step.apply(params);
+        engine.run(params);
+        if (engine.recomputedStages() != step.expected) {
+            std::printf("[%s]   %s recomputed 0x%x, expected 0x%x\n",kScriptName.c_str(),step.name,engine.recomputedStages(),step.expected);
+            recomputeOk = false;
+        }
+        StarDetectionEngine fresh;
+        fresh.setImage(field.gray.data(),field.width,field.height,1,(size_t)field.width);
+        resultOk &= sameStars(engine.selection(),fresh.run(params)) && sameStars(engine.stars(),fresh.stars());
+    }
+    check(recomputeOk,"stage cache: each parameter recomputes exactly its downstream stages");
+    check(resultOk,"stage cache: cached results equal a fresh engine's after every change");
+
+    StarField moved = field;
+    moved.gray[(size_t)100 * field.width + 100] ^= 1;
+    engine.setImage(moved.gray.data(),moved.width,moved.height,1,(size_t)moved.width);
+    engine.run(params);
+    check(engine.recomputedStages() == all,"stage cache: a new image recomputes every stage");
+}
+
+// ============================================================== //
+// |                          SEQUENCE                          | //
+// ============================================================== //
+//Frame of a sky turned by angle radians about the disc centre: flat
+//sky plus noise, Gaussian stars (x, y, peak) rotated like the engine.
+static std::vector<uint8_t> rotatedFrame(int size,const std::vector<double>& stars,double angle,uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> normal;
+    std::vector<double> sky((size_t)size * size);
+    for (double& v : sky) v = 25.0 + 2.0 * normal(rng);
+    const double sigma = 1.2, centre = size / 2.0;
+    for (size_t s = 0; s < stars.size(); s += 3) {
+        double cx = stars[s], cy = stars[s + 1];
+        sequence::rotateAbout(centre,centre,angle,cx,cy);
+        for (int y = (int)cy - 6; y <= (int)cy + 6; y++) {
+            for (int x = (int)cx - 6; x <= (int)cx + 6; x++) {
+                const double dx = x - cx, dy = y - cy;
+                sky[(size_t)y * size + x] += stars[s + 2] * std::exp(-(dx * dx + dy * dy) / (2.0 * sigma * sigma));
+            }
+        }
+    }
+    std::vector<uint8_t> gray(sky.size());
+    for (size_t i = 0; i < sky.size(); i++) gray[i] = (uint8_t)std::max(0.0,std::min(255.0,std::round(sky[i])));
+    return gray;
+}
+
+static void checkSequence() {
+    //Stars well inside the disc and apart, so none leaves it or merges
+    //with another over the run.
+    const int size = 320, frames = 6;
+    const double step = 1.5;
+    std::mt19937 rng(31);
+    std::uniform_real_distribution<double> u(0.0,1.0);
+    std::vector<double> stars;
+    while (stars.size() < 3 * 30) {
+        const double radius = 20.0 + 100.0 * std::sqrt(u(rng)), theta = 2.0 * M_PI * u(rng);
+        const double x = size / 2.0 + radius * std::cos(theta), y = size / 2.0 + radius * std::sin(theta);
+        bool apart = true;
+        for (size_t s = 0; s < stars.size(); s += 3) apart &= std::hypot(stars[s] - x,stars[s + 1] - y) > 12.0;
+        if (apart) { stars.push_back(x); stars.push_back(y); stars.push_back(120.0 + 100.0 * u(rng)); }
+    }
+    const std::vector<detection::Disc> discs = {{size / 2.0,size / 2.0,150.0}};
+    DetectionParams params;
+    params.bgKernel = 31;
+    params.snrThreshold = 6.0;
+    params.minArea = 4;
+    params.maxArea = 200;
+    params.minSeparation = 0.0;
+    params.maxStars = 100000;
+
+    for (bool given : {true,false}) {
+        sequence::SequenceOptions options;
+        options.fullScanEvery = 0;
+        if (given) options.rotationDegrees = {step};
+        sequence::SequenceDetector detector(params,options,discs);
+        bool matchOk = true, idsOk = true, windowOk = true;
+        std::vector<int64_t> firstIds;
+        for (int f = 0; f < frames; f++) {
+            const std::vector<uint8_t> gray = rotatedFrame(size,stars,f * step * M_PI / 180.0,100 + f);
+            const sequence::FrameResult result = detector.detect(gray.data(),size,size,1,(size_t)size,false);
+            StarDetectionEngine engine;
+            engine.setDiscs(discs);
+            engine.setImage(gray.data(),size,size,1,(size_t)size);
+            const std::vector<StarRow> full = engine.run(params);
+
+            //Both runs find every star, and the tracked centroids are as
+            //close to the truth as the full frame's.
+            matchOk &= result.rows.size() == stars.size() / 3 && full.size() == stars.size() / 3;
+            std::vector<double> truth;
+            for (size_t s = 0; s < stars.size(); s += 3) {
+                double x = stars[s], y = stars[s + 1];
+                sequence::rotateAbout(size / 2.0,size / 2.0,f * step * M_PI / 180.0,x,y);
+                truth.push_back(x); truth.push_back(y);
+            }
+            auto rms = [&](const std::vector<StarRow>& rows) {
+                double sum = 0.0;
+                for (const StarRow& row : rows) {
+                    double best = 1e9;
+                    for (size_t s = 0; s < truth.size(); s += 2) best = std::min(best,std::hypot(row.centerX - truth[s],row.centerY - truth[s + 1]));
+                    sum += best * best;
+                }
+                return rows.empty() ? 1e9 : std::sqrt(sum / rows.size());
+            };
+            matchOk &= rms(result.rows) <= rms(full) + 0.05;
+            std::vector<int64_t> ids = result.ids;
+            std::sort(ids.begin(),ids.end());
+            if (f == 0) firstIds = ids; else idsOk &= ids == firstIds;
+            if (!result.fullScan) windowOk &= result.recovered == result.predicted && result.pixelsRead < (size_t)size * size / 3;
+        }
+        const std::string how = given ? " (rotation given)" : " (rotation estimated)";
+        check(matchOk,"sequence: every star is found, as close to the truth as a full-frame run" + how);
+        check(idsOk,"sequence: every star keeps its track id" + how);
+        check(windowOk,"sequence: tracked frames recover every star from small windows" + how);
+        check(std::fabs(detector.rotationDegrees(0) - step) < 0.1,"sequence: the measured step is within 0.1 degrees of the true rotation" + how);
+    }
+}
+
+// ============================================================== //
+// |                        MAIN PROGRAM                        | //
+// ============================================================== //
+int main() {
+    try {
+        checkFilters();
+        checkDiscs();
+        checkComponents();
+        checkHaloIndex();
+        checkRefinement();
+        checkTiled();
+        checkOverlay();
+        checkStageCache();
+        checkSequence();
+    } catch (const std::exception& e) {
+        std::fprintf(stderr,"Error: %s\n",e.what());
+        return 1;
+    }
+    std::printf("[%s] %s\n",kScriptName.c_str(),gFailures == 0 ? "All checks passed" : (std::to_string(gFailures) + " checks failed").c_str());
+    return gFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+//Star Table Loading
+//Shared Header
+//Chris D. | Version 1 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Functional launch
+//  Version 1 (10/18/2026): Columnar .stc tables (starColumns.h)
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Loads the tab-separated star catalog written by starDetection.py
+//  (onExportTxt, equatorial mode) into column arrays for the native
+//  star tools. Columns are found by header name, so the optional
+//  gha_deg column and any column order are accepted.
+//
+//  loadStarTable() also takes the binary columnar format
+//  (starColumns.h), detected by its magic rather than the extension.
+
+#ifndef LIVE_SKYBOXES_STAR_TABLE_H
+#define LIVE_SKYBOXES_STAR_TABLE_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "starColumns.h"
+
+// ============================================================== //
+// |                         STAR TABLE                         | //
+// ============================================================== //
+struct StarTable {
+    std::vector<std::string> ids;
+    std::vector<std::string> names;
+    std::vector<double> xPix, yPix;      // Detection pixel coordinates
+    std::vector<double> rightAscension;  // Degrees [0,360)
+    std::vector<double> declination;     // Degrees [-90,90]
+
+    size_t size() const { return rightAscension.size(); }
+
+    void push(const std::string& id,const std::string& name,double x,double y,double ra,double dec) {
+        ids.push_back(id);
+        names.push_back(name);
+        xPix.push_back(x);
+        yPix.push_back(y);
+        rightAscension.push_back(ra);
+        declination.push_back(dec);
+    }
+
+    //Keeps the first count rows (exports are sorted brightest first).
+    void truncate(size_t count) {
+        if (count >= size()) return;
+        ids.resize(count); names.resize(count);
+        xPix.resize(count); yPix.resize(count);
+        rightAscension.resize(count); declination.resize(count);
+    }
+};
+
+static inline std::vector<std::string> splitTabs(const std::string& line) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (true) {
+        size_t tab = line.find('\t',start);
+        std::string field = line.substr(start,tab == std::string::npos ? std::string::npos : tab - start);
+        if (!field.empty() && field.back() == '\r') field.pop_back();
+        fields.push_back(field);
+        if (tab == std::string::npos) break;
+        start = tab + 1;
+    }
+    return fields;
+}
+
+//Columnar table: ra and dec are required; id, label, x and y are
+//optional.
+static inline StarTable loadStarColumns(const std::string& path) {
+    StarColumnsFile file(path);
+    if (!file.has("ra") || !file.has("dec")) {
+        throw std::runtime_error("Star table needs ra and dec columns (export in equatorial mode): " + path);
+    }
+    ColumnSpan<double> ra = file.float64("ra"), dec = file.float64("dec");
+    ColumnSpan<double> x = file.has("x") ? file.float64("x") : ColumnSpan<double>();
+    ColumnSpan<double> y = file.has("y") ? file.float64("y") : ColumnSpan<double>();
+    ColumnSpan<int64_t> ids = file.has("id") ? file.int64("id") : ColumnSpan<int64_t>();
+    StringColumnSpan labels = file.has("label") ? file.strings("label") : StringColumnSpan();
+
+    StarTable table;
+    const size_t n = file.rows();
+    table.ids.reserve(n); table.names.reserve(n);
+    table.xPix.reserve(n); table.yPix.reserve(n);
+    table.rightAscension.reserve(n); table.declination.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        std::string id = ids.empty() ? std::to_string(i + 1) : std::to_string(ids[i]);
+        std::string name = labels.empty() ? std::string() : std::string(labels[i]);
+        if (name.empty()) name = id;
+        table.push(id,name,x.empty() ? 0.0 : x[i],y.empty() ? 0.0 : y[i],ra[i],dec[i]);
+    }
+    return table;
+}
+
+//Reads an equatorial star catalog (id, name, xpix, ypix, ra_deg,
+//dec_deg). Rows without RA/Dec are rejected with their line number.
+static inline StarTable loadStarTable(const std::string& path) {
+    if (StarColumnsFile::probe(path)) return loadStarColumns(path);
+    std::ifstream file(path,std::ios::binary);
+    if (!file) throw std::runtime_error("Failed to open star table: " + path);
+
+    std::string line;
+    if (!std::getline(file,line)) throw std::runtime_error("Empty star table: " + path);
+    std::vector<std::string> header = splitTabs(line);
+    auto column = [&](const char* name) {
+        for (size_t i = 0; i < header.size(); i++) if (header[i] == name) return (int)i;
+        return -1;
+    };
+    int idCol = column("id"), nameCol = column("name");
+    int xCol = column("xpix"), yCol = column("ypix");
+    int raCol = column("ra_deg"), decCol = column("dec_deg");
+    if (raCol < 0 || decCol < 0) {
+        throw std::runtime_error("Star table needs ra_deg and dec_deg columns (export in equatorial mode): " + path);
+    }
+
+    StarTable table;
+    int lineNumber = 1;
+    while (std::getline(file,line)) {
+        ++lineNumber;
+        if (line.empty() || line == "\r") continue;
+        std::vector<std::string> fields = splitTabs(line);
+        auto field = [&](int col) { return (col >= 0 && col < (int)fields.size()) ? fields[col] : std::string(); };
+        auto number = [&](int col,double fallback) {
+            std::string text = field(col);
+            if (text.empty()) return fallback;
+            char* end = nullptr;
+            double value = std::strtod(text.c_str(),&end);
+            if (end == text.c_str()) {
+                throw std::runtime_error("Bad number '" + text + "' on line " + std::to_string(lineNumber) + " of " + path);
+            }
+            return value;
+        };
+        if (field(raCol).empty() || field(decCol).empty()) {
+            throw std::runtime_error("Missing RA/Dec on line " + std::to_string(lineNumber) + " of " + path);
+        }
+        std::string id = field(idCol);
+        std::string name = field(nameCol);
+        if (id.empty()) id = std::to_string(table.size() + 1);
+        if (name.empty()) name = id;
+        table.push(id,name,number(xCol,0.0),number(yCol,0.0),number(raCol,0.0),number(decCol,0.0));
+    }
+    return table;
+}
+
+#endif // LIVE_SKYBOXES_STAR_TABLE_H
@@ -0,0 +1,240 @@
+//Star Detection
+//Tiled Detection (Shared Header)
+//Chris D. | Version 1 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Overlapping tiles with run stitching
+//  Version 1 (10/18/2026): Disc footprints passed through to tiles
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Runs StarDetectionEngine over overlapping tiles so the working
+//  maps (gray, background, sigma, masks) never exceed one tile per
+//  thread, for panoramas too large to process as one frame. The
+//  caller's pixels (decoded or memory-mapped) are read in place.
+//
+//    1. One streaming pass over the frame builds the gray histogram,
+//       so every tile thresholds bright sources at the frame-wide
+//       brightPercentile level.
+//    2. Each tile is its core plus a margin wide enough for the
+//       median + sigma windows, the open/blur cleanup and, with halo
+//       suppression, haloMargin pixels of bright-source context.
+//       Tiles run in parallel, one engine per thread.
+//    3. Only candidate runs inside a tile's core are kept, so every
+//       pixel has exactly one owner and nothing is counted twice.
+//       Runs meeting at a vertical seam are joined, and a union-find
+//       over the frame-wide run list stitches components across
+//       horizontal seams.
+//
+//  With the margin covering every window, results match a full-frame
+//  run; only bright sources wider than haloMargin that straddle a
+//  seam can see a clipped halo. Refinement (psfRefine.h) is not
+//  applied to tiled runs.
+//
+//  Projection discs are shifted into each tile's coordinates, so a
+//  tile only filters its in-disc spans and tiles outside every disc
+//  do no work.
+
+#ifndef LIVE_SKYBOXES_TILED_DETECTION_H
+#define LIVE_SKYBOXES_TILED_DETECTION_H
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include "starDetectionEngine.h"
+
+namespace tiled {
+
+struct TileOptions {
+    int tileSize = 2048;            // Core edge in pixels
+    int haloMargin = 128;           // Bright-source context beyond the filter windows
+};
+
+struct TiledDetection {
+    std::vector<StarRow> stars;     // Area-filtered, brightest first
+    std::vector<StarRow> selection; // filterBySeparation() applied
+    int tiles = 0, margin = 0;
+    size_t tileBytes = 0;           // Largest per-tile working set (maps and packed masks)
+};
+
+//Run with the gray sum of its pixels, in frame coordinates.
+struct SummedRun { int y, x0, x1; uint64_t sum; };
+
+//Context a core pixel needs: median and sigma windows (2r), the 3x3
+//open (2), the blur (k/2); or the 9x9 close plus haloMargin.
+static inline int tileMargin(const DetectionParams& params,const TileOptions& options) {
+    const int r = backgroundKernel(params) / 2;
+    const int blur = (params.blur > 1) ? (params.blur | 1) : 0;
+    const int snrContext = 2 * r + 2 + blur / 2;
+    const int haloContext = params.suppressHalo ? options.haloMargin + 8 : 0;
+    return std::max(snrContext,haloContext);
+}
+
+//Frame-wide bright level from a streaming gray histogram (in-disc
+//pixels only when discs are given).
+static inline int frameBrightLevel(const uint8_t* pixels,int width,int height,int channels,size_t strideBytes,bool bgr,double q,
+                                   const std::vector<detection::Disc>& discs) {
+    const int blockRows = 256;
+    detection::Footprint footprint;
+    footprint.build(discs,width,height);
+    std::vector<uint64_t> histogram(256,0);
+    std::vector<uint8_t> gray((size_t)width * blockRows);
+    for (int y = 0; y < height; y += blockRows) {
+        const int rows = std::min(blockRows,height - y);
+        detection::toGray(pixels + (size_t)y * strideBytes,width,rows,channels,strideBytes,bgr,gray.data());
+        if (!footprint.active()) {
+            std::vector<uint64_t> block = detection::histogram256(gray.data(),(size_t)width * rows);
+            for (int bin = 0; bin < 256; bin++) histogram[bin] += block[bin];
+            continue;
+        }
+        for (int row = 0; row < rows; row++) {
+            const uint8_t* g = &gray[(size_t)row * width];
+            for (size_t i = footprint.rowStart[y + row]; i < footprint.rowStart[y + row + 1]; i++) {
+                for (int x = footprint.spans[i].first; x < footprint.spans[i].second; x++) histogram[g[x]]++;
+            }
+        }
+    }
+    return detection::percentileBin(histogram,footprint.active() ? footprint.pixels : (size_t)width * height,q);
+}
+
+//Union-find over frame-wide runs, grouped by row; the same component
+//order and statistics as detection::labelRuns().
+static inline std::vector<detection::Component> stitchRuns(const std::vector<SummedRun>& runs,int height) {
+    std::vector<detection::Run> plain(runs.size());
+    std::vector<size_t> rowStart((size_t)height + 1,0);
+    for (size_t i = 0; i < runs.size(); i++) {
+        plain[i] = {runs[i].y,runs[i].x0,runs[i].x1};
+        rowStart[runs[i].y + 1]++;
+    }
+    for (int y = 0; y < height; y++) rowStart[y + 1] += rowStart[y];
+
+    std::vector<int> parent(runs.size());
+    for (size_t i = 0; i < runs.size(); i++) parent[i] = (int)i;
+    for (int y = 1; y < height; y++) detection::linkRows(plain,rowStart[y - 1],rowStart[y],rowStart[y + 1],parent);
+
+    std::vector<int> componentOf(runs.size(),-1);
+    std::vector<detection::Component> components;
+    for (size_t i = 0; i < runs.size(); i++) {
+        int root = detection::findRoot(parent,(int)i);
+        if (componentOf[root] < 0) {
+            componentOf[root] = (int)components.size();
+            detection::Component c;
+            c.left = runs[i].x0; c.right = runs[i].x1 - 1; c.top = c.bottom = runs[i].y;
+            components.push_back(c);
+        }
+        detection::Component& c = components[componentOf[root]];
+        const SummedRun& run = runs[i];
+        const int length = run.x1 - run.x0;
+        c.area += length;
+        c.sumX += 0.5 * (double)(run.x0 + run.x1 - 1) * length;
+        c.sumY += (double)run.y * length;
+        c.sumIntensity += (double)run.sum;
+        c.left = std::min(c.left,run.x0);
+        c.right = std::max(c.right,run.x1 - 1);
+        c.bottom = std::max(c.bottom,run.y);
+    }
+    return components;
+}
+
+static inline TiledDetection detect(const uint8_t* pixels,int width,int height,int channels,size_t strideBytes,bool bgr,
+                                    const DetectionParams& params,const TileOptions& options,
+                                    const std::vector<detection::Disc>& discs = {}) {
+    if (!pixels || width <= 0 || height <= 0) throw std::runtime_error("tiled::detect: empty image");
+    if (options.tileSize < 64) throw std::runtime_error("tiled::detect: tileSize must be >= 64");
+
+    TiledDetection result;
+    result.margin = tileMargin(params,options);
+    DetectionParams tileParams = params;
+    tileParams.refine = psf::RefineOff;
+    if (params.suppressHalo && params.brightLevel < 0) {
+        tileParams.brightLevel = frameBrightLevel(pixels,width,height,channels,strideBytes,bgr,params.brightPercentile,discs);
+    }
+
+    const int size = options.tileSize, margin = result.margin;
+    const int columns = (width + size - 1) / size, rows = (height + size - 1) / size;
+    result.tiles = columns * rows;
+    std::vector<std::vector<SummedRun>> tileRuns((size_t)result.tiles);
+    std::vector<size_t> tileBytes((size_t)result.tiles,0);
+
+    // ----- Tiles (parallel, one engine per thread) ----- //
+    #ifdef USE_OMP
+    #pragma omp parallel
+    #endif
+    {
+        StarDetectionEngine engine;
+        #ifdef USE_OMP
+        #pragma omp for schedule(dynamic,1)
+        #endif
+        for (int t = 0; t < result.tiles; t++) {
+            const int coreX0 = (t % columns) * size, coreY0 = (t / columns) * size;
+            const int coreX1 = std::min(width,coreX0 + size), coreY1 = std::min(height,coreY0 + size);
+            const int x0 = std::max(0,coreX0 - margin), y0 = std::max(0,coreY0 - margin);
+            const int x1 = std::min(width,coreX1 + margin), y1 = std::min(height,coreY1 + margin);
+            const int tileWidth = x1 - x0, tileHeight = y1 - y0;
+
+            std::vector<detection::Disc> tileDiscs;
+            for (const detection::Disc& disc : discs) {
+                if (disc.centerX + disc.radius < x0 || disc.centerX - disc.radius >= x1) continue;
+                if (disc.centerY + disc.radius < y0 || disc.centerY - disc.radius >= y1) continue;
+                tileDiscs.push_back({disc.centerX - x0,disc.centerY - y0,disc.radius});
+            }
+            if (!discs.empty() && tileDiscs.empty()) continue;
+            engine.setDiscs(tileDiscs);
+            engine.setImage(pixels + (size_t)y0 * strideBytes + (size_t)x0 * channels,tileWidth,tileHeight,channels,strideBytes,bgr);
+            engine.run(tileParams);
+            tileBytes[t] = (size_t)tileWidth * tileHeight * 3 + (size_t)((tileWidth + 63) / 64) * 8 * tileHeight * 2;
+
+            const uint8_t* gray = engine.gray();
+            std::vector<SummedRun>& out = tileRuns[t];
+            for (const detection::Run& run : engine.candidateRuns()) {
+                const int y = run.y + y0;
+                if (y < coreY0 || y >= coreY1) continue;
+                const int a = std::max(run.x0 + x0,coreX0), b = std::min(run.x1 + x0,coreX1);
+                if (a >= b) continue;
+                const uint8_t* g = gray + (size_t)run.y * tileWidth - x0;
+                uint64_t sum = 0;
+                for (int x = a; x < b; x++) sum += g[x];
+                out.push_back({y,a,b,sum});
+            }
+        }
+    }
+    result.tileBytes = *std::max_element(tileBytes.begin(),tileBytes.end());
+
+    // ----- Frame-wide runs: row order, joined across vertical seams ----- //
+    std::vector<SummedRun> runs;
+    for (int tileRow = 0; tileRow < rows; tileRow++) {
+        const int coreY0 = tileRow * size, coreY1 = std::min(height,coreY0 + size);
+        std::vector<size_t> cursor(columns,0);
+        for (int y = coreY0; y < coreY1; y++) {
+            const size_t rowBegin = runs.size();
+            for (int column = 0; column < columns; column++) {
+                const std::vector<SummedRun>& source = tileRuns[(size_t)tileRow * columns + column];
+                size_t& i = cursor[column];
+                for (; i < source.size() && source[i].y == y; i++) {
+                    if (runs.size() > rowBegin && runs.back().x1 == source[i].x0) {
+                        runs.back().x1 = source[i].x1;
+                        runs.back().sum += source[i].sum;
+                    } else {
+                        runs.push_back(source[i]);
+                    }
+                }
+            }
+        }
+        for (int column = 0; column < columns; column++) {
+            std::vector<SummedRun>().swap(tileRuns[(size_t)tileRow * columns + column]);
+        }
+    }
+
+    result.stars = detection::starsFromComponents(stitchRuns(runs,height),params.minArea,params.maxArea);
+    result.selection = detection::selectBySeparation(result.stars,params.minSeparation,params.maxStars);
+    return result;
+}
+
+} // namespace tiled
+
+#endif // LIVE_SKYBOXES_TILED_DETECTION_H
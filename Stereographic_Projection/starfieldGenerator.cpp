@@ -0,0 +1,644 @@
+//Synthetic Equirectangular Starfield
+//Generator
+//Chris D. | Version 0 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Functional launch
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Renders deterministic 2:1 equirect star panoramas, a stand-in for
+//  SpaceEngine when benchmarking or validating the projection and
+//  detection stages. Column x is longitude (RA) -180..180 degrees and
+//  row y is latitude (Dec) 90..-90, as stereographicProjectionEngine
+//  samples them; pixel (i,j) is centered on (i,j).
+//
+//  Stars come from --seed (uniform on the sphere, magnitudes from a
+//  10^(0.35 m) count law, colors from B-V) or from a star table
+//  (starTable.h: .tsv or .stc, with an optional mag column).
+//
+//  Each star is a Gaussian PSF of --psf pixels evaluated in chord
+//  distance on the sphere, so footprints stretch by 1/cos(lat)
+//  toward the poles and wrap across the seam and over the poles.
+//  Optional extras: a Milky Way band (fBm value noise around the
+//  galactic plane plus a bulge, evaluated on an 8 px grid and
+//  interpolated), planet discs with limb darkening, sky level and
+//  per-pixel noise hashed from (x,y,seed).
+//
+//  The frame is rendered in bands of rows in parallel; stars are
+//  binned to the bands their footprint touches. A .ppm output is
+//  streamed band group by band group, so gigapixel panoramas never
+//  need the whole image in memory (stb_image reads .ppm, so the
+//  projection and detection engines take it directly). .png/.jpg/
+//  .bmp/.tga are written through stb_image_write from a full buffer.
+//
+//  --truth writes the rendered stars as a starTable.h catalog (id,
+//  name, xpix, ypix, ra_deg, dec_deg, mag) for checking detection and
+//  plate solving against ground truth.
+
+// ============================================================== //
+// |                     COMPILE BASH SCRIPT                    | //
+// ============================================================== //
+// g++ starfieldGenerator.cpp -o starfieldGenerator -std=c++17 -O3 -Wall
+// (multi-threaded) add: -fopenmp -DUSE_OMP
+
+// ============================================================== //
+// |                      INCLUDE / DEFINE                      | //
+// ============================================================== //
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#include "stb_image_write.h"
+#include "../Star_Detection_and_Data_Generation/starTable.h"
+
+#ifdef USE_OMP
+#include <omp.h>
+#endif
+
+static const std::string kScriptName = "CHRIS'S KIT";
+
+// ============================================================== //
+// |                          OPTIONS                           | //
+// ============================================================== //
+struct Planet {
+    double lon = 0.0, lat = 0.0;    // Radians
+    double radius = 0.0;            // Radians
+    float rgb[3] = {0.55f,0.5f,0.45f};
+};
+
+struct Options {
+    std::string out;
+    int width = 4096, height = 0;   // height 0: width / 2
+    uint64_t seed = 1;
+    int stars = 50000;
+    double magLimit = 8.0;
+    double magZero = 2.0;           // Magnitude whose PSF peak is exactly white
+    double psf = 1.2;               // Gaussian sigma in pixels
+    std::string table;
+    double milkyWay = 0.0;          // Band brightness, 0 off
+    double sky = 0.0;               // Linear background level
+    double noise = 0.0;             // Per-pixel noise sigma (linear)
+    std::vector<Planet> planets;
+    std::string truth;
+    int bandRows = 64;
+};
+
+// ============================================================== //
+// |                          RANDOMS                           | //
+// ============================================================== //
+struct SplitMix64 {
+    uint64_t state;
+    explicit SplitMix64(uint64_t seed) : state(seed) {}
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }   // [0,1)
+};
+
+static inline uint64_t hash3(uint64_t a,uint64_t b,uint64_t c) {
+    uint64_t h = a * 0x9E3779B97F4A7C15ULL ^ (b + 0x632BE59BD9B4E019ULL) * 0xC2B2AE3D27D4EB4FULL ^ (c + 0x165667B19E3779F9ULL);
+    h = (h ^ (h >> 31)) * 0xBF58476D1CE4E5B9ULL;
+    return h ^ (h >> 29);
+}
+
+// ============================================================== //
+// |                           STARS                            | //
+// ============================================================== //
+struct Star {
+    double lon, lat, mag;           // Radians, magnitude
+    float rgb[3];
+    std::string name;
+};
+
+//B-V to an approximate blackbody color, brightest channel 1.
+static void colorFromBV(double bv,float rgb[3]) {
+    const double t = 4600.0 * (1.0 / (0.92 * bv + 1.7) + 1.0 / (0.92 * bv + 0.62)) / 100.0;
+    double r, g, b;
+    if (t <= 66.0) {
+        r = 255.0;
+        g = 99.4708025861 * std::log(t) - 161.1195681661;
+        b = (t <= 19.0) ? 0.0 : 138.5177312231 * std::log(t - 10.0) - 305.0447927307;
+    } else {
+        r = 329.698727446 * std::pow(t - 60.0,-0.1332047592);
+        g = 288.1221695283 * std::pow(t - 60.0,-0.0755148492);
+        b = 255.0;
+    }
+    r = std::clamp(r,0.0,255.0); g = std::clamp(g,0.0,255.0); b = std::clamp(b,0.0,255.0);
+    const double peak = std::max({r,g,b,1.0});
+    rgb[0] = (float)(r / peak); rgb[1] = (float)(g / peak); rgb[2] = (float)(b / peak);
+}
+
+static double randomMagnitude(SplitMix64& rng,double magLimit) {
+    const double u = std::max(1e-12,rng.uniform());
+    return std::max(-1.5,magLimit + std::log10(u) / 0.35);
+}
+
+static double randomBV(SplitMix64& rng) {
+    const double u = rng.uniform(), v = rng.uniform();
+    return std::clamp(0.6 + 0.45 * (u + v - 1.0) * 1.7,-0.3,1.9);
+}
+
+//Optional mag column of a star table, in table order.
+static std::vector<double> loadMagnitudes(const std::string& path,size_t rows) {
+    std::vector<double> mags;
+    if (StarColumnsFile::probe(path)) {
+        StarColumnsFile file(path);
+        if (!file.has("mag")) return mags;
+        ColumnSpan<double> column = file.float64("mag");
+        mags.assign(column.begin(),column.end());
+        return mags;
+    }
+    std::ifstream file(path,std::ios::binary);
+    std::string line;
+    if (!std::getline(file,line)) return mags;
+    std::vector<std::string> header = splitTabs(line);
+    int magCol = -1;
+    for (size_t i = 0; i < header.size(); i++) if (header[i] == "mag") magCol = (int)i;
+    if (magCol < 0) return mags;
+    while (std::getline(file,line) && mags.size() < rows) {
+        if (line.empty() || line == "\r") continue;
+        std::vector<std::string> fields = splitTabs(line);
+        mags.push_back(magCol < (int)fields.size() && !fields[magCol].empty() ? std::strtod(fields[magCol].c_str(),nullptr) : 99.0);
+    }
+    return mags;
+}
+
+static std::vector<Star> makeStars(const Options& opt) {
+    SplitMix64 rng(opt.seed);
+    std::vector<Star> stars;
+    if (!opt.table.empty()) {
+        StarTable table = loadStarTable(opt.table);
+        std::vector<double> mags = loadMagnitudes(opt.table,table.size());
+        stars.resize(table.size());
+        for (size_t i = 0; i < table.size(); i++) {
+            Star& star = stars[i];
+            double ra = std::fmod(table.rightAscension[i],360.0);
+            if (ra >= 180.0) ra -= 360.0;
+            if (ra < -180.0) ra += 360.0;
+            star.lon = ra * M_PI / 180.0;
+            star.lat = std::clamp(table.declination[i],-90.0,90.0) * M_PI / 180.0;
+            star.mag = i < mags.size() ? mags[i] : randomMagnitude(rng,opt.magLimit);
+            colorFromBV(randomBV(rng),star.rgb);
+            star.name = table.names[i];
+        }
+        return stars;
+    }
+    stars.resize((size_t)std::max(0,opt.stars));
+    for (size_t i = 0; i < stars.size(); i++) {
+        Star& star = stars[i];
+        star.lat = std::asin(2.0 * rng.uniform() - 1.0);
+        star.lon = 2.0 * M_PI * rng.uniform() - M_PI;
+        star.mag = randomMagnitude(rng,opt.magLimit);
+        colorFromBV(randomBV(rng),star.rgb);
+        star.name = "SYN" + std::to_string(i + 1);
+    }
+    return stars;
+}
+
+// ============================================================== //
+// |                         MILKY WAY                          | //
+// ============================================================== //
+static inline double valueNoise(double x,double y,double z,uint64_t seed) {
+    const double fx = std::floor(x), fy = std::floor(y), fz = std::floor(z);
+    const int64_t ix = (int64_t)fx, iy = (int64_t)fy, iz = (int64_t)fz;
+    double tx = x - fx, ty = y - fy, tz = z - fz;
+    tx = tx * tx * (3.0 - 2.0 * tx); ty = ty * ty * (3.0 - 2.0 * ty); tz = tz * tz * (3.0 - 2.0 * tz);
+    auto corner = [&](int dx,int dy,int dz) {
+        return (hash3((uint64_t)(ix + dx) ^ seed,(uint64_t)(iy + dy),(uint64_t)(iz + dz)) >> 11) * (1.0 / 9007199254740992.0);
+    };
+    const double x00 = corner(0,0,0) + (corner(1,0,0) - corner(0,0,0)) * tx;
+    const double x10 = corner(0,1,0) + (corner(1,1,0) - corner(0,1,0)) * tx;
+    const double x01 = corner(0,0,1) + (corner(1,0,1) - corner(0,0,1)) * tx;
+    const double x11 = corner(0,1,1) + (corner(1,1,1) - corner(0,1,1)) * tx;
+    const double y0 = x00 + (x10 - x00) * ty, y1 = x01 + (x11 - x01) * ty;
+    return y0 + (y1 - y0) * tz;
+}
+
+//Band brightness at a unit vector: Gaussian in galactic latitude
+//modulated by 5 octaves of value noise, plus the bulge.
+static double milkyWay(double x,double y,double z,uint64_t seed) {
+    //North galactic pole (RA 192.86, Dec 27.13) and center (266.40, -28.94):
+    static const double pole[3] = {-0.8676660,-0.1980764,0.4559838};
+    static const double center[3] = {-0.0548755,-0.8734371,-0.4838350};
+    const double sinB = x * pole[0] + y * pole[1] + z * pole[2];
+    const double toCenter = std::acos(std::clamp(x * center[0] + y * center[1] + z * center[2],-1.0,1.0));
+    double fbm = 0.0, amplitude = 0.5, frequency = 4.0;
+    for (int octave = 0; octave < 5; octave++) {
+        fbm += amplitude * valueNoise(x * frequency,y * frequency,z * frequency,seed + (uint64_t)octave);
+        amplitude *= 0.5;
+        frequency *= 2.0;
+    }
+    const double band = std::exp(-(sinB * sinB) / (2.0 * 0.12 * 0.12)) * (0.25 + 0.75 * fbm * fbm * 2.0);
+    const double bulge = 0.8 * std::exp(-(toCenter * toCenter) / (2.0 * 0.3 * 0.3)) * (0.5 + 0.5 * fbm);
+    return band + bulge;
+}
+
+// ============================================================== //
+// |                          RENDERER                          | //
+// ============================================================== //
+//Per-star footprint precomputed for the band loop.
+struct Splat {
+    double lon, lat, cosLat;
+    float amplitude, rgb[3];
+    double chordCut2;               // Squared chord beyond which the PSF is dropped
+    int row0, row1;                 // Inclusive row range
+    int col0, cols;                 // Column window (wraps); cols == width for full rows
+};
+
+struct Frame {
+    int width, height;
+    double stepX, stepY;            // Radians per pixel
+    std::vector<double> rowLat, rowCos;
+    double lonOf(int i) const { return i * stepX - M_PI; }
+};
+
+//Rows and wrapped columns whose chord distance to (lon,lat) can be
+//below chordCut (conservative at the row nearest the pole).
+static void footprint(const Frame& frame,double lon,double lat,double chordCut,int& row0,int& row1,int& col0,int& cols) {
+    const double angle = 2.0 * std::asin(std::min(1.0,chordCut * 0.5));
+    const double y = (M_PI / 2.0 - lat) / frame.stepY;
+    row0 = std::max(0,(int)std::floor(y - angle / frame.stepY) - 1);
+    row1 = std::min(frame.height - 1,(int)std::ceil(y + angle / frame.stepY) + 1);
+    const double latMax = std::min(M_PI / 2.0,std::max(std::fabs(frame.rowLat[row0]),std::fabs(frame.rowLat[row1])));
+    const double cosProduct = std::cos(lat) * std::cos(latMax);
+    const double s = (cosProduct > 1e-12) ? chordCut / (2.0 * std::sqrt(cosProduct)) : 2.0;
+    if (s >= 1.0 || (row0 == 0 && lat + angle >= M_PI / 2.0) || (row1 == frame.height - 1 && lat - angle <= -M_PI / 2.0)) {
+        col0 = 0;
+        cols = frame.width;
+        return;
+    }
+    const double halfLon = 2.0 * std::asin(s);
+    const int half = (int)std::ceil(halfLon / frame.stepX) + 1;
+    cols = std::min(frame.width,2 * half + 1);
+    col0 = (int)std::floor((lon + M_PI) / frame.stepX) - half;
+    if (cols == frame.width) col0 = 0;
+}
+
+//Squared chord = 4 (sin^2(dLat/2) + cos(lat1) cos(lat2) sin^2(dLon/2)).
+static inline double chord2(const Frame& frame,int row,double lon,double lat,double cosLat,double columnLon) {
+    const double a = std::sin((frame.rowLat[row] - lat) * 0.5), b = std::sin((columnLon - lon) * 0.5);
+    return 4.0 * (a * a + frame.rowCos[row] * cosLat * b * b);
+}
+
+//Longitude terms 4 sin^2(dLon/2) of a splat's column window, wrapped.
+static inline void columnTerms(const Frame& frame,int col0,int cols,double lon,std::vector<int>& index,std::vector<double>& term) {
+    index.resize(cols);
+    term.resize(cols);
+    for (int c = 0; c < cols; c++) {
+        const int i = ((col0 + c) % frame.width + frame.width) % frame.width;
+        const double b = std::sin((frame.lonOf(i) - lon) * 0.5);
+        index[c] = i;
+        term[c] = 4.0 * b * b;
+    }
+}
+
+static void renderPanorama(const Options& opt,const std::vector<Star>& stars,
+                           const std::function<void(const uint8_t*,int,int)>& emit,size_t& visible) {
+    Frame frame;
+    frame.width = opt.width;
+    frame.height = opt.height;
+    frame.stepX = 2.0 * M_PI / opt.width;
+    frame.stepY = M_PI / opt.height;
+    frame.rowLat.resize(opt.height);
+    frame.rowCos.resize(opt.height);
+    for (int j = 0; j < opt.height; j++) {
+        frame.rowLat[j] = M_PI / 2.0 - j * frame.stepY;
+        frame.rowCos[j] = std::max(0.0,std::cos(frame.rowLat[j]));
+    }
+
+    // ----- Splats: drop stars below 1/1024 at the peak ----- //
+    const double sigma = std::max(0.3,opt.psf) * frame.stepY;   // Radians
+    std::vector<Splat> splats;
+    splats.reserve(stars.size());
+    for (const Star& star : stars) {
+        const double amplitude = std::pow(10.0,-0.4 * (star.mag - opt.magZero));
+        if (amplitude < 1.0 / 1024.0) continue;
+        Splat s;
+        s.lon = star.lon; s.lat = star.lat; s.cosLat = std::cos(star.lat);
+        s.amplitude = (float)amplitude;
+        std::copy(star.rgb,star.rgb + 3,s.rgb);
+        const double cut = sigma * std::sqrt(2.0 * std::log(amplitude * 1024.0));
+        s.chordCut2 = cut * cut;
+        footprint(frame,s.lon,s.lat,cut,s.row0,s.row1,s.col0,s.cols);
+        splats.push_back(s);
+    }
+    visible = splats.size();
+
+    struct PlanetSplat { Planet planet; double cosLat, chordCut2; int row0, row1, col0, cols; };
+    std::vector<PlanetSplat> planets;
+    for (const Planet& planet : opt.planets) {
+        PlanetSplat p;
+        p.planet = planet;
+        p.cosLat = std::cos(planet.lat);
+        const double reach = planet.radius + 2.0 * frame.stepY;
+        const double chord = 2.0 * std::sin(std::min(M_PI / 2.0,reach * 0.5));
+        p.chordCut2 = chord * chord;
+        footprint(frame,planet.lon,planet.lat,chord,p.row0,p.row1,p.col0,p.cols);
+        planets.push_back(p);
+    }
+
+    // ----- Bin splats by band (CSR, star order kept) ----- //
+    const int bandRows = std::max(8,opt.bandRows);
+    const int bands = (opt.height + bandRows - 1) / bandRows;
+    std::vector<size_t> bandStart((size_t)bands + 1,0);
+    for (const Splat& s : splats) for (int b = s.row0 / bandRows; b <= s.row1 / bandRows; b++) bandStart[b + 1]++;
+    for (int b = 0; b < bands; b++) bandStart[b + 1] += bandStart[b];
+    std::vector<uint32_t> bandSplats(bandStart[bands]);
+    {
+        std::vector<size_t> cursor(bandStart.begin(),bandStart.end() - 1);
+        for (size_t i = 0; i < splats.size(); i++) {
+            for (int b = splats[i].row0 / bandRows; b <= splats[i].row1 / bandRows; b++) bandSplats[cursor[b]++] = (uint32_t)i;
+        }
+    }
+
+    // ----- Linear -> 8-bit gamma ----- //
+    std::vector<uint8_t> toByte(4096);
+    for (int i = 0; i < 4096; i++) toByte[i] = (uint8_t)std::lround(255.0 * std::pow(i / 4095.0,1.0 / 2.2));
+
+    const int width = opt.width, grid = 8;
+    const int gridColumns = width / grid + 2;
+    #ifdef USE_OMP
+    const int threads = omp_get_max_threads();
+    #else
+    const int threads = 1;
+    #endif
+    const int groupBands = std::max(1,2 * threads);
+    std::vector<uint8_t> group((size_t)groupBands * bandRows * width * 3);
+
+    for (int firstBand = 0; firstBand < bands; firstBand += groupBands) {
+        const int lastBand = std::min(bands,firstBand + groupBands);
+        #ifdef USE_OMP
+        #pragma omp parallel
+        #endif
+        {
+            std::vector<float> accum((size_t)bandRows * width * 3);
+            std::vector<float> wayGrid;
+            std::vector<double> columnLon(width), term;
+            std::vector<int> index;
+            for (int i = 0; i < width; i++) columnLon[i] = frame.lonOf(i);
+            #ifdef USE_OMP
+            #pragma omp for schedule(dynamic,1)
+            #endif
+            for (int band = firstBand; band < lastBand; band++) {
+                const int y0 = band * bandRows, rows = std::min(bandRows,opt.height - y0);
+
+                // ----- Background: sky, Milky Way, noise ----- //
+                std::fill(accum.begin(),accum.end(),(float)opt.sky);
+                if (opt.milkyWay > 0.0) {
+                    const int g0 = y0 / grid, g1 = (y0 + rows - 1) / grid + 1;
+                    wayGrid.assign((size_t)(g1 - g0 + 1) * gridColumns,0.0f);
+                    for (int gy = g0; gy <= g1; gy++) {
+                        const double lat = M_PI / 2.0 - std::min(opt.height - 1,gy * grid) * frame.stepY;
+                        for (int gx = 0; gx < gridColumns; gx++) {
+                            const double lon = frame.lonOf((gx * grid) % width);
+                            const double x = std::cos(lat) * std::cos(lon), y = std::cos(lat) * std::sin(lon), z = std::sin(lat);
+                            wayGrid[(size_t)(gy - g0) * gridColumns + gx] = (float)(opt.milkyWay * milkyWay(x,y,z,opt.seed));
+                        }
+                    }
+                    for (int r = 0; r < rows; r++) {
+                        const int j = y0 + r, gy = j / grid - g0;
+                        const float ty = (float)(j % grid) / grid;
+                        const float* top = &wayGrid[(size_t)gy * gridColumns];
+                        const float* bottom = top + gridColumns;
+                        float* row = &accum[(size_t)r * width * 3];
+                        for (int i = 0; i < width; i++) {
+                            const int gx = i / grid;
+                            const float tx = (float)(i % grid) / grid;
+                            const float upper = top[gx] + (top[gx + 1] - top[gx]) * tx;
+                            const float lower = bottom[gx] + (bottom[gx + 1] - bottom[gx]) * tx;
+                            const float v = upper + (lower - upper) * ty;
+                            row[3 * i] += v; row[3 * i + 1] += v * 0.95f; row[3 * i + 2] += v * 0.85f;
+                        }
+                    }
+                }
+                if (opt.noise > 0.0) {
+                    for (int r = 0; r < rows; r++) {
+                        float* row = &accum[(size_t)r * width * 3];
+                        for (int i = 0; i < width; i++) {
+                            const uint64_t h = hash3((uint64_t)i,(uint64_t)(y0 + r),opt.seed);
+                            const float n = (float)(((h & 0xFFFF) + ((h >> 16) & 0xFFFF) + ((h >> 32) & 0xFFFF)) / 65535.0 - 1.5) * 2.0f;
+                            const float v = (float)opt.noise * n;
+                            row[3 * i] += v; row[3 * i + 1] += v; row[3 * i + 2] += v;
+                        }
+                    }
+                }
+
+                // ----- Stars ----- //
+                const double inverse2Sigma2 = 1.0 / (2.0 * sigma * sigma);
+                for (size_t k = bandStart[band]; k < bandStart[band + 1]; k++) {
+                    const Splat& s = splats[bandSplats[k]];
+                    const int r0 = std::max(s.row0,y0), r1 = std::min(s.row1,y0 + rows - 1);
+                    columnTerms(frame,s.col0,s.cols,s.lon,index,term);
+                    for (int j = r0; j <= r1; j++) {
+                        float* row = &accum[(size_t)(j - y0) * width * 3];
+                        const double a = std::sin((frame.rowLat[j] - s.lat) * 0.5);
+                        const double latTerm = 4.0 * a * a, lonScale = frame.rowCos[j] * s.cosLat;
+                        if (latTerm > s.chordCut2) continue;
+                        for (int c = 0; c < s.cols; c++) {
+                            const double d2 = latTerm + lonScale * term[c];
+                            if (d2 > s.chordCut2) continue;
+                            const int i = index[c];
+                            const float v = s.amplitude * (float)std::exp(-d2 * inverse2Sigma2);
+                            row[3 * i] += v * s.rgb[0]; row[3 * i + 1] += v * s.rgb[1]; row[3 * i + 2] += v * s.rgb[2];
+                        }
+                    }
+                }
+
+                // ----- Planets (opaque, over everything) ----- //
+                for (const PlanetSplat& p : planets) {
+                    const int r0 = std::max(p.row0,y0), r1 = std::min(p.row1,y0 + rows - 1);
+                    for (int j = r0; j <= r1; j++) {
+                        float* row = &accum[(size_t)(j - y0) * width * 3];
+                        for (int c = 0; c < p.cols; c++) {
+                            int i = p.col0 + c;
+                            i = (i % width + width) % width;
+                            const double d2 = chord2(frame,j,p.planet.lon,p.planet.lat,p.cosLat,columnLon[i]);
+                            if (d2 > p.chordCut2) continue;
+                            const double d = 2.0 * std::asin(std::min(1.0,std::sqrt(d2) * 0.5));
+                            const float coverage = (float)std::clamp((p.planet.radius - d) / frame.stepY + 0.5,0.0,1.0);
+                            if (coverage <= 0.0f) continue;
+                            const double t = std::min(1.0,d / p.planet.radius);
+                            const float shade = (float)(0.35 + 0.65 * std::sqrt(1.0 - t * t));
+                            for (int ch = 0; ch < 3; ch++) {
+                                row[3 * i + ch] = row[3 * i + ch] * (1.0f - coverage) + p.planet.rgb[ch] * shade * coverage;
+                            }
+                        }
+                    }
+                }
+
+                // ----- To bytes ----- //
+                uint8_t* out = &group[(size_t)(band - firstBand) * bandRows * width * 3];
+                const size_t values = (size_t)rows * width * 3;
+                for (size_t v = 0; v < values; v++) {
+                    const float x = std::clamp(accum[v],0.0f,1.0f);
+                    out[v] = toByte[(int)(x * 4095.0f + 0.5f)];
+                }
+            }
+        }
+        const int y0 = firstBand * bandRows, y1 = std::min(opt.height,lastBand * bandRows);
+        emit(group.data(),y0,y1 - y0);
+    }
+}
+
+// ============================================================== //
+// |                           OUTPUT                           | //
+// ============================================================== //
+static std::string lowerExtension(const std::string& path) {
+    const size_t dot = path.find_last_of('.');
+    std::string ext = (dot == std::string::npos) ? "" : path.substr(dot + 1);
+    for (char& c : ext) c = (char)std::tolower((unsigned char)c);
+    return ext;
+}
+
+static void writeTruth(const std::string& path,const Options& opt,const std::vector<Star>& stars) {
+    std::FILE* file = std::fopen(path.c_str(),"wb");
+    if (!file) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + path);
+    std::fprintf(file,"id\tname\txpix\typix\tra_deg\tdec_deg\tmag\n");
+    const double maxMag = opt.magZero + 2.5 * std::log10(1024.0);
+    size_t id = 0;
+    for (const Star& star : stars) {
+        if (star.mag > maxMag) continue;
+        const double x = (star.lon + M_PI) / (2.0 * M_PI) * opt.width;
+        const double y = (M_PI / 2.0 - star.lat) / M_PI * opt.height;
+        double ra = star.lon * 180.0 / M_PI;
+        if (ra < 0.0) ra += 360.0;
+        std::fprintf(file,"%zu\t%s\t%.3f\t%.3f\t%.8f\t%.8f\t%.3f\n",++id,star.name.c_str(),x,y,ra,star.lat * 180.0 / M_PI,star.mag);
+    }
+    std::fclose(file);
+}
+
+// ============================================================== //
+// |                        CLI PARSING                         | //
+// ============================================================== //
+static Planet parsePlanet(const std::string& text) {
+    std::vector<double> values;
+    size_t start = 0;
+    while (start <= text.size()) {
+        const size_t comma = text.find(',',start);
+        values.push_back(std::stod(text.substr(start,comma == std::string::npos ? std::string::npos : comma - start)));
+        if (comma == std::string::npos) break;
+        start = comma + 1;
+    }
+    if (values.size() != 3 && values.size() != 6) {
+        throw std::runtime_error("[" + kScriptName + "]: --planet expects lon,lat,radiusDeg[,r,g,b]");
+    }
+    Planet planet;
+    planet.lon = values[0] * M_PI / 180.0;
+    planet.lat = values[1] * M_PI / 180.0;
+    planet.radius = values[2] * M_PI / 180.0;
+    if (values.size() == 6) for (int c = 0; c < 3; c++) planet.rgb[c] = (float)values[3 + c];
+    return planet;
+}
+
+static Options parseArguments(int argc,char** argv) {
+    Options opt;
+    if (argc < 2) {
+        std::fprintf(stderr,
+            "Usage: %s --out sky.ppm|.png|.jpg [--width N] [--height N] [--seed N] [--stars N] [--magLimit m]\n"
+            "          [--magZero m] [--psf sigmaPx] [--table stars.tsv|.stc] [--milkyWay level] [--sky level]\n"
+            "          [--noise sigma] [--planet lon,lat,radiusDeg[,r,g,b]]... [--truth truth.tsv] [--bandRows N]\n",
+            argv[0]);
+        std::exit(1);
+    }
+    for (int i = 1; i < argc; i++) {
+        std::string key = argv[i];
+        auto need = [&](bool has) { if (!has) throw std::runtime_error("[" + kScriptName + "]: Missing value for " + key); };
+        if (key == "--out") { need(i + 1 < argc); opt.out = argv[++i]; }
+        else if (key == "--width") { need(i + 1 < argc); opt.width = std::stoi(argv[++i]); }
+        else if (key == "--height") { need(i + 1 < argc); opt.height = std::stoi(argv[++i]); }
+        else if (key == "--seed") { need(i + 1 < argc); opt.seed = std::stoull(argv[++i]); }
+        else if (key == "--stars") { need(i + 1 < argc); opt.stars = std::stoi(argv[++i]); }
+        else if (key == "--magLimit") { need(i + 1 < argc); opt.magLimit = std::stod(argv[++i]); }
+        else if (key == "--magZero") { need(i + 1 < argc); opt.magZero = std::stod(argv[++i]); }
+        else if (key == "--psf") { need(i + 1 < argc); opt.psf = std::stod(argv[++i]); }
+        else if (key == "--table") { need(i + 1 < argc); opt.table = argv[++i]; }
+        else if (key == "--milkyWay") { need(i + 1 < argc); opt.milkyWay = std::stod(argv[++i]); }
+        else if (key == "--sky") { need(i + 1 < argc); opt.sky = std::stod(argv[++i]); }
+        else if (key == "--noise") { need(i + 1 < argc); opt.noise = std::stod(argv[++i]); }
+        else if (key == "--planet") { need(i + 1 < argc); opt.planets.push_back(parsePlanet(argv[++i])); }
+        else if (key == "--truth") { need(i + 1 < argc); opt.truth = argv[++i]; }
+        else if (key == "--bandRows") { need(i + 1 < argc); opt.bandRows = std::stoi(argv[++i]); }
+        else { std::fprintf(stderr,"Unknown arg: %s\n",key.c_str()); std::exit(1); }
+    }
+    if (opt.out.empty()) throw std::runtime_error("[" + kScriptName + "]: --out is required");
+    if (opt.height <= 0) opt.height = opt.width / 2;
+    if (opt.width < 16 || opt.height < 8) throw std::runtime_error("[" + kScriptName + "]: Panorama too small");
+    return opt;
+}
+
+// ============================================================== //
+// |                        MAIN PROGRAM                        | //
+// ============================================================== //
+int main(int argc,char** argv) {
+    try {
+        Options opt = parseArguments(argc,argv);
+        const auto t0 = std::chrono::steady_clock::now();
+        std::vector<Star> stars = makeStars(opt);
+
+        const std::string ext = lowerExtension(opt.out);
+        const bool streamed = (ext == "ppm");
+        if (!streamed && ext != "png" && ext != "jpg" && ext != "jpeg" && ext != "bmp" && ext != "tga") {
+            throw std::runtime_error("[" + kScriptName + "]: Unsupported output type: " + opt.out);
+        }
+        std::FILE* stream = nullptr;
+        std::vector<uint8_t> image;
+        if (streamed) {
+            stream = std::fopen(opt.out.c_str(),"wb");
+            if (!stream) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + opt.out);
+            std::fprintf(stream,"P6\n%d %d\n255\n",opt.width,opt.height);
+        } else {
+            image.resize((size_t)opt.width * opt.height * 3);
+        }
+
+        size_t visible = 0;
+        renderPanorama(opt,stars,[&](const uint8_t* rows,int y0,int count) {
+            const size_t bytes = (size_t)count * opt.width * 3;
+            if (stream) {
+                if (std::fwrite(rows,1,bytes,stream) != bytes) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + opt.out);
+            } else {
+                std::memcpy(&image[(size_t)y0 * opt.width * 3],rows,bytes);
+            }
+        },visible);
+        const auto t1 = std::chrono::steady_clock::now();
+
+        int ok = 1;
+        if (stream) ok = std::fclose(stream) == 0;
+        else if (ext == "png") ok = stbi_write_png(opt.out.c_str(),opt.width,opt.height,3,image.data(),opt.width * 3);
+        else if (ext == "jpg" || ext == "jpeg") ok = stbi_write_jpg(opt.out.c_str(),opt.width,opt.height,3,image.data(),95);
+        else if (ext == "bmp") ok = stbi_write_bmp(opt.out.c_str(),opt.width,opt.height,3,image.data());
+        else ok = stbi_write_tga(opt.out.c_str(),opt.width,opt.height,3,image.data());
+        if (!ok) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + opt.out);
+        if (!opt.truth.empty()) writeTruth(opt.truth,opt,stars);
+
+        const double renderMs = std::chrono::duration<double,std::milli>(t1 - t0).count();
+        const double totalMs = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - t0).count();
+        std::printf("[%s] %dx%d, %zu of %zu stars visible | render %.1f ms (%.1f MP/s), total %.1f ms\n",kScriptName.c_str(),
+                    opt.width,opt.height,visible,stars.size(),renderMs,(double)opt.width * opt.height / 1000.0 / std::max(renderMs,1e-3),totalMs);
+        std::printf("Wrote: %s\n",opt.out.c_str());
+        if (!opt.truth.empty()) std::printf("Wrote: %s\n",opt.truth.c_str());
+        return 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr,"Error: %s\n",e.what());
+        return 1;
+    }
+} // END OF MAIN PROGRAM
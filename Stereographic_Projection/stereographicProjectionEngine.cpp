@@ -1,6 +1,6 @@
 //Cylindrical Panoramic to Stereographically Projected Hemispheres
 //Engine
-//Chris D. | Version 1 | Version Date: 11/8/2025
+//Chris D. | Version 6 | Version Date: 10/18/2026
 
 // ============================================================== //
 // |                      VERSION HISTORY                       | //
@@ -10,11 +10,31 @@
 //      defintiion of parseArguments() to reflect UI update and more
 //      concise, descriptive naming.
 //      Modified export file names to match clarity.
+//  Version 2 (10/18/2026): Sequence mode (--sequence) reprojects only
+//      the output tiles whose input tiles changed since the previous
+//      frame, and can record the tile diff as a delta-tile archive
+//      (--archive, read back with --extract). The input stays 8-bit
+//      in memory.
+//  Version 3 (10/18/2026): Polar caps (--polarCap): pixels above a
+//      latitude read a small orthographic resample of each pole
+//      instead of the equirect.
+//  Version 4 (10/18/2026): Native SpaceEngine CubeMap (--cube, six
+//      faces) and FishEye (--fisheye) captures are sampled directly,
+//      without stitching an equirect first.
+//  Version 5 (10/18/2026): --progressFd writes JSON progress records
+//      (stage, fraction, ETA); --cancelFile or SIGINT stops at the
+//      next row or frame and removes the partial outputs (exit code
+//      130).
+//  Version 6 (10/18/2026): --metricsPort / --metricsFile export
+//      frame, tile-reuse and per-stage latency metrics in the
+//      Prometheus text format.
 
 // ============================================================== //
 // |                     COMPILE BASH SCRIPT                    | //
 // ============================================================== //
 // g++ stereographicProjectionEngine.cpp -o stereographicProjectionEngine -std=c++17 -O2 -Wall
+// (multi-threaded) add: -fopenmp -DUSE_OMP
+// (Windows/MinGW) add: -lws2_32
 
 // ============================================================== //
 // |                      INCLUDE / DEFINE                      | //
@@ -28,6 +48,10 @@
 #include <cstring>
 #include <string>
 #include <vector>
+#include <chrono>
+#include <memory>
+#include <fstream>
+#include <filesystem>
 #include <stdexcept>
 #include <algorithm>
 
@@ -37,6 +61,8 @@
 
 #include "stb_image.h"
 #include "stb_image_write.h"
+#include "../engineProgress.h"
+#include "../engineMetrics.h"
 
 #ifdef USE_OMP
 #include <omp.h>
@@ -49,9 +75,42 @@ static const std::string kScriptName = "CHRIS'S KIT";
 // ============================================================== //
 // |                         IMAGE I/O                          | //
 // ============================================================== //
+//Orthographic resample of one polar cap: texel = center + (x,y) * scale,
+//with (x,y) the unit vector in the equirect's frame.
+struct PolarCap {
+    int side = 0;                   // 0: not built
+    float minAbsZ = 2.f;            // Read for |z| >= minAbsZ (2: never)
+    float center = 0.f, scale = 0.f;
+    int rowBegin = 0, rowEnd = 0;   // Equirect rows the cap was sampled from
+    std::vector<uint8_t> rgb;       // side * side * 3, texels past the reach stay 0
+};
+
+//Six faces in the OpenGL cube-map order (+X,-X,+Y,-Y,+Z,-Z), each with
+//a one-texel border copied from its neighbours (fillCubeSeams).
+struct CubeMap {
+    int faceSize = 0;
+    std::vector<uint8_t> faces[6];  // (faceSize + 2)^2 * 3
+};
+
+//Equidistant fisheye: angle from the optical axis grows linearly with
+//the distance from the image centre, halfFov at `radius` pixels.
+struct FishEye {
+    int width = 0, height = 0;      // 0: no capture for this pole
+    float centerX = 0.f, centerY = 0.f, radius = 0.f, halfFov = 0.f;
+    std::vector<uint8_t> data;      // height * width * 3
+};
+
+enum SourceKind { SourceEquirect = 0, SourceCubeMap, SourceFishEye };
+
+//The input sky. width/height/data hold an equirect; CubeMap and FishEye
+//captures fill `cube` or `fisheyes` instead.
 struct Image {
     int width = 0, height = 0, channels = 0; // channels=3 (RGB)
-    std::vector<float> data;                 // height * width * 3, [0..1]
+    std::vector<uint8_t> data;               // height * width * 3, sampled as [0..1]
+    PolarCap caps[2];                        // North, south (buildPolarCaps)
+    int kind = SourceEquirect;
+    CubeMap cube;
+    FishEye fisheyes[2];                     // Looking along +z, -z
 };
 
 static inline float deg2rad(float degrees) { return degrees * float(M_PI) / 180.f; }
@@ -72,18 +131,19 @@ static Image loadEquirect(const char* path) {
             "Proceeding; latitude/longitude will be sampled assuming full [-90°,90°] × [-180°,180°].\n",
             kScriptName.c_str(),width,height,(double)width/height);
     }
-    Image img; img.width = width; img.height = height; img.channels = 3; img.data.resize((size_t)width*height*3);
-    for (size_t i=0; i < img.data.size(); i++) img.data[i] = pix[i] / 255.f;
+    Image img; img.width = width; img.height = height; img.channels = 3;
+    img.data.assign(pix,pix + (size_t)width*height*3);
     stbi_image_free(pix);
     return img;
 }
 
+static inline uint8_t toByte(float value) {
+    return (uint8_t)std::lround(std::clamp(value, 0.f, 1.f) * 255.f);
+}
+
 static void savePNG_RGBA(const char* path,int width,int height,const std::vector<float>& rgba) {
     std::vector<unsigned char> out((size_t)width*height*4);
-    for (size_t i=0; i < out.size(); i++) {
-        float imageBuffer = std::clamp(rgba[i], 0.f, 1.f);
-        out[i] = (unsigned char)std::lround(imageBuffer * 255.f);
-    }
+    for (size_t i=0; i < out.size(); i++) out[i] = toByte(rgba[i]);
     if (!stbi_write_png(path,width,height,4,out.data(),width*4)) {
         throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + std::string(path));
     }
@@ -92,21 +152,36 @@ static void savePNG_RGBA(const char* path,int width,int height,const std::vector
 // ============================================================== //
 // |                      BILINEAR SAMPLING                     | //
 // ============================================================== //
-static inline void sampleEquirect(const Image& img,float longitude,float latitude,float rgb[3]) {
-    float width = (float)img.width, height = (float)img.height;
+//The four texels (and weights) a bilinear sample reads. Sequence mode
+//uses the same cell to build its footprint index.
+struct EquirectCell {
+    int x0, x1, y0, y1;
+    float horizInterp, vertInterp;
+};
+
+static inline EquirectCell equirectCell(int imgWidth,int imgHeight,float longitude,float latitude) {
+    float width = (float)imgWidth, height = (float)imgHeight;
     float x = (longitude + float(M_PI)) / (2.f * float(M_PI)) * width;         // [0,width)
     float y = (float(M_PI)/2.f - latitude) / float(M_PI) * height;            // [0,height)
 
     int x0 = (int)std::floor(x), y0 = (int)std::floor(y);
-    int x1 = (x0 + 1) % img.width;
-    int y1 = std::clamp(y0 + 1, 0, img.height - 1);
-    x0 = (x0 % img.width + img.width) % img.width;
-    y0 = std::clamp(y0, 0, img.height - 1);
+    EquirectCell cell;
+    cell.x1 = (x0 + 1) % imgWidth;
+    cell.y1 = std::clamp(y0 + 1, 0, imgHeight - 1);
+    cell.x0 = (x0 % imgWidth + imgWidth) % imgWidth;
+    cell.y0 = std::clamp(y0, 0, imgHeight - 1);
+    cell.horizInterp = x - (float)cell.x0;
+    cell.vertInterp = y - (float)cell.y0;
+    return cell;
+}
 
-    float horizInterp = x - (float)x0, vertInterp = y - (float)y0;
-    auto px = [&](int yIndex, int xIndex, int channel){ return img.data[((size_t)yIndex * img.width + xIndex)*3 + channel]; };
+static inline void sampleEquirect(const Image& img,float longitude,float latitude,float rgb[3]) {
+    const EquirectCell cell = equirectCell(img.width,img.height,longitude,latitude);
+    float horizInterp = cell.horizInterp, vertInterp = cell.vertInterp;
+    auto px = [&](int yIndex, int xIndex, int channel){ return img.data[((size_t)yIndex * img.width + xIndex)*3 + channel] / 255.f; };
     for (int channel=0; channel < 3; channel++) {
-        float topLeft = px(y0,x0,channel), topRight = px(y0,x1,channel), bottomLeft = px(y1,x0,channel), bottomRight = px(y1,x1,channel);
+        float topLeft = px(cell.y0,cell.x0,channel), topRight = px(cell.y0,cell.x1,channel);
+        float bottomLeft = px(cell.y1,cell.x0,channel), bottomRight = px(cell.y1,cell.x1,channel);
         float top = topLeft * (1 - horizInterp) + topRight * horizInterp;
         float bot = bottomLeft * (1 - horizInterp) + bottomRight * horizInterp;
         rgb[channel] = top * (1 - vertInterp) + bot * vertInterp;
@@ -130,6 +205,259 @@ static inline void xyzToLonLat(float x,float y,float z,float lon0,float& lon,flo
     lon = wrapPi(lon - lon0);
 }
 
+//Unit vector shown at output pixel (xOut,yOut) of a disc; false
+//outside the unit circle.
+static inline bool discXYZ(int size,bool south,bool southMirror,int xOut,int yOut,float& x,float& y,float& z) {
+    float radius = size * 0.5f;
+    int xPix = (south && southMirror) ? size - 1 - xOut : xOut;
+    float normX = ((float)xPix - radius)/radius;      // unit circle boundary (equator)
+    float normY = (radius - (float)yOut)/radius;      // +Y up
+    float radiusSquared = normX * normX + normY * normY;
+    if (radiusSquared > 1.f) return false;
+
+    invStereoToXYZ(normX,normY,x,y,z);
+    if (south) z = -z;
+    return true;
+}
+
+// ============================================================== //
+// |                     POLAR-CAP SAMPLING                     | //
+// ============================================================== //
+//  Near the disc centres every output pixel lands in the first or last
+//  few equirect rows at scattered x, so the sampler strides across
+//  whole rows and pays atan2/asin for samples that are hugely
+//  oversampled in longitude. Above --polarCap degrees the sampler reads
+//  an orthographic resample of the cap instead: neighbouring output
+//  pixels read neighbouring texels, straight from the unit vector.
+//  The cap keeps twice the equirect's row density out to its edge, so
+//  its own bilinear step adds little on top of the equirect's (at 1x,
+//  star cores lose up to 40 levels). Building it costs one equirect
+//  sample per texel, about 6.5 (height/size)^2 per disc pixel it
+//  serves, so it pays off for discs larger than the input's height, or
+//  in sequence mode, where a cap whose rows did not change is reused.
+static const float kPolarCapDensity = 2.f;
+
+static void buildPolarCap(Image& img,float latitudeDegrees,int pole) {
+    img.caps[pole] = PolarCap();
+    if (latitudeDegrees <= 0.f) return;
+    const float colatitude = deg2rad(90.f - latitudeDegrees);
+    const float reach = std::sin(colatitude);
+    const float scale = kPolarCapDensity * img.height / (float(M_PI) * std::cos(colatitude));
+    const int half = (int)std::ceil(reach * scale) + 1;
+    const float built = (reach * scale + 2.f) * (reach * scale + 2.f);
+
+    {
+        PolarCap& cap = img.caps[pole];
+        cap.side = 2 * half + 1;
+        cap.center = (float)half;
+        cap.scale = scale;
+        cap.minAbsZ = std::cos(colatitude);
+        cap.rgb.assign((size_t)cap.side * cap.side * 3,0);
+        int rowMin = img.height, rowMax = -1;
+        #ifdef USE_OMP
+        #pragma omp parallel for schedule(static) reduction(min:rowMin) reduction(max:rowMax)
+        #endif
+        for (int v=0; v < cap.side; v++) {
+            for (int u=0; u < cap.side; u++) {
+                const float du = u - cap.center, dv = v - cap.center;
+                if (du * du + dv * dv > built) continue;
+                const float x = du / scale, y = dv / scale;
+                float z = std::sqrt(std::max(0.f,1.f - x * x - y * y));
+                if (pole == 1) z = -z;
+                float lon, lat;
+                xyzToLonLat(x,y,z,0.f,lon,lat);
+                const EquirectCell cell = equirectCell(img.width,img.height,lon,lat);
+                rowMin = std::min(rowMin,cell.y0);
+                rowMax = std::max(rowMax,cell.y1);
+                float rgb[3];
+                sampleEquirect(img,lon,lat,rgb);
+                uint8_t* texel = &cap.rgb[((size_t)v * cap.side + u) * 3];
+                for (int channel=0; channel < 3; channel++) texel[channel] = toByte(rgb[channel]);
+            }
+        }
+        cap.rowBegin = rowMin;
+        cap.rowEnd = rowMax + 1;
+    }
+}
+
+static void buildPolarCaps(Image& img,float latitudeDegrees) {
+    buildPolarCap(img,latitudeDegrees,0);
+    buildPolarCap(img,latitudeDegrees,1);
+}
+
+//(x,y) already rotated into the equirect's frame; |(x,y)| stays within
+//the cap's reach, so the 2x2 footprint is always inside the tile.
+static inline void samplePolarCap(const PolarCap& cap,float x,float y,float rgb[3]) {
+    const float u = cap.center + x * cap.scale, v = cap.center + y * cap.scale;
+    const int u0 = (int)u, v0 = (int)v;
+    const float horizInterp = u - (float)u0, vertInterp = v - (float)v0;
+    const uint8_t* top = &cap.rgb[((size_t)v0 * cap.side + u0) * 3];
+    const uint8_t* bottom = top + (size_t)cap.side * 3;
+    for (int channel=0; channel < 3; channel++) {
+        float upper = top[channel] / 255.f * (1 - horizInterp) + top[3 + channel] / 255.f * horizInterp;
+        float lower = bottom[channel] / 255.f * (1 - horizInterp) + bottom[3 + channel] / 255.f * horizInterp;
+        rgb[channel] = upper * (1 - vertInterp) + lower * vertInterp;
+    }
+}
+
+// ============================================================== //
+// |                  CUBEMAP AND FISHEYE INPUTS                | //
+// ============================================================== //
+//  Directions here are in the equirect's frame (lon = atan2(y,x),
+//  lat = asin(z)). The cube frame is +Y north, -Z at lon 0 and +X at
+//  lon 90, so faces line up with an equirect of the same sky; --lon0
+//  rotates either source the same way.
+static const char* const kCubeFaceNames[6] = { "pos_x","neg_x","pos_y","neg_y","pos_z","neg_z" };
+
+static stbi_uc* loadRGB8(const std::string& path,int& width,int& height) {
+    int imageContainer;
+    stbi_uc* pix = stbi_load(path.c_str(),&width,&height,&imageContainer,3);
+    if (!pix) throw std::runtime_error("[" + kScriptName + "]: Failed to load: " + path);
+    return pix;
+}
+
+//Bilinear over an RGB8 grid with texel centres on integers; coordinates
+//are clamped to the grid.
+static inline void bilinearRGB8(const uint8_t* data,int width,int height,float x,float y,float rgb[3]) {
+    x = std::clamp(x,0.f,(float)(width - 1));
+    y = std::clamp(y,0.f,(float)(height - 1));
+    const int x0 = std::min((int)x,std::max(0,width - 2)), y0 = std::min((int)y,std::max(0,height - 2));
+    const int x1 = std::min(x0 + 1,width - 1), y1 = std::min(y0 + 1,height - 1);
+    const float horizInterp = x - (float)x0, vertInterp = y - (float)y0;
+    const uint8_t* a = &data[((size_t)y0 * width + x0) * 3];
+    const uint8_t* b = &data[((size_t)y0 * width + x1) * 3];
+    const uint8_t* c = &data[((size_t)y1 * width + x0) * 3];
+    const uint8_t* d = &data[((size_t)y1 * width + x1) * 3];
+    for (int channel=0; channel < 3; channel++) {
+        float top = a[channel] / 255.f * (1 - horizInterp) + b[channel] / 255.f * horizInterp;
+        float bot = c[channel] / 255.f * (1 - horizInterp) + d[channel] / 255.f * horizInterp;
+        rgb[channel] = top * (1 - vertInterp) + bot * vertInterp;
+    }
+}
+
+//Face and face coordinates (s,t in [-1,1], t down the image) of a cube-
+//frame direction; the standard cube-map major-axis selection.
+static inline int cubeFace(float x,float y,float z,float& s,float& t) {
+    const float ax = std::fabs(x), ay = std::fabs(y), az = std::fabs(z);
+    int face;
+    float major, sc, tc;
+    if (ax >= ay && ax >= az) { face = x > 0 ? 0 : 1; major = ax; sc = x > 0 ? -z : z; tc = -y; }
+    else if (ay >= az) { face = y > 0 ? 2 : 3; major = ay; sc = x; tc = y > 0 ? z : -z; }
+    else { face = z > 0 ? 4 : 5; major = az; sc = z > 0 ? x : -x; tc = -y; }
+    s = sc / major;
+    t = tc / major;
+    return face;
+}
+
+//Inverse of cubeFace (unnormalised direction).
+static inline void cubeDirection(int face,float s,float t,float& x,float& y,float& z) {
+    switch (face) {
+        case 0:  x = 1.f;  y = -t;   z = -s;   break;
+        case 1:  x = -1.f; y = -t;   z = s;    break;
+        case 2:  x = s;    y = 1.f;  z = t;    break;
+        case 3:  x = s;    y = -1.f; z = -t;   break;
+        case 4:  x = s;    y = -t;   z = 1.f;  break;
+        default: x = -s;   y = -t;   z = -1.f; break;
+    }
+}
+
+//Seam filter: each face's border texel takes the nearest texel of the
+//face its direction actually falls on, so bilinear taps at an edge
+//blend across the seam instead of clamping (corner texels take one of
+//the three faces meeting there).
+static void fillCubeSeams(CubeMap& cube) {
+    const int n = cube.faceSize, padded = n + 2;
+    for (int face=0; face < 6; face++) {
+        for (int j=0; j < padded; j++) {
+            for (int i=0; i < padded; i++) {
+                if (i > 0 && i <= n && j > 0 && j <= n) continue;
+                float x, y, z, s, t;
+                cubeDirection(face,((i - 1) + 0.5f) / n * 2.f - 1.f,((j - 1) + 0.5f) / n * 2.f - 1.f,x,y,z);
+                const int source = cubeFace(x,y,z,s,t);
+                const int si = std::clamp((int)((s + 1.f) * 0.5f * n),0,n - 1) + 1;
+                const int sj = std::clamp((int)((t + 1.f) * 0.5f * n),0,n - 1) + 1;
+                std::memcpy(&cube.faces[face][((size_t)j * padded + i) * 3],&cube.faces[source][((size_t)sj * padded + si) * 3],3);
+            }
+        }
+    }
+}
+
+//`pattern` names the six files with a {face} placeholder, filled from
+//`faceNames` in +X,-X,+Y,-Y,+Z,-Z order.
+static Image loadCubeMap(const std::string& pattern,const std::vector<std::string>& faceNames) {
+    const size_t at = pattern.find("{face}");
+    if (at == std::string::npos) throw std::runtime_error("[" + kScriptName + "]: --cube pattern needs a {face} placeholder");
+    if (faceNames.size() != 6) throw std::runtime_error("[" + kScriptName + "]: --cubeFaces needs six names");
+    Image img;
+    img.kind = SourceCubeMap;
+    img.channels = 3;
+    for (int face=0; face < 6; face++) {
+        const std::string path = pattern.substr(0,at) + faceNames[face] + pattern.substr(at + 6);
+        int width, height;
+        stbi_uc* pix = loadRGB8(path,width,height);
+        if (width != height || (face > 0 && width != img.cube.faceSize)) {
+            stbi_image_free(pix);
+            throw std::runtime_error("[" + kScriptName + "]: Cube faces must be square and the same size: " + path);
+        }
+        img.cube.faceSize = width;
+        const int padded = width + 2;
+        img.cube.faces[face].assign((size_t)padded * padded * 3,0);
+        for (int y=0; y < height; y++) {
+            std::memcpy(&img.cube.faces[face][((size_t)(y + 1) * padded + 1) * 3],pix + (size_t)y * width * 3,(size_t)width * 3);
+        }
+        stbi_image_free(pix);
+    }
+    fillCubeSeams(img.cube);
+    return img;
+}
+
+//`paths` is "north.png" or "north.png,south.png"; a pole without a
+//capture leaves its disc transparent past the other's field of view.
+static Image loadFishEyes(const std::string& paths,float fovDegrees) {
+    if (fovDegrees <= 0.f || fovDegrees > 360.f) throw std::runtime_error("[" + kScriptName + "]: --fisheyeFov must be in (0,360]");
+    Image img;
+    img.kind = SourceFishEye;
+    img.channels = 3;
+    const size_t comma = paths.find(',');
+    const std::string files[2] = { paths.substr(0,comma), comma == std::string::npos ? std::string() : paths.substr(comma + 1) };
+    for (int pole=0; pole < 2; pole++) {
+        if (files[pole].empty()) continue;
+        FishEye& eye = img.fisheyes[pole];
+        stbi_uc* pix = loadRGB8(files[pole],eye.width,eye.height);
+        eye.data.assign(pix,pix + (size_t)eye.width * eye.height * 3);
+        stbi_image_free(pix);
+        eye.centerX = eye.width * 0.5f - 0.5f;
+        eye.centerY = eye.height * 0.5f - 0.5f;
+        eye.radius = std::min(eye.width,eye.height) * 0.5f;
+        eye.halfFov = deg2rad(fovDegrees) * 0.5f;
+    }
+    return img;
+}
+
+//(x,y,z) in the equirect's frame, unit length. False where no capture
+//covers the direction.
+static inline bool sampleDirection(const Image& input,float x,float y,float z,float rgb[3]) {
+    if (input.kind == SourceCubeMap) {
+        float s, t;
+        const int face = cubeFace(y,z,-x,s,t);
+        const int n = input.cube.faceSize;
+        bilinearRGB8(input.cube.faces[face].data(),n + 2,n + 2,(s + 1.f) * 0.5f * n + 0.5f,(t + 1.f) * 0.5f * n + 0.5f,rgb);
+        return true;
+    }
+    for (int pole=0; pole < 2; pole++) {
+        const FishEye& eye = input.fisheyes[pole];
+        if (eye.width == 0) continue;
+        const float angle = std::acos(std::clamp(pole == 0 ? z : -z,-1.f,1.f));
+        if (angle > eye.halfFov) continue;
+        const float planar = std::sqrt(x * x + y * y);
+        const float r = angle / eye.halfFov * eye.radius;
+        const float dx = planar > 1e-7f ? x / planar * r : 0.f, dy = planar > 1e-7f ? y / planar * r : 0.f;
+        bilinearRGB8(eye.data.data(),eye.width,eye.height,eye.centerX + dx,eye.centerY - dy,rgb);
+        return true;
+    }
+    return false;
+}
+
 // ============================================================== //
 // |                          OPTIONS                           | //
 // ============================================================== //
@@ -140,39 +468,58 @@ struct Options {
     float southLon0OffsetDegrees = 0.f;
     bool  southMirror = true;
     bool  bothHemispheres = true;
+    float polarCapDegrees = 0.f;    // 0: always sample the equirect
+
+    // ----- Native SpaceEngine captures ----- //
+    std::string cube;               // Face pattern with {face}
+    std::vector<std::string> cubeFaces{ kCubeFaceNames,kCubeFaceNames + 6 };
+    std::string fisheye;            // north[,south]
+    float fisheyeFov = 180.f;
+
+    // ----- Sequence mode ----- //
+    std::string sequence;           // Frame list, one input per line
+    int   tile = 64;                // Input and output tile edge (px)
+    std::string archive;            // Delta-tile archive to write
+    bool  writeFrames = true;
+
+    // ----- Archive extraction ----- //
+    std::string extract;
+    int   frame = 0;
+
+    // ----- Progress / cancellation ----- //
+    int   progressFd = -1;          // -1: no progress records
+    std::string cancelFile;
+
+    // ----- Metrics ----- //
+    int   metricsPort = 0;          // 0: no listener
+    std::string metricsFile;
 };
 
 // ============================================================== //
 // |                HEMISPHERICAL DISC GENERATOR                | //
 // ============================================================== //
-static void makeDisc(const Image& input,int size,float lon0degrees,bool south,bool southMirror,
-                    std::vector<float>& rgbaOut) {
-    rgbaOut.assign((size_t)size * size * 4,0.f);
-    float radius = size * 0.5f;
-    float lon0 = deg2rad(lon0degrees);
-
-    #ifdef USE_OMP
-    #pragma omp parallel for schedule(static)
-    #endif
-    for (int yPix=0; yPix < size; yPix++) {
-        for (int xPix=0; xPix < size; xPix++) {
-            float normX = ((float)xPix - radius)/radius;      // unit circle boundary (equator)
-            float normY = (radius - (float)yPix)/radius;      // +Y up
-            float radiusSquared = normX * normX + normY * normY;
-            if (radiusSquared > 1.f) continue;
-
+//Reprojects output rows [yBegin,yEnd) x columns [xBegin,xEnd); pixels
+//outside the disc are left untouched.
+static void renderDiscRect(const Image& input,int size,float lon0,bool south,bool southMirror,std::vector<float>& rgbaOut,
+                           int xBegin,int xEnd,int yBegin,int yEnd) {
+    const PolarCap& cap = input.caps[south ? 1 : 0];
+    const float cosLon0 = std::cos(lon0), sinLon0 = std::sin(lon0);
+    for (int yOut=yBegin; yOut < yEnd; yOut++) {
+        for (int xOut=xBegin; xOut < xEnd; xOut++) {
             float sphericalX, sphericalY, sphericalZ;
-            invStereoToXYZ(normX,normY,sphericalX,sphericalY,sphericalZ);
-            if (south) sphericalZ = -sphericalZ;
-
-            float lon, lat;
-            xyzToLonLat(sphericalX,sphericalY,sphericalZ,lon0,lon,lat);
+            if (!discXYZ(size,south,southMirror,xOut,yOut,sphericalX,sphericalY,sphericalZ)) continue;
 
             float rgb[3];
-            sampleEquirect(input,lon,lat,rgb);
-
-            int xOut = xPix, yOut = yPix;
-            if (south && southMirror) xOut = size - 1 - xPix;
+            if (input.kind != SourceEquirect) {
+                if (!sampleDirection(input,sphericalX * cosLon0 + sphericalY * sinLon0,sphericalY * cosLon0 - sphericalX * sinLon0,
+                                     sphericalZ,rgb)) continue;
+            } else if (std::fabs(sphericalZ) >= cap.minAbsZ) {
+                samplePolarCap(cap,sphericalX * cosLon0 + sphericalY * sinLon0,sphericalY * cosLon0 - sphericalX * sinLon0,rgb);
+            } else {
+                float lon, lat;
+                xyzToLonLat(sphericalX,sphericalY,sphericalZ,lon0,lon,lat);
+                sampleEquirect(input,lon,lat,rgb);
+            }
 
             size_t idx = ((size_t)yOut * size + xOut) * 4;
             rgbaOut[idx+0] = rgb[0];
@@ -183,6 +530,25 @@ static void makeDisc(const Image& input,int size,float lon0degrees,bool south,bo
     }
 }
 
+static void makeDisc(const Image& input,int size,float lon0degrees,bool south,bool southMirror,
+                    std::vector<float>& rgbaOut) {
+    rgbaOut.assign((size_t)size * size * 4,0.f);
+    float lon0 = deg2rad(lon0degrees);
+    progress::Reporter& reporter = progress::engine();
+    reporter.stage(south ? "south" : "north",size);
+
+    //Rows after a cancellation are skipped; the checkpoint below throws.
+    #ifdef USE_OMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (int yPix=0; yPix < size; yPix++) {
+        if (reporter.cancelled()) continue;
+        renderDiscRect(input,size,lon0,south,southMirror,rgbaOut,0,size,yPix,yPix + 1);
+        reporter.advance();
+    }
+    reporter.checkpoint();
+}
+
 // ============================================================== //
 // |             SIDE-BY-SIDE HEMISPHERE COMPOSITOR             | //
 // ============================================================== //
@@ -211,6 +577,451 @@ static void compositeDblHemispheres(const std::vector<float>& north,const std::v
     savePNG_RGBA(outPath.c_str(),compWidth,compHeight,canvas);
 }
 
+static std::string stemOf(const std::string& path) {
+    std::string stem = path;
+    auto dot = stem.find_last_of('.');
+    if (dot != std::string::npos) stem = stem.substr(0,dot);
+    return stem;
+}
+
+// ============================================================== //
+// |                  DIRTY-TILE SEQUENCE MODE                  | //
+// ============================================================== //
+//  A time-lapse from a fixed, rotation-compensated camera changes only
+//  where planets, moons or atmosphere moved. Each frame's input tiles
+//  are hashed; the inverse footprint index (input tile -> the output
+//  tiles whose bilinear samples read it, built once per geometry)
+//  turns the changed input tiles into the output tiles to reproject.
+//  Every other output tile keeps the previous frame's pixels, which are
+//  exactly what a full reprojection would produce again. Pixels read
+//  from a polar cap depend on every tile in the cap's rows.
+struct FootprintIndex {
+    int inWidth = 0, inHeight = 0;
+    int tile = 0, inTilesX = 0, inTilesY = 0, outTilesX = 0;
+    std::vector<uint32_t> start;    // CSR over input tiles
+    std::vector<uint32_t> outputs;  // hemisphere * outTilesX^2 + tileY * outTilesX + tileX
+};
+
+static FootprintIndex buildFootprintIndex(const Image& input,const Options& opt) {
+    const int inWidth = input.width, inHeight = input.height;
+    FootprintIndex index;
+    index.inWidth = inWidth;
+    index.inHeight = inHeight;
+    index.tile = opt.tile;
+    index.inTilesX = (inWidth + opt.tile - 1) / opt.tile;
+    index.inTilesY = (inHeight + opt.tile - 1) / opt.tile;
+    index.outTilesX = (opt.size + opt.tile - 1) / opt.tile;
+    const int perDisc = index.outTilesX * index.outTilesX;
+    const float lon0[2] = { deg2rad(opt.lon0degrees), deg2rad(opt.lon0degrees + opt.southLon0OffsetDegrees) };
+
+    std::vector<std::vector<uint32_t>> touched((size_t)perDisc * 2);
+    #ifdef USE_OMP
+    #pragma omp parallel for schedule(dynamic)
+    #endif
+    for (int t=0; t < perDisc * 2; t++) {
+        const int hemisphere = t / perDisc;
+        const int tileY = (t % perDisc) / index.outTilesX, tileX = t % index.outTilesX;
+        const PolarCap& cap = input.caps[hemisphere];
+        std::vector<uint32_t>& list = touched[t];
+        bool readsCap = false;
+        for (int y=tileY * opt.tile; y < std::min(opt.size,(tileY + 1) * opt.tile); y++) {
+            for (int x=tileX * opt.tile; x < std::min(opt.size,(tileX + 1) * opt.tile); x++) {
+                float sphericalX, sphericalY, sphericalZ, lon, lat;
+                if (!discXYZ(opt.size,hemisphere == 1,opt.southMirror,x,y,sphericalX,sphericalY,sphericalZ)) continue;
+                if (std::fabs(sphericalZ) >= cap.minAbsZ) { readsCap = true; continue; }
+                xyzToLonLat(sphericalX,sphericalY,sphericalZ,lon0[hemisphere],lon,lat);
+                const EquirectCell cell = equirectCell(inWidth,inHeight,lon,lat);
+                for (int row : {cell.y0,cell.y1}) {
+                    for (int column : {cell.x0,cell.x1}) {
+                        const uint32_t id = (uint32_t)((row / opt.tile) * index.inTilesX + column / opt.tile);
+                        if (list.empty() || list.back() != id) list.push_back(id);
+                    }
+                }
+            }
+        }
+        if (readsCap) {
+            for (int row=cap.rowBegin / opt.tile; row <= (cap.rowEnd - 1) / opt.tile; row++) {
+                for (int column=0; column < index.inTilesX; column++) list.push_back((uint32_t)(row * index.inTilesX + column));
+            }
+        }
+        std::sort(list.begin(),list.end());
+        list.erase(std::unique(list.begin(),list.end()),list.end());
+    }
+
+    index.start.assign((size_t)index.inTilesX * index.inTilesY + 1,0);
+    for (const std::vector<uint32_t>& list : touched) for (uint32_t id : list) index.start[id + 1]++;
+    for (size_t i=1; i < index.start.size(); i++) index.start[i] += index.start[i - 1];
+    index.outputs.resize(index.start.back());
+    std::vector<uint32_t> fill(index.start.begin(),index.start.end() - 1);
+    for (size_t t=0; t < touched.size(); t++) {
+        for (uint32_t id : touched[t]) index.outputs[fill[id]++] = (uint32_t)t;
+    }
+    return index;
+}
+
+//FNV-1a per input tile over 8-byte words of each tile row (then the tail).
+static void hashTiles(const Image& img,int tile,int tilesX,int tilesY,std::vector<uint64_t>& hashes) {
+    hashes.assign((size_t)tilesX * tilesY,1469598103934665603ULL);
+    #ifdef USE_OMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for (int tileY=0; tileY < tilesY; tileY++) {
+        uint64_t* h = &hashes[(size_t)tileY * tilesX];
+        for (int y=tileY * tile; y < std::min(img.height,(tileY + 1) * tile); y++) {
+            const uint8_t* row = &img.data[(size_t)y * img.width * 3];
+            for (int tileX=0; tileX < tilesX; tileX++) {
+                const uint8_t* bytes = row + (size_t)tileX * tile * 3;
+                const size_t count = (size_t)(std::min(img.width,(tileX + 1) * tile) - tileX * tile) * 3;
+                uint64_t hash = h[tileX];
+                size_t i = 0;
+                for (; i + 8 <= count; i += 8) {
+                    uint64_t word;
+                    std::memcpy(&word,bytes + i,8);
+                    hash = (hash ^ word) * 1099511628211ULL;
+                }
+                for (; i < count; i++) hash = (hash ^ bytes[i]) * 1099511628211ULL;
+                h[tileX] = hash;
+            }
+        }
+    }
+}
+
+// ============================================================== //
+// |                     DELTA-TILE ARCHIVE                     | //
+// ============================================================== //
+//  Layout (native little-endian):
+//    header  "SDTA", u32 version, i32 size, i32 tile
+//    frame   "FRME", u32 frame, u32 tiles, u32 pathBytes, path
+//            then per tile: u32 id, u32 zlibBytes, zlib(RGBA8 rows)
+//  Tile ids follow FootprintIndex::outputs. A tile is stored when its
+//  8-bit pixels differ from what the archive already reconstructs (all
+//  zero before frame 0), so tiles outside the discs are never stored
+//  and a static sky costs nothing after the first frame. Only tiles the
+//  dirty-tile pass reprojected are compared.
+static const char kArchiveMagic[4] = {'S','D','T','A'};
+static const char kFrameMagic[4] = {'F','R','M','E'};
+static const uint32_t kArchiveVersion = 1;
+
+struct TileRect { int hemisphere, x0, y0, x1, y1; };
+
+static TileRect tileRect(uint32_t id,int size,int tile) {
+    const int tilesX = (size + tile - 1) / tile;
+    const int perDisc = tilesX * tilesX;
+    TileRect rect;
+    rect.hemisphere = (int)id / perDisc;
+    rect.x0 = ((int)id % tilesX) * tile;
+    rect.y0 = (((int)id % perDisc) / tilesX) * tile;
+    rect.x1 = std::min(size,rect.x0 + tile);
+    rect.y1 = std::min(size,rect.y0 + tile);
+    return rect;
+}
+
+static void writeU32(std::ofstream& out,uint32_t value) { out.write(reinterpret_cast<const char*>(&value),4); }
+static uint32_t readU32(std::ifstream& in) {
+    uint32_t value = 0;
+    if (!in.read(reinterpret_cast<char*>(&value),4)) throw std::runtime_error("[" + kScriptName + "]: Truncated archive");
+    return value;
+}
+
+class DeltaArchiveWriter {
+public:
+    DeltaArchiveWriter(const std::string& path,int size,int tile) : out_(path,std::ios::binary), size_(size), tile_(tile) {
+        if (!out_) throw std::runtime_error("[" + kScriptName + "]: Failed to write: " + path);
+        state_[0].assign((size_t)size * size * 4,0);
+        state_[1].assign((size_t)size * size * 4,0);
+        out_.write(kArchiveMagic,4);
+        writeU32(out_,kArchiveVersion);
+        writeU32(out_,(uint32_t)size);
+        writeU32(out_,(uint32_t)tile);
+    }
+
+    //Returns the number of tiles stored for this frame.
+    int addFrame(uint32_t frame,const std::string& source,const std::vector<float>* discs,const std::vector<uint32_t>& reprojected) {
+        std::vector<std::vector<uint8_t>> packed(reprojected.size());
+        #ifdef USE_OMP
+        #pragma omp parallel for schedule(dynamic)
+        #endif
+        for (int i=0; i < (int)reprojected.size(); i++) {
+            const TileRect rect = tileRect(reprojected[i],size_,tile_);
+            std::vector<uint8_t>& state = state_[rect.hemisphere];
+            const std::vector<float>& disc = discs[rect.hemisphere];
+            const size_t rowBytes = (size_t)(rect.x1 - rect.x0) * 4;
+            std::vector<uint8_t> pixels((size_t)(rect.y1 - rect.y0) * rowBytes);
+            bool changed = false;
+            for (int y=rect.y0; y < rect.y1; y++) {
+                const size_t offset = ((size_t)y * size_ + rect.x0) * 4;
+                uint8_t* dst = &pixels[(size_t)(y - rect.y0) * rowBytes];
+                for (size_t k=0; k < rowBytes; k++) dst[k] = toByte(disc[offset + k]);
+                if (std::memcmp(dst,&state[offset],rowBytes) != 0) {
+                    changed = true;
+                    std::memcpy(&state[offset],dst,rowBytes);
+                }
+            }
+            if (!changed) continue;
+            int zlibBytes = 0;
+            unsigned char* zlib = stbi_zlib_compress(pixels.data(),(int)pixels.size(),&zlibBytes,8);
+            if (!zlib) continue;
+            packed[i].assign(zlib,zlib + zlibBytes);
+            STBIW_FREE(zlib);
+        }
+
+        uint32_t stored = 0;
+        for (const std::vector<uint8_t>& tile : packed) stored += tile.empty() ? 0 : 1;
+        out_.write(kFrameMagic,4);
+        writeU32(out_,frame);
+        writeU32(out_,stored);
+        writeU32(out_,(uint32_t)source.size());
+        out_.write(source.data(),(std::streamsize)source.size());
+        for (size_t i=0; i < packed.size(); i++) {
+            if (packed[i].empty()) continue;
+            writeU32(out_,reprojected[i]);
+            writeU32(out_,(uint32_t)packed[i].size());
+            out_.write(reinterpret_cast<const char*>(packed[i].data()),(std::streamsize)packed[i].size());
+        }
+        out_.flush();
+        if (!out_) throw std::runtime_error("[" + kScriptName + "]: Failed writing archive frame " + std::to_string(frame));
+        return (int)stored;
+    }
+
+    uint64_t bytesWritten() { return (uint64_t)out_.tellp(); }
+
+private:
+    std::ofstream out_;
+    int size_, tile_;
+    std::vector<uint8_t> state_[2];     // What a reader reconstructs so far
+};
+
+//Replays the archive up to `frame` and writes its discs (and
+//composite) as <archive stem>_<frame>_stereo*.png.
+static void extractArchiveFrame(const Options& opt) {
+    std::ifstream in(opt.extract,std::ios::binary);
+    if (!in) throw std::runtime_error("[" + kScriptName + "]: Failed to load: " + opt.extract);
+    char magic[4];
+    if (!in.read(magic,4) || std::memcmp(magic,kArchiveMagic,4) != 0) throw std::runtime_error("[" + kScriptName + "]: Not a delta-tile archive: " + opt.extract);
+    if (readU32(in) != kArchiveVersion) throw std::runtime_error("[" + kScriptName + "]: Unsupported archive version");
+    const int size = (int)readU32(in), tile = (int)readU32(in);
+    if (size <= 0 || tile <= 0) throw std::runtime_error("[" + kScriptName + "]: Corrupt archive header");
+
+    std::vector<float> discs[2];
+    discs[0].assign((size_t)size * size * 4,0.f);
+    discs[1].assign((size_t)size * size * 4,0.f);
+    std::string source;
+    bool found = false;
+    while (!found && in.read(magic,4)) {
+        if (std::memcmp(magic,kFrameMagic,4) != 0) throw std::runtime_error("[" + kScriptName + "]: Corrupt archive frame");
+        const uint32_t frame = readU32(in), tiles = readU32(in), pathBytes = readU32(in);
+        source.assign(pathBytes,'\0');
+        in.read(&source[0],pathBytes);
+        std::vector<char> zlib;
+        for (uint32_t t=0; t < tiles; t++) {
+            const uint32_t id = readU32(in), zlibBytes = readU32(in);
+            zlib.resize(zlibBytes);
+            if (!in.read(zlib.data(),zlibBytes)) throw std::runtime_error("[" + kScriptName + "]: Truncated archive");
+            const TileRect rect = tileRect(id,size,tile);
+            if (rect.hemisphere > 1) throw std::runtime_error("[" + kScriptName + "]: Corrupt archive tile id");
+            int length = 0;
+            char* pixels = stbi_zlib_decode_malloc(zlib.data(),(int)zlibBytes,&length);
+            const size_t rowBytes = (size_t)(rect.x1 - rect.x0) * 4;
+            if (!pixels || (size_t)length != rowBytes * (rect.y1 - rect.y0)) {
+                STBI_FREE(pixels);
+                throw std::runtime_error("[" + kScriptName + "]: Corrupt archive tile");
+            }
+            for (int y=rect.y0; y < rect.y1; y++) {
+                const uint8_t* src = reinterpret_cast<const uint8_t*>(pixels) + (size_t)(y - rect.y0) * rowBytes;
+                float* dst = &discs[rect.hemisphere][((size_t)y * size + rect.x0) * 4];
+                for (size_t k=0; k < rowBytes; k++) dst[k] = src[k] / 255.f;
+            }
+            STBI_FREE(pixels);
+        }
+        found = ((int)frame == opt.frame);
+    }
+    if (!found) throw std::runtime_error("[" + kScriptName + "]: Frame " + std::to_string(opt.frame) + " is not in " + opt.extract);
+
+    char suffix[32];
+    std::snprintf(suffix,sizeof(suffix),"_%04d",opt.frame);
+    const std::string stem = stemOf(opt.extract) + suffix;
+    savePNG_RGBA((stem + "_stereoNorth.png").c_str(),size,size,discs[0]);
+    savePNG_RGBA((stem + "_stereoSouth.png").c_str(),size,size,discs[1]);
+    if (opt.bothHemispheres) compositeDblHemispheres(discs[0],discs[1],size,stem + "_stereoHemispheres.png");
+    std::printf("Frame %d (%s)\n",opt.frame,source.c_str());
+    std::printf("Wrote: %s_stereoNorth.png\n",stem.c_str());
+    std::printf("Wrote: %s_stereoSouth.png\n",stem.c_str());
+    if (opt.bothHemispheres) std::printf("Wrote: %s_stereoHemispheres.png\n",stem.c_str());
+}
+
+// ============================================================== //
+// |                       SEQUENCE DRIVER                      | //
+// ============================================================== //
+//Blank lines and # comments are skipped; relative paths resolve
+//against the list's folder.
+static std::vector<std::string> readFrameList(const std::string& path) {
+    std::ifstream list(path);
+    if (!list) throw std::runtime_error("[" + kScriptName + "]: Failed to load: " + path);
+    const std::filesystem::path folder = std::filesystem::path(path).parent_path();
+    std::vector<std::string> frames;
+    std::string line;
+    while (std::getline(list,line)) {
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) line.pop_back();
+        size_t first = line.find_first_not_of(" \t");
+        if (first == std::string::npos || line[first] == '#') continue;
+        std::filesystem::path frame(line.substr(first));
+        if (frame.is_relative()) frame = folder / frame;
+        frames.push_back(frame.string());
+    }
+    if (frames.empty()) throw std::runtime_error("[" + kScriptName + "]: No frames in " + path);
+    return frames;
+}
+
+static void runSequence(const Options& opt) {
+    using Clock = std::chrono::steady_clock;
+    const std::vector<std::string> frames = readFrameList(opt.sequence);
+    const float lon0[2] = { deg2rad(opt.lon0degrees), deg2rad(opt.lon0degrees + opt.southLon0OffsetDegrees) };
+
+    progress::Reporter& reporter = progress::engine();
+    metrics::Registry& registry = metrics::registry();
+    metrics::Counter& framesDone = registry.counter("projection_frames_total","Sequence frames projected.");
+    metrics::Counter& tilesReprojected = registry.counter("projection_tiles_total","Output tiles per frame by whether they were reprojected or reused.",
+                                                          "result=\"reprojected\"");
+    metrics::Counter& tilesReused = registry.counter("projection_tiles_total","","result=\"reused\"");
+    metrics::Counter& outputsEncoded = registry.counter("projection_outputs_total","Frame outputs by how they were produced.","action=\"encoded\"");
+    metrics::Counter& outputsCopied = registry.counter("projection_outputs_total","","action=\"copied\"");
+    metrics::Counter& outputsKept = registry.counter("projection_outputs_total","","action=\"unchanged\"");
+    metrics::Gauge& framesPerSecond = registry.gauge("projection_frames_per_second","Throughput over the last frame.");
+    auto stageSeconds = [&](const char* stage) -> metrics::Histogram& {
+        return registry.histogram("projection_stage_seconds","Wall time per frame and stage.",std::string("stage=\"") + stage + "\"");
+    };
+    metrics::Histogram* stageHistograms[5] = { &stageSeconds("load"),&stageSeconds("hash"),&stageSeconds("project"),
+                                               &stageSeconds("write"),&stageSeconds("archive") };
+    FootprintIndex index;
+    std::vector<uint64_t> hashes, previousHashes;
+    PolarCap previousCaps[2];
+    std::vector<float> discs[2];
+    discs[0].assign((size_t)opt.size * opt.size * 4,0.f);
+    discs[1].assign((size_t)opt.size * opt.size * 4,0.f);
+    std::vector<std::string> previousOutputs;
+    std::unique_ptr<DeltaArchiveWriter> archive;
+    if (!opt.archive.empty()) archive.reset(new DeltaArchiveWriter(opt.archive,opt.size,opt.tile));
+    size_t totalReprojected = 0, totalTiles = 0;
+    const auto sequenceStart = Clock::now();
+    reporter.stage("frames",(int64_t)frames.size());
+
+    //A cancelled run keeps its finished frames (and the archive, which
+    //only ever holds whole frames) and removes the frame in flight.
+    for (size_t f=0; f < frames.size(); f++) {
+        reporter.checkpoint();
+        const auto t0 = Clock::now();
+        Image input = loadEquirect(frames[f].c_str());
+        const auto tLoaded = Clock::now();
+        if (input.width != index.inWidth || input.height != index.inHeight) {
+            buildPolarCaps(input,opt.polarCapDegrees);
+            index = buildFootprintIndex(input,opt);
+            previousHashes.clear();
+        }
+        hashTiles(input,index.tile,index.inTilesX,index.inTilesY,hashes);
+        const auto tHashed = Clock::now();
+
+        // ----- Changed input tiles -> output tiles to reproject ----- //
+        const int perDisc = index.outTilesX * index.outTilesX;
+        std::vector<uint8_t> dirty((size_t)perDisc * 2,previousHashes.empty() ? 1 : 0);
+        int changedInputs = (int)hashes.size();
+        if (!previousHashes.empty()) {
+            changedInputs = 0;
+            bool capStale[2] = { false,false };
+            for (size_t t=0; t < hashes.size(); t++) {
+                if (hashes[t] == previousHashes[t]) continue;
+                changedInputs++;
+                for (uint32_t k=index.start[t]; k < index.start[t + 1]; k++) dirty[index.outputs[k]] = 1;
+                const int rowBegin = (int)(t / index.inTilesX) * index.tile, rowEnd = rowBegin + index.tile;
+                for (int pole=0; pole < 2; pole++) {
+                    if (previousCaps[pole].rowBegin < rowEnd && rowBegin < previousCaps[pole].rowEnd) capStale[pole] = true;
+                }
+            }
+            //A cap whose rows did not change is reused as is.
+            for (int pole=0; pole < 2; pole++) {
+                if (capStale[pole]) buildPolarCap(input,opt.polarCapDegrees,pole);
+                else input.caps[pole] = std::move(previousCaps[pole]);
+            }
+        }
+        std::vector<uint32_t> reprojected;
+        bool hemisphereDirty[2] = { false,false };
+        for (size_t t=0; t < dirty.size(); t++) {
+            if (!dirty[t]) continue;
+            reprojected.push_back((uint32_t)t);
+            hemisphereDirty[t / perDisc] = true;
+        }
+
+        #ifdef USE_OMP
+        #pragma omp parallel for schedule(dynamic)
+        #endif
+        for (int i=0; i < (int)reprojected.size(); i++) {
+            if (reporter.cancelled()) continue;
+            const TileRect rect = tileRect(reprojected[i],opt.size,opt.tile);
+            renderDiscRect(input,opt.size,lon0[rect.hemisphere],rect.hemisphere == 1,opt.southMirror,discs[rect.hemisphere],
+                           rect.x0,rect.x1,rect.y0,rect.y1);
+        }
+        reporter.checkpoint();
+        const auto t1 = Clock::now();
+
+        // ----- Frames: re-encode a disc only when it changed ----- //
+        if (opt.writeFrames) {
+            const std::string stem = stemOf(frames[f]);
+            std::vector<std::string> outputs = { stem + "_stereoNorth.png", stem + "_stereoSouth.png" };
+            if (opt.bothHemispheres) outputs.push_back(stem + "_stereoHemispheres.png");
+            for (size_t o=0; o < outputs.size(); o++) {
+                reporter.checkpoint();
+                const bool changed = (o < 2) ? hemisphereDirty[o] : (hemisphereDirty[0] || hemisphereDirty[1]);
+                if (!changed && previousOutputs.size() == outputs.size()) {
+                    if (previousOutputs[o] != outputs[o]) {
+                        reporter.track(outputs[o]);
+                        std::filesystem::copy_file(previousOutputs[o],outputs[o],std::filesystem::copy_options::overwrite_existing);
+                        outputsCopied.add();
+                    } else {
+                        outputsKept.add();
+                    }
+                    continue;
+                }
+                outputsEncoded.add();
+                if (o < 2) {
+                    reporter.track(outputs[o]);
+                    savePNG_RGBA(outputs[o].c_str(),opt.size,opt.size,discs[o]);
+                } else {
+                    reporter.track(outputs[o]);
+                    compositeDblHemispheres(discs[0],discs[1],opt.size,outputs[o]);
+                }
+            }
+            previousOutputs = outputs;
+        }
+        const auto tWritten = Clock::now();
+        const int stored = archive ? archive->addFrame((uint32_t)f,frames[f],discs,reprojected) : 0;
+        const auto t2 = Clock::now();
+        reporter.keep();
+        reporter.advance();
+
+        totalReprojected += reprojected.size();
+        totalTiles += dirty.size();
+        const Clock::time_point marks[6] = { t0,tLoaded,tHashed,t1,tWritten,t2 };
+        for (int stage=0; stage < 5; stage++) stageHistograms[stage]->observe(std::chrono::duration<double>(marks[stage + 1] - marks[stage]).count());
+        framesDone.add();
+        tilesReprojected.add(reprojected.size());
+        tilesReused.add(dirty.size() - reprojected.size());
+        framesPerSecond.set(1.0 / std::max(1e-9,std::chrono::duration<double>(t2 - t0).count()));
+        std::printf("[%s] frame %zu: %d/%zu input tiles changed, %zu/%zu output tiles reprojected",
+                    kScriptName.c_str(),f,changedInputs,hashes.size(),reprojected.size(),dirty.size());
+        if (archive) std::printf(", %d archived",stored);
+        std::printf(" | project %.1f ms, write %.1f ms\n",
+                    std::chrono::duration<double,std::milli>(t1 - t0).count(),
+                    std::chrono::duration<double,std::milli>(t2 - t1).count());
+        previousHashes.swap(hashes);
+        previousCaps[0] = std::move(input.caps[0]);
+        previousCaps[1] = std::move(input.caps[1]);
+    }
+
+    std::printf("[%s] %zu frames, %.1f%% of output tiles reprojected, %.1f ms total\n",
+                kScriptName.c_str(),frames.size(),totalTiles ? 100.0 * totalReprojected / totalTiles : 0.0,
+                std::chrono::duration<double,std::milli>(Clock::now() - sequenceStart).count());
+    if (archive) std::printf("Wrote: %s (%llu bytes)\n",opt.archive.c_str(),(unsigned long long)archive->bytesWritten());
+}
+
 // ============================================================== //
 // |                        CLI PARSING                         | //
 // ============================================================== //
@@ -218,12 +1029,21 @@ static Options parseArguments(int argc,char** argv) {
     Options opt;
     if (argc < 2) {
         std::fprintf(stderr,
-            "Usage: %s <input> [--size N] [--lon0 deg] [--southLon0Offset deg] [--southMirror 0|1] [--bothHemispheres 0|1]\n",
-            argv[0]);
+            "Usage: %s <input> [--size N] [--lon0 deg] [--southLon0Offset deg] [--southMirror 0|1] [--bothHemispheres 0|1]\n"
+            "          [--polarCap latitudeDeg] (e.g. 80; default 0 = off)\n"
+            "       %s --cube <frame_{face}.png> [--cubeFaces pos_x,neg_x,pos_y,neg_y,pos_z,neg_z] [same options]\n"
+            "       %s --fisheye <north.png>[,<south.png>] [--fisheyeFov deg] (default 180) [same options]\n"
+            "       %s --sequence <frames.txt> [same options] [--tile N] (default 64)\n"
+            "          [--archive deltas.sdt] [--writeFrames 0|1]\n"
+            "       %s --extract <deltas.sdt> --frame N [--bothHemispheres 0|1]\n"
+            "       any mode: [--progressFd N] (JSON progress lines) [--cancelFile path] (stop once it exists)\n"
+            "                 [--metricsPort N] [--metricsFile metrics.prom] (Prometheus text)\n",
+            argv[0],argv[0],argv[0],argv[0],argv[0]);
         std::exit(1);
     }
-    opt.input = argv[1];
-    for (int i=2; i< argc; i++) {
+    int first = 1;
+    if (std::strncmp(argv[1],"--",2) != 0) { opt.input = argv[1]; first = 2; }
+    for (int i=first; i< argc; i++) {
         std::string key = argv[i];
         auto need = [&](bool has) { if (!has) throw std::runtime_error("[" + kScriptName + "]: Missing value for " + key); };
         if (key == "--size") { need(i + 1 < argc); opt.size = std::stoi(argv[++i]); }
@@ -231,8 +1051,42 @@ static Options parseArguments(int argc,char** argv) {
         else if (key == "--southOffset") { need(i + 1 < argc); opt.southLon0OffsetDegrees = std::stof(argv[++i]); }
         else if (key == "--southMirror") { need(i + 1 < argc); opt.southMirror = (std::stoi(argv[++i]) != 0); }
         else if (key == "--bothHemispheres") { need(i + 1 < argc); opt.bothHemispheres = (std::stoi(argv[++i]) != 0); }
+        else if (key == "--polarCap") { need(i + 1 < argc); opt.polarCapDegrees = std::stof(argv[++i]); }
+        else if (key == "--cube") { need(i + 1 < argc); opt.cube = argv[++i]; }
+        else if (key == "--cubeFaces") {
+            need(i + 1 < argc);
+            opt.cubeFaces.clear();
+            std::string names = argv[++i];
+            for (size_t begin=0, end; begin <= names.size(); begin = end + 1) {
+                end = names.find(',',begin);
+                if (end == std::string::npos) end = names.size();
+                opt.cubeFaces.push_back(names.substr(begin,end - begin));
+            }
+        }
+        else if (key == "--fisheye") { need(i + 1 < argc); opt.fisheye = argv[++i]; }
+        else if (key == "--fisheyeFov") { need(i + 1 < argc); opt.fisheyeFov = std::stof(argv[++i]); }
+        else if (key == "--sequence") { need(i + 1 < argc); opt.sequence = argv[++i]; }
+        else if (key == "--tile") { need(i + 1 < argc); opt.tile = std::stoi(argv[++i]); }
+        else if (key == "--archive") { need(i + 1 < argc); opt.archive = argv[++i]; }
+        else if (key == "--writeFrames") { need(i + 1 < argc); opt.writeFrames = (std::stoi(argv[++i]) != 0); }
+        else if (key == "--extract") { need(i + 1 < argc); opt.extract = argv[++i]; }
+        else if (key == "--frame") { need(i + 1 < argc); opt.frame = std::stoi(argv[++i]); }
+        else if (key == "--progressFd") { need(i + 1 < argc); opt.progressFd = std::stoi(argv[++i]); }
+        else if (key == "--cancelFile") { need(i + 1 < argc); opt.cancelFile = argv[++i]; }
+        else if (key == "--metricsPort") { need(i + 1 < argc); opt.metricsPort = std::stoi(argv[++i]); }
+        else if (key == "--metricsFile") { need(i + 1 < argc); opt.metricsFile = argv[++i]; }
         else { std::fprintf(stderr,"Unknown arg: %s\n",key.c_str()); std::exit(1); }
     }
+    const int modes = (opt.input.empty() ? 0 : 1) + (opt.sequence.empty() ? 0 : 1) + (opt.extract.empty() ? 0 : 1)
+                    + (opt.cube.empty() ? 0 : 1) + (opt.fisheye.empty() ? 0 : 1);
+    if (modes != 1) throw std::runtime_error("[" + kScriptName + "]: Give exactly one of <input>, --sequence, --extract, --cube or --fisheye");
+    if ((!opt.cube.empty() || !opt.fisheye.empty()) && opt.polarCapDegrees > 0.f) {
+        throw std::runtime_error("[" + kScriptName + "]: --polarCap applies to equirect inputs only");
+    }
+    if (opt.size <= 0) throw std::runtime_error("[" + kScriptName + "]: --size must be positive");
+    if (opt.polarCapDegrees < 0.f || opt.polarCapDegrees >= 90.f) throw std::runtime_error("[" + kScriptName + "]: --polarCap must be in [0,90)");
+    if (opt.tile < 8) throw std::runtime_error("[" + kScriptName + "]: --tile must be at least 8");
+    if (!opt.archive.empty() && opt.sequence.empty()) throw std::runtime_error("[" + kScriptName + "]: --archive needs --sequence");
     return opt;
 }
 
@@ -242,33 +1096,76 @@ static Options parseArguments(int argc,char** argv) {
 int main(int argc,char** argv) {
     try {
         Options opt = parseArguments(argc,argv);
-        Image inputImage = loadEquirect(opt.input.c_str());
+        progress::engine().open(opt.progressFd,opt.cancelFile);
+        metrics::Exporter exporter;     // Final dump when main returns
+        exporter.start(opt.metricsPort,opt.metricsFile);
+        if (!opt.extract.empty()) { extractArchiveFrame(opt); progress::engine().event("done"); return 0; }
+        if (!opt.sequence.empty()) { runSequence(opt); progress::engine().event("done"); return 0; }
+        Image inputImage;
+        std::string stem;
+        if (!opt.cube.empty()) {
+            inputImage = loadCubeMap(opt.cube,opt.cubeFaces);
+            std::string named = opt.cube;
+            named.erase(named.find("{face}"),6);
+            stem = stemOf(named);
+            while (!stem.empty() && (stem.back() == '_' || stem.back() == '-' || stem.back() == '.')) stem.pop_back();
+        } else if (!opt.fisheye.empty()) {
+            inputImage = loadFishEyes(opt.fisheye,opt.fisheyeFov);
+            stem = stemOf(opt.fisheye.substr(0,opt.fisheye.find(',')));
+        } else {
+            inputImage = loadEquirect(opt.input.c_str());
+            buildPolarCaps(inputImage,opt.polarCapDegrees);
+            stem = stemOf(opt.input);
+        }
 
         std::vector<float> northRGBA, southRGBA;
-        makeDisc(inputImage,opt.size,opt.lon0degrees,/*south=*/false,opt.southMirror,northRGBA);
-        makeDisc(inputImage,opt.size,opt.lon0degrees + opt.southLon0OffsetDegrees,
-                /*south=*/true,opt.southMirror,southRGBA);
+        {
+            metrics::ScopedTimer timer(metrics::registry().histogram("projection_stage_seconds","Wall time per frame and stage.","stage=\"north\""));
+            makeDisc(inputImage,opt.size,opt.lon0degrees,/*south=*/false,opt.southMirror,northRGBA);
+        }
+        {
+            metrics::ScopedTimer timer(metrics::registry().histogram("projection_stage_seconds","Wall time per frame and stage.","stage=\"south\""));
+            makeDisc(inputImage,opt.size,opt.lon0degrees + opt.southLon0OffsetDegrees,
+                    /*south=*/true,opt.southMirror,southRGBA);
+        }
 
-        std::string stem = opt.input;
-        auto dot = stem.find_last_of('.');
-        if (dot != std::string::npos) stem = stem.substr(0,dot);
 
+        progress::Reporter& reporter = progress::engine();
         std::string northPath = stem + "_stereoNorth.png";
         std::string southPath = stem + "_stereoSouth.png";
+        reporter.stage("write",opt.bothHemispheres ? 3 : 2);
+        reporter.checkpoint();
+        reporter.track(northPath);
         savePNG_RGBA(northPath.c_str(),opt.size,opt.size,northRGBA);
+        reporter.advance();
+        reporter.checkpoint();
+        reporter.track(southPath);
         savePNG_RGBA(southPath.c_str(),opt.size,opt.size,southRGBA);
+        reporter.advance();
 
         if (opt.bothHemispheres) {
             std::string dbl = stem + "_stereoHemispheres.png";
+            reporter.checkpoint();
+            reporter.track(dbl);
             compositeDblHemispheres(northRGBA,southRGBA,opt.size,dbl);
+            reporter.advance();
         }
+        reporter.keep();
+        reporter.event("done");
 
         std::printf("Wrote: %s\n",northPath.c_str());
         std::printf("Wrote: %s\n",southPath.c_str());
         if (opt.bothHemispheres) std::printf("Wrote: %s\n",(stem + "_stereoHemispheres.png").c_str());
         return 0;
+    } catch (const progress::Cancelled&) {
+        progress::engine().discard();
+        progress::engine().event("cancelled");
+        std::fprintf(stderr,"Cancelled\n");
+        return progress::kExitCancelled;
     } catch (const std::exception& e) {
+        progress::engine().discard();
+        progress::engine().event("error",e.what());
         std::fprintf(stderr,"Error: %s\n",e.what());
         return 1;
     }
-} // END OF MAIN PROGRAM
\ No newline at end of file
+} // END OF MAIN PROGRAM
@@ -1,6 +1,6 @@
 #Cylindrical Panoramic to Stereographically Projected Hemispheres
 #User Interface
-#Chris D. | Version 1 | Version Date: 11/8/2025
+#Chris D. | Version 2 | Version Date: 10/18/2026
 
 # ============================================================== #
 #|                       VERSION HISTORY                       | #
@@ -9,6 +9,9 @@
 #   Version 1 (11/8/2025): UI reprogrammed in PyQt5 for better
 #       resolution, more robust widgets, and modularityin full
 #       program.
+#   Version 2 (10/18/2026): Engine runs under QProcess with a
+#       progress bar fed by its progress records and a Cancel
+#       button backed by --cancelFile.
 
 # ============================================================== #
 #|                    SUBPROGRAM DESCRIPTION                   | #
@@ -17,7 +20,7 @@
 # a double-hemisphere stereographic projection of that image,
 # such as seen in continental and celestial maps.
 
-import os, shutil, subprocess, sys
+import json, os, shutil, sys, tempfile
 from PyQt5 import QtCore, QtGui, QtWidgets
 
 # ============================================================== #
@@ -99,11 +102,27 @@ class StereographicProjectionWidget(QtWidgets.QWidget):
         runRow = QtWidgets.QHBoxLayout()
         self.runBtn = QtWidgets.QPushButton("Generate")
         self.runBtn.clicked.connect(self.onRun)
+        self.cancelBtn = QtWidgets.QPushButton("Cancel")
+        self.cancelBtn.clicked.connect(self.onCancel)
+        self.cancelBtn.setEnabled(False)
         self.status = QtWidgets.QLabel("")
         runRow.addWidget(self.runBtn,0)
+        runRow.addWidget(self.cancelBtn,0)
         runRow.addWidget(self.status,1)
         root.addLayout(runRow)
 
+        self.progressBar = QtWidgets.QProgressBar()
+        self.progressBar.setRange(0,1000)
+        self.progressBar.setTextVisible(False)
+        self.progressBar.hide()
+        root.addWidget(self.progressBar)
+
+        # -------------------- ENGINE PROCESS -------------------- #
+        self.proc = None
+        self.cancelPath = ""
+        self.errorLines = []
+        self.stderrTail = ""
+
         # -------------------- UI GEOMETRY -------------------- #
         grid.setColumnStretch(0,1)
         grid.setColumnStretch(1,0)
@@ -148,24 +167,82 @@ class StereographicProjectionWidget(QtWidgets.QWidget):
             "--bothHemispheres", "1" if self.bothHemispheres.isChecked() else "0",
         ]
 
-        try:
-            self.status.setText("Running...")
-            #TODO: Implement QProcess or QThread for intensive processing (future version)
-            print("ENGINE:",exe)
-            print("ARGS:",args)
-            proc = subprocess.run(args,capture_output=True,text=True)
-        except Exception as e:
-            QtWidgets.QMessageBox.critical(self,"RUN FAILED",f"Could not run the executable:\n{e}")
-            self.status.setText("")
+        #Progress records share stderr (fd 2) with error text; Windows
+        #cannot hand the engine any other descriptor.
+        handle,self.cancelPath = tempfile.mkstemp(prefix="stereoCancel_")
+        os.close(handle)
+        os.remove(self.cancelPath)
+        args += ["--progressFd","2","--cancelFile",self.cancelPath]
+
+        print("ENGINE:",exe)
+        print("ARGS:",args)
+        self.errorLines = []
+        self.stderrTail = ""
+        self.proc = QtCore.QProcess(self)
+        self.proc.readyReadStandardError.connect(self.onEngineStderr)
+        self.proc.finished.connect(self.onEngineFinished)
+        self.proc.errorOccurred.connect(self.onEngineError)
+        self.runBtn.setEnabled(False)
+        self.cancelBtn.setEnabled(True)
+        self.progressBar.setValue(0)
+        self.progressBar.show()
+        self.status.setText("Running...")
+        self.proc.start(args[0],args[1:])
+
+    def onCancel(self):
+        if self.proc is None:
             return
-        
-        if proc.returncode != 0:
-            self.status.setText("")
-            stderr = (proc.stderr or "").strip()
+        self.status.setText("Cancelling...")
+        self.cancelBtn.setEnabled(False)
+        with open(self.cancelPath,"w"):
+            pass
+
+    def onEngineStderr(self):
+        text = self.stderrTail + bytes(self.proc.readAllStandardError()).decode("utf-8","replace")
+        lines = text.split("\n")
+        self.stderrTail = lines.pop()
+        for line in lines:
+            line = line.strip()
+            try:
+                record = json.loads(line) if line.startswith("{") else None
+            except ValueError:
+                record = None
+            if record is None:
+                if line:
+                    self.errorLines.append(line)
+            elif "stage" in record:
+                self.progressBar.setValue(int(record["fraction"] * 1000))
+                eta = record["eta"]
+                self.status.setText(f"{record['stage'].capitalize()}: {record['fraction'] * 100:.0f}%"
+                                    + (f" ({eta:.0f} s left)" if eta >= 0 else ""))
+
+    def onEngineError(self,error):
+        if error == QtCore.QProcess.FailedToStart:
+            QtWidgets.QMessageBox.critical(self,"RUN FAILED",f"Could not run the executable:\n{self.proc.errorString()}")
+            self.finishRun("")
+
+    def onEngineFinished(self,exitCode,exitStatus):
+        self.onEngineStderr()
+        stdout = bytes(self.proc.readAllStandardOutput()).decode("utf-8","replace").strip()
+        if exitCode == 130:
+            self.finishRun("Cancelled")
+        elif exitStatus != QtCore.QProcess.NormalExit or exitCode != 0:
+            self.finishRun("")
+            stderr = "\n".join(self.errorLines + [self.stderrTail]).strip()
             QtWidgets.QMessageBox.critical(self,"ERROR",stderr if stderr else "UNKNOWN ERROR")
         else:
-            self.status.setText("Done")
-            QtWidgets.QMessageBox.information(self,"SUCCESS",(proc.stdout or "").strip())
+            self.finishRun("Done")
+            QtWidgets.QMessageBox.information(self,"SUCCESS",stdout)
+
+    def finishRun(self,status):
+        if os.path.exists(self.cancelPath):
+            os.remove(self.cancelPath)
+        self.proc.deleteLater()
+        self.proc = None
+        self.progressBar.hide()
+        self.runBtn.setEnabled(True)
+        self.cancelBtn.setEnabled(False)
+        self.status.setText(status)
 
 # ============================================================== #
 #|                          EXECUTION                          | #
@@ -1,6 +1,6 @@
 #Live Skyboxes
 #Main UI and Control
-#Developed by Chris D. | Version 2 | Version Date 11/15/2025
+#Developed by Chris D. | Version 5 | Version Date 10/18/2026
 
 #============================================================#
 #|                    VERSION HISTORY                       |#
@@ -13,7 +13,13 @@
 #   was added.
 #           (11/15/2025): Debugged, cleaned up, and prepared
 #           for subprogram UI linkage.
-# TODO: Version 3: Tie in sub-programs' interfaces as widgets
+# Version 3 (10/18/2026): Generate Scripts for Entire Catalog runs
+#   seScreenshotEngine's catalog batch mode.
+# Version 4 (10/18/2026): Script and catalog generation run the
+#   engine under QProcess with a cancellable progress dialog.
+# Version 5 (10/18/2026): Leap Rule selector passes --leapRule for
+#   whole-day years and months on fractional calendars.
+# TODO: Version 6: Tie in sub-programs' interfaces as widgets
 #       of this as the main.
 
 #============================================================#
@@ -23,6 +29,8 @@ from PyQt5 import QtCore, QtGui, QtWidgets
 from PyQt5.QtCore import QSettings
 import os
 import sys
+import json
+import tempfile
 import subprocess
 from SpaceEngine_Automation.seObjectParser import readText, writeTXTCopy, parseBlocks, buildCalendarSpec
 
@@ -31,6 +39,7 @@ seLicense = "spaceengine.org/manual/license"
 CAPTURE_TYPES = [
     "CubeMap","FishEye","Cylinder","VR","CrossEye","VePair","HorPair","Anaglyph","Shutter"
     ]
+LEAP_RULES = ["none","even","gregorian"]
 
 #============================================================#
 #|                     FUNCTIONS / SETUP                    |#
@@ -42,6 +51,71 @@ def getScreenshotEnginePath(name="seScreenshotEngine.exe"):
     baseDir = os.path.dirname(os.path.abspath(__file__))
     return os.path.join(baseDir,"SpaceEngine_Automation",name)
 
+def runEngineWithProgress(parent,cmd,label: str):
+    """Runs an engine with a progress dialog; returns (exitCode, stdout, stderr).
+    Progress records arrive on stderr (--progressFd 2) between any error
+    text; Cancel creates the engine's --cancelFile and it exits with 130."""
+    handle,cancelPath = tempfile.mkstemp(prefix="liveSkyboxesCancel_")
+    os.close(handle)
+    os.remove(cancelPath)
+
+    dialog = QtWidgets.QProgressDialog(label,"Cancel",0,1000,parent)
+    dialog.setWindowTitle(scriptName)
+    dialog.setWindowModality(QtCore.Qt.WindowModal)
+    dialog.setAutoClose(False)
+    dialog.setAutoReset(False)
+    dialog.setMinimumDuration(300)
+    dialog.setValue(0)
+
+    proc = QtCore.QProcess(parent)
+    loop = QtCore.QEventLoop()
+    errorLines = []
+    pending = [""]
+
+    def readStderr():
+        lines = (pending[0] + bytes(proc.readAllStandardError()).decode("utf-8","replace")).split("\n")
+        pending[0] = lines.pop()
+        for line in lines:
+            line = line.strip()
+            try:
+                record = json.loads(line) if line.startswith("{") else None
+            except ValueError:
+                record = None
+            if record is None:
+                if line:
+                    errorLines.append(line)
+            elif "stage" in record:
+                dialog.setValue(int(record["fraction"] * 1000))
+                eta = record["eta"]
+                dialog.setLabelText(f"{label}\n{record['stage'].capitalize()}: {record['done']} of {record['total']}"
+                                    + (f" ({eta:.0f} s left)" if eta >= 0 else ""))
+
+    def cancel():
+        dialog.setLabelText("Cancelling...")
+        with open(cancelPath,"w"):
+            pass
+
+    proc.readyReadStandardError.connect(readStderr)
+    proc.finished.connect(loop.quit)
+    proc.errorOccurred.connect(lambda error: loop.quit() if error == QtCore.QProcess.FailedToStart else None)
+    dialog.canceled.connect(cancel)
+    proc.start(cmd[0],cmd[1:] + ["--progressFd","2","--cancelFile",cancelPath])
+    if proc.state() != QtCore.QProcess.NotRunning or proc.error() != QtCore.QProcess.FailedToStart:
+        loop.exec_()
+    readStderr()
+
+    if proc.error() == QtCore.QProcess.FailedToStart:
+        exitCode,stderr = -1,proc.errorString()
+    else:
+        exitCode = proc.exitCode() if proc.exitStatus() == QtCore.QProcess.NormalExit else -1
+        stderr = "\n".join(errorLines + [pending[0]]).strip()
+    stdout = bytes(proc.readAllStandardOutput()).decode("utf-8","replace")
+    dialog.close()
+    if os.path.exists(cancelPath):
+        os.remove(cancelPath)
+    proc.deleteLater()
+    return exitCode,stdout,stderr
+
 class AdaptiveSkyboxWidget(QtWidgets.QWidget):
     def __init__(self,path: str = None,parent=None):
         super().__init__(parent)
@@ -123,6 +197,16 @@ class AdaptiveSkyboxWidget(QtWidgets.QWidget):
         moonRow.addWidget(self.moonBox,1)
         seLayout.addLayout(moonRow)
 
+        # ----- Leap Rule ----- #
+        leapRow = QtWidgets.QHBoxLayout()
+        self.leapRuleBox = QtWidgets.QComboBox(); self.leapRuleBox.setEditable(True)
+        self.leapRuleBox.addItems(LEAP_RULES)
+        self.leapRuleBox.setToolTip("none: continuous fractional years; even: whole-day years with spread leap days; "
+                                    "gregorian: Earth's calendar; or type P:+d,... (years divisible by P gain d days)")
+        leapRow.addWidget(QtWidgets.QLabel("Leap Rule:"))
+        leapRow.addWidget(self.leapRuleBox,1)
+        seLayout.addLayout(leapRow)
+
         # ----- Capture Position ----- #
         positionRow = QtWidgets.QHBoxLayout()
         self.capturePosEdit = QtWidgets.QLineEdit("Sol/Earth")
@@ -181,9 +265,12 @@ class AdaptiveSkyboxWidget(QtWidgets.QWidget):
         btnRow = QtWidgets.QHBoxLayout()
         self.previewBtn = QtWidgets.QPushButton("Preview / Validate")
         self.generateBtn = QtWidgets.QPushButton("Generate Skybox Script")
+        self.catalogBtn = QtWidgets.QPushButton("Generate Scripts for Entire Catalog")
         self.previewBtn.clicked.connect(self.onPreview)
         self.generateBtn.clicked.connect(self.onGenerate)
+        self.catalogBtn.clicked.connect(self.onGenerateCatalog)
         btnRow.addStretch(1); btnRow.addWidget(self.previewBtn); btnRow.addWidget(self.generateBtn)
+        btnRow.addWidget(self.catalogBtn)
         seLayout.addLayout(btnRow)
         seLayout.addStretch(1)
     
@@ -245,6 +332,8 @@ class AdaptiveSkyboxWidget(QtWidgets.QWidget):
             self.endDateEdit.setText(settings.value("endDate","",str))
         if hasattr(self,"endTimeEdit"):
             self.endTimeEdit.setText(settings.value("endTime","00:00:00.00",str))
+        if hasattr(self,"leapRuleBox"):
+            self.leapRuleBox.setCurrentText(settings.value("leapRule","none",str))
         # ----- Screenshot Interval and Frames ----- #
         if hasattr(self,"intervalUnitBox"):
             intervalUnit = settings.value("intervalUnit","hours",str)
@@ -285,6 +374,8 @@ class AdaptiveSkyboxWidget(QtWidgets.QWidget):
             settings.setValue("endDate",self.endDateEdit.text().strip())
         if hasattr(self,"endTimeEdit"):
             settings.setValue("endTime",self.endTimeEdit.text().strip())
+        if hasattr(self,"leapRuleBox"):
+            settings.setValue("leapRule",self.leapRule())
         if hasattr(self,"intervalUnitBox"):
             settings.setValue("intervalUnit",self.intervalUnitBox.currentText())
         if hasattr(self,"intervalStepEdit"):
@@ -316,6 +407,9 @@ class AdaptiveSkyboxWidget(QtWidgets.QWidget):
         if path:
             self.objectEdit.setText(path)
     
+    def leapRule(self):
+        return self.leapRuleBox.currentText().strip() or "none"
+
     def updateFiletypesForPro(self,checked: bool):
         keep = self.filetypeBox.currentText()
         self.filetypeBox.blockSignals(True)
@@ -402,6 +496,7 @@ class AdaptiveSkyboxWidget(QtWidgets.QWidget):
         "--monthDays",str(calendar["monthDays"]),
         "--yearDays",str(calendar["yearDays"]),
         "--year0",str(calendar["year0"]),
+        "--leapRule",self.leapRule(),
         "--debugDir",debugDir
         ]
 
@@ -413,16 +508,89 @@ class AdaptiveSkyboxWidget(QtWidgets.QWidget):
             framesCount = framesText if framesText else "20"
             cmd += ["--frames",framesCount]
 
-        try:
-            subprocess.run(cmd,check=True)
+        exitCode,_,stderr = runEngineWithProgress(self,cmd,"Writing the frame export script...")
+        if exitCode == 0:
             QtWidgets.QMessageBox.information(self,"Done",
                                               f"Skybox frame export script written:\n{outPath}\n\n"
                                               f"Debug Copy (if set):\n{debugDir}")
-        except subprocess.CalledProcessError as e:
+        elif exitCode != 130:
             QtWidgets.QMessageBox.critical(self,"Engine Error",
                                            f"seScreenshotEngine exited with an error.\n\n"
-                                           f"Command:\n{' '.join(cmd)}\n\n{e}")
+                                           f"Command:\n{' '.join(cmd)}\n\n{stderr or exitCode}")
     
+    def onGenerateCatalog(self):
+        exportDir = self.exportPathEdit.text().strip()
+        objectPath = self.objectEdit.text().strip()
+        if not exportDir:
+            QtWidgets.QMessageBox.warning(self,"Missing Export Path",
+                                          "Please choose an SE Code Path (export folder) first.")
+            return
+        if not objectPath or not os.path.exists(objectPath):
+            QtWidgets.QMessageBox.warning(self,"Missing Target Object",
+                                          "Please choose a Target Object File containing the Planet blocks.")
+            return
+
+        exePath = getScreenshotEnginePath("seScreenshotEngine.exe")
+        if not os.path.exists(exePath):
+            QtWidgets.QMessageBox.critical(self,"Engine Not Found",
+                                           f"Could not find the screenshot engine at:\n{exePath}\n\n"
+                                           "Make sure seScreenshotEngine.exe is in:\nSpaceEngine_Automation/.")
+            return
+
+        try:
+            step = float(self.intervalStepEdit.text().strip() or "1.0")
+            if step <= 0:
+                raise ValueError
+        except ValueError:
+            QtWidgets.QMessageBox.warning(self,"Invalid Screenshot Interval",
+                                          "Interval Step must be a positive number.")
+            return
+
+        name = (self.outNameEdit.text().strip() or "adaptiveSkybox.se")
+        if not name.lower().endswith(".se"):
+            name += ".se"
+        stem = os.path.splitext(os.path.basename(objectPath))[0]
+        batchDir = os.path.join(exportDir,stem + "_batch")
+
+        # Per-planet calendars and capture positions are derived by the engine
+        cmd = [
+            exePath,
+        "--catalog",objectPath,
+        "--batchDir",batchDir,
+        "--out",name,
+        "--scriptName","Live Skybox",
+        "--initialDate",self.startDateEdit.text().strip() or "2000.01.01",
+        "--startTime",self.startTimeEdit.text().strip() or "00:00:00.00",
+        "--captureObject","ISS",
+        "--captureType",self.captureTypeBox.currentText(),
+        "--exportFiletype",self.filetypeBox.currentText(),
+        "--intervalUnit",self.intervalUnitBox.currentText(),
+        "--intervalStep",str(step),
+        "--leapRule",self.leapRule()
+        ]
+
+        if self.endDateEdit.text().strip():
+            cmd += ["--endDate",self.endDateEdit.text().strip(),
+                    "--endTime",self.endTimeEdit.text().strip() or "00:00:00.00"]
+        elif self.framesEdit.text().strip():
+            cmd += ["--frames",self.framesEdit.text().strip()]
+        # Otherwise the engine schedules one full orbit per planet
+
+        exitCode,stdout,stderr = runEngineWithProgress(self,cmd,"Writing catalog scripts...")
+        if exitCode == 0:
+            QtWidgets.QMessageBox.information(self,"Done",
+                                              f"Catalog scripts written to:\n{batchDir}\n\n"
+                                              f"Summary Index:\n{os.path.join(batchDir,'index.tsv')}")
+        elif exitCode == 130:
+            QtWidgets.QMessageBox.information(self,"Cancelled",
+                                              f"Catalog generation cancelled. Finished bodies remain in:\n{batchDir}")
+        else:
+            QtWidgets.QMessageBox.critical(self,"Engine Error",
+                                           f"seScreenshotEngine exited with an error.\n\n"
+                                           f"Command:\n{' '.join(cmd)}\n\n"
+                                           f"STDOUT:\n{stdout or '(empty)'}\n\n"
+                                           f"STDERR:\n{stderr or '(empty)'}")
+
     def onPreview(self):
         exportDir = self.exportPathEdit.text().strip()
         debugDir = self.debugPathEdit.text().strip()
@@ -498,6 +666,7 @@ class AdaptiveSkyboxWidget(QtWidgets.QWidget):
         "--monthDays",str(calendar["monthDays"]),
         "--yearDays",str(calendar["yearDays"]),
         "--year0",str(calendar["year0"]),
+        "--leapRule",self.leapRule(),
         "--debugDir",debugDir
         ]
 
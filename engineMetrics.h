@@ -0,0 +1,423 @@
+//Shared Engine Utilities
+//Engine Metrics (Shared Header)
+//Chris D. | Version 1 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Counters, gauges and latency histograms
+//      with a Prometheus text exporter
+//  Version 1 (10/18/2026): Idle scrapers time out instead of holding
+//      the exporter thread, writes to closed sockets no longer raise
+//      SIGPIPE, and SIGUSR1 is handled whenever the exporter starts
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  One Registry per process (metrics::registry()). Metrics are
+//  registered once, by name and optional labels, and the returned
+//  reference is kept; updating one is a single relaxed atomic add
+//  on its own cache line, so hot loops pay a few nanoseconds and
+//  never take a lock. Loops over pixels or tiles should still add
+//  their totals once per tile or frame.
+//
+//    Counter    add(n)                 monotonically increasing
+//    Gauge      set(v) / add(n)        queue depths, memory
+//    Histogram  observe(seconds)       fixed latency buckets
+//                                      (100 us .. 60 s), plus _sum
+//                                      and _count
+//
+//  Exporter serves the registry in the Prometheus text format:
+//
+//    --metricsPort N   http://127.0.0.1:N/metrics (any path answers);
+//                      a client gets 1 s to send its request and
+//                      1 s per write to read the reply
+//    --metricsFile F   written on SIGUSR1 (POSIX) and at exit
+//
+//  With no --metricsFile (including neither flag), SIGUSR1 dumps to
+//  stderr; the previous handler is restored by stop().
+//
+//  process_resident_memory_bytes and process_uptime_seconds are
+//  always included.
+
+#ifndef LIVE_SKYBOXES_ENGINE_METRICS_H
+#define LIVE_SKYBOXES_ENGINE_METRICS_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <csignal>
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#ifdef _MSC_VER
+#pragma comment(lib,"ws2_32")
+#endif
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif
+
+namespace metrics {
+
+// ============================================================== //
+// |                          METRICS                           | //
+// ============================================================== //
+struct alignas(64) Counter {
+    std::atomic<uint64_t> value{0};
+    void add(uint64_t count = 1) { value.fetch_add(count,std::memory_order_relaxed); }
+};
+
+struct alignas(64) Gauge {
+    std::atomic<double> value{0.0};
+    void set(double v) { value.store(v,std::memory_order_relaxed); }
+    void add(double delta) {
+        double current = value.load(std::memory_order_relaxed);
+        while (!value.compare_exchange_weak(current,current + delta,std::memory_order_relaxed)) {}
+    }
+};
+
+//Upper bounds in seconds; the +Inf bucket is implicit.
+static const double kLatencyBounds[] = { 0.0001,0.00025,0.0005,0.001,0.0025,0.005,0.01,0.025,0.05,
+                                         0.1,0.25,0.5,1.0,2.5,5.0,10.0,30.0,60.0 };
+static const int kLatencyBuckets = (int)(sizeof(kLatencyBounds) / sizeof(kLatencyBounds[0]));
+
+class Histogram {
+public:
+    void observe(double seconds) {
+        const int bucket = (int)(std::lower_bound(kLatencyBounds,kLatencyBounds + kLatencyBuckets,seconds) - kLatencyBounds);
+        counts_[bucket].fetch_add(1,std::memory_order_relaxed);
+        sumNanos_.fetch_add((uint64_t)std::max(0.0,seconds * 1e9),std::memory_order_relaxed);
+    }
+
+    //Non-cumulative counts, kLatencyBuckets + 1 of them (last is +Inf).
+    std::vector<uint64_t> counts() const {
+        std::vector<uint64_t> out(kLatencyBuckets + 1);
+        for (int b = 0; b <= kLatencyBuckets; b++) out[b] = counts_[b].load(std::memory_order_relaxed);
+        return out;
+    }
+    double sumSeconds() const { return sumNanos_.load(std::memory_order_relaxed) * 1e-9; }
+
+private:
+    alignas(64) std::atomic<uint64_t> counts_[kLatencyBuckets + 1] = {};
+    alignas(64) std::atomic<uint64_t> sumNanos_{0};
+};
+
+//Observes the enclosing scope's wall time.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram& histogram) : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() { histogram_.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count()); }
+private:
+    Histogram& histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// ============================================================== //
+// |                          REGISTRY                          | //
+// ============================================================== //
+class Registry {
+public:
+    //labels is the Prometheus label body, e.g. stage="project".
+    Counter& counter(const std::string& name,const std::string& help,const std::string& labels = "") {
+        return *find(name,help,labels,KindCounter).counter;
+    }
+    Gauge& gauge(const std::string& name,const std::string& help,const std::string& labels = "") {
+        return *find(name,help,labels,KindGauge).gauge;
+    }
+    Histogram& histogram(const std::string& name,const std::string& help,const std::string& labels = "") {
+        return *find(name,help,labels,KindHistogram).histogram;
+    }
+
+    //Prometheus text exposition format 0.0.4; series sharing a name
+    //are grouped under one HELP/TYPE header in registration order.
+    std::string render() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::string out;
+        std::vector<bool> written(entries_.size(),false);
+        for (size_t i = 0; i < entries_.size(); i++) {
+            if (written[i]) continue;
+            const Entry& head = entries_[i];
+            static const char* const kTypes[] = { "counter","gauge","histogram" };
+            out += "# HELP " + head.name + " " + head.help + "\n# TYPE " + head.name + " " + kTypes[head.kind] + "\n";
+            for (size_t j = i; j < entries_.size(); j++) {
+                if (entries_[j].name != head.name) continue;
+                written[j] = true;
+                renderEntry(entries_[j],out);
+            }
+        }
+        out += "# HELP process_resident_memory_bytes Resident set size.\n# TYPE process_resident_memory_bytes gauge\n";
+        out += "process_resident_memory_bytes " + std::to_string(residentBytes()) + "\n";
+        out += "# HELP process_uptime_seconds Seconds since the metrics registry was created.\n# TYPE process_uptime_seconds gauge\n";
+        out += "process_uptime_seconds " + number(std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count()) + "\n";
+        return out;
+    }
+
+private:
+    enum Kind { KindCounter = 0, KindGauge, KindHistogram };
+    struct Entry {
+        std::string name, help, labels;
+        Kind kind;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+    std::mutex mutex_;
+    std::deque<Entry> entries_;
+    std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+
+    Entry& find(const std::string& name,const std::string& help,const std::string& labels,Kind kind) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Entry& entry : entries_) {
+            if (entry.name != name) continue;
+            if (entry.kind != kind) throw std::runtime_error("Metric registered with two types: " + name);
+            if (entry.labels == labels) return entry;
+        }
+        entries_.push_back(Entry{name,help,labels,kind,nullptr,nullptr,nullptr});
+        Entry& entry = entries_.back();
+        if (kind == KindCounter) entry.counter.reset(new Counter());
+        else if (kind == KindGauge) entry.gauge.reset(new Gauge());
+        else entry.histogram.reset(new Histogram());
+        return entry;
+    }
+
+    static std::string number(double value) {
+        char text[48];
+        std::snprintf(text,sizeof(text),"%.9g",value);
+        return text;
+    }
+
+    static std::string series(const std::string& name,const std::string& labels,const std::string& extra = "") {
+        std::string all = labels;
+        if (!extra.empty()) all += (all.empty() ? "" : ",") + extra;
+        return all.empty() ? name : name + "{" + all + "}";
+    }
+
+    static void renderEntry(const Entry& entry,std::string& out) {
+        if (entry.kind == KindCounter) {
+            out += series(entry.name,entry.labels) + " " + std::to_string(entry.counter->value.load(std::memory_order_relaxed)) + "\n";
+        } else if (entry.kind == KindGauge) {
+            out += series(entry.name,entry.labels) + " " + number(entry.gauge->value.load(std::memory_order_relaxed)) + "\n";
+        } else {
+            const std::vector<uint64_t> counts = entry.histogram->counts();
+            uint64_t cumulative = 0;
+            for (int b = 0; b <= kLatencyBuckets; b++) {
+                cumulative += counts[b];
+                const std::string le = b < kLatencyBuckets ? number(kLatencyBounds[b]) : std::string("+Inf");
+                out += series(entry.name + "_bucket",entry.labels,"le=\"" + le + "\"") + " " + std::to_string(cumulative) + "\n";
+            }
+            out += series(entry.name + "_sum",entry.labels) + " " + number(entry.histogram->sumSeconds()) + "\n";
+            out += series(entry.name + "_count",entry.labels) + " " + std::to_string(cumulative) + "\n";
+        }
+    }
+
+    static uint64_t residentBytes() {
+        #if defined(__linux__)
+        std::ifstream statm("/proc/self/statm");
+        uint64_t pages = 0, resident = 0;
+        if (statm >> pages >> resident) return resident * (uint64_t)sysconf(_SC_PAGESIZE);
+        #endif
+        return 0;
+    }
+};
+
+inline Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+// ============================================================== //
+// |                          EXPORTER                          | //
+// ============================================================== //
+static volatile std::sig_atomic_t gDumpSignal = 0;
+
+static void onDumpSignal(int) { gDumpSignal = 1; }
+
+//Background thread: answers scrapes on the port and writes the dump
+//file (or stderr) when SIGUSR1 arrives. stop() (or the destructor)
+//writes the final dump file.
+class Exporter {
+public:
+    ~Exporter() { stop(); }
+
+    void start(int port,const std::string& dumpPath) {
+        registry();                     // Uptime counts from here at the latest
+        if (running_) return;
+        dumpPath_ = dumpPath;
+        if (port > 0) listen(port);
+        #ifdef SIGUSR1
+        previousHandler_ = std::signal(SIGUSR1,onDumpSignal);
+        #endif
+        running_ = true;
+        thread_ = std::thread([this]() { loop(); });
+    }
+
+    void stop() {
+        if (!running_) return;
+        running_ = false;
+        thread_.join();
+        closeSocket(listener_);
+        listener_ = kNoSocket;
+        #ifdef SIGUSR1
+        if (previousHandler_ != SIG_ERR) std::signal(SIGUSR1,previousHandler_);
+        #endif
+        if (!dumpPath_.empty()) dump();
+    }
+
+private:
+    #ifdef _WIN32
+    using Socket = SOCKET;
+    static constexpr Socket kNoSocket = INVALID_SOCKET;
+    static constexpr int kSendFlags = 0;
+    #else
+    using Socket = int;
+    static constexpr Socket kNoSocket = -1;
+    #ifdef MSG_NOSIGNAL
+    static constexpr int kSendFlags = MSG_NOSIGNAL;
+    #else
+    static constexpr int kSendFlags = 0;    // SO_NOSIGPIPE per client instead
+    #endif
+    #endif
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    std::string dumpPath_;
+    Socket listener_ = kNoSocket;
+    void (*previousHandler_)(int) = SIG_DFL;
+
+    //Bounded recv/send, blocking mode (BSD accept() inherits the
+    //listener's non-blocking flag), and no SIGPIPE on macOS.
+    static void prepareClient(Socket client) {
+        #ifdef _WIN32
+        u_long blocking = 0;
+        ioctlsocket(client,FIONBIO,&blocking);
+        const DWORD timeout = 1000;
+        #else
+        fcntl(client,F_SETFL,fcntl(client,F_GETFL,0) & ~O_NONBLOCK);
+        const timeval timeout = { 1,0 };
+        #endif
+        setsockopt(client,SOL_SOCKET,SO_RCVTIMEO,(const char*)&timeout,sizeof(timeout));
+        setsockopt(client,SOL_SOCKET,SO_SNDTIMEO,(const char*)&timeout,sizeof(timeout));
+        #ifdef SO_NOSIGPIPE
+        int noSigPipe = 1;
+        setsockopt(client,SOL_SOCKET,SO_NOSIGPIPE,(const char*)&noSigPipe,sizeof(noSigPipe));
+        #endif
+    }
+
+    static void closeSocket(Socket socket) {
+        if (socket == kNoSocket) return;
+        #ifdef _WIN32
+        closesocket(socket);
+        #else
+        ::close(socket);
+        #endif
+    }
+
+    void listen(int port) {
+        #ifdef _WIN32
+        WSADATA wsa;
+        if (WSAStartup(MAKEWORD(2,2),&wsa) != 0) throw std::runtime_error("Metrics: WSAStartup failed");
+        #endif
+        listener_ = ::socket(AF_INET,SOCK_STREAM,0);
+        if (listener_ == kNoSocket) throw std::runtime_error("Metrics: socket() failed");
+        int reuse = 1;
+        setsockopt(listener_,SOL_SOCKET,SO_REUSEADDR,(const char*)&reuse,sizeof(reuse));
+        sockaddr_in address;
+        std::memset(&address,0,sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons((uint16_t)port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::bind(listener_,(sockaddr*)&address,sizeof(address)) != 0 || ::listen(listener_,8) != 0) {
+            closeSocket(listener_);
+            listener_ = kNoSocket;
+            throw std::runtime_error("Metrics: cannot listen on 127.0.0.1:" + std::to_string(port));
+        }
+        //Non-blocking, so a client that leaves between select() and
+        //accept() cannot stall the loop.
+        #ifdef _WIN32
+        u_long nonBlocking = 1;
+        ioctlsocket(listener_,FIONBIO,&nonBlocking);
+        #else
+        fcntl(listener_,F_SETFL,fcntl(listener_,F_GETFL,0) | O_NONBLOCK);
+        #endif
+    }
+
+    void dump() {
+        const std::string text = registry().render();
+        if (dumpPath_.empty()) {
+            std::fwrite(text.data(),1,text.size(),stderr);
+            return;
+        }
+        //Written beside the target and renamed, so readers never see half a dump.
+        const std::string temporary = dumpPath_ + ".tmp";
+        {
+            std::ofstream file(temporary,std::ios::binary);
+            file << text;
+        }
+        std::remove(dumpPath_.c_str());
+        std::rename(temporary.c_str(),dumpPath_.c_str());
+    }
+
+    //One scrape per connection (HTTP/1.0); the request is drained,
+    //not parsed. A client that sends nothing within the receive
+    //timeout is dropped without a reply.
+    void serve(Socket client) {
+        prepareClient(client);
+        char request[2048];
+        if (::recv(client,request,sizeof(request),0) <= 0) {
+            closeSocket(client);
+            return;
+        }
+        const std::string body = registry().render();
+        const std::string response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: "
+                                   + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+        size_t sent = 0;
+        while (sent < response.size()) {
+            const int n = (int)::send(client,response.data() + sent,(int)(response.size() - sent),kSendFlags);
+            if (n <= 0) break;
+            sent += (size_t)n;
+        }
+        closeSocket(client);
+    }
+
+    void loop() {
+        while (running_) {
+            if (gDumpSignal) {
+                gDumpSignal = 0;
+                dump();
+            }
+            if (listener_ == kNoSocket) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
+            }
+            fd_set readable;
+            FD_ZERO(&readable);
+            FD_SET(listener_,&readable);
+            timeval timeout = { 0,100000 };
+            if (::select((int)listener_ + 1,&readable,nullptr,nullptr,&timeout) <= 0) continue;
+            const Socket client = ::accept(listener_,nullptr,nullptr);
+            if (client != kNoSocket) serve(client);
+        }
+    }
+};
+
+} // namespace metrics
+
+#endif // LIVE_SKYBOXES_ENGINE_METRICS_H
@@ -0,0 +1,213 @@
+//Shared Engine Utilities
+//Engine Progress (Shared Header)
+//Chris D. | Version 1 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Progress records and cooperative
+//      cancellation for the engines the UIs launch
+//  Version 1 (10/18/2026): Stage total and start are atomics, so
+//      advance() from worker threads no longer races stage()
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  One Reporter per engine process (progress::engine()).
+//
+//    --progressFd N   One JSON object per line on file descriptor N:
+//                       {"stage":"north","done":512,"total":2048,
+//                        "fraction":0.2500,"elapsed":0.84,"eta":2.52}
+//                     then {"event":"done"}, {"event":"cancelled"} or
+//                     {"event":"error","message":"..."} at exit. A stage
+//                     reports at most every 100 ms, plus its first and
+//                     last record.
+//    --cancelFile F   Once F exists (or on SIGINT/SIGTERM) the engine
+//                     stops at its next row, tile, frame or chunk
+//                     checkpoint, removes the outputs of the unit it was
+//                     writing, and exits with kExitCancelled. A second
+//                     signal kills the process as usual.
+//
+//  Outputs are tracked per unit of work: track() a file when it is
+//  written, keep() once the unit is complete, and discard() on
+//  cancellation or error removes whatever is still tracked.
+
+#ifndef LIVE_SKYBOXES_ENGINE_PROGRESS_H
+#define LIVE_SKYBOXES_ENGINE_PROGRESS_H
+
+#include <cstdio>
+#include <cstdint>
+#include <csignal>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace progress {
+
+static const int kExitCancelled = 130;
+
+//Thrown by checkpoint(); engines catch it in main() ahead of the
+//generic handler.
+struct Cancelled : std::runtime_error {
+    Cancelled() : std::runtime_error("Cancelled") {}
+};
+
+static volatile std::sig_atomic_t gCancelSignal = 0;
+
+static void onCancelSignal(int signal) {
+    gCancelSignal = 1;
+    std::signal(signal,SIG_DFL);
+}
+
+class Reporter {
+public:
+    void open(int fd,const std::string& cancelFile) {
+        fd_ = fd;
+        cancelFile_ = cancelFile;
+        start_ = std::chrono::steady_clock::now();
+        std::signal(SIGINT,onCancelSignal);
+        std::signal(SIGTERM,onCancelSignal);
+    }
+
+    // ----- Progress ----- //
+    void stage(const std::string& name,int64_t total) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stage_ = name;
+        total_ = total;
+        done_ = 0;
+        stageStartNs_ = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+        lastEmit_ = -1.0;
+        emitLocked(true);
+    }
+
+    //Thread-safe; callers inside OpenMP loops report one unit each.
+    void advance(int64_t count = 1) {
+        const int64_t done = done_.fetch_add(count) + count;
+        if (fd_ < 0) return;
+        const bool last = done >= total_.load();
+        if (!last && stageSeconds() - lastEmit_ < 0.1) return;
+        std::unique_lock<std::mutex> lock(mutex_,std::try_to_lock);
+        if (lock.owns_lock() || last) {
+            if (!lock.owns_lock()) lock.lock();
+            emitLocked(last);
+        }
+    }
+
+    void set(int64_t done) { advance(done - done_.load()); }
+
+    void event(const char* name,const std::string& message = std::string()) {
+        if (fd_ < 0) return;
+        std::string line = std::string("{\"event\":\"") + name + "\"";
+        if (!message.empty()) line += ",\"message\":\"" + escape(message) + "\"";
+        line += ",\"elapsed\":" + number(seconds(start_),3) + "}\n";
+        std::lock_guard<std::mutex> lock(mutex_);
+        writeLine(line);
+    }
+
+    // ----- Cancellation ----- //
+    //The cancel file is polled at most every 50 ms; the answer latches.
+    bool cancelled() {
+        if (cancelled_.load(std::memory_order_relaxed)) return true;
+        if (gCancelSignal) { cancelled_ = true; return true; }
+        if (cancelFile_.empty()) return false;
+        const int64_t now = (int64_t)(seconds(start_) * 1000.0);
+        int64_t polled = lastPoll_.load(std::memory_order_relaxed);
+        if (now - polled < 50 || !lastPoll_.compare_exchange_strong(polled,now)) return false;
+        std::error_code ec;
+        if (std::filesystem::exists(cancelFile_,ec)) cancelled_ = true;
+        return cancelled_;
+    }
+
+    void checkpoint() { if (cancelled()) throw Cancelled(); }
+
+    // ----- Outputs of the unit in flight ----- //
+    void track(const std::string& path) { std::lock_guard<std::mutex> lock(mutex_); outputs_.push_back(path); }
+    void keep() { std::lock_guard<std::mutex> lock(mutex_); outputs_.clear(); }
+    void discard() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const std::string& path : outputs_) {
+            std::error_code ec;
+            std::filesystem::remove(path,ec);
+        }
+        outputs_.clear();
+    }
+
+private:
+    int fd_ = -1;
+    std::string cancelFile_;
+    std::mutex mutex_;
+    std::string stage_;
+    std::atomic<int64_t> total_{0};         // Written by stage() under the lock, read by advance() without it
+    std::atomic<int64_t> done_{0};
+    std::atomic<bool> cancelled_{false};
+    std::atomic<int64_t> lastPoll_{-1000};
+    std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();     // Set by open(), before any worker
+    std::atomic<int64_t> stageStartNs_{0};  // Stage start, nanoseconds after start_
+    std::atomic<double> lastEmit_{-1.0};     // Seconds into the stage
+    std::vector<std::string> outputs_;
+
+    static double seconds(std::chrono::steady_clock::time_point since) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+    }
+
+    double stageSeconds() const {
+        return seconds(start_) - (double)stageStartNs_.load() * 1e-9;
+    }
+
+    static std::string number(double value,int decimals) {
+        char text[48];
+        std::snprintf(text,sizeof(text),"%.*f",decimals,value);
+        return text;
+    }
+
+    static std::string escape(const std::string& text) {
+        std::string out;
+        for (char c : text) {
+            if (c == '"' || c == '\\') { out += '\\'; out += c; }
+            else if ((unsigned char)c < 0x20) out += ' ';
+            else out += c;
+        }
+        return out;
+    }
+
+    void writeLine(const std::string& line) {
+        #ifdef _WIN32
+        _write(fd_,line.data(),(unsigned)line.size());
+        #else
+        if (::write(fd_,line.data(),line.size()) < 0) fd_ = -1;     // Reader went away
+        #endif
+    }
+
+    void emitLocked(bool force) {
+        if (fd_ < 0) return;
+        const double elapsed = stageSeconds();
+        if (!force && elapsed - lastEmit_ < 0.1) return;
+        lastEmit_ = elapsed;
+        const int64_t total = total_.load();
+        const int64_t done = std::min<int64_t>(done_.load(),total);
+        const double fraction = total > 0 ? (double)done / total : 0.0;
+        const double eta = done > 0 ? elapsed * (total - done) / done : -1.0;
+        writeLine("{\"stage\":\"" + escape(stage_) + "\",\"done\":" + std::to_string(done) + ",\"total\":" + std::to_string(total)
+                  + ",\"fraction\":" + number(fraction,4) + ",\"elapsed\":" + number(elapsed,2) + ",\"eta\":" + number(eta,2) + "}\n");
+    }
+};
+
+inline Reporter& engine() {
+    static Reporter reporter;
+    return reporter;
+}
+
+} // namespace progress
+
+#endif // LIVE_SKYBOXES_ENGINE_PROGRESS_H
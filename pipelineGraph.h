@@ -0,0 +1,365 @@
+//Pipeline Orchestrator
+//Pipeline Graph (Shared Header)
+//Chris D. | Version 1 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Stage DAG, resource-limited scheduler
+//      and content-hashed artifact cache
+//  Version 1 (10/18/2026): Queue depth, node outcome and per-stage
+//      latency metrics (engineMetrics.h)
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  A pipeline is a DAG of nodes. Each node names its input and
+//  output files, a recipe (the command line, or a description of
+//  in-process work) and an action that produces the outputs.
+//
+//    Cache      A node's key hashes its recipe and the contents of
+//               its inputs. When the key matches the record left by
+//               the last successful run and every output exists, the
+//               node is skipped. Because downstream keys hash file
+//               contents, a rerun upstream that rewrites identical
+//               bytes does not invalidate anything below it.
+//    Schedule   `jobs` workers take the ready node with the lowest
+//               (frame, insertion) order whose stage is under its
+//               maxParallel and whose memoryMB fits the budget, so
+//               frame 2 renders while frame 1 projects. A node that
+//               alone exceeds the budget still runs, by itself.
+//    Failures   A failed node marks everything downstream skipped;
+//               independent branches keep running.
+//    Metrics    pipeline_ready_nodes, pipeline_running_nodes and
+//               pipeline_memory_in_use_mb track the queue;
+//               pipeline_nodes_total{stage,state} counts outcomes
+//               (ran vs cached is the cache hit rate) and
+//               pipeline_node_seconds{stage} times the nodes that ran.
+
+#ifndef LIVE_SKYBOXES_PIPELINE_GRAPH_H
+#define LIVE_SKYBOXES_PIPELINE_GRAPH_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cctype>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <filesystem>
+#include <stdexcept>
+#include <algorithm>
+#include <condition_variable>
+
+#include "engineMetrics.h"
+
+namespace pipeline {
+
+namespace fs = std::filesystem;
+
+enum NodeState { NodePending = 0, NodeRunning, NodeDone, NodeCached, NodeFailed, NodeSkipped };
+static const char* const kNodeStateNames[] = { "pending","running","ran","cached","FAILED","skipped" };
+
+struct Node {
+    std::string name;               // Unique, e.g. "project[0003]"
+    std::string stage;              // Limits and timings group by stage
+    int frame = -1;                 // Scheduling priority; -1 runs first
+    std::vector<int> deps;
+    std::vector<std::string> inputs, outputs;
+    std::string recipe;
+    int memoryMB = 0;
+    std::function<void(const Node&)> action;   // Throws on failure
+
+    // ----- Results ----- //
+    int state = NodePending;
+    double milliseconds = 0.0;
+    std::string error;
+};
+
+struct StageLimits {
+    int maxParallel = 0;            // 0: only the worker count applies
+};
+
+struct RunOptions {
+    int jobs = 1;
+    int memoryMB = 0;               // 0: no memory budget
+    bool force = false;             // Ignore cache records
+    bool dryRun = false;            // Report cache state only
+    std::string cacheDir;
+    std::map<std::string,StageLimits> limits;
+};
+
+struct RunSummary {
+    double wallMilliseconds = 0.0;
+    double stageMilliseconds = 0.0; // Sum over nodes that ran
+    int ran = 0, cached = 0, failed = 0, skipped = 0;
+};
+
+// ============================================================== //
+// |                       CONTENT HASHES                       | //
+// ============================================================== //
+static inline uint64_t hashBytes(uint64_t h,const void* data,size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) h = (h ^ bytes[i]) * 1099511628211ULL;
+    return h;
+}
+
+//FNV-1a over 8-byte words (then the tail), read in 1 MB blocks.
+static inline uint64_t hashFile(const std::string& path) {
+    std::ifstream file(path,std::ios::binary);
+    if (!file) throw std::runtime_error("Missing input: " + path);
+    uint64_t h = 1469598103934665603ULL;
+    std::vector<char> block(1 << 20);
+    while (file) {
+        file.read(block.data(),(std::streamsize)block.size());
+        const size_t got = (size_t)file.gcount();
+        size_t i = 0;
+        for (; i + 8 <= got; i += 8) {
+            uint64_t word;
+            std::memcpy(&word,block.data() + i,8);
+            h = (h ^ word) * 1099511628211ULL;
+        }
+        h = hashBytes(h,block.data() + i,got - i);
+    }
+    return h;
+}
+
+//Hashes keyed by path, size and write time, so an input shared by
+//several nodes (or unchanged since the last lookup) is read once.
+class HashCache {
+public:
+    uint64_t get(const std::string& path) {
+        std::error_code ec;
+        const uint64_t size = (uint64_t)fs::file_size(path,ec);
+        if (ec) throw std::runtime_error("Missing input: " + path);
+        const int64_t stamp = (int64_t)fs::last_write_time(path,ec).time_since_epoch().count();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(path);
+            if (it != entries_.end() && it->second.size == size && it->second.stamp == stamp) return it->second.hash;
+        }
+        const uint64_t hash = hashFile(path);
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_[path] = {size,stamp,hash};
+        return hash;
+    }
+
+private:
+    struct Entry { uint64_t size; int64_t stamp; uint64_t hash; };
+    std::mutex mutex_;
+    std::map<std::string,Entry> entries_;
+};
+
+// ============================================================== //
+// |                           GRAPH                            | //
+// ============================================================== //
+class Graph {
+public:
+    int add(Node node) {
+        for (int dep : node.deps) {
+            if (dep < 0 || dep >= (int)nodes_.size()) throw std::runtime_error("Pipeline: bad dependency for " + node.name);
+        }
+        nodes_.push_back(std::move(node));
+        return (int)nodes_.size() - 1;
+    }
+
+    std::vector<Node>& nodes() { return nodes_; }
+    const std::vector<Node>& nodes() const { return nodes_; }
+
+    RunSummary run(const RunOptions& options) {
+        RunSummary summary;
+        const auto start = std::chrono::steady_clock::now();
+        if (!options.cacheDir.empty()) fs::create_directories(options.cacheDir);
+
+        const size_t n = nodes_.size();
+        std::vector<std::vector<int>> dependents(n);
+        std::vector<int> waiting(n,0);
+        for (size_t i = 0; i < n; i++) {
+            nodes_[i].state = NodePending;
+            nodes_[i].milliseconds = 0.0;
+            nodes_[i].error.clear();
+            waiting[i] = (int)nodes_[i].deps.size();
+            for (int dep : nodes_[i].deps) dependents[dep].push_back((int)i);
+        }
+        std::vector<int> ready;
+        for (size_t i = 0; i < n; i++) if (waiting[i] == 0) ready.push_back((int)i);
+
+        metrics::Registry& registry = metrics::registry();
+        metrics::Gauge& readyGauge = registry.gauge("pipeline_ready_nodes","Nodes whose dependencies are done, waiting for a worker.");
+        metrics::Gauge& runningGauge = registry.gauge("pipeline_running_nodes","Nodes executing now.");
+        metrics::Gauge& memoryGauge = registry.gauge("pipeline_memory_in_use_mb","Declared memoryMB of the running nodes.");
+        auto outcome = [&](const Node& node,int state) -> metrics::Counter& {
+            return registry.counter("pipeline_nodes_total","Finished nodes by stage and outcome.",
+                                    "stage=\"" + node.stage + "\",state=\"" + kNodeStateNames[state] + "\"");
+        };
+        readyGauge.set((int64_t)ready.size());
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::map<std::string,int> running;
+        int memoryInUse = 0, active = 0;
+        size_t finished = 0;
+
+        auto fits = [&](const Node& node) {
+            auto limit = options.limits.find(node.stage);
+            if (limit != options.limits.end() && limit->second.maxParallel > 0 && running[node.stage] >= limit->second.maxParallel) return false;
+            if (options.memoryMB > 0 && active > 0 && memoryInUse + node.memoryMB > options.memoryMB) return false;
+            return true;
+        };
+        auto before = [&](int a,int b) {
+            return std::make_pair(nodes_[a].frame,a) < std::make_pair(nodes_[b].frame,b);
+        };
+        std::function<void(int)> skipBelow = [&](int i) {
+            for (int d : dependents[i]) {
+                if (nodes_[d].state != NodePending) continue;
+                nodes_[d].state = NodeSkipped;
+                nodes_[d].error = "upstream " + nodes_[i].name + " failed";
+                outcome(nodes_[d],NodeSkipped).add();
+                finished++;
+                skipBelow(d);
+            }
+        };
+
+        auto worker = [&]() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                int pick = -1;
+                for (int candidate : ready) {
+                    if (fits(nodes_[candidate]) && (pick < 0 || before(candidate,pick))) pick = candidate;
+                }
+                if (pick < 0) {
+                    if (finished == n) break;
+                    changed.wait(lock);
+                    continue;
+                }
+                ready.erase(std::find(ready.begin(),ready.end(),pick));
+                Node& node = nodes_[pick];
+                node.state = NodeRunning;
+                running[node.stage]++;
+                memoryInUse += node.memoryMB;
+                active++;
+                readyGauge.set((int64_t)ready.size());
+                runningGauge.set(active);
+                memoryGauge.set(memoryInUse);
+                lock.unlock();
+
+                const int state = execute(node,options);
+                if (state == NodeDone && !options.dryRun) {
+                    registry.histogram("pipeline_node_seconds","Wall time of nodes that ran, by stage.",
+                                       "stage=\"" + node.stage + "\"").observe(node.milliseconds * 1e-3);
+                }
+
+                lock.lock();
+                node.state = state;
+                running[node.stage]--;
+                memoryInUse -= node.memoryMB;
+                active--;
+                finished++;
+                outcome(node,state).add();
+                if (state == NodeFailed) {
+                    skipBelow(pick);
+                } else {
+                    for (int d : dependents[pick]) {
+                        if (nodes_[d].state == NodePending && --waiting[d] == 0) ready.push_back(d);
+                    }
+                }
+                readyGauge.set((int64_t)ready.size());
+                runningGauge.set(active);
+                memoryGauge.set(memoryInUse);
+                changed.notify_all();
+            }
+            changed.notify_all();
+        };
+
+        const int jobs = std::max(1,options.jobs);
+        std::vector<std::thread> threads;
+        for (int t = 1; t < jobs; t++) threads.emplace_back(worker);
+        worker();
+        for (std::thread& thread : threads) thread.join();
+
+        for (const Node& node : nodes_) {
+            if (node.state == NodeDone) { summary.ran++; summary.stageMilliseconds += node.milliseconds; }
+            else if (node.state == NodeCached) summary.cached++;
+            else if (node.state == NodeFailed) summary.failed++;
+            else if (node.state == NodeSkipped) summary.skipped++;
+        }
+        summary.wallMilliseconds = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - start).count();
+        return summary;
+    }
+
+private:
+    std::vector<Node> nodes_;
+    HashCache hashes_;
+
+    uint64_t key(const Node& node) {
+        uint64_t h = hashBytes(1469598103934665603ULL,node.recipe.data(),node.recipe.size());
+        for (const std::string& input : node.inputs) {
+            const uint64_t content = hashes_.get(input);
+            h = hashBytes(h,input.data(),input.size());
+            h = hashBytes(h,&content,sizeof(content));
+        }
+        return h;
+    }
+
+    static std::string recordPath(const RunOptions& options,const Node& node) {
+        std::string file = node.name;
+        for (char& c : file) if (!std::isalnum((unsigned char)c) && c != '-' && c != '_') c = '_';
+        return (fs::path(options.cacheDir) / (file + ".key")).string();
+    }
+
+    static bool upToDate(const RunOptions& options,const Node& node,uint64_t key) {
+        if (options.cacheDir.empty() || options.force) return false;
+        for (const std::string& output : node.outputs) if (!fs::exists(output)) return false;
+        std::ifstream record(recordPath(options,node));
+        unsigned long long stored = 0;
+        return (record >> std::hex >> stored) && stored == key;
+    }
+
+    int execute(Node& node,const RunOptions& options) {
+        const auto t0 = std::chrono::steady_clock::now();
+        auto elapsed = [&]() { return std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - t0).count(); };
+        if (options.dryRun) {
+            //Reports what a run would do: stale upstream (or inputs it has
+            //not produced yet) means this node reruns too.
+            for (int dep : node.deps) if (nodes_[dep].state == NodeDone) return NodeDone;
+            try {
+                return upToDate(options,node,key(node)) ? NodeCached : NodeDone;
+            } catch (const std::exception&) {
+                return NodeDone;
+            }
+        }
+        try {
+            const uint64_t k = key(node);
+            if (upToDate(options,node,k)) return NodeCached;
+            for (const std::string& output : node.outputs) {
+                const fs::path parent = fs::path(output).parent_path();
+                if (!parent.empty()) fs::create_directories(parent);
+            }
+            if (node.action) node.action(node);
+            for (const std::string& output : node.outputs) {
+                if (!fs::exists(output)) throw std::runtime_error("did not produce " + output);
+            }
+            node.milliseconds = elapsed();
+            if (!options.cacheDir.empty()) {
+                std::ofstream record(recordPath(options,node));
+                char text[24];
+                std::snprintf(text,sizeof(text),"%016llx\n",(unsigned long long)k);
+                record << text;
+            }
+            return NodeDone;
+        } catch (const std::exception& e) {
+            node.milliseconds = elapsed();
+            node.error = e.what();
+            return NodeFailed;
+        }
+    }
+};
+
+} // namespace pipeline
+
+#endif // LIVE_SKYBOXES_PIPELINE_GRAPH_H
@@ -0,0 +1,517 @@
+//Pipeline Orchestrator
+//Engine
+//Chris D. | Version 2 | Version Date: 10/18/2026
+
+// ============================================================== //
+// |                      VERSION HISTORY                       | //
+// ============================================================== //
+//  Version 0 (10/18/2026): Functional launch
+//  Version 1 (10/18/2026): --metricsPort / --metricsFile export the
+//      scheduler's queue, cache and stage-latency metrics
+//  Version 2 (10/18/2026): [CHRIS'S KIT] log prefix, like the other
+//      engines
+
+// ============================================================== //
+// |                    PROGRAM DESCRIPTION                     | //
+// ============================================================== //
+//  Runs the skybox tools end to end from one config file instead of
+//  by hand through each UI. The config becomes a DAG (pipelineGraph.h):
+//
+//    schedule            seScreenshotEngine writes the SpaceEngine script
+//    render[frame]       stand-in for SpaceEngine: a command template, or
+//                        a pattern of already-rendered panoramas to copy
+//    project[frame]      stereographicProjectionEngine
+//    detect[frame]       starDetectionEngine, columnar (.stc) output
+//    catalog             every frame's detections merged into one .stc
+//                        table with a frame column
+//
+//  Frames are independent, so with --jobs > 1 their stages overlap;
+//  maxParallel per stage (e.g. one SpaceEngine instance) and memoryMB
+//  per stage against the pipeline budget bound what runs at once.
+//  Nodes whose recipe and input contents are unchanged since their
+//  last run are skipped. Each run reports per-node and per-stage
+//  timings and the overlap gained (sum of stage times / wall time).
+//
+//  Config (INI; '#' or ';' starts a comment line). Values may use
+//  {workDir}, {frame} (zero-padded), {index}, {output}, {script}:
+//
+//    [pipeline]
+//    workDir = skyboxBuild
+//    frames = 24
+//    firstFrame = 1
+//    jobs = 4
+//    memoryMB = 8192
+//    threadsPerJob = 2          (OMP_NUM_THREADS for the tools)
+//
+//    [schedule]                 (optional)
+//    tool = SpaceEngine_Automation/seScreenshotEngine
+//    args = --scriptName sky --capturePosition Sol/Earth ...
+//
+//    [render]
+//    command = my_render.sh {script} {index} {output}
+//      or
+//    source = panoramas/pano_{frame}.png
+//    extension = png
+//    maxParallel = 1
+//
+//    [project]
+//    tool = Stereographic_Projection/stereographicProjectionEngine
+//    args = --size 2048
+//    memoryMB = 1500
+//
+//    [detect]
+//    tool = Star_Detection_and_Data_Generation/starDetectionEngine
+//    image = hemispheres        (hemispheres | north | south)
+//    args = --disc hemispheres --maxStars 500
+//
+//    [catalog]
+//    output = {workDir}/catalog.stc
+//
+//  Any stage section may set enabled = 0; later stages then start
+//  from the last enabled one.
+//
+//  --metricsPort N serves Prometheus text on 127.0.0.1:N while the
+//  pipeline runs; --metricsFile F is rewritten on SIGUSR1 and at the
+//  end (engineMetrics.h).
+
+// ============================================================== //
+// |                     COMPILE BASH SCRIPT                    | //
+// ============================================================== //
+// g++ pipelineOrchestrator.cpp -o pipelineOrchestrator -std=c++17 -O2 -Wall -pthread
+// (Windows/MinGW) add: -lws2_32
+
+// ============================================================== //
+// |                      INCLUDE / DEFINE                      | //
+// ============================================================== //
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <filesystem>
+
+#include "pipelineGraph.h"
+#include "Star_Detection_and_Data_Generation/starColumns.h"
+
+namespace fs = std::filesystem;
+
+static const std::string kScriptName = "CHRIS'S KIT";
+
+// ============================================================== //
+// |                           CONFIG                           | //
+// ============================================================== //
+using Section = std::map<std::string,std::string>;
+using Config = std::map<std::string,Section>;
+
+static std::string trim(const std::string& text) {
+    const size_t a = text.find_first_not_of(" \t\r\n");
+    if (a == std::string::npos) return "";
+    const size_t b = text.find_last_not_of(" \t\r\n");
+    return text.substr(a,b - a + 1);
+}
+
+static Config readConfig(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) throw std::runtime_error("[" + kScriptName + "]: Failed to open config: " + path);
+    Config config;
+    std::string line, section;
+    int lineNumber = 0;
+    while (std::getline(file,line)) {
+        lineNumber++;
+        line = trim(line);
+        if (line.empty() || line[0] == '#' || line[0] == ';') continue;
+        if (line.front() == '[' && line.back() == ']') {
+            section = trim(line.substr(1,line.size() - 2));
+            config[section];
+            continue;
+        }
+        const size_t eq = line.find('=');
+        if (eq == std::string::npos || section.empty()) {
+            throw std::runtime_error("[" + kScriptName + "]: " + path + ":" + std::to_string(lineNumber) + ": expected key = value in a [section]");
+        }
+        config[section][trim(line.substr(0,eq))] = trim(line.substr(eq + 1));
+    }
+    return config;
+}
+
+static std::string value(const Config& config,const std::string& section,const std::string& key,const std::string& fallback = "") {
+    auto s = config.find(section);
+    if (s == config.end()) return fallback;
+    auto k = s->second.find(key);
+    return k == s->second.end() ? fallback : k->second;
+}
+
+static int intValue(const Config& config,const std::string& section,const std::string& key,int fallback) {
+    const std::string text = value(config,section,key);
+    if (text.empty()) return fallback;
+    try {
+        return std::stoi(text);
+    } catch (const std::exception&) {
+        throw std::runtime_error("[" + kScriptName + "]: [" + section + "] " + key + " is not an integer: " + text);
+    }
+}
+
+static bool stageEnabled(const Config& config,const std::string& stage) {
+    return config.count(stage) && intValue(config,stage,"enabled",1) != 0;
+}
+
+//Replaces {name} placeholders; unknown names are an error.
+static std::string expand(const std::string& text,const std::map<std::string,std::string>& values) {
+    std::string out;
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] != '{') { out += text[i]; continue; }
+        const size_t close = text.find('}',i);
+        if (close == std::string::npos) throw std::runtime_error("[" + kScriptName + "]: Unclosed placeholder in: " + text);
+        const std::string name = text.substr(i + 1,close - i - 1);
+        auto it = values.find(name);
+        if (it == values.end()) throw std::runtime_error("[" + kScriptName + "]: Unknown placeholder {" + name + "} in: " + text);
+        out += it->second;
+        i = close;
+    }
+    return out;
+}
+
+static std::string quote(const std::string& path) { return "\"" + path + "\""; }
+
+static std::string frameLabel(int frame) {
+    char text[16];
+    std::snprintf(text,sizeof(text),"%04d",frame);
+    return text;
+}
+
+// ============================================================== //
+// |                          ACTIONS                           | //
+// ============================================================== //
+//Runs a shell command with stdout/stderr captured to logPath.
+static void runCommand(const std::string& command,const std::string& logPath) {
+    fs::create_directories(fs::path(logPath).parent_path());
+    std::string line = command + " > " + quote(logPath) + " 2>&1";
+    #if defined(_WIN32)
+    line = "\"" + line + "\""; //cmd /c strips one pair of outer quotes
+    #endif
+    const int status = std::system(line.c_str());
+    if (status != 0) {
+        throw std::runtime_error("exit status " + std::to_string(status) + " (log: " + logPath + ")");
+    }
+}
+
+//Concatenates per-frame detection tables into one with a frame column.
+static void mergeCatalog(const std::vector<std::pair<int,std::string>>& frames,const std::string& outPath) {
+    std::vector<int32_t> frame, area;
+    std::vector<int64_t> id, track;
+    std::vector<double> x, y, flux, fwhm;
+    for (const auto& item : frames) {
+        StarColumnsFile table(item.second);
+        const size_t n = table.rows();
+        const ColumnSpan<double> cx = table.float64("x"), cy = table.float64("y");
+        ColumnSpan<int64_t> ids;
+        ColumnSpan<int32_t> areas;
+        ColumnSpan<double> fluxes, widths;
+        if (table.has("id")) ids = table.int64("id");
+        if (table.has("area")) areas = table.int32("area");
+        if (table.has("flux")) fluxes = table.float64("flux");
+        if (table.has("fwhm")) widths = table.float64("fwhm");
+        for (size_t i = 0; i < n; i++) {
+            frame.push_back(item.first);
+            id.push_back(ids.empty() ? (int64_t)i + 1 : ids[i]);
+            x.push_back(cx[i]);
+            y.push_back(cy[i]);
+            flux.push_back(fluxes.empty() ? 0.0 : fluxes[i]);
+            area.push_back(areas.empty() ? 0 : areas[i]);
+            fwhm.push_back(widths.empty() ? 0.0 : widths[i]);
+            track.push_back(-1); //Assigned by cross-frame tracking, not here
+        }
+    }
+    StarColumnsWriter writer(frame.size());
+    writer.addInt32("frame",frame,CodecDelta);
+    writer.addInt64("id",id,CodecDelta);
+    writer.addFloat64("x",x);
+    writer.addFloat64("y",y);
+    writer.addFloat64("flux",flux);
+    writer.addInt32("area",area,CodecDelta);
+    writer.addFloat64("fwhm",fwhm);
+    writer.addInt64("track",track,CodecDelta);
+    writer.write(outPath);
+}
+
+// ============================================================== //
+// |                        GRAPH BUILDER                       | //
+// ============================================================== //
+struct Built {
+    pipeline::Graph graph;
+    pipeline::RunOptions options;
+};
+
+static void buildPipeline(const Config& config,int framesOverride,Built& built) {
+    pipeline::Graph& graph = built.graph;
+    pipeline::RunOptions& options = built.options;
+
+    const std::string workDir = value(config,"pipeline","workDir","skyboxBuild");
+    const int frames = framesOverride > 0 ? framesOverride : intValue(config,"pipeline","frames",1);
+    const int firstFrame = intValue(config,"pipeline","firstFrame",1);
+    if (frames <= 0) throw std::runtime_error("[" + kScriptName + "]: [pipeline] frames must be positive");
+    options.jobs = intValue(config,"pipeline","jobs",1);
+    options.memoryMB = intValue(config,"pipeline","memoryMB",0);
+    options.cacheDir = (fs::path(workDir) / "cache").string();
+    const std::string logDir = (fs::path(workDir) / "logs").string();
+    for (const char* stage : {"schedule","render","project","detect","catalog"}) {
+        options.limits[stage].maxParallel = intValue(config,stage,"maxParallel",0);
+    }
+    std::map<std::string,std::string> common = {{"workDir",workDir}};
+    auto memoryOf = [&](const std::string& stage) { return intValue(config,stage,"memoryMB",0); };
+    auto toolOf = [&](const std::string& stage) {
+        const std::string tool = value(config,stage,"tool");
+        if (tool.empty()) throw std::runtime_error("[" + kScriptName + "]: [" + stage + "] needs tool =");
+        return tool;
+    };
+    auto logOf = [&](const std::string& name) {
+        std::string file = name;
+        for (char& c : file) if (c == '[' || c == ']') c = '_';
+        return (fs::path(logDir) / (file + ".log")).string();
+    };
+    auto commandNode = [&](pipeline::Node& node,const std::string& command) {
+        node.recipe = command;
+        const std::string log = logOf(node.name);
+        node.action = [command,log](const pipeline::Node&) { runCommand(command,log); };
+    };
+
+    // ----- Schedule ----- //
+    int scheduleNode = -1;
+    std::string script;
+    if (stageEnabled(config,"schedule")) {
+        pipeline::Node node;
+        node.name = node.stage = "schedule";
+        script = (fs::path(workDir) / "schedule" / "skybox.se").string();
+        const std::string tool = toolOf("schedule");
+        node.inputs = {tool};
+        node.outputs = {script};
+        node.memoryMB = memoryOf("schedule");
+        commandNode(node,quote(tool) + " --out " + quote(script) + " " + expand(value(config,"schedule","args"),common));
+        scheduleNode = graph.add(std::move(node));
+    }
+
+    // ----- Per frame: render, project, detect ----- //
+    std::vector<std::pair<int,std::string>> catalogInputs;
+    std::vector<int> catalogDeps;
+    for (int k = 0; k < frames; k++) {
+        const int frame = firstFrame + k;
+        std::map<std::string,std::string> values = common;
+        values["frame"] = frameLabel(frame);
+        values["index"] = std::to_string(frame);
+        values["script"] = script;
+
+        int last = scheduleNode;
+        std::string panorama;
+        if (stageEnabled(config,"render")) {
+            pipeline::Node node;
+            node.stage = "render";
+            node.name = "render[" + values["frame"] + "]";
+            node.frame = frame;
+            if (last >= 0) node.deps = {last};
+            node.memoryMB = memoryOf("render");
+            const std::string extension = value(config,"render","extension","png");
+            panorama = (fs::path(workDir) / "render" / ("frame_" + values["frame"] + "." + extension)).string();
+            node.outputs = {panorama};
+            if (!script.empty()) node.inputs = {script};
+            values["output"] = panorama;
+            const std::string command = value(config,"render","command");
+            if (!command.empty()) {
+                commandNode(node,expand(command,values));
+            } else {
+                //Stand-in without a renderer: copy a panorama rendered elsewhere
+                const std::string source = expand(value(config,"render","source"),values);
+                if (source.empty()) throw std::runtime_error("[" + kScriptName + "]: [render] needs command = or source =");
+                node.inputs.push_back(source);
+                node.recipe = "copy " + source;
+                node.action = [source,panorama](const pipeline::Node&) {
+                    fs::copy_file(source,panorama,fs::copy_options::overwrite_existing);
+                };
+            }
+            last = graph.add(std::move(node));
+        } else {
+            panorama = expand(value(config,"render","source"),values);
+        }
+
+        std::string image = panorama;
+        if (stageEnabled(config,"project")) {
+            if (panorama.empty()) throw std::runtime_error("[" + kScriptName + "]: [project] has no panorama (enable [render] or set source =)");
+            pipeline::Node node;
+            node.stage = "project";
+            node.name = "project[" + values["frame"] + "]";
+            node.frame = frame;
+            if (last >= 0) node.deps = {last};
+            node.memoryMB = memoryOf("project");
+            const std::string tool = toolOf("project");
+            const bool both = intValue(config,"project","bothHemispheres",1) != 0;
+            //The projection engine writes next to its input:
+            std::string stem = panorama;
+            const size_t dot = stem.find_last_of('.');
+            if (dot != std::string::npos && stem.find_first_of("/\\",dot) == std::string::npos) stem = stem.substr(0,dot);
+            node.inputs = {tool,panorama};
+            node.outputs = {stem + "_stereoNorth.png",stem + "_stereoSouth.png"};
+            if (both) node.outputs.push_back(stem + "_stereoHemispheres.png");
+            commandNode(node,quote(tool) + " " + quote(panorama) + " --bothHemispheres " + (both ? "1 " : "0 ")
+                             + expand(value(config,"project","args"),values));
+            const std::string which = value(config,"detect","image","hemispheres");
+            if (which == "north") image = node.outputs[0];
+            else if (which == "south") image = node.outputs[1];
+            else if (which == "hemispheres" && both) image = node.outputs[2];
+            else throw std::runtime_error("[" + kScriptName + "]: [detect] image must be hemispheres (with bothHemispheres = 1), north or south");
+            last = graph.add(std::move(node));
+        }
+
+        if (stageEnabled(config,"detect")) {
+            if (image.empty()) throw std::runtime_error("[" + kScriptName + "]: [detect] has no input image");
+            pipeline::Node node;
+            node.stage = "detect";
+            node.name = "detect[" + values["frame"] + "]";
+            node.frame = frame;
+            if (last >= 0) node.deps = {last};
+            node.memoryMB = memoryOf("detect");
+            const std::string tool = toolOf("detect");
+            const std::string table = (fs::path(workDir) / "detect" / ("frame_" + values["frame"] + ".stc")).string();
+            node.inputs = {tool,image};
+            node.outputs = {table};
+            commandNode(node,quote(tool) + " " + quote(image) + " --out " + quote(table) + " " + expand(value(config,"detect","args"),values));
+            catalogInputs.push_back({frame,table});
+            catalogDeps.push_back(graph.add(std::move(node)));
+        }
+    }
+
+    // ----- Catalog ----- //
+    if (stageEnabled(config,"catalog")) {
+        if (catalogInputs.empty()) throw std::runtime_error("[" + kScriptName + "]: [catalog] needs [detect]");
+        pipeline::Node node;
+        node.name = node.stage = "catalog";
+        node.frame = firstFrame + frames;
+        node.deps = catalogDeps;
+        node.memoryMB = memoryOf("catalog");
+        const std::string output = expand(value(config,"catalog","output","{workDir}/catalog.stc"),common);
+        for (const auto& item : catalogInputs) node.inputs.push_back(item.second);
+        node.outputs = {output};
+        node.recipe = "merge v0 -> " + output;
+        node.action = [catalogInputs,output](const pipeline::Node&) { mergeCatalog(catalogInputs,output); };
+        graph.add(std::move(node));
+    }
+
+    if (graph.nodes().empty()) throw std::runtime_error("[" + kScriptName + "]: No stages enabled");
+}
+
+// ============================================================== //
+// |                           REPORT                           | //
+// ============================================================== //
+static void report(const pipeline::Graph& graph,const pipeline::RunSummary& summary,bool dryRun,const std::string& tsvPath) {
+    struct StageTotals { int nodes = 0, ran = 0, cached = 0; double total = 0.0, longest = 0.0; };
+    std::vector<std::string> order;
+    std::map<std::string,StageTotals> stages;
+    for (const pipeline::Node& node : graph.nodes()) {
+        if (!stages.count(node.stage)) order.push_back(node.stage);
+        StageTotals& totals = stages[node.stage];
+        totals.nodes++;
+        totals.ran += node.state == pipeline::NodeDone;
+        totals.cached += node.state == pipeline::NodeCached;
+        totals.total += node.milliseconds;
+        totals.longest = std::max(totals.longest,node.milliseconds);
+    }
+
+    for (const pipeline::Node& node : graph.nodes()) {
+        const char* state = (dryRun && node.state == pipeline::NodeDone) ? "would run" : pipeline::kNodeStateNames[node.state];
+        std::printf("  %-18s %-9s %10.1f ms%s%s\n",node.name.c_str(),state,node.milliseconds,
+                    node.error.empty() ? "" : "  ",node.error.c_str());
+    }
+    std::printf("\n  %-10s %6s %6s %6s %12s %12s\n","stage","nodes","ran","cached","total ms","longest ms");
+    for (const std::string& stage : order) {
+        const StageTotals& totals = stages[stage];
+        std::printf("  %-10s %6d %6d %6d %12.1f %12.1f\n",stage.c_str(),totals.nodes,totals.ran,totals.cached,totals.total,totals.longest);
+    }
+    std::printf("\n[%s] %d ran, %d cached, %d failed, %d skipped | wall %.1f ms, stage sum %.1f ms (overlap %.2fx)\n",
+                kScriptName.c_str(),summary.ran,summary.cached,summary.failed,summary.skipped,summary.wallMilliseconds,
+                summary.stageMilliseconds,summary.wallMilliseconds > 0.0 ? summary.stageMilliseconds / summary.wallMilliseconds : 0.0);
+
+    if (tsvPath.empty()) return;
+    std::ofstream tsv(tsvPath);
+    if (!tsv) throw std::runtime_error("[" + kScriptName + "]: Failed to write report: " + tsvPath);
+    tsv << "node\tstage\tframe\tstate\tms\terror\n";
+    for (const pipeline::Node& node : graph.nodes()) {
+        tsv << node.name << "\t" << node.stage << "\t" << node.frame << "\t" << pipeline::kNodeStateNames[node.state] << "\t"
+            << node.milliseconds << "\t" << node.error << "\n";
+    }
+}
+
+// ============================================================== //
+// |                        CLI PARSING                         | //
+// ============================================================== //
+struct Options {
+    std::string config;
+    int jobs = 0, frames = 0;
+    bool force = false, dryRun = false;
+    std::string reportPath;
+    int metricsPort = 0;
+    std::string metricsFile;
+};
+
+static Options parseArguments(int argc,char** argv) {
+    Options opt;
+    if (argc < 2) {
+        std::fprintf(stderr,
+            "Usage: %s <pipeline.cfg> [--jobs N] [--frames N] [--force] [--dryRun] [--report timings.tsv]\n"
+            "          [--metricsPort N] [--metricsFile metrics.prom]\n",argv[0]);
+        std::exit(1);
+    }
+    opt.config = argv[1];
+    for (int i = 2; i < argc; i++) {
+        std::string key = argv[i];
+        auto need = [&](bool has) { if (!has) throw std::runtime_error("[" + kScriptName + "]: Missing value for " + key); };
+        if (key == "--jobs") { need(i + 1 < argc); opt.jobs = std::stoi(argv[++i]); }
+        else if (key == "--frames") { need(i + 1 < argc); opt.frames = std::stoi(argv[++i]); }
+        else if (key == "--force") { opt.force = true; }
+        else if (key == "--dryRun") { opt.dryRun = true; }
+        else if (key == "--report") { need(i + 1 < argc); opt.reportPath = argv[++i]; }
+        else if (key == "--metricsPort") { need(i + 1 < argc); opt.metricsPort = std::stoi(argv[++i]); }
+        else if (key == "--metricsFile") { need(i + 1 < argc); opt.metricsFile = argv[++i]; }
+        else { std::fprintf(stderr,"Unknown arg: %s\n",key.c_str()); std::exit(1); }
+    }
+    return opt;
+}
+
+// ============================================================== //
+// |                        MAIN PROGRAM                        | //
+// ============================================================== //
+int main(int argc,char** argv) {
+    try {
+        Options opt = parseArguments(argc,argv);
+        Config config = readConfig(opt.config);
+        Built built;
+        buildPipeline(config,opt.frames,built);
+        if (opt.jobs > 0) built.options.jobs = opt.jobs;
+        built.options.force = opt.force;
+        built.options.dryRun = opt.dryRun;
+
+        //Keep concurrent tools from each claiming every core:
+        const int threadsPerJob = intValue(config,"pipeline","threadsPerJob",0);
+        if (threadsPerJob > 0) {
+            #if defined(_WIN32)
+            _putenv_s("OMP_NUM_THREADS",std::to_string(threadsPerJob).c_str());
+            #else
+            setenv("OMP_NUM_THREADS",std::to_string(threadsPerJob).c_str(),1);
+            #endif
+        }
+
+        std::printf("[%s] %zu nodes, %d jobs%s\n",kScriptName.c_str(),built.graph.nodes().size(),built.options.jobs,
+                    opt.dryRun ? " (dry run)" : "");
+        metrics::Exporter exporter;
+        exporter.start(opt.metricsPort,opt.metricsFile);
+        const pipeline::RunSummary summary = built.graph.run(built.options);
+        exporter.stop();
+        report(built.graph,summary,opt.dryRun,opt.reportPath);
+        return summary.failed > 0 ? 1 : 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr,"Error: %s\n",e.what());
+        return 1;
+    }
+} // END OF MAIN PROGRAM